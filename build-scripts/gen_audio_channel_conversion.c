@@ -457,5 +457,29 @@ int main(void)
 
     printf("};\n\n");
 
+    printf("// The same conversions as coefficient matrices, for the SIMD converters: dst[j] = sum(src[i] * matrix[(j * fromchans) + i])\n");
+    printf("static const float channel_converter_matrices[%d][%d][%d] = {   /* [from][to] */\n", NUM_CHANNELS, NUM_CHANNELS, NUM_CHANNELS * NUM_CHANNELS);
+    for (ini = 1; ini <= NUM_CHANNELS; ini++) {
+        printf("    {\n");
+        for (outi = 1; outi <= NUM_CHANNELS; outi++) {
+            const float *cvtmatrix = channel_conversion_matrix[ini-1][outi-1];
+            int i, j;
+            printf("        {   /* %s x %s */\n", layout_names[ini-1], layout_names[outi-1]);
+            for (j = 0; j < outi; j++) {
+                printf("           ");
+                for (i = 0; i < ini; i++) {
+                    /* the table doesn't always hold an identity matrix for same-layout "conversions", but they're never used. */
+                    const float coefficient = (ini == outi) ? ((i == j) ? 1.0f : 0.0f) : cvtmatrix[(j * ini) + i];
+                    printf(" %.9ff%s", coefficient, ((i == ini - 1) && (j == outi - 1)) ? "" : ",");
+                }
+                printf("  /* %s */\n", channel_names[outi-1][j]);
+            }
+            printf("        }%s\n", (outi == NUM_CHANNELS) ? "" : ",");
+        }
+        printf("    }%s\n", (ini == NUM_CHANNELS) ? "" : ",");
+    }
+
+    printf("};\n\n");
+
     return 0;
 }
@@ -170,6 +170,20 @@ typedef struct SDL_AudioSpec
 struct SDL_AudioStream;  /* this is opaque to the outside world. */
 typedef struct SDL_AudioStream SDL_AudioStream;
 
+/**
+ * How an audio stream resamples, from cheapest to best sounding.
+ *
+ * This is set per stream with the "SDL.audiostream.resampler_quality"
+ * property; see SDL_GetAudioStreamProperties().
+ */
+typedef enum
+{
+    SDL_AUDIO_RESAMPLER_NEAREST,  /**< nearest sample, no filtering */
+    SDL_AUDIO_RESAMPLER_LINEAR,   /**< linear interpolation between two samples */
+    SDL_AUDIO_RESAMPLER_CUBIC,    /**< cubic interpolation across four samples */
+    SDL_AUDIO_RESAMPLER_SINC      /**< windowed-sinc filtering (the default) */
+} SDL_AudioResamplerQuality;
+
 
 /* Function prototypes */
 
@@ -351,6 +365,65 @@ extern DECLSPEC char *SDLCALL SDL_GetAudioDeviceName(SDL_AudioDeviceID devid);
  */
 extern DECLSPEC int SDLCALL SDL_GetAudioDeviceFormat(SDL_AudioDeviceID devid, SDL_AudioSpec *spec, int *sample_frames);
 
+/**
+ * The number of buckets in each SDL_AudioDeviceStats histogram.
+ *
+ * Bucket 0 counts durations shorter than 2 microseconds, bucket N counts
+ * durations from 2^N up to (but not including) 2^(N+1) microseconds, and
+ * the last bucket also counts everything longer than that.
+ */
+#define SDL_AUDIO_DEVICE_STATS_BUCKETS 20
+
+/**
+ * Timing counters for an opened audio device.
+ *
+ * A "period" is one buffer's worth of audio passing between SDL and the
+ * hardware. All counters start at zero when the physical device is opened.
+ *
+ * \sa SDL_GetAudioDeviceStats
+ */
+typedef struct SDL_AudioDeviceStats
+{
+    Uint64 periods;             /**< Number of periods the device thread has processed */
+    Uint64 period_ns;           /**< How long one period of audio lasts, in nanoseconds */
+    Uint64 short_reads;         /**< Output only: times a bound stream had less data than the device needed */
+    Uint64 xruns;               /**< Underruns or overruns reported by the platform, if it reports them */
+    Uint64 max_wait_to_play_ns; /**< Longest time from the device asking for data to SDL handing it over */
+    Uint64 max_process_ns;      /**< Longest time spent mixing and converting (or distributing captured data) in one period */
+    Uint64 max_interval_ns;     /**< Longest time between the start of two consecutive periods */
+    Uint64 wait_to_play_histogram[SDL_AUDIO_DEVICE_STATS_BUCKETS];  /**< Distribution of wait-to-play times */
+    Uint64 process_histogram[SDL_AUDIO_DEVICE_STATS_BUCKETS];       /**< Distribution of processing times */
+    Uint64 interval_histogram[SDL_AUDIO_DEVICE_STATS_BUCKETS];      /**< Distribution of period intervals; compare to `period_ns` to see jitter */
+} SDL_AudioDeviceStats;
+
+/**
+ * Get timing counters for an opened audio device.
+ *
+ * The counters are always collected, and are meant to be cheap enough to
+ * leave on in shipping builds. They are gathered by the device's audio
+ * thread without taking any extra locks, and this function doesn't block
+ * that thread, so it can be called often (say, to show them live).
+ *
+ * A logical device ID reports the counters of the physical device it is
+ * attached to, since that's where mixing happens. You may also specify
+ * SDL_AUDIO_DEVICE_DEFAULT_OUTPUT or SDL_AUDIO_DEVICE_DEFAULT_CAPTURE.
+ *
+ * Counters only grow; to measure an interval, take two snapshots and
+ * subtract them.
+ *
+ * \param devid the instance ID of the device to query.
+ * \param stats On return, will be filled with the device's counters.
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_GetAudioDeviceFormat
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceStats(SDL_AudioDeviceID devid, SDL_AudioDeviceStats *stats);
+
 
 /**
  * Open a specific audio device.
@@ -679,6 +752,44 @@ extern DECLSPEC SDL_AudioStream *SDLCALL SDL_CreateAudioStream(const SDL_AudioSp
 /**
  * Get the properties associated with an audio stream.
  *
+ * The following properties are understood by SDL:
+ *
+ * - "SDL.audiostream.resampler_quality" (number) - an
+ *   SDL_AudioResamplerQuality value; the lower tiers trade quality for less
+ *   CPU time and less per-stream memory, which helps when mixing many short
+ *   sounds. This is picked up the next time data is read from the stream.
+ *   Defaults to SDL_AUDIO_RESAMPLER_SINC.
+ * - "SDL.audiostream.get_callback.quantum" (number) - the fewest bytes of
+ *   input to ask a get callback for. Once any of the get_callback properties
+ *   are set, the callback is only called when a read comes up short or the
+ *   queue drops below the prefetch amount, and is then asked for at least
+ *   this much, so decoders can work in large batches. Defaults to 0.
+ * - "SDL.audiostream.get_callback.prefetch" (number) - ask a get callback for
+ *   more data whenever fewer than this many bytes of input are queued, even
+ *   if a read could be satisfied without it. Defaults to 0.
+ * - "SDL.audiostream.get_callback.async" (boolean) - true to run the get
+ *   callback on a worker thread owned by the audio subsystem instead of the
+ *   thread reading from the stream. The read returns whatever is already
+ *   queued without waiting for the callback, so this is best combined with a
+ *   prefetch amount. The callback runs without the stream's lock held. If the
+ *   audio subsystem isn't initialized, the callback runs inline as usual.
+ *   Defaults to false.
+ * - "SDL.audiostream.low_watermark" (number) - when the bytes of input queued
+ *   drop below this, an SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK event is sent.
+ *   Defaults to 0, for no events.
+ * - "SDL.audiostream.high_watermark" (number) - when the bytes of input
+ *   queued reach this, an SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK event is
+ *   sent. Defaults to 0, for no events.
+ *
+ * The get_callback properties are picked up the next time data is read from
+ * the stream, and the watermarks the next time data is put into or read from
+ * it. Watermark events are only sent once per crossing and only while the
+ * audio subsystem is initialized; the amount queued is checked whenever data
+ * is put into or read from the stream. Each stream has at most one event of
+ * each type waiting to be sent: if the amount queued crosses the same
+ * watermark again before events are pumped, that event reports the most
+ * recent crossing.
+ *
  * \param stream the SDL_AudioStream to query
  * \returns a valid property ID on success or 0 on failure; call
  *          SDL_GetError() for more information.
@@ -690,6 +801,44 @@ extern DECLSPEC SDL_AudioStream *SDLCALL SDL_CreateAudioStream(const SDL_AudioSp
  */
 extern DECLSPEC SDL_PropertiesID SDLCALL SDL_GetAudioStreamProperties(SDL_AudioStream *stream);
 
+/**
+ * A snapshot of the pool that audio streams recycle their queued data
+ * through.
+ *
+ * Audio streams keep queued data in chunks, and the pool is shared by every
+ * stream in the process.
+ *
+ * \sa SDL_GetAudioChunkPoolStats
+ */
+typedef struct SDL_AudioChunkPoolStats
+{
+    Uint64 num_allocated;   /**< Chunks currently allocated, whether in use or waiting in the pool */
+    Uint64 num_free;        /**< Chunks waiting in the pool to be reused */
+    Uint64 allocated_bytes; /**< Memory held by the pool, in use or not */
+    Uint64 free_bytes;      /**< Memory waiting in the pool to be reused */
+    Uint64 hits;            /**< Chunks reused from the pool */
+    Uint64 misses;          /**< Chunks that had to be allocated */
+} SDL_AudioChunkPoolStats;
+
+/**
+ * Get the current state of the audio stream chunk pool.
+ *
+ * This only takes the pool's own short-lived locks, and doesn't touch any
+ * stream, so it can be called often. `hits` and `misses` only grow; to
+ * measure an interval, take two snapshots and subtract them.
+ *
+ * \param stats On return, will be filled with the pool's counters.
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_CreateAudioStream
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioChunkPoolStats(SDL_AudioChunkPoolStats *stats);
+
 /**
  * Query the current format of an audio stream.
  *
@@ -778,6 +927,95 @@ extern DECLSPEC float SDLCALL SDL_GetAudioStreamFrequencyRatio(SDL_AudioStream *
  */
 extern DECLSPEC int SDLCALL SDL_SetAudioStreamFrequencyRatio(SDL_AudioStream *stream, float ratio);
 
+/**
+ * Get the gain of an audio stream.
+ *
+ * \param stream the SDL_AudioStream to query.
+ * \returns the gain of the stream, or -1.0f on error; call SDL_GetError()
+ *          for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread, as it holds
+ *               a stream-specific mutex while running.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_SetAudioStreamGain
+ */
+extern DECLSPEC float SDLCALL SDL_GetAudioStreamGain(SDL_AudioStream *stream);
+
+/**
+ * Change the gain of an audio stream.
+ *
+ * The gain scales every sample the stream contributes to a playback device's
+ * mix; 1.0 leaves it alone, 0.5 is about 6dB quieter, and 0.0 is silence.
+ * It is applied on top of any channel gains (see
+ * SDL_SetAudioStreamChannelGains).
+ *
+ * This is applied while the device mixes the stream, so it has no effect on
+ * streams that aren't bound to a playback device, and SDL_GetAudioStreamData
+ * always returns unscaled data. Changes are ramped smoothly over the next
+ * device buffer, so this can be called as often as needed for fades without
+ * clicks.
+ *
+ * \param stream The stream the gain is being changed on
+ * \param gain The new gain. Must be >= 0.0.
+ * \returns 0 on success, or -1 on error.
+ *
+ * \threadsafety It is safe to call this function from any thread, as it holds
+ *               a stream-specific mutex while running.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_GetAudioStreamGain
+ * \sa SDL_SetAudioStreamChannelGains
+ */
+extern DECLSPEC int SDLCALL SDL_SetAudioStreamGain(SDL_AudioStream *stream, float gain);
+
+/**
+ * Get the per-channel gains of an audio stream.
+ *
+ * \param stream the SDL_AudioStream to query.
+ * \param gains an array of `num_channels` floats to fill in.
+ * \param num_channels the number of channels to query, from 1 to 8.
+ * \returns 0 on success, or -1 on error.
+ *
+ * \threadsafety It is safe to call this function from any thread, as it holds
+ *               a stream-specific mutex while running.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_SetAudioStreamChannelGains
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioStreamChannelGains(SDL_AudioStream *stream, float *gains, int num_channels);
+
+/**
+ * Change the per-channel gains of an audio stream, to pan it.
+ *
+ * `gains[i]` scales channel `i` of the playback device's mix, in the device's
+ * channel layout (see SDL_GetAudioDeviceFormat), not the stream's input
+ * layout. Channels past `num_channels` get a gain of 1.0, and passing NULL
+ * for `gains` sets all of them back to 1.0. For example, on a stereo device,
+ * a constant-power pan to position `p` (from 0.0, left, to 1.0, right) is
+ * `{ SDL_cosf(p * SDL_PI_F / 2), SDL_sinf(p * SDL_PI_F / 2) }`.
+ *
+ * Like SDL_SetAudioStreamGain, this is applied while a playback device mixes
+ * the stream, and changes are ramped smoothly over the next device buffer.
+ *
+ * \param stream The stream the gains are being changed on
+ * \param gains An array of `num_channels` gains, each >= 0.0, or NULL
+ * \param num_channels The number of gains in `gains`, from 1 to 8
+ * \returns 0 on success, or -1 on error.
+ *
+ * \threadsafety It is safe to call this function from any thread, as it holds
+ *               a stream-specific mutex while running.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_GetAudioStreamChannelGains
+ * \sa SDL_SetAudioStreamGain
+ */
+extern DECLSPEC int SDLCALL SDL_SetAudioStreamChannelGains(SDL_AudioStream *stream, const float *gains, int num_channels);
+
 /**
  * Add data to be converted/resampled to the stream.
  *
@@ -810,6 +1048,102 @@ extern DECLSPEC int SDLCALL SDL_SetAudioStreamFrequencyRatio(SDL_AudioStream *st
  */
 extern DECLSPEC int SDLCALL SDL_PutAudioStreamData(SDL_AudioStream *stream, const void *buf, int len);
 
+/**
+ * A callback that fires when an SDL_AudioStream is done with data added by
+ * SDL_PutAudioStreamDataNoCopy.
+ *
+ * This is called once the stream has consumed all of the data, or when the
+ * data is thrown away because the stream was cleared or destroyed. After
+ * this, the app is free to reuse or free the buffer.
+ *
+ * The stream's lock is held while this runs, and it can run on any thread
+ * (like the audio device thread, when the stream is bound to a device), so
+ * it should be quick and should not try to use the stream.
+ *
+ * \param userdata An opaque pointer provided by the app for their personal use.
+ * \param buf The buffer that was passed to SDL_PutAudioStreamDataNoCopy.
+ * \param buflen The length of that buffer, in bytes.
+ *
+ * \since This datatype is available since SDL 3.0.0.
+ *
+ * \sa SDL_PutAudioStreamDataNoCopy
+ */
+typedef void (SDLCALL *SDL_AudioStreamDataCompleteCallback)(void *userdata, const void *buf, int buflen);
+
+/**
+ * Add data to the stream without copying it.
+ *
+ * This works like SDL_PutAudioStreamData, except that the stream keeps a
+ * pointer to `buf` instead of copying the data into its own memory. This is
+ * useful for data that's already in memory for a long time anyhow, like a
+ * decoded sound effect that is played over and over.
+ *
+ * The buffer must stay valid, and must not change, until `callback` is
+ * called. If this function fails, the stream doesn't keep the buffer and the
+ * callback isn't called.
+ *
+ * \param stream The stream the audio data is being added to
+ * \param buf A pointer to the audio data to add
+ * \param len The number of bytes to add to the stream
+ * \param callback A function to call when the stream is done with the data,
+ *                 or NULL
+ * \param userdata An opaque pointer to pass to `callback`
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread, but if the
+ *               stream has a callback set, the caller might need to manage
+ *               extra locking.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_PutAudioStreamData
+ * \sa SDL_ClearAudioStream
+ * \sa SDL_DestroyAudioStream
+ */
+extern DECLSPEC int SDLCALL SDL_PutAudioStreamDataNoCopy(SDL_AudioStream *stream, const void *buf, int len, SDL_AudioStreamDataCompleteCallback callback, void *userdata);
+
+/**
+ * Let a single thread add data to the stream without locking it.
+ *
+ * Normally SDL_PutAudioStreamData locks the stream, so a thread feeding a
+ * stream that is bound to an audio device has to take turns with the
+ * device's thread, every time either one touches the stream.
+ *
+ * In single-producer mode, the stream gets a lock-free buffer of at least
+ * `buffer_size` bytes. SDL_PutAudioStreamData copies data into this buffer
+ * without locking the stream, and the stream picks it up the next time
+ * something locks it to read, query, flush or clear it. The stream reads the
+ * data straight out of the buffer, and the space is only reused once it has
+ * been read, so the buffer should be large enough for as much data as the
+ * producer keeps queued ahead. If the data doesn't fit in the buffer, or the
+ * stream has a put callback, SDL_PutAudioStreamData locks the stream as usual.
+ * Data is always kept in order either way. Data added without locking is only
+ * counted against the stream's "SDL.audiostream.high_watermark" once the
+ * stream picks it up, so that event can arrive later than it would otherwise.
+ *
+ * This comes with some rules: only one thread may add data to the stream (the
+ * "producer"), and that includes not adding data from a get callback. Format
+ * changes with SDL_SetAudioStreamFormat still lock the stream; they should
+ * come from the producer, so they can't happen in the middle of adding data.
+ * Don't call this function while another thread might be adding data.
+ *
+ * \param stream The audio stream to change
+ * \param buffer_size The size of the lock-free buffer, in bytes, or 0 to go
+ *                    back to always locking the stream
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread, as long as
+ *               no other thread is adding data to the stream.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_PutAudioStreamData
+ * \sa SDL_SetAudioStreamFormat
+ */
+extern DECLSPEC int SDLCALL SDL_SetAudioStreamSingleProducer(SDL_AudioStream *stream, int buffer_size);
+
 /**
  * Get converted/resampled data from the stream.
  *
@@ -1054,9 +1388,14 @@ typedef void (SDLCALL *SDL_AudioStreamCallback)(void *userdata, SDL_AudioStream
  *
  * Clearing or flushing an audio stream does not call this callback.
  *
+ * The stream's "SDL.audiostream.get_callback.*" properties can batch these
+ * calls into fewer, larger requests, or move them to a worker thread; see
+ * SDL_GetAudioStreamProperties().
+ *
  * This function obtains the stream's lock, which means any existing callback
  * (get or put) in progress will finish running before setting the new
- * callback.
+ * callback. An async get callback runs without the stream's lock, so it might
+ * still be running when this returns.
  *
  * Setting a NULL function turns off the callback.
  *
@@ -1388,6 +1727,71 @@ extern DECLSPEC int SDLCALL SDL_LoadWAV_RW(SDL_RWops * src, SDL_bool freesrc,
 extern DECLSPEC int SDLCALL SDL_LoadWAV(const char *path, SDL_AudioSpec * spec,
                                         Uint8 ** audio_buf, Uint32 * audio_len);
 
+/**
+ * Create an audio stream that plays a WAVE file, decoding it as needed.
+ *
+ * Unlike SDL_LoadWAV_RW(), this only parses the file's headers up front. The
+ * audio data is decoded a block at a time from the stream's get callback as
+ * it is needed, so large files start playing right away and never have to be
+ * in memory all at once. The stream is flushed when the end of the data is
+ * reached.
+ *
+ * If `src` is a memory stream (from SDL_RWFromMem() or SDL_RWFromConstMem())
+ * and the data is PCM or floating point that the audio stream can take as-is,
+ * it is queued without being copied at all; the memory must stay valid until
+ * the stream is destroyed.
+ *
+ * The stream's input format is set from the file, in the same way
+ * SDL_LoadWAV_RW() reports it. The same formats and hints are supported.
+ *
+ * The stream owns the decoder; do not replace its get callback. Destroying
+ * the stream with SDL_DestroyAudioStream() frees everything, and closes
+ * `src` if `freesrc` is SDL_TRUE. The data source must support seeking, and
+ * must not be used by anything else while the stream exists.
+ *
+ * \param src The data source for the WAVE data
+ * \param freesrc If SDL_TRUE, calls SDL_RWclose() on `src` when the stream
+ *                is destroyed, or before returning if this function fails
+ * \param dst_spec The format details of the output audio, or NULL to set it
+ *                 later (for example, by binding the stream to a device)
+ * \returns a new audio stream on success, or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_CreateAudioStreamFromWAV
+ * \sa SDL_DestroyAudioStream
+ * \sa SDL_LoadWAV_RW
+ */
+extern DECLSPEC SDL_AudioStream *SDLCALL SDL_CreateAudioStreamFromWAV_RW(SDL_RWops *src, SDL_bool freesrc, const SDL_AudioSpec *dst_spec);
+
+/**
+ * Create an audio stream that plays a WAVE file from a path, decoding it as
+ * needed.
+ *
+ * This works like SDL_CreateAudioStreamFromWAV_RW(), but where the platform
+ * allows it, the file is mapped into memory instead of read. PCM and
+ * floating point data is then played straight from the mapping, without any
+ * reads or copies before it reaches the audio stream.
+ *
+ * \param path The file path of the WAV file to open.
+ * \param dst_spec The format details of the output audio, or NULL to set it
+ *                 later (for example, by binding the stream to a device)
+ * \returns a new audio stream on success, or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_CreateAudioStreamFromWAV_RW
+ * \sa SDL_DestroyAudioStream
+ * \sa SDL_LoadWAV
+ */
+extern DECLSPEC SDL_AudioStream *SDLCALL SDL_CreateAudioStreamFromWAV(const char *path, const SDL_AudioSpec *dst_spec);
+
 
 
 #define SDL_MIX_MAXVOLUME 128
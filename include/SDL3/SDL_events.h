@@ -190,6 +190,8 @@ typedef enum
     SDL_EVENT_AUDIO_DEVICE_ADDED = 0x1100,  /**< A new audio device is available */
     SDL_EVENT_AUDIO_DEVICE_REMOVED,         /**< An audio device has been removed. */
     SDL_EVENT_AUDIO_DEVICE_FORMAT_CHANGED,  /**< An audio device's format has been changed by the system. */
+    SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK,   /**< An audio stream's queued data dropped below its low watermark. */
+    SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK,  /**< An audio stream's queued data reached its high watermark. */
 
     /* Sensor events */
     SDL_EVENT_SENSOR_UPDATE = 0x1200,     /**< A sensor was updated */
@@ -502,6 +504,22 @@ typedef struct SDL_AudioDeviceEvent
     Uint8 padding3;
 } SDL_AudioDeviceEvent;
 
+/**
+ *  Audio stream event structure (event.astream.*)
+ *
+ *  These are only sent for streams that set the
+ *  "SDL.audiostream.low_watermark" or "SDL.audiostream.high_watermark"
+ *  properties; see SDL_GetAudioStreamProperties(). The stream might have been
+ *  destroyed by the time the app sees the event, if the app destroyed it.
+ */
+typedef struct SDL_AudioStreamEvent
+{
+    Uint32 type;        /**< ::SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK or ::SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK */
+    Uint64 timestamp;   /**< In nanoseconds, populated using SDL_GetTicksNS() */
+    SDL_AudioStream *stream; /**< The stream whose queue crossed a watermark */
+    int queued;         /**< Bytes of input queued in the stream right after it crossed */
+} SDL_AudioStreamEvent;
+
 
 /**
  *  Touch finger event structure (event.tfinger.*)
@@ -666,6 +684,7 @@ typedef union SDL_Event
     SDL_GamepadTouchpadEvent gtouchpad;     /**< Gamepad touchpad event data */
     SDL_GamepadSensorEvent gsensor;         /**< Gamepad sensor event data */
     SDL_AudioDeviceEvent adevice;           /**< Audio device event data */
+    SDL_AudioStreamEvent astream;           /**< Audio stream event data */
     SDL_SensorEvent sensor;                 /**< Sensor event data */
     SDL_QuitEvent quit;                     /**< Quit request event data */
     SDL_UserEvent user;                     /**< Custom event data */
@@ -898,6 +917,75 @@ extern DECLSPEC void SDLCALL SDL_FlushEvents(Uint32 minType, Uint32 maxType);
  */
 extern DECLSPEC SDL_bool SDLCALL SDL_PollEvent(SDL_Event *event);
 
+/**
+ * Poll for all currently pending events at once.
+ *
+ * This is equivalent to calling SDL_PollEvent() until it returns SDL_FALSE
+ * or `numevents` events have been retrieved, but it pumps the event loop at
+ * most once and only locks the event queue once, which is much cheaper when
+ * a lot of events are pending (e.g. with high polling rate mice).
+ *
+ * If fewer than `numevents` events are returned, all currently pending
+ * events have been retrieved. Otherwise there may be more events pending,
+ * and the next call will continue returning them without pumping again.
+ *
+ * As this function may implicitly call SDL_PumpEvents(), you can only call
+ * this function in the thread that set the video mode.
+ *
+ * ```c
+ * while (game_is_still_running) {
+ *     SDL_Event events[64];
+ *     int i, count;
+ *     do {
+ *         count = SDL_PollEvents(events, SDL_arraysize(events));
+ *         for (i = 0; i < count; ++i) {
+ *             // decide what to do with events[i].
+ *         }
+ *     } while (count == SDL_arraysize(events));
+ *
+ *     // update game state, draw the current frame
+ * }
+ * ```
+ *
+ * \param events an array of SDL_Event structures to be filled with events
+ *               from the queue
+ * \param numevents the maximum number of events to retrieve
+ * \returns the number of events stored in `events`, or a negative error code
+ *          on failure; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_PollEvent
+ * \sa SDL_PeepEvents
+ */
+extern DECLSPEC int SDLCALL SDL_PollEvents(SDL_Event *events, int numevents);
+
+/**
+ * Retrieve the individual mouse motion samples that were merged into motion
+ * events.
+ *
+ * When SDL_HINT_MOUSE_COALESCE_MOTION is set to "2", every mouse motion is
+ * also recorded, in order, as an SDL_MouseMotionEvent with the position and
+ * relative motion of that single sample. This lets applications that need
+ * the full resolution of the device (e.g. drawing programs) recover it while
+ * the event queue only holds the merged events.
+ *
+ * Only the most recent samples are kept, so this should be called regularly,
+ * typically once per frame after processing events.
+ *
+ * \param samples an array of SDL_MouseMotionEvent structures to be filled
+ *                with the oldest recorded samples
+ * \param numsamples the maximum number of samples to retrieve
+ * \returns the number of samples stored in `samples` and removed from the
+ *          recorded history, or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_HINT_MOUSE_COALESCE_MOTION
+ */
+extern DECLSPEC int SDLCALL SDL_GetMouseMotionSamples(SDL_MouseMotionEvent *samples, int numsamples);
+
 /**
  * Wait indefinitely for the next available event.
  *
@@ -1006,7 +1094,14 @@ typedef int (SDLCALL *SDL_EventFilter)(void *userdata, SDL_Event *event);
  * selective filtering of dynamically arriving events.
  *
  * **WARNING**: Be very careful of what you do in the event filter function,
- * as it may run in a different thread!
+ * as it may run in a different thread! Calls are not serialized: if several
+ * threads push events at once, the filter runs on each of them at the same
+ * time, so any state it touches must be protected.
+ *
+ * Once this function returns, the previous filter is no longer running on
+ * any thread and won't be called again. The exception is calling this from
+ * inside a filter or watch callback: then the previous filter won't be called
+ * again, but calls already in progress on other threads may still be running.
  *
  * On platforms that support it, if the quit event is generated by an
  * interrupt signal (e.g. pressing Ctrl-C), it will be delivered to the
@@ -1064,7 +1159,10 @@ extern DECLSPEC SDL_bool SDLCALL SDL_GetEventFilter(SDL_EventFilter *filter, voi
  * ignored.
  *
  * **WARNING**: Be very careful of what you do in the event filter function,
- * as it may run in a different thread!
+ * as it may run in a different thread! Calls are not serialized: if several
+ * threads push events at once, watchers run on each of them at the same
+ * time, and alongside the event filter, so any state they touch must be
+ * protected.
  *
  * If the quit event is generated by a signal (e.g. SIGINT), it will bypass
  * the internal queue and be delivered to the watch callback immediately, and
@@ -1093,6 +1191,12 @@ extern DECLSPEC int SDLCALL SDL_AddEventWatch(SDL_EventFilter filter, void *user
  * This function takes the same input as SDL_AddEventWatch() to identify and
  * delete the corresponding callback.
  *
+ * Once this function returns, the callback is no longer running on any thread
+ * and won't be called again, so `userdata` can be freed. The exception is
+ * calling this from inside a filter or watch callback: then the callback
+ * won't be called again, but calls already in progress on other threads may
+ * still be running, so don't free anything they might use.
+ *
  * \param filter the function originally passed to SDL_AddEventWatch()
  * \param userdata the pointer originally passed to SDL_AddEventWatch()
  *
@@ -1178,6 +1282,40 @@ extern DECLSPEC Uint32 SDLCALL SDL_RegisterEvents(int numevents);
  */
 extern DECLSPEC void * SDLCALL SDL_AllocateEventMemory(size_t size);
 
+/**
+ * Statistics about the memory used by SDL_AllocateEventMemory()
+ *
+ * \since This struct is available since SDL 3.0.0.
+ *
+ * \sa SDL_GetEventMemoryStats
+ */
+typedef struct SDL_EventMemoryStats
+{
+    Uint64 allocations;      /**< Number of calls to SDL_AllocateEventMemory() */
+    Uint64 bytes_allocated;  /**< Total number of bytes handed out */
+    Uint64 heap_allocations; /**< Number of arena blocks allocated from the heap */
+    Uint64 heap_frees;       /**< Number of arena blocks returned to the heap */
+    int blocks_in_use;       /**< Number of arena blocks holding event memory */
+    int blocks_cached;       /**< Number of empty arena blocks kept for reuse */
+} SDL_EventMemoryStats;
+
+/**
+ * Get statistics about the memory used by SDL_AllocateEventMemory()
+ *
+ * Event memory is carved out of arena blocks that are recycled once all the
+ * events that used them have been processed, so in steady state
+ * `heap_allocations` should stop increasing.
+ *
+ * \param stats a pointer filled in with the current statistics
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_AllocateEventMemory
+ */
+extern DECLSPEC int SDLCALL SDL_GetEventMemoryStats(SDL_EventMemoryStats *stats);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
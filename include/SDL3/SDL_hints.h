@@ -1238,6 +1238,20 @@ extern "C" {
  */
 #define SDL_HINT_MOUSE_AUTO_CAPTURE    "SDL_MOUSE_AUTO_CAPTURE"
 
+/**
+ *  A variable controlling whether consecutive mouse motion events are combined in the event queue
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Every mouse motion is queued as a separate event (the default)
+ *    "1"       - Mouse motion is merged into the newest queued event if that is motion for the same window, mouse and button state
+ *    "2"       - As above, and the individual motion samples are kept for SDL_GetMouseMotionSamples()
+ *
+ *  A merged event has the latest position and timestamp, and the sum of the relative motion.
+ *  This keeps high polling rate mice from flooding the event queue. Every motion is still
+ *  passed to the event filter and event watchers before it is merged.
+ */
+#define SDL_HINT_MOUSE_COALESCE_MOTION    "SDL_MOUSE_COALESCE_MOTION"
+
 /**
  *  Treat pen movement as separate from mouse movement
  *
@@ -2481,6 +2495,77 @@ extern "C" {
  */
 #define SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES "SDL_AUDIO_DEVICE_SAMPLE_FRAMES"
 
+/**
+ * Let SDL pick and adjust playback buffer sizes on the fly.
+ *
+ * The variable can be set to the following values:
+ *   "0"       - Use a fixed buffer size. (default)
+ *   "1"       - Start with a small buffer and adapt it at runtime.
+ *
+ * When enabled, a playback device opens with a small buffer (128 sample
+ * frames at 48000Hz) and SDL watches it from the audio thread. If the
+ * platform reports an underrun, the device thread wakes up late, or mixing
+ * takes most of the buffer's time, the buffer is doubled, up to the size
+ * SDL would have picked without this hint. After a stretch without trouble,
+ * SDL tries halving it again, and waits longer before the next try each
+ * time that fails. This finds the smallest buffer that is stable on a given
+ * machine without hand-tuning.
+ *
+ * Each change is reported with SDL_EVENT_AUDIO_DEVICE_FORMAT_CHANGED, and
+ * SDL_GetAudioDeviceFormat() reports the current size.
+ *
+ * This only applies to audio drivers that can resize a buffer while it is
+ * playing, and is ignored if SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES is set.
+ *
+ * This hint is checked when opening an audio device and can be changed
+ * between calls.
+ */
+#define SDL_HINT_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES "SDL_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES"
+
+/**
+ * Request worker threads to mix playback devices with many bound streams.
+ *
+ * This hint is an integer >= 0, the number of extra threads SDL should
+ * start to help mix audio. By default it is 0, and each playback device
+ * mixes all of its bound streams on its own thread.
+ *
+ * When it is > 0, a device that has two or more bound streams splits
+ * them between its own thread and the workers, which each mix their
+ * share into a separate buffer before the results are added together
+ * (and before any postmix callback sees them). Streams are always split
+ * the same way, so the output does not depend on thread timing. This can
+ * help when an app has a large number of streams that need resampling or
+ * conversion, but it costs a thread handoff per buffer, so it is rarely
+ * a win for just a few streams.
+ *
+ * Note that with this enabled, audio stream callbacks set with
+ * SDL_SetAudioStreamGetCallback() may run on any of the worker threads.
+ *
+ * This hint is checked when the audio subsystem is initialized.
+ */
+#define SDL_HINT_AUDIO_MIX_THREADS "SDL_AUDIO_MIX_THREADS"
+
+/**
+ * Drive several physical audio devices from a few shared threads.
+ *
+ * This hint is an integer >= 0, the number of shared device threads SDL
+ * should start. By default it is 0, and every opened physical device gets
+ * a thread of its own that sleeps until the device wants more data.
+ *
+ * When it is > 0, each newly opened device is handed to the shared thread
+ * that currently has the fewest devices. That thread checks each of its
+ * devices in turn, services the ones that are ready, and sleeps until the
+ * next one is expected to be. This saves threads and wakeups for apps that
+ * keep many devices open at once, at the cost of one slow device (or a
+ * slow audio stream callback) delaying the others on the same thread.
+ *
+ * Only some audio drivers can do this; the rest ignore this hint and keep
+ * using a thread per device.
+ *
+ * This hint is checked when the audio subsystem is initialized.
+ */
+#define SDL_HINT_AUDIO_SHARED_DEVICE_THREADS "SDL_AUDIO_SHARED_DEVICE_THREADS"
+
 
 /**
  * Request SDL_AppIterate() be called at a specific rate.
@@ -0,0 +1,119 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2023 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/**
+ *  \file SDL_test_eventrecord.h
+ *
+ *  Event recording and replay functions of SDL test framework.
+ *
+ *  This code is a part of the SDL test library, not the main SDL library.
+ */
+
+/*
+ * Records the events pushed through SDL_PushEvent() to a compact binary file
+ * and plays them back later, at the original or an accelerated pace, so input
+ * handling can be benchmarked reproducibly (e.g. with the dummy or offscreen
+ * video drivers in CI).
+ *
+ * Recordings store the raw SDL_Event layout, so they should be replayed by a
+ * build for the same architecture. Text and drop event strings are saved with
+ * the event; user event data pointers can't be recorded and are replayed as NULL.
+ */
+
+#ifndef SDL_test_eventrecord_h_
+#define SDL_test_eventrecord_h_
+
+#include <SDL3/SDL_begin_code.h>
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SDLTest_EventRecorder SDLTest_EventRecorder;
+typedef struct SDLTest_EventReplay SDLTest_EventReplay;
+
+/**
+ * Start recording events to a file
+ *
+ * Events are captured with an event watcher, so every event that reaches
+ * the event queue is recorded, from any thread.
+ *
+ * \param file the file to write the recording to
+ *
+ * \returns the recorder, or NULL on error
+ */
+SDLTest_EventRecorder *SDLTest_StartEventRecording(const char *file);
+
+/**
+ * Stop recording events, and finish writing the file
+ *
+ * \param recorder the recorder returned by SDLTest_StartEventRecording()
+ *
+ * \returns the number of events recorded, or -1 on error
+ */
+int SDLTest_StopEventRecording(SDLTest_EventRecorder *recorder);
+
+/**
+ * Open a recording for replay
+ *
+ * \param file the file written by SDLTest_StartEventRecording()
+ * \param speed how fast to replay, 1.0 for the original pace, 2.0 for twice as fast,
+ *              or 0.0 to replay every event as soon as possible
+ *
+ * \returns the replay, or NULL on error
+ */
+SDLTest_EventReplay *SDLTest_OpenEventReplay(const char *file, float speed);
+
+/**
+ * Push the recorded events that are due into the event queue
+ *
+ * Call this once per frame, before handling events. Replay time starts with
+ * the first call.
+ *
+ * \param replay the replay returned by SDLTest_OpenEventReplay()
+ *
+ * \returns the number of events pushed, or -1 on error
+ */
+int SDLTest_UpdateEventReplay(SDLTest_EventReplay *replay);
+
+/**
+ * Check whether all the recorded events have been pushed
+ *
+ * \param replay the replay returned by SDLTest_OpenEventReplay()
+ *
+ * \returns SDL_TRUE if the replay is finished, SDL_FALSE otherwise
+ */
+SDL_bool SDLTest_IsEventReplayDone(SDLTest_EventReplay *replay);
+
+/**
+ * Close a replay
+ *
+ * \param replay the replay returned by SDLTest_OpenEventReplay()
+ */
+void SDLTest_CloseEventReplay(SDLTest_EventReplay *replay);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include <SDL3/SDL_close_code.h>
+
+#endif /* SDL_test_eventrecord_h_ */
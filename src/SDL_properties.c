@@ -52,6 +52,7 @@ static SDL_HashTable *SDL_properties;
 static SDL_Mutex *SDL_properties_lock;
 static SDL_PropertiesID SDL_last_properties_id;
 static SDL_PropertiesID SDL_global_properties;
+static SDL_AtomicInt SDL_properties_serial;
 
 
 static void SDL_FreeProperty(const void *key, const void *value, void *data)
@@ -255,6 +256,7 @@ static int SDL_PrivateSetProperty(SDL_PropertiesID props, const char *name, SDL_
                 result = -1;
             }
         }
+        SDL_AtomicAdd(&SDL_properties_serial, 1);
     }
     SDL_UnlockMutex(properties->lock);
 
@@ -271,6 +273,9 @@ int SDL_SetPropertyWithCleanup(SDL_PropertiesID props, const char *name, void *v
 
     property = (SDL_Property *)SDL_calloc(1, sizeof(*property));
     if (!property) {
+        if (cleanup) {
+            cleanup(userdata, value);  /* same as the other failure cases, which free the property. */
+        }
         return SDL_OutOfMemory();
     }
     property->type = SDL_PROPERTY_TYPE_POINTER;
@@ -718,4 +723,11 @@ void SDL_DestroyProperties(SDL_PropertiesID props)
     SDL_LockMutex(SDL_properties_lock);
     SDL_RemoveFromHashTable(SDL_properties, (const void *)(uintptr_t)props);
     SDL_UnlockMutex(SDL_properties_lock);
+
+    SDL_AtomicAdd(&SDL_properties_serial, 1);
+}
+
+Uint32 SDL_GetPropertiesSerial(void)
+{
+    return (Uint32)SDL_AtomicGet(&SDL_properties_serial);
 }
@@ -21,3 +21,6 @@
 
 extern int SDL_InitProperties(void);
 extern void SDL_QuitProperties(void);
+
+/* Changes every time any property is set or cleared, so readers can cache values until it does */
+extern Uint32 SDL_GetPropertiesSerial(void);
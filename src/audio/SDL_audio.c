@@ -22,6 +22,7 @@
 
 #include "SDL_audio_c.h"
 #include "SDL_sysaudio.h"
+#include "SDL_audioqueue.h"
 #include "../thread/SDL_systhread.h"
 #include "../SDL_utils_c.h"
 
@@ -180,6 +181,43 @@ void OnAudioStreamDestroy(SDL_AudioStream *stream)
     }
 }
 
+static void CancelAudioStreamPrefetch(SDL_AudioStream *stream);
+
+void OnAudioStreamUnbound(SDL_AudioStream *stream)
+{
+    if (!current_audio.device_hash_lock) {
+        return;
+    }
+
+    CancelAudioStreamPrefetch(stream);
+
+    // drop this stream's watermark events if they haven't gone out yet.
+    SDL_AtomicLock(&current_audio.pending_stream_events_lock);
+    for (int i = 0; i < (int) SDL_arraysize(stream->watermark_events); i++) {
+        SDL_PendingAudioDeviceEvent *p = &stream->watermark_events[i];
+        if (stream->watermark_event_queued[i]) {
+            SDL_PendingAudioDeviceEvent *prev = &current_audio.pending_stream_events;
+            while (prev->next != p) {
+                prev = prev->next;
+            }
+            prev->next = p->next;
+            if (current_audio.pending_stream_events_tail == p) {
+                current_audio.pending_stream_events_tail = prev;
+            }
+            p->next = NULL;
+            stream->watermark_event_queued[i] = SDL_FALSE;
+        }
+    }
+    SDL_AtomicUnlock(&current_audio.pending_stream_events_lock);
+}
+
+// SDL_TRUE if the device mix has no gains to apply to this stream, and isn't in the middle of ramping away from some, either.
+// This gets checked every period, so it reads the flag the gain setters keep up to date instead of locking the stream.
+static SDL_bool AudioStreamHasUnityGains(SDL_AudioStream *stream)
+{
+    return SDL_AtomicGet(&stream->unity_gains) ? SDL_TRUE : SDL_FALSE;
+}
+
 // device should be locked when calling this.
 static SDL_bool AudioDeviceCanUseSimpleCopy(SDL_AudioDevice *device)
 {
@@ -189,7 +227,8 @@ static SDL_bool AudioDeviceCanUseSimpleCopy(SDL_AudioDevice *device)
         !device->logical_devices->next &&  // there's only _ONE_ logical device
         !device->logical_devices->postmix && // there isn't a postmix callback
         device->logical_devices->bound_streams &&  // there's a bound stream
-        !device->logical_devices->bound_streams->next_binding  // there's only _ONE_ bound stream.
+        !device->logical_devices->bound_streams->next_binding &&  // there's only _ONE_ bound stream.
+        AudioStreamHasUnityGains(device->logical_devices->bound_streams)  // the stream's data doesn't need scaling.
     );
 }
 
@@ -213,6 +252,8 @@ static void UpdateAudioStreamFormatsPhysical(SDL_AudioDevice *device)
                 // SDL_SetAudioStreamFormat does a ton of validation just to memcpy an audiospec.
                 SDL_LockMutex(stream->lock);
                 SDL_copyp(&stream->dst_spec, &spec);
+                UpdateAudioStreamConvertPlans(stream);
+                UpdateAudioStreamRingFrameSize(stream);
                 SDL_UnlockMutex(stream->lock);
             }
         }
@@ -233,6 +274,12 @@ static int ZombieWaitDevice(SDL_AudioDevice *device)
     return 0;
 }
 
+static int ZombiePollDevice(SDL_AudioDevice *device, Uint64 *wait_ns)
+{
+    const int frames = device->buffer_size / SDL_AUDIO_FRAMESIZE(device->spec);
+    return SDL_PollAudioDeviceTimer(device, (((Uint64) frames) * SDL_NS_PER_SECOND) / device->spec.freq, wait_ns);
+}
+
 static int ZombiePlayDevice(SDL_AudioDevice *device, const Uint8 *buffer, int buflen)
 {
     return 0;  // no-op, just throw the audio away.
@@ -596,7 +643,7 @@ SDL_AudioDevice *SDL_AddAudioDevice(const SDL_bool iscapture, const char *name,
 
     // Add a device add event to the pending list, to be pushed when the event queue is pumped (away from any of our internal threads).
     if (device) {
-        SDL_PendingAudioDeviceEvent *p = (SDL_PendingAudioDeviceEvent *) SDL_malloc(sizeof (SDL_PendingAudioDeviceEvent));
+        SDL_PendingAudioDeviceEvent *p = (SDL_PendingAudioDeviceEvent *) SDL_calloc(1, sizeof (SDL_PendingAudioDeviceEvent));
         if (p) {  // if allocation fails, you won't get an event, but we can't help that.
             p->type = SDL_EVENT_AUDIO_DEVICE_ADDED;
             p->devid = device->instance_id;
@@ -647,13 +694,14 @@ void SDL_AudioDeviceDisconnected(SDL_AudioDevice *device)
         device->WaitCaptureDevice = ZombieWaitDevice;
         device->CaptureFromDevice = ZombieCaptureFromDevice;
         device->FlushCapture = ZombieFlushCapture;
+        device->PollDevice = ZombiePollDevice;
 
         // on default devices, dump any logical devices that explicitly opened this device. Things that opened the system default can stay.
         // on non-default devices, dump everything.
         // (by "dump" we mean send a REMOVED event; the zombie will keep consuming audio data for these logical devices until explicitly closed.)
         for (SDL_LogicalAudioDevice *logdev = device->logical_devices; logdev; logdev = logdev->next) {
             if (!is_default_device || !logdev->opened_as_default) {  // if opened as a default, leave it on the zombie device for later migration.
-                SDL_PendingAudioDeviceEvent *p = (SDL_PendingAudioDeviceEvent *) SDL_malloc(sizeof (SDL_PendingAudioDeviceEvent));
+                SDL_PendingAudioDeviceEvent *p = (SDL_PendingAudioDeviceEvent *) SDL_calloc(1, sizeof (SDL_PendingAudioDeviceEvent));
                 if (p) {  // if this failed, no event for you, but you have deeper problems anyhow.
                     p->type = SDL_EVENT_AUDIO_DEVICE_REMOVED;
                     p->devid = logdev->instance_id;
@@ -664,7 +712,7 @@ void SDL_AudioDeviceDisconnected(SDL_AudioDevice *device)
             }
         }
 
-        SDL_PendingAudioDeviceEvent *p = (SDL_PendingAudioDeviceEvent *) SDL_malloc(sizeof (SDL_PendingAudioDeviceEvent));
+        SDL_PendingAudioDeviceEvent *p = (SDL_PendingAudioDeviceEvent *) SDL_calloc(1, sizeof (SDL_PendingAudioDeviceEvent));
         if (p) {  // if this failed, no event for you, but you have deeper problems anyhow.
             p->type = SDL_EVENT_AUDIO_DEVICE_REMOVED;
             p->devid = device->instance_id;
@@ -801,6 +849,767 @@ static void NukeAudioDeviceHashItem(const void *key, const void *value, void *da
     // no-op, keys and values in this hashtable are treated as Plain Old Data and don't get freed here.
 }
 
+// Parallel mixing...
+
+// When SDL_HINT_AUDIO_MIX_THREADS is set, an output device with several bound streams splits the
+//  SDL_GetAudioStreamData work into partitions: the Nth stream of a mix job (counting through its
+//  logical devices in list order) always belongs to partition (N % num_partitions). The device thread
+//  runs partition 0 into the real mix buffer, the pool's workers run the others into their own partial
+//  buffers, and then the device thread adds the partials in partition order. The split and the order of
+//  the sums only depend on the stream lists, so the output doesn't depend on thread timing, and all the
+//  buffers involved are allocated when the device opens.
+
+#define SDL_MAX_AUDIO_MIX_THREADS 64
+
+typedef struct SDL_AudioMixJob
+{
+    SDL_AudioDevice *device;
+    SDL_LogicalAudioDevice *logdev;  // if non-NULL, only mix this logical device. Otherwise, all unpaused logical devices without a postmix callback.
+    float *mix_buffer;  // partition 0 mixes straight into this.
+    int work_buffer_size;
+    int num_partitions;
+    SDL_AtomicInt failed;
+    SDL_AtomicInt short_reads;  // streams that had less data than we asked for, for the device's stats.
+} SDL_AudioMixJob;
+
+typedef struct SDL_AudioMixWorker
+{
+    struct SDL_AudioMixPool *pool;
+    SDL_Thread *thread;
+    SDL_Semaphore *go;
+    int partition;
+} SDL_AudioMixWorker;
+
+typedef struct SDL_AudioMixPool
+{
+    SDL_Mutex *lock;  // held by whatever device thread is currently using the workers.
+    SDL_Semaphore *done;
+    SDL_AtomicInt quit;
+    SDL_AudioMixJob *job;
+    int num_workers;
+    SDL_AudioMixWorker workers[1];  // actually as long as the hint asked for; num_workers of them are running.
+} SDL_AudioMixPool;
+
+static SDL_LogicalAudioDevice *GetNextAudioMixJobLogicalDevice(const SDL_AudioMixJob *job, SDL_LogicalAudioDevice *logdev)
+{
+    if (job->logdev) {
+        return logdev ? NULL : job->logdev;
+    }
+
+    for (logdev = logdev ? logdev->next : job->device->logical_devices; logdev; logdev = logdev->next) {
+        if (!logdev->postmix && !SDL_AtomicGet(&logdev->paused)) {
+            return logdev;
+        }
+    }
+    return NULL;
+}
+
+static int CountAudioMixJobStreams(const SDL_AudioMixJob *job)
+{
+    int retval = 0;
+    for (SDL_LogicalAudioDevice *logdev = GetNextAudioMixJobLogicalDevice(job, NULL); logdev; logdev = GetNextAudioMixJobLogicalDevice(job, logdev)) {
+        for (SDL_AudioStream *stream = logdev->bound_streams; stream; stream = stream->next_binding) {
+            retval++;
+        }
+    }
+    return retval;
+}
+
+/* Mix a bound stream's float32 output into `dst` with the stream's gains, ramped from whatever the last mix used, and return SDL_TRUE.
+   If the stream has no gains to apply, this does nothing and returns SDL_FALSE, so the caller can mix it plainly (or later).
+   This expects the device lock to be held, so only one thread mixes a given stream at a time. */
+static SDL_bool MixAudioStreamWithGains(SDL_AudioStream *stream, float *dst, const float *src, const int buffer_size, const int channels)
+{
+    float start_gains[SDL_MAX_AUDIO_CHANNELS];
+    float end_gains[SDL_MAX_AUDIO_CHANNELS];
+    SDL_bool unity = SDL_TRUE;
+
+    SDL_assert(channels <= SDL_MAX_AUDIO_CHANNELS);
+
+    SDL_LockMutex(stream->lock);
+    for (int c = 0; c < channels; c++) {
+        start_gains[c] = stream->mixed_gains[c];
+        end_gains[c] = stream->gain * stream->channel_gains[c];
+        stream->mixed_gains[c] = end_gains[c];
+        if ((start_gains[c] != 1.0f) || (end_gains[c] != 1.0f)) {
+            unity = SDL_FALSE;
+        }
+    }
+    if (!unity) {
+        UpdateAudioStreamUnityGains(stream);  // a ramp back to 1.0f just finished, maybe.
+    }
+    SDL_UnlockMutex(stream->lock);
+
+    if (unity) {
+        return SDL_FALSE;
+    }
+
+    SDL_MixFloat32Gains(dst, src, buffer_size / (channels * (int) sizeof (float)), channels, start_gains, end_gains);
+    return SDL_TRUE;
+}
+
+// This runs on the device thread or a worker, while the device thread holds device->lock, so the logical device and binding lists can't change under us.
+static void MixAudioPartition(SDL_AudioMixJob *job, const int partition)
+{
+    SDL_AudioDevice *device = job->device;
+    Uint8 *scratch = device->work_buffer;
+    float *mix_buffer = job->mix_buffer;
+    int index = 0;
+
+    if (partition > 0) {
+        const size_t offset = (size_t) (partition - 1) * device->work_buffer_size;
+        scratch = device->mix_partition_scratch + offset;
+        mix_buffer = (float *) (((Uint8 *) device->mix_partition_partials) + offset);
+        SDL_memset(mix_buffer, '\0', job->work_buffer_size);  // start with silence.
+    }
+
+    for (SDL_LogicalAudioDevice *logdev = GetNextAudioMixJobLogicalDevice(job, NULL); logdev; logdev = GetNextAudioMixJobLogicalDevice(job, logdev)) {
+        for (SDL_AudioStream *stream = logdev->bound_streams; stream; stream = stream->next_binding, index++) {
+            if ((index % job->num_partitions) != partition) {
+                continue;  // someone else's stream.
+            }
+
+            const int br = SDL_GetAudioStreamData(stream, scratch, job->work_buffer_size);
+            if (br < 0) {  // Probably OOM. The device thread will kill the audio device.
+                SDL_AtomicSet(&job->failed, 1);
+                return;
+            }
+
+            if (br < job->work_buffer_size) {
+                SDL_AtomicIncRef(&job->short_reads);
+            }
+
+            if ((br > 0) && !MixAudioStreamWithGains(stream, mix_buffer, (const float *) scratch, br, device->spec.channels)) {  // it's okay if we get less than requested, we mix what we have.
+                SDL_MixFloat32(mix_buffer, (const float *) scratch, br / (int) sizeof (float), 1.0f);
+            }
+        }
+    }
+}
+
+static int SDLCALL AudioMixWorkerThread(void *data)  // thread entry point
+{
+    SDL_AudioMixWorker *worker = (SDL_AudioMixWorker *) data;
+    SDL_AudioMixPool *pool = worker->pool;
+
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL);
+
+    while (SDL_WaitSemaphore(worker->go) == 0) {
+        if (SDL_AtomicGet(&pool->quit)) {
+            break;
+        }
+        MixAudioPartition(pool->job, worker->partition);
+        SDL_PostSemaphore(pool->done);
+    }
+
+    return 0;
+}
+
+static void RunAudioMixJob(SDL_AudioMixJob *job)
+{
+    SDL_AudioMixPool *pool = current_audio.mix_pool;
+    const int num_partitions = job->num_partitions;
+    int i;
+
+    if (num_partitions == 1) {
+        MixAudioPartition(job, 0);
+        return;
+    }
+
+    if (SDL_TryLockMutex(pool->lock) == 0) {
+        pool->job = job;
+        for (i = 1; i < num_partitions; i++) {
+            SDL_PostSemaphore(pool->workers[i - 1].go);
+        }
+        MixAudioPartition(job, 0);
+        for (i = 1; i < num_partitions; i++) {
+            SDL_WaitSemaphore(pool->done);
+        }
+        pool->job = NULL;
+        SDL_UnlockMutex(pool->lock);
+    } else {
+        // another device thread has the workers right now. Run the same partitions here instead of waiting, so the output is identical.
+        for (i = 0; i < num_partitions; i++) {
+            MixAudioPartition(job, i);
+        }
+    }
+
+    for (i = 1; i < num_partitions; i++) {
+        const size_t offset = (size_t) (i - 1) * job->device->work_buffer_size;
+        SDL_MixFloat32(job->mix_buffer, (const float *) (((Uint8 *) job->device->mix_partition_partials) + offset), job->work_buffer_size / (int) sizeof (float), 1.0f);
+    }
+}
+
+// Returns SDL_FALSE if this device should mix serially instead. This expects the device lock to be held.
+static SDL_bool MixOutputAudioInParallel(SDL_AudioDevice *device, float *final_mix_buffer, const int work_buffer_size, const SDL_AudioSpec *outspec, SDL_bool *failed, int *short_reads)
+{
+    SDL_AudioMixJob job;
+    int num_direct_streams, num_streams;
+
+    if (device->num_mix_partitions < 2) {
+        return SDL_FALSE;
+    }
+
+    SDL_zero(job);
+    job.device = device;
+    job.mix_buffer = final_mix_buffer;
+    job.work_buffer_size = work_buffer_size;
+    num_direct_streams = CountAudioMixJobStreams(&job);
+    num_streams = num_direct_streams;
+
+    SDL_LogicalAudioDevice *logdev;
+    for (logdev = device->logical_devices; logdev; logdev = logdev->next) {
+        if (logdev->postmix && !SDL_AtomicGet(&logdev->paused)) {
+            for (SDL_AudioStream *stream = logdev->bound_streams; stream; stream = stream->next_binding) {
+                num_streams++;
+            }
+        }
+    }
+
+    if (num_streams < 2) {
+        return SDL_FALSE;  // not worth waking anyone up.
+    }
+
+    // everything without a postmix callback goes straight into the final mix in one job...
+    if (num_direct_streams > 0) {
+        job.num_partitions = SDL_min(num_direct_streams, device->num_mix_partitions);
+        RunAudioMixJob(&job);
+    }
+
+    // ...and each logical device with a postmix callback gets a job of its own, since the callback needs to see just its streams.
+    for (logdev = device->logical_devices; logdev; logdev = logdev->next) {
+        if (!logdev->postmix || SDL_AtomicGet(&logdev->paused)) {
+            continue;
+        }
+
+        job.logdev = logdev;
+        job.mix_buffer = device->postmix_buffer;
+        SDL_memset(job.mix_buffer, '\0', work_buffer_size);  // start with silence.
+        num_streams = CountAudioMixJobStreams(&job);
+        if (num_streams > 0) {
+            job.num_partitions = SDL_min(num_streams, device->num_mix_partitions);
+            RunAudioMixJob(&job);
+        }
+        logdev->postmix(logdev->postmix_userdata, outspec, job.mix_buffer, work_buffer_size);
+        SDL_MixFloat32(final_mix_buffer, job.mix_buffer, work_buffer_size / (int) sizeof (float), 1.0f);
+    }
+
+    if (SDL_AtomicGet(&job.failed)) {
+        *failed = SDL_TRUE;
+    }
+
+    *short_reads += SDL_AtomicGet(&job.short_reads);
+
+    return SDL_TRUE;
+}
+
+static void FreeAudioMixPartitions(SDL_AudioDevice *device)
+{
+    SDL_aligned_free(device->mix_partition_scratch);
+    device->mix_partition_scratch = NULL;
+    SDL_aligned_free(device->mix_partition_partials);
+    device->mix_partition_partials = NULL;
+    device->num_mix_partitions = 0;
+}
+
+// (Re)allocates the per-partition buffers for the current work_buffer_size, if this device will use the mixing pool.
+static SDL_bool AllocateAudioMixPartitions(SDL_AudioDevice *device)
+{
+    FreeAudioMixPartitions(device);
+
+    if (!current_audio.mix_pool || device->iscapture) {
+        return SDL_TRUE;  // nothing to do.
+    }
+
+    const size_t buflen = (size_t) current_audio.mix_pool->num_workers * device->work_buffer_size;
+    device->mix_partition_scratch = (Uint8 *)SDL_aligned_alloc(SDL_SIMDGetAlignment(), buflen);
+    device->mix_partition_partials = (float *)SDL_aligned_alloc(SDL_SIMDGetAlignment(), buflen);
+    if (!device->mix_partition_scratch || !device->mix_partition_partials) {
+        FreeAudioMixPartitions(device);
+        return SDL_FALSE;
+    }
+
+    device->num_mix_partitions = current_audio.mix_pool->num_workers + 1;
+    return SDL_TRUE;
+}
+
+static void DestroyAudioMixPool(SDL_AudioMixPool *pool)
+{
+    if (!pool) {
+        return;
+    }
+
+    SDL_AtomicSet(&pool->quit, 1);
+    for (int i = 0; i < pool->num_workers; i++) {
+        SDL_PostSemaphore(pool->workers[i].go);
+        SDL_WaitThread(pool->workers[i].thread, NULL);
+        SDL_DestroySemaphore(pool->workers[i].go);
+    }
+
+    SDL_DestroySemaphore(pool->done);
+    SDL_DestroyMutex(pool->lock);
+    SDL_free(pool);
+}
+
+// Failing to build the pool isn't fatal; devices just mix on their own thread like usual.
+static void CreateAudioMixPool(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_AUDIO_MIX_THREADS);
+    const int num_workers = SDL_min(hint ? SDL_atoi(hint) : 0, SDL_MAX_AUDIO_MIX_THREADS);
+    if (num_workers <= 0) {
+        return;
+    }
+
+    SDL_AudioMixPool *pool = (SDL_AudioMixPool *) SDL_calloc(1, sizeof (*pool) + ((num_workers - 1) * sizeof (SDL_AudioMixWorker)));
+    if (!pool) {
+        return;
+    }
+
+    pool->lock = SDL_CreateMutex();
+    pool->done = SDL_CreateSemaphore(0);
+    if (!pool->lock || !pool->done) {
+        DestroyAudioMixPool(pool);
+        return;
+    }
+
+    for (int i = 0; i < num_workers; i++) {
+        SDL_AudioMixWorker *worker = &pool->workers[i];
+        char threadname[64];
+        worker->pool = pool;
+        worker->partition = i + 1;
+        worker->go = SDL_CreateSemaphore(0);
+        if (!worker->go) {
+            break;
+        }
+        (void)SDL_snprintf(threadname, sizeof (threadname), "SDLAudioMix%d", i);
+        worker->thread = SDL_CreateThreadInternal(AudioMixWorkerThread, threadname, 0, worker);
+        if (!worker->thread) {
+            SDL_DestroySemaphore(worker->go);
+            worker->go = NULL;
+            break;
+        }
+        pool->num_workers++;
+    }
+
+    if (pool->num_workers == 0) {
+        DestroyAudioMixPool(pool);
+        return;
+    }
+
+    current_audio.mix_pool = pool;
+}
+
+// Shared device threads (SDL_HINT_AUDIO_SHARED_DEVICE_THREADS). Instead of each device sleeping in WaitDevice on a thread of its
+//  own, a shared thread polls all of its devices with PollDevice and runs the usual iterate function on whichever ones are ready.
+
+#define SDL_MAX_SHARED_AUDIO_THREADS 16
+#define SHARED_AUDIO_THREAD_MAX_WAIT_NS (10 * SDL_NS_PER_MS)
+
+typedef struct SDL_SharedAudioThread
+{
+    SDL_Mutex *lock;  // protects everything below.
+    SDL_Condition *wake;  // signaled when a device is added or the thread should quit.
+    SDL_Condition *idle;  // broadcast each time the thread is done with `current_device`.
+    SDL_Thread *thread;
+    SDL_bool quit;
+    SDL_AudioDevice **devices;  // removed devices leave a NULL behind while the thread is in the middle of a pass, so it doesn't lose its place.
+    int num_devices;  // slots in use in `devices`, including any NULLs.
+    int num_removed;  // NULLs in `devices`, waiting for the end of the pass to be compacted away.
+    int allocated_devices;
+    SDL_bool iterating;  // SDL_TRUE while the thread is going through `devices`.
+    SDL_AudioDevice *current_device;  // the device being polled or iterated right now (with `lock` released), or NULL.
+} SDL_SharedAudioThread;
+
+// Squeeze out the NULLs left by devices removed during a pass. Call with `lock` held.
+static void CompactSharedAudioThreadDevices(SDL_SharedAudioThread *shared)
+{
+    int num_devices = 0;
+    for (int i = 0; i < shared->num_devices; i++) {
+        if (shared->devices[i]) {
+            shared->devices[num_devices++] = shared->devices[i];
+        }
+    }
+    shared->num_devices = num_devices;
+    shared->num_removed = 0;
+}
+
+int SDL_PollAudioDeviceTimer(SDL_AudioDevice *device, Uint64 interval_ns, Uint64 *wait_ns)
+{
+    const Uint64 now = SDL_GetTicksNS();
+    if (now < device->next_poll_ns) {
+        *wait_ns = device->next_poll_ns - now;
+        return 0;
+    }
+    device->next_poll_ns = now + interval_ns;
+    return 1;
+}
+
+static int SDLCALL SharedAudioThread(void *data)  // thread entry point
+{
+    SDL_SharedAudioThread *shared = (SDL_SharedAudioThread *) data;
+
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL);
+
+    SDL_LockMutex(shared->lock);
+    while (!shared->quit) {
+        Uint64 wait_ns = SHARED_AUDIO_THREAD_MAX_WAIT_NS;
+        SDL_bool serviced = SDL_FALSE;
+
+        // `lock` isn't held while working on a device, since closing a device waits for us here and might be holding other device locks while it does.
+        // Devices removed meanwhile are only NULLed out until the pass is done, so the rest of them stay where we expect them.
+        shared->iterating = SDL_TRUE;
+        for (int i = 0; i < shared->num_devices; i++) {
+            SDL_AudioDevice *device = shared->devices[i];
+            if (!device) {
+                continue;
+            }
+            Uint64 device_wait_ns = wait_ns;
+            shared->current_device = device;
+            SDL_UnlockMutex(shared->lock);
+
+            const int rc = SDL_AtomicGet(&device->shutdown) ? 0 : device->PollDevice(device, &device_wait_ns);
+            if (rc < 0) {
+                SDL_AudioDeviceDisconnected(device);  // doh. It'll poll as a zombie from now on.
+                serviced = SDL_TRUE;
+            } else if (rc > 0) {
+                device->wait_finished_ns = SDL_GetTicksNS();
+                if (device->iscapture) {
+                    SDL_CaptureAudioThreadIterate(device);
+                } else {
+                    SDL_OutputAudioThreadIterate(device);
+                }
+                serviced = SDL_TRUE;
+            } else {
+                wait_ns = SDL_min(wait_ns, device_wait_ns);
+            }
+
+            SDL_LockMutex(shared->lock);
+            shared->current_device = NULL;
+            SDL_BroadcastCondition(shared->idle);
+        }
+        shared->iterating = SDL_FALSE;
+        if (shared->num_removed) {
+            CompactSharedAudioThreadDevices(shared);
+        }
+
+        // if something was ready, go around again right away; another device might have become ready while we worked.
+        if (!serviced && !shared->quit) {
+            SDL_WaitConditionTimeoutNS(shared->wake, shared->lock, (Sint64) wait_ns);
+        }
+    }
+    SDL_UnlockMutex(shared->lock);
+
+    return 0;
+}
+
+// Returns SDL_FALSE if there are no shared threads (or we ran out of memory); the device should get a thread of its own then.
+static SDL_bool AddToSharedAudioThread(SDL_AudioDevice *device)
+{
+    SDL_SharedAudioThread *shared = NULL;
+    int least_devices = 0;
+    for (int i = 0; i < current_audio.num_shared_threads; i++) {
+        SDL_SharedAudioThread *candidate = current_audio.shared_threads[i];
+        SDL_LockMutex(candidate->lock);
+        const int num_devices = candidate->num_devices - candidate->num_removed;
+        SDL_UnlockMutex(candidate->lock);
+        if (!shared || (num_devices < least_devices)) {
+            shared = candidate;
+            least_devices = num_devices;
+        }
+    }
+
+    if (!shared) {
+        return SDL_FALSE;
+    }
+
+    SDL_LockMutex(shared->lock);
+    if (shared->num_devices >= shared->allocated_devices) {
+        const int allocated = shared->allocated_devices ? (shared->allocated_devices * 2) : 4;
+        SDL_AudioDevice **ptr = (SDL_AudioDevice **) SDL_realloc(shared->devices, allocated * sizeof (SDL_AudioDevice *));
+        if (!ptr) {
+            SDL_UnlockMutex(shared->lock);
+            return SDL_FALSE;
+        }
+        shared->devices = ptr;
+        shared->allocated_devices = allocated;
+    }
+    shared->devices[shared->num_devices++] = device;
+    device->shared_thread = shared;
+    SDL_SignalCondition(shared->wake);
+    SDL_UnlockMutex(shared->lock);
+
+    return SDL_TRUE;
+}
+
+// When this returns, the shared thread is done with `device` and won't touch it again.
+static void RemoveFromSharedAudioThread(SDL_AudioDevice *device)
+{
+    SDL_SharedAudioThread *shared = device->shared_thread;
+    SDL_LockMutex(shared->lock);
+    for (int i = 0; i < shared->num_devices; i++) {
+        if (shared->devices[i] == device) {
+            if (shared->iterating) {
+                shared->devices[i] = NULL;  // the thread compacts this when it finishes the pass.
+                shared->num_removed++;
+            } else {
+                SDL_memmove(&shared->devices[i], &shared->devices[i + 1], (shared->num_devices - i - 1) * sizeof (SDL_AudioDevice *));
+                shared->num_devices--;
+            }
+            break;
+        }
+    }
+    while (shared->current_device == device) {
+        SDL_WaitCondition(shared->idle, shared->lock);
+    }
+    SDL_UnlockMutex(shared->lock);
+    device->shared_thread = NULL;
+}
+
+static void DestroySharedAudioThreads(void)
+{
+    for (int i = 0; i < current_audio.num_shared_threads; i++) {
+        SDL_SharedAudioThread *shared = current_audio.shared_threads[i];
+        SDL_LockMutex(shared->lock);
+        shared->quit = SDL_TRUE;
+        SDL_SignalCondition(shared->wake);
+        SDL_UnlockMutex(shared->lock);
+        SDL_WaitThread(shared->thread, NULL);
+        SDL_assert(shared->num_devices == 0);  // devices should have all been closed by now.
+        SDL_DestroyCondition(shared->idle);
+        SDL_DestroyCondition(shared->wake);
+        SDL_DestroyMutex(shared->lock);
+        SDL_free(shared->devices);
+        SDL_free(shared);
+    }
+
+    SDL_free(current_audio.shared_threads);
+    current_audio.shared_threads = NULL;
+    current_audio.num_shared_threads = 0;
+}
+
+// Failing to start these isn't fatal; devices just get a thread of their own like usual.
+static void CreateSharedAudioThreads(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_AUDIO_SHARED_DEVICE_THREADS);
+    const int num_threads = SDL_min(hint ? SDL_atoi(hint) : 0, SDL_MAX_SHARED_AUDIO_THREADS);
+    if ((num_threads <= 0) || !current_audio.impl.PollDevice || current_audio.impl.ProvidesOwnCallbackThread) {
+        return;
+    }
+
+    current_audio.shared_threads = (SDL_SharedAudioThread **) SDL_calloc(num_threads, sizeof (SDL_SharedAudioThread *));
+    if (!current_audio.shared_threads) {
+        return;
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        SDL_SharedAudioThread *shared = (SDL_SharedAudioThread *) SDL_calloc(1, sizeof (*shared));
+        if (!shared) {
+            break;
+        }
+
+        char threadname[64];
+        (void)SDL_snprintf(threadname, sizeof (threadname), "SDLAudioShared%d", i);
+        shared->lock = SDL_CreateMutex();
+        shared->wake = SDL_CreateCondition();
+        shared->idle = SDL_CreateCondition();
+        if (shared->lock && shared->wake && shared->idle) {
+            shared->thread = SDL_CreateThreadInternal(SharedAudioThread, threadname, 0, shared);
+        }
+
+        if (!shared->thread) {
+            SDL_DestroyCondition(shared->idle);
+            SDL_DestroyCondition(shared->wake);
+            SDL_DestroyMutex(shared->lock);
+            SDL_free(shared);
+            break;
+        }
+
+        current_audio.shared_threads[current_audio.num_shared_threads++] = shared;
+    }
+
+    if (current_audio.num_shared_threads == 0) {
+        DestroySharedAudioThreads();
+    }
+}
+
+// Async get callbacks ("SDL.audiostream.get_callback.async"). One worker thread, started the first time a stream asks for it,
+//  runs get callbacks for streams that are running low, so decoding doesn't happen while a device thread waits on the stream.
+
+typedef struct SDL_AudioPrefetcher
+{
+    SDL_Mutex *lock;  // protects everything below, and each stream's prefetch_queued and next_prefetch.
+    SDL_Condition *wake;  // signaled when a stream is queued or the thread should quit.
+    SDL_Condition *idle;  // broadcast each time the thread is done with `current_stream`.
+    SDL_Thread *thread;  // NULL until something needs it.
+    SDL_bool quit;
+    SDL_AudioStream *queue_head;
+    SDL_AudioStream *queue_tail;
+    SDL_AudioStream *current_stream;  // the stream whose callback is running right now (without any locks held), or NULL.
+} SDL_AudioPrefetcher;
+
+static int SDLCALL AudioPrefetchThread(void *data)  // thread entry point
+{
+    SDL_AudioPrefetcher *prefetcher = (SDL_AudioPrefetcher *) data;
+
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    SDL_LockMutex(prefetcher->lock);
+    while (!prefetcher->quit) {
+        SDL_AudioStream *stream = prefetcher->queue_head;
+        if (!stream) {
+            SDL_WaitCondition(prefetcher->wake, prefetcher->lock);
+            continue;
+        }
+
+        prefetcher->queue_head = stream->next_prefetch;
+        if (!prefetcher->queue_head) {
+            prefetcher->queue_tail = NULL;
+        }
+        stream->next_prefetch = NULL;
+        stream->prefetch_queued = SDL_FALSE;
+        prefetcher->current_stream = stream;
+        SDL_UnlockMutex(prefetcher->lock);
+
+        SDL_LockMutex(stream->lock);
+        const SDL_AudioStreamCallback callback = stream->get_callback;
+        void *userdata = stream->get_callback_userdata;
+        const int additional_amount = stream->prefetch_additional;
+        const int total_amount = stream->prefetch_total;
+        stream->prefetch_additional = stream->prefetch_total = 0;
+        SDL_UnlockMutex(stream->lock);
+
+        // the stream isn't locked while this runs, so a device thread reading from it doesn't have to wait for it.
+        if (callback && (additional_amount > 0)) {
+            callback(userdata, stream, additional_amount, total_amount);
+        }
+
+        SDL_LockMutex(prefetcher->lock);
+        prefetcher->current_stream = NULL;
+        SDL_BroadcastCondition(prefetcher->idle);
+    }
+    SDL_UnlockMutex(prefetcher->lock);
+
+    return 0;
+}
+
+SDL_bool SDL_RequestAudioStreamPrefetch(SDL_AudioStream *stream, int additional_amount, int total_amount)
+{
+    SDL_AudioPrefetcher *prefetcher = current_audio.prefetcher;
+    if (!prefetcher) {
+        return SDL_FALSE;
+    }
+
+    SDL_LockMutex(prefetcher->lock);
+
+    if (!prefetcher->thread && !prefetcher->quit) {
+        prefetcher->thread = SDL_CreateThreadInternal(AudioPrefetchThread, "SDLAudioPrefetch", 0, prefetcher);
+    }
+
+    if (!prefetcher->thread) {
+        SDL_UnlockMutex(prefetcher->lock);
+        return SDL_FALSE;
+    }
+
+    // If its callback is already running, it's busy refilling; the next read will ask again if that wasn't enough.
+    if (prefetcher->current_stream != stream) {
+        stream->prefetch_additional = SDL_max(stream->prefetch_additional, additional_amount);
+        stream->prefetch_total = SDL_max(stream->prefetch_total, total_amount);
+        if (!stream->prefetch_queued) {
+            stream->prefetch_queued = SDL_TRUE;
+            if (prefetcher->queue_tail) {
+                prefetcher->queue_tail->next_prefetch = stream;
+            } else {
+                prefetcher->queue_head = stream;
+            }
+            prefetcher->queue_tail = stream;
+            SDL_SignalCondition(prefetcher->wake);
+        }
+    }
+
+    SDL_UnlockMutex(prefetcher->lock);
+
+    return SDL_TRUE;
+}
+
+// When this returns, the prefetch worker is done with `stream` and won't touch it again.
+static void CancelAudioStreamPrefetch(SDL_AudioStream *stream)
+{
+    SDL_AudioPrefetcher *prefetcher = current_audio.prefetcher;
+    if (!prefetcher) {
+        return;
+    }
+
+    SDL_LockMutex(prefetcher->lock);
+    if (stream->prefetch_queued) {
+        SDL_AudioStream *prev = NULL;
+        for (SDL_AudioStream *i = prefetcher->queue_head; i; prev = i, i = i->next_prefetch) {
+            if (i == stream) {
+                if (prev) {
+                    prev->next_prefetch = i->next_prefetch;
+                } else {
+                    prefetcher->queue_head = i->next_prefetch;
+                }
+                if (prefetcher->queue_tail == i) {
+                    prefetcher->queue_tail = prev;
+                }
+                break;
+            }
+        }
+        stream->next_prefetch = NULL;
+        stream->prefetch_queued = SDL_FALSE;
+    }
+
+    // (if the callback is destroying its own stream, there's nothing to wait for.)
+    while ((prefetcher->current_stream == stream) && (SDL_ThreadID() != SDL_GetThreadID(prefetcher->thread))) {
+        SDL_WaitCondition(prefetcher->idle, prefetcher->lock);
+    }
+    SDL_UnlockMutex(prefetcher->lock);
+}
+
+static void DestroyAudioPrefetcher(void)
+{
+    SDL_AudioPrefetcher *prefetcher = current_audio.prefetcher;
+    if (!prefetcher) {
+        return;
+    }
+
+    SDL_LockMutex(prefetcher->lock);
+    prefetcher->quit = SDL_TRUE;
+    SDL_SignalCondition(prefetcher->wake);
+    SDL_UnlockMutex(prefetcher->lock);
+    SDL_WaitThread(prefetcher->thread, NULL);
+
+    // streams that were made before the audio subsystem was initialized outlive it; make sure they don't think they're still queued.
+    for (SDL_AudioStream *i = prefetcher->queue_head; i; ) {
+        SDL_AudioStream *next = i->next_prefetch;
+        i->next_prefetch = NULL;
+        i->prefetch_queued = SDL_FALSE;
+        i = next;
+    }
+
+    SDL_DestroyCondition(prefetcher->idle);
+    SDL_DestroyCondition(prefetcher->wake);
+    SDL_DestroyMutex(prefetcher->lock);
+    SDL_free(prefetcher);
+    current_audio.prefetcher = NULL;
+}
+
+// Failing to set this up isn't fatal; async get callbacks just run inline like any other.
+static void CreateAudioPrefetcher(void)
+{
+    SDL_AudioPrefetcher *prefetcher = (SDL_AudioPrefetcher *) SDL_calloc(1, sizeof (*prefetcher));
+    if (!prefetcher) {
+        return;
+    }
+
+    prefetcher->lock = SDL_CreateMutex();
+    prefetcher->wake = SDL_CreateCondition();
+    prefetcher->idle = SDL_CreateCondition();
+    current_audio.prefetcher = prefetcher;
+    if (!prefetcher->lock || !prefetcher->wake || !prefetcher->idle) {
+        DestroyAudioPrefetcher();
+    }
+}
+
 // !!! FIXME: the video subsystem does SDL_VideoInit, not SDL_InitVideo. Make this match.
 int SDL_InitAudio(const char *driver_name)
 {
@@ -812,6 +1621,8 @@ int SDL_InitAudio(const char *driver_name)
     SDL_AtomicCAS(&last_device_instance_id, 0, 2);
 
     SDL_ChooseAudioConverters();
+    SDL_ChooseAudioChannelConverters();
+    SDL_ChooseAudioMixers();
     SDL_SetupAudioResampler();
 
     SDL_RWLock *device_hash_lock = SDL_CreateRWLock();  // create this early, so if it fails we don't have to tear down the whole audio subsystem.
@@ -861,6 +1672,7 @@ int SDL_InitAudio(const char *driver_name)
                     tried_to_init = SDL_TRUE;
                     SDL_zero(current_audio);
                     current_audio.pending_events_tail = &current_audio.pending_events;
+                    current_audio.pending_stream_events_tail = &current_audio.pending_stream_events;
                     current_audio.device_hash_lock = device_hash_lock;
                     current_audio.device_hash = device_hash;
                     if (bootstrap[i]->init(&current_audio.impl)) {
@@ -885,6 +1697,7 @@ int SDL_InitAudio(const char *driver_name)
             tried_to_init = SDL_TRUE;
             SDL_zero(current_audio);
             current_audio.pending_events_tail = &current_audio.pending_events;
+            current_audio.pending_stream_events_tail = &current_audio.pending_stream_events;
             current_audio.device_hash_lock = device_hash_lock;
             current_audio.device_hash = device_hash;
             if (bootstrap[i]->init(&current_audio.impl)) {
@@ -912,6 +1725,9 @@ int SDL_InitAudio(const char *driver_name)
     }
 
     CompleteAudioEntryPoints();
+    CreateAudioMixPool();
+    CreateSharedAudioThreads();
+    CreateAudioPrefetcher();
 
     // Make sure we have a list of devices available at startup...
     SDL_AudioDevice *default_output = NULL;
@@ -969,6 +1785,17 @@ void SDL_QuitAudio(void)
         SDL_free(i);
     }
 
+    // streams created before the audio subsystem was initialized survive this, so unhook their watermark events.
+    SDL_AtomicLock(&current_audio.pending_stream_events_lock);
+    for (SDL_PendingAudioDeviceEvent *i = current_audio.pending_stream_events.next; i; i = pending_next) {
+        pending_next = i->next;
+        i->next = NULL;
+        i->stream->watermark_event_queued[i - i->stream->watermark_events] = SDL_FALSE;
+    }
+    current_audio.pending_stream_events.next = NULL;
+    current_audio.pending_stream_events_tail = &current_audio.pending_stream_events;
+    SDL_AtomicUnlock(&current_audio.pending_stream_events_lock);
+
     const void *key;
     const void *value;
     void *iter = NULL;
@@ -981,6 +1808,13 @@ void SDL_QuitAudio(void)
         }
     }
 
+    DestroySharedAudioThreads();
+    DestroyAudioMixPool(current_audio.mix_pool);
+    DestroyAudioPrefetcher();
+
+    // all the streams are gone, so give the recycled queue memory back.
+    SDL_TrimAudioChunkPool();
+
     // Free the driver data
     current_audio.impl.Deinitialize();
 
@@ -997,9 +1831,152 @@ void SDL_AudioThreadFinalize(SDL_AudioDevice *device)
 
 static void MixFloat32Audio(float *dst, const float *src, const int buffer_size)
 {
-    if (SDL_MixAudioFormat((Uint8 *) dst, (const Uint8 *) src, SDL_AUDIO_F32, buffer_size, SDL_MIX_MAXVOLUME) < 0) {
-        SDL_assert(!"This shouldn't happen.");
+    SDL_MixFloat32(dst, src, buffer_size / (int)sizeof(float), 1.0f);
+}
+
+
+// Device timing counters. Only the device thread calls these, so there's no locking beyond the sequence counter readers check.
+
+static void BeginAudioDeviceStatsUpdate(SDL_AudioDevice *device)
+{
+    SDL_AtomicIncRef(&device->stats_sequence);  // odd: an update is in progress. (this is a full barrier, so it stays ahead of the writes.)
+}
+
+static void EndAudioDeviceStatsUpdate(SDL_AudioDevice *device)
+{
+    SDL_AtomicIncRef(&device->stats_sequence);  // even again: readers can trust what they copied.
+}
+
+static void ResetAudioDeviceStats(SDL_AudioDevice *device)
+{
+    BeginAudioDeviceStatsUpdate(device);
+    SDL_zero(device->stats);
+    EndAudioDeviceStatsUpdate(device);
+    SDL_AtomicSet(&device->xruns, 0);
+    device->wait_finished_ns = 0;
+    device->last_period_ns = 0;
+}
+
+static void AddToAudioDeviceHistogram(Uint64 *histogram, Uint64 *max_ns, const Uint64 ns)
+{
+    const Uint64 us = ns / 1000;
+    int bucket = 0;
+    if (us >= 2) {
+        bucket = (us > 0xFFFFFFFF) ? 31 : SDL_MostSignificantBitIndex32((Uint32) us);
+    }
+    histogram[SDL_min(bucket, SDL_AUDIO_DEVICE_STATS_BUCKETS - 1)]++;
+    *max_ns = SDL_max(*max_ns, ns);
+}
+
+// Call this once per period, with device->lock held, just before handing the data over. Returns the processing time.
+static Uint64 RecordAudioDevicePeriod(SDL_AudioDevice *device, const Uint64 period_start_ns, const Uint64 process_start_ns, const int short_reads)
+{
+    SDL_AudioDeviceStats *stats = &device->stats;
+    const Uint64 now = SDL_GetTicksNS();
+
+    BeginAudioDeviceStatsUpdate(device);
+    stats->periods++;
+    stats->period_ns = (((Uint64) device->sample_frames) * SDL_NS_PER_SECOND) / device->spec.freq;
+    stats->short_reads += short_reads;
+    AddToAudioDeviceHistogram(stats->wait_to_play_histogram, &stats->max_wait_to_play_ns, now - period_start_ns);
+    AddToAudioDeviceHistogram(stats->process_histogram, &stats->max_process_ns, now - process_start_ns);
+    if (device->last_period_ns) {
+        AddToAudioDeviceHistogram(stats->interval_histogram, &stats->max_interval_ns, period_start_ns - device->last_period_ns);
+    }
+    EndAudioDeviceStatsUpdate(device);
+
+    device->last_period_ns = period_start_ns;
+
+    return now - process_start_ns;
+}
+
+// Adaptive buffer sizing: start small, double the buffer when the device gets into trouble, and try halving it again after things have been calm for a while.
+#define ADAPTIVE_SETTLE_PERIODS 4
+#define ADAPTIVE_INITIAL_HOLD_NS (10 * SDL_NS_PER_SECOND)
+#define ADAPTIVE_MAX_HOLD_NS (5 * 60 * SDL_NS_PER_SECOND)
+
+// Call this after the backend has opened the device, since it might have adjusted sample_frames.
+static void StartAdaptiveAudioDeviceSizing(SDL_AudioDevice *device, const int max_frames)
+{
+    device->adaptive_min_frames = device->sample_frames;
+    device->adaptive_max_frames = SDL_max(max_frames, device->sample_frames);
+    device->adaptive_settle_periods = ADAPTIVE_SETTLE_PERIODS;
+    device->adaptive_last_xruns = 0;
+    device->adaptive_tried_smaller = SDL_FALSE;
+    device->adaptive_hold_ns = ADAPTIVE_INITIAL_HOLD_NS;
+    device->adaptive_calm_since_ns = SDL_GetTicksNS();
+    device->adaptive_max_process_ns = 0;
+}
+
+// This goes through the same path as a backend reporting a format change, so buffers get resized and the app gets SDL_EVENT_AUDIO_DEVICE_FORMAT_CHANGED.
+static int ResizeAdaptiveAudioDevice(SDL_AudioDevice *device, int sample_frames)
+{
+    if (current_audio.impl.ResizeDevice(device, &sample_frames) < 0) {
+        device->adaptive_max_frames = 0;  // the backend couldn't do it. Stay at the current size and stop trying.
+        return 0;
+    }
+
+    const SDL_AudioSpec spec = device->spec;
+    device->adaptive_settle_periods = ADAPTIVE_SETTLE_PERIODS;
+    return SDL_AudioDeviceFormatChangedAlreadyLocked(device, &spec, sample_frames);
+}
+
+// Call this once per period with device->lock held, after PlayDevice. Returns -1 if the device should die.
+static int AdaptAudioDeviceSize(SDL_AudioDevice *device, const Uint64 interval_ns, const Uint64 process_ns)
+{
+    const Uint64 now = SDL_GetTicksNS();
+    const Uint64 period_ns = (((Uint64) device->sample_frames) * SDL_NS_PER_SECOND) / device->spec.freq;
+    const int xruns = SDL_AtomicGet(&device->xruns);
+    const SDL_bool xrun = (xruns != device->adaptive_last_xruns);
+    int sample_frames = device->sample_frames;
+
+    device->adaptive_last_xruns = xruns;
+
+    if (device->adaptive_settle_periods > 0) {
+        device->adaptive_settle_periods--;
+        device->adaptive_calm_since_ns = now;
+        device->adaptive_max_process_ns = 0;
+        return 0;
     }
+
+    // Trouble is the platform telling us it ran dry, waking up so late that it probably did, or mixing eating most of the period.
+    const SDL_bool late = (interval_ns > ((period_ns * 3) / 2));
+    const SDL_bool busy = (process_ns > ((period_ns * 3) / 4));
+    if (xrun || late || busy) {
+        if (device->adaptive_tried_smaller) {  // we just came down to this size and it didn't work out; wait longer before trying again.
+            device->adaptive_hold_ns = SDL_min(device->adaptive_hold_ns * 2, ADAPTIVE_MAX_HOLD_NS);
+            device->adaptive_tried_smaller = SDL_FALSE;
+        }
+        sample_frames = SDL_min(sample_frames * 2, device->adaptive_max_frames);
+        device->adaptive_calm_since_ns = now;
+        device->adaptive_max_process_ns = 0;
+    } else {
+        device->adaptive_max_process_ns = SDL_max(device->adaptive_max_process_ns, process_ns);
+        if ((now - device->adaptive_calm_since_ns) >= device->adaptive_hold_ns) {
+            device->adaptive_tried_smaller = SDL_FALSE;  // whatever size we're at has proven itself.
+            if ((device->adaptive_max_process_ns < (period_ns / 4)) && (sample_frames > device->adaptive_min_frames)) {
+                sample_frames = SDL_max(sample_frames / 2, device->adaptive_min_frames);
+                device->adaptive_tried_smaller = SDL_TRUE;
+            }
+            device->adaptive_calm_since_ns = now;
+            device->adaptive_max_process_ns = 0;
+        }
+    }
+
+    return (sample_frames != device->sample_frames) ? ResizeAdaptiveAudioDevice(device, sample_frames) : 0;
+}
+
+// Returns when the current period started: when WaitDevice returned, or now, if the backend calls the iterate functions itself.
+static Uint64 GetAudioDevicePeriodStart(SDL_AudioDevice *device)
+{
+    const Uint64 retval = device->wait_finished_ns ? device->wait_finished_ns : SDL_GetTicksNS();
+    device->wait_finished_ns = 0;
+    return retval;
+}
+
+void SDL_AudioDeviceReportXrun(SDL_AudioDevice *device)
+{
+    SDL_AtomicIncRef(&device->xruns);
 }
 
 
@@ -1011,6 +1988,27 @@ void SDL_OutputAudioThreadSetup(SDL_AudioDevice *device)
     current_audio.impl.ThreadInit(device);
 }
 
+/* Mix the last of the float32 data into the final mix, and convert the final mix to the device's format, straight into the device buffer.
+   This goes a block at a time, so each block is still in the CPU cache when it gets converted, instead of making two passes over
+   the whole buffer. The converters don't need the device buffer to be aligned. */
+static void MixAndConvertOutputAudio(SDL_AudioDevice *device, float *final_mix_buffer, const float *src, const int src_bytes, Uint8 *device_buffer, const int buffer_size)
+{
+    const int block_frames = 256;
+    const int channels = device->spec.channels;
+    const int device_frame_size = SDL_AUDIO_FRAMESIZE(device->spec);
+    const int num_frames = buffer_size / device_frame_size;
+    const int src_frames = src_bytes / (channels * (int) sizeof (float));
+
+    for (int i = 0; i < num_frames; i += block_frames) {
+        const int frames = SDL_min(block_frames, num_frames - i);
+        float *mix = final_mix_buffer + (i * channels);
+        if (i < src_frames) {
+            SDL_MixFloat32(mix, src + (i * channels), SDL_min(frames, src_frames - i) * channels, 1.0f);
+        }
+        RunAudioConvertPlan(&device->output_plan, frames, mix, device_buffer + (i * device_frame_size), NULL);
+    }
+}
+
 SDL_bool SDL_OutputAudioThreadIterate(SDL_AudioDevice *device)
 {
     SDL_assert(!device->iscapture);
@@ -1023,6 +2021,7 @@ SDL_bool SDL_OutputAudioThreadIterate(SDL_AudioDevice *device)
     }
 
     SDL_bool failed = SDL_FALSE;
+    const Uint64 period_start_ns = GetAudioDevicePeriodStart(device);
     int buffer_size = device->buffer_size;
     Uint8 *device_buffer = device->GetDeviceBuf(device, &buffer_size);
     if (buffer_size == 0) {
@@ -1030,8 +2029,15 @@ SDL_bool SDL_OutputAudioThreadIterate(SDL_AudioDevice *device)
     } else if (!device_buffer) {
         failed = SDL_TRUE;
     } else {
+        const Uint64 process_start_ns = SDL_GetTicksNS();
+        int short_reads = 0;
+
         SDL_assert(buffer_size <= device->buffer_size);  // you can ask for less, but not more.
-        SDL_assert(AudioDeviceCanUseSimpleCopy(device) == device->simple_copy);  // make sure this hasn't gotten out of sync.
+
+        // stream gains can change without the device lock, so the answer here might have changed since the bindings last did.
+        if (AudioDeviceCanUseSimpleCopy(device) != device->simple_copy) {
+            UpdateAudioStreamFormatsPhysical(device);
+        }
 
         // can we do a basic copy without silencing/mixing the buffer? This is an extremely likely scenario, so we special-case it.
         if (device->simple_copy) {
@@ -1041,12 +2047,16 @@ SDL_bool SDL_OutputAudioThreadIterate(SDL_AudioDevice *device)
             // We should have updated this elsewhere if the format changed!
             SDL_assert(AUDIO_SPECS_EQUAL(stream->dst_spec, device->spec));
 
-            const int br = SDL_AtomicGet(&logdev->paused) ? 0 : SDL_GetAudioStreamData(stream, device_buffer, buffer_size);
+            const SDL_bool paused = SDL_AtomicGet(&logdev->paused) ? SDL_TRUE : SDL_FALSE;
+            const int br = paused ? 0 : SDL_GetAudioStreamData(stream, device_buffer, buffer_size);
             if (br < 0) {  // Probably OOM. Kill the audio device; the whole thing is likely dying soon anyhow.
                 failed = SDL_TRUE;
                 SDL_memset(device_buffer, device->silence_value, buffer_size);  // just supply silence to the device before we die.
             } else if (br < buffer_size) {
                 SDL_memset(device_buffer + br, device->silence_value, buffer_size - br);  // silence whatever we didn't write to.
+                if (!paused) {
+                    short_reads++;
+                }
             }
         } else {  // need to actually mix (or silence the buffer)
             float *final_mix_buffer = (float *) ((device->spec.format == SDL_AUDIO_F32) ? device_buffer : device->mix_buffer);
@@ -1062,53 +2072,88 @@ SDL_bool SDL_OutputAudioThreadIterate(SDL_AudioDevice *device)
 
             SDL_memset(final_mix_buffer, '\0', work_buffer_size);  // start with silence.
 
-            for (SDL_LogicalAudioDevice *logdev = device->logical_devices; logdev; logdev = logdev->next) {
-                if (SDL_AtomicGet(&logdev->paused)) {
-                    continue;  // paused? Skip this logical device.
-                }
+            // The last stream to go straight into the final mix is left in the work buffer, so it can be mixed
+            //  as part of the conversion to the device format. Anything else that needs the work buffer mixes it first.
+            int pending_mix_bytes = 0;
 
-                const SDL_AudioPostmixCallback postmix = logdev->postmix;
-                float *mix_buffer = final_mix_buffer;
-                if (postmix) {
-                    mix_buffer = device->postmix_buffer;
-                    SDL_memset(mix_buffer, '\0', work_buffer_size);  // start with silence.
-                }
+            if (MixOutputAudioInParallel(device, final_mix_buffer, work_buffer_size, &outspec, &failed, &short_reads)) {
+                // the mixing pool took care of it.
+            } else {
+                for (SDL_LogicalAudioDevice *logdev = device->logical_devices; logdev; logdev = logdev->next) {
+                    if (SDL_AtomicGet(&logdev->paused)) {
+                        continue;  // paused? Skip this logical device.
+                    }
 
-                for (SDL_AudioStream *stream = logdev->bound_streams; stream; stream = stream->next_binding) {
-                    // We should have updated this elsewhere if the format changed!
-                    SDL_assert(AUDIO_SPECS_EQUAL(stream->dst_spec, outspec));
+                    const SDL_AudioPostmixCallback postmix = logdev->postmix;
+                    float *mix_buffer = final_mix_buffer;
+                    if (postmix) {
+                        mix_buffer = device->postmix_buffer;
+                        SDL_memset(mix_buffer, '\0', work_buffer_size);  // start with silence.
+                    }
 
-                    /* this will hold a lock on `stream` while getting. We don't explicitly lock the streams
-                       for iterating here because the binding linked list can only change while the device lock is held.
-                       (we _do_ lock the stream during binding/unbinding to make sure that two threads can't try to bind
-                       the same stream to different devices at the same time, though.) */
-                    const int br = SDL_GetAudioStreamData(stream, device->work_buffer, work_buffer_size);
-                    if (br < 0) {  // Probably OOM. Kill the audio device; the whole thing is likely dying soon anyhow.
-                        failed = SDL_TRUE;
-                        break;
-                    } else if (br > 0) {  // it's okay if we get less than requested, we mix what we have.
-                        MixFloat32Audio(mix_buffer, (float *) device->work_buffer, br);
+                    for (SDL_AudioStream *stream = logdev->bound_streams; stream; stream = stream->next_binding) {
+                        // We should have updated this elsewhere if the format changed!
+                        SDL_assert(AUDIO_SPECS_EQUAL(stream->dst_spec, outspec));
+
+                        if (pending_mix_bytes > 0) {
+                            MixFloat32Audio(final_mix_buffer, (float *) device->work_buffer, pending_mix_bytes);
+                            pending_mix_bytes = 0;
+                        }
+
+                        /* this will hold a lock on `stream` while getting. We don't explicitly lock the streams
+                           for iterating here because the binding linked list can only change while the device lock is held.
+                           (we _do_ lock the stream during binding/unbinding to make sure that two threads can't try to bind
+                           the same stream to different devices at the same time, though.) */
+                        const int br = SDL_GetAudioStreamData(stream, device->work_buffer, work_buffer_size);
+                        if (br < 0) {  // Probably OOM. Kill the audio device; the whole thing is likely dying soon anyhow.
+                            failed = SDL_TRUE;
+                            break;
+                        }
+
+                        if (br < work_buffer_size) {
+                            short_reads++;
+                        }
+
+                        if (br > 0) {  // it's okay if we get less than requested, we mix what we have.
+                            if (MixAudioStreamWithGains(stream, mix_buffer, (const float *) device->work_buffer, br, outspec.channels)) {
+                                // already mixed.
+                            } else if (postmix) {
+                                MixFloat32Audio(mix_buffer, (float *) device->work_buffer, br);
+                            } else {
+                                pending_mix_bytes = br;
+                            }
+                        }
                     }
-                }
 
-                if (postmix) {
-                    SDL_assert(mix_buffer == device->postmix_buffer);
-                    postmix(logdev->postmix_userdata, &outspec, mix_buffer, work_buffer_size);
-                    MixFloat32Audio(final_mix_buffer, mix_buffer, work_buffer_size);
+                    if (postmix) {
+                        SDL_assert(mix_buffer == device->postmix_buffer);
+                        if (pending_mix_bytes > 0) {
+                            MixFloat32Audio(final_mix_buffer, (float *) device->work_buffer, pending_mix_bytes);
+                            pending_mix_bytes = 0;
+                        }
+                        postmix(logdev->postmix_userdata, &outspec, mix_buffer, work_buffer_size);
+                        MixFloat32Audio(final_mix_buffer, mix_buffer, work_buffer_size);
+                    }
                 }
             }
 
             if (((Uint8 *) final_mix_buffer) != device_buffer) {
-                // !!! FIXME: we can't promise the device buf is aligned/padded for SIMD.
-                //ConvertAudio(needed_samples * device->spec.channels, final_mix_buffer, SDL_AUDIO_F32, device->spec.channels, device_buffer, device->spec.format, device->spec.channels, device->work_buffer);
-                ConvertAudio(needed_samples / device->spec.channels, final_mix_buffer, SDL_AUDIO_F32, device->spec.channels, device->work_buffer, device->spec.format, device->spec.channels, NULL);
-                SDL_memcpy(device_buffer, device->work_buffer, buffer_size);
+                MixAndConvertOutputAudio(device, final_mix_buffer, (const float *) device->work_buffer, pending_mix_bytes, device_buffer, buffer_size);
+            } else if (pending_mix_bytes > 0) {
+                MixFloat32Audio(final_mix_buffer, (float *) device->work_buffer, pending_mix_bytes);
             }
         }
 
+        const Uint64 previous_period_ns = device->last_period_ns;
+        const Uint64 process_ns = RecordAudioDevicePeriod(device, period_start_ns, process_start_ns, short_reads);
+
         // PlayDevice SHOULD NOT BLOCK, as we are holding a lock right now. Block in WaitDevice instead!
         if (device->PlayDevice(device, device_buffer, buffer_size) < 0) {
             failed = SDL_TRUE;
+        } else if (device->adaptive_max_frames && previous_period_ns) {
+            if (AdaptAudioDeviceSize(device, period_start_ns - previous_period_ns, process_ns) < 0) {
+                failed = SDL_TRUE;
+            }
         }
     }
 
@@ -1121,14 +2166,19 @@ SDL_bool SDL_OutputAudioThreadIterate(SDL_AudioDevice *device)
     return SDL_TRUE;  // always go on if not shutting down, even if device failed.
 }
 
-void SDL_OutputAudioThreadShutdown(SDL_AudioDevice *device)
+static void WaitForOutputAudioToDrain(SDL_AudioDevice *device)
 {
-    SDL_assert(!device->iscapture);
     const int frames = device->buffer_size / SDL_AUDIO_FRAMESIZE(device->spec);
     // Wait for the audio to drain if device didn't die.
     if (!SDL_AtomicGet(&device->zombie)) {
         SDL_Delay(((frames * 1000) / device->spec.freq) * 2);
     }
+}
+
+void SDL_OutputAudioThreadShutdown(SDL_AudioDevice *device)
+{
+    SDL_assert(!device->iscapture);
+    WaitForOutputAudioToDrain(device);
     current_audio.impl.ThreadDeinit(device);
     SDL_AudioThreadFinalize(device);
 }
@@ -1144,6 +2194,7 @@ static int SDLCALL OutputAudioThread(void *devicep)  // thread entry point
         if (device->WaitDevice(device) < 0) {
             SDL_AudioDeviceDisconnected(device);  // doh. (but don't break out of the loop, just be a zombie for now!)
         }
+        device->wait_finished_ns = SDL_GetTicksNS();
     } while (SDL_OutputAudioThreadIterate(device));
 
     SDL_OutputAudioThreadShutdown(device);
@@ -1172,12 +2223,14 @@ SDL_bool SDL_CaptureAudioThreadIterate(SDL_AudioDevice *device)
     }
 
     SDL_bool failed = SDL_FALSE;
+    const Uint64 period_start_ns = GetAudioDevicePeriodStart(device);
 
     if (!device->logical_devices) {
         device->FlushCapture(device); // nothing wants data, dump anything pending.
     } else {
         // this SHOULD NOT BLOCK, as we are holding a lock right now. Block in WaitCaptureDevice!
         int br = device->CaptureFromDevice(device, device->work_buffer, device->buffer_size);
+        const Uint64 process_start_ns = SDL_GetTicksNS();
         if (br < 0) {  // uhoh, device failed for some reason!
             failed = SDL_TRUE;
         } else if (br > 0) {  // queue the new data to each bound stream.
@@ -1219,6 +2272,8 @@ SDL_bool SDL_CaptureAudioThreadIterate(SDL_AudioDevice *device)
                     }
                 }
             }
+
+            RecordAudioDevicePeriod(device, period_start_ns, process_start_ns, 0);
         }
     }
 
@@ -1250,6 +2305,7 @@ static int SDLCALL CaptureAudioThread(void *devicep)  // thread entry point
         if (device->WaitCaptureDevice(device) < 0) {
             SDL_AudioDeviceDisconnected(device);  // doh. (but don't break out of the loop, just be a zombie for now!)
         }
+        device->wait_finished_ns = SDL_GetTicksNS();
     } while (SDL_CaptureAudioThreadIterate(device));
 
     SDL_CaptureAudioThreadShutdown(device);
@@ -1389,6 +2445,52 @@ int SDL_GetAudioDeviceFormat(SDL_AudioDeviceID devid, SDL_AudioSpec *spec, int *
     return retval;
 }
 
+int SDL_GetAudioDeviceStats(SDL_AudioDeviceID devid, SDL_AudioDeviceStats *stats)
+{
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    } else if (!SDL_GetCurrentAudioDriver()) {
+        return SDL_SetError("Audio subsystem is not initialized");
+    }
+
+    // We only hold a reference here, not the device lock, so we never make the device thread wait on us.
+    SDL_AudioDevice *device = NULL;
+    SDL_LockRWLockForReading(current_audio.device_hash_lock);
+    if (devid == SDL_AUDIO_DEVICE_DEFAULT_OUTPUT) {
+        devid = current_audio.default_output_device_id;
+    } else if (devid == SDL_AUDIO_DEVICE_DEFAULT_CAPTURE) {
+        devid = current_audio.default_capture_device_id;
+    }
+
+    const void *value = NULL;
+    if (devid && SDL_FindInHashTable(current_audio.device_hash, (const void *) (uintptr_t) devid, &value)) {
+        // bit #1 of devid is set for physical devices and unset for logical.
+        const SDL_bool islogical = !(devid & (1<<1));
+        device = islogical ? ((const SDL_LogicalAudioDevice *) value)->physical_device : (SDL_AudioDevice *) value;
+        RefPhysicalAudioDevice(device);
+    }
+    SDL_UnlockRWLock(current_audio.device_hash_lock);
+
+    if (!device) {
+        return SDL_SetError("Invalid audio device instance ID");
+    }
+
+    int sequence;
+    do {
+        while ((sequence = SDL_AtomicGet(&device->stats_sequence)) & 1) {
+            SDL_CPUPauseInstruction();  // the device thread is in the middle of an update; it'll be quick.
+        }
+        SDL_copyp(stats, &device->stats);
+        SDL_MemoryBarrierAcquire();
+    } while (SDL_AtomicGet(&device->stats_sequence) != sequence);
+
+    stats->xruns = (Uint64) SDL_AtomicGet(&device->xruns);
+
+    UnrefPhysicalAudioDevice(device);
+
+    return 0;
+}
+
 // this is awkward, but this makes sure we can release the device lock
 //  so the device thread can terminate but also not have two things
 //  race to close or open the device while the lock is unprotected.
@@ -1415,6 +2517,14 @@ static void ClosePhysicalAudioDevice(SDL_AudioDevice *device)
     if (device->thread) {
         SDL_WaitThread(device->thread, NULL);
         device->thread = NULL;
+    } else if (device->shared_thread) {
+        // nothing to join; take the device off the shared thread, then do what a device thread would have done on the way out.
+        RemoveFromSharedAudioThread(device);
+        if (device->iscapture) {
+            device->FlushCapture(device);
+        } else {
+            WaitForOutputAudioToDrain(device);
+        }
     }
 
     if (device->currently_opened) {
@@ -1436,6 +2546,8 @@ static void ClosePhysicalAudioDevice(SDL_AudioDevice *device)
     SDL_aligned_free(device->postmix_buffer);
     device->postmix_buffer = NULL;
 
+    FreeAudioMixPartitions(device);
+
     SDL_copyp(&device->spec, &device->default_spec);
     device->sample_frames = 0;
     device->silence_value = SDL_GetSilenceValueForFormat(device->spec.format);
@@ -1517,6 +2629,7 @@ void SDL_UpdatedAudioDeviceFormat(SDL_AudioDevice *device)
     device->buffer_size = device->sample_frames * SDL_AUDIO_FRAMESIZE(device->spec);
     device->work_buffer_size = device->sample_frames * sizeof (float) * device->spec.channels;
     device->work_buffer_size = SDL_max(device->buffer_size, device->work_buffer_size);  // just in case we end up with a 64-bit audio format at some point.
+    BuildAudioConvertPlan(&device->output_plan, SDL_AUDIO_F32, device->spec.channels, device->spec.format, device->spec.channels);
 }
 
 char *SDL_GetAudioThreadName(SDL_AudioDevice *device, char *buf, size_t buflen)
@@ -1547,6 +2660,8 @@ static int OpenPhysicalAudioDevice(SDL_AudioDevice *device, const SDL_AudioSpec
     device->WaitCaptureDevice = current_audio.impl.WaitCaptureDevice;
     device->CaptureFromDevice = current_audio.impl.CaptureFromDevice;
     device->FlushCapture = current_audio.impl.FlushCapture;
+    device->PollDevice = current_audio.impl.PollDevice;
+    device->next_poll_ns = 0;
 
     SDL_AudioSpec spec;
     SDL_copyp(&spec, inspec ? inspec : &device->default_spec);
@@ -1560,7 +2675,18 @@ static int OpenPhysicalAudioDevice(SDL_AudioDevice *device, const SDL_AudioSpec
     device->spec.freq = SDL_max(device->default_spec.freq, spec.freq);
     device->spec.channels = SDL_max(device->default_spec.channels, spec.channels);
     device->sample_frames = GetDefaultSampleFramesFromFreq(device->spec.freq);
+
+    // Adaptive sizing starts an eighth of the usual size (128 frames at 48000Hz) and can grow back to it. An explicit size from the app wins.
+    const int adaptive_max_frames = device->sample_frames;
+    device->adaptive_max_frames = 0;
+    const SDL_bool adaptive = (!device->iscapture && current_audio.impl.ResizeDevice && !SDL_GetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES) &&
+                               SDL_GetHintBoolean(SDL_HINT_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES, SDL_FALSE));
+    if (adaptive) {
+        device->sample_frames = SDL_max(adaptive_max_frames / 8, 32);
+    }
+
     SDL_UpdatedAudioDeviceFormat(device);  // start this off sane.
+    ResetAudioDeviceStats(device);
 
     device->currently_opened = SDL_TRUE;  // mark this true even if impl.OpenDevice fails, so we know to clean up.
     if (current_audio.impl.OpenDevice(device) < 0) {
@@ -1570,6 +2696,10 @@ static int OpenPhysicalAudioDevice(SDL_AudioDevice *device, const SDL_AudioSpec
 
     SDL_UpdatedAudioDeviceFormat(device);  // in case the backend changed things and forgot to call this.
 
+    if (adaptive) {
+        StartAdaptiveAudioDeviceSizing(device, adaptive_max_frames);
+    }
+
     // Allocate a scratch audio buffer
     device->work_buffer = (Uint8 *)SDL_aligned_alloc(SDL_SIMDGetAlignment(), device->work_buffer_size);
     if (!device->work_buffer) {
@@ -1585,8 +2715,17 @@ static int OpenPhysicalAudioDevice(SDL_AudioDevice *device, const SDL_AudioSpec
         }
     }
 
+    if (!AllocateAudioMixPartitions(device)) {
+        ClosePhysicalAudioDevice(device);
+        return SDL_OutOfMemory();
+    }
+
     // Start the audio thread if necessary
-    if (!current_audio.impl.ProvidesOwnCallbackThread) {
+    if (current_audio.impl.ProvidesOwnCallbackThread) {
+        // the backend drives the device itself.
+    } else if (device->PollDevice && AddToSharedAudioThread(device)) {
+        // a shared thread drives the device.
+    } else {
         const size_t stacksize = 0;  // just take the system default, since audio streams might have callbacks.
         char threadname[64];
         SDL_GetAudioThreadName(device, threadname, sizeof (threadname));
@@ -1803,6 +2942,7 @@ int SDL_BindAudioStreams(SDL_AudioDeviceID devid, SDL_AudioStream **streams, int
                 if (logdev->postmix) {
                     stream->src_spec.format = SDL_AUDIO_F32;
                 }
+                UpdateAudioStreamRingFrameSize(stream);
             }
 
             SDL_UnlockMutex(stream->lock);
@@ -2101,7 +3241,7 @@ void SDL_DefaultAudioDeviceChanged(SDL_AudioDevice *new_default_device)
 
                 // Queue an event for each logical device we moved.
                 if (spec_changed) {
-                    p = (SDL_PendingAudioDeviceEvent *)SDL_malloc(sizeof(SDL_PendingAudioDeviceEvent));
+                    p = (SDL_PendingAudioDeviceEvent *)SDL_calloc(1, sizeof(SDL_PendingAudioDeviceEvent));
                     if (p) { // if this failed, no event for you, but you have deeper problems anyhow.
                         p->type = SDL_EVENT_AUDIO_DEVICE_FORMAT_CHANGED;
                         p->devid = logdev->instance_id;
@@ -2178,6 +3318,10 @@ int SDL_AudioDeviceFormatChangedAlreadyLocked(SDL_AudioDevice *device, const SDL
                 kill_device = SDL_TRUE;
             }
         }
+
+        if (!AllocateAudioMixPartitions(device)) {
+            kill_device = SDL_TRUE;
+        }
     }
 
     // Post an event for the physical device, and each logical device on this physical device.
@@ -2191,7 +3335,7 @@ int SDL_AudioDeviceFormatChangedAlreadyLocked(SDL_AudioDevice *device, const SDL
 
         SDL_PendingAudioDeviceEvent *p;
 
-        p = (SDL_PendingAudioDeviceEvent *)SDL_malloc(sizeof(SDL_PendingAudioDeviceEvent));
+        p = (SDL_PendingAudioDeviceEvent *)SDL_calloc(1, sizeof(SDL_PendingAudioDeviceEvent));
         if (p) { // if this failed, no event for you, but you have deeper problems anyhow.
             p->type = SDL_EVENT_AUDIO_DEVICE_FORMAT_CHANGED;
             p->devid = device->instance_id;
@@ -2201,7 +3345,7 @@ int SDL_AudioDeviceFormatChangedAlreadyLocked(SDL_AudioDevice *device, const SDL
         }
 
         for (SDL_LogicalAudioDevice *logdev = device->logical_devices; logdev; logdev = logdev->next) {
-            p = (SDL_PendingAudioDeviceEvent *)SDL_malloc(sizeof(SDL_PendingAudioDeviceEvent));
+            p = (SDL_PendingAudioDeviceEvent *)SDL_calloc(1, sizeof(SDL_PendingAudioDeviceEvent));
             if (p) { // if this failed, no event for you, but you have deeper problems anyhow.
                 p->type = SDL_EVENT_AUDIO_DEVICE_FORMAT_CHANGED;
                 p->devid = logdev->instance_id;
@@ -2232,10 +3376,69 @@ int SDL_AudioDeviceFormatChanged(SDL_AudioDevice *device, const SDL_AudioSpec *n
     return retval;
 }
 
+void SDL_QueueAudioStreamWatermarkEvent(SDL_AudioStream *stream, Uint32 type, int queued)
+{
+    if (!current_audio.device_hash_lock) {
+        return;
+    }
+
+    // Each stream has a node for each watermark, so the device thread never allocates. If the last event
+    // of this type hasn't gone out yet, it just gets updated, so the app hears about the most recent crossing.
+    const int i = (type == SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK) ? 1 : 0;
+    SDL_AtomicLock(&current_audio.pending_stream_events_lock);
+    SDL_PendingAudioDeviceEvent *p = &stream->watermark_events[i];
+    p->type = type;
+    p->stream = stream;
+    p->queued = queued;
+    if (!stream->watermark_event_queued[i]) {
+        SDL_assert(current_audio.pending_stream_events_tail != NULL);
+        SDL_assert(current_audio.pending_stream_events_tail->next == NULL);
+        p->next = NULL;
+        current_audio.pending_stream_events_tail->next = p;
+        current_audio.pending_stream_events_tail = p;
+        stream->watermark_event_queued[i] = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&current_audio.pending_stream_events_lock);
+}
+
+// Send the queued watermark events. They live in their streams, so copy each one out before letting go of the lock.
+static void SendPendingAudioStreamEvents(void)
+{
+    for (;;) {
+        SDL_AtomicLock(&current_audio.pending_stream_events_lock);
+        SDL_PendingAudioDeviceEvent *p = current_audio.pending_stream_events.next;
+        if (!p) {
+            SDL_AtomicUnlock(&current_audio.pending_stream_events_lock);
+            break;
+        }
+        current_audio.pending_stream_events.next = p->next;
+        if (current_audio.pending_stream_events_tail == p) {
+            current_audio.pending_stream_events_tail = &current_audio.pending_stream_events;
+        }
+        p->next = NULL;
+        p->stream->watermark_event_queued[p - p->stream->watermark_events] = SDL_FALSE;
+
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = p->type;
+        event.astream.stream = p->stream;
+        event.astream.queued = p->queued;
+        SDL_AtomicUnlock(&current_audio.pending_stream_events_lock);
+
+        if (SDL_EventEnabled(event.type)) {
+            SDL_PushEvent(&event);
+        }
+    }
+}
+
 // This is an internal function, so SDL_PumpEvents() can check for pending audio device events.
 // ("UpdateSubsystem" is the same naming that the other things that hook into PumpEvents use.)
 void SDL_UpdateAudio(void)
 {
+    if (current_audio.pending_stream_events.next) {  // unlocked peek; anything we miss goes out next time.
+        SendPendingAudioStreamEvents();
+    }
+
     SDL_LockRWLockForReading(current_audio.device_hash_lock);
     SDL_PendingAudioDeviceEvent *pending_events = current_audio.pending_events.next;
     SDL_UnlockRWLock(current_audio.device_hash_lock);
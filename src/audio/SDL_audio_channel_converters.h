@@ -1066,3 +1066,439 @@ static const SDL_AudioChannelConverter channel_converters[8][8] = {   /* [from][
     { SDL_Convert71ToMono, SDL_Convert71ToStereo, SDL_Convert71To21, SDL_Convert71ToQuad, SDL_Convert71To41, SDL_Convert71To51, SDL_Convert71To61, NULL }
 };
 
+// The same conversions as coefficient matrices, for the SIMD converters: dst[j] = sum(src[i] * matrix[(j * fromchans) + i])
+static const float channel_converter_matrices[8][8][64] = {   /* [from][to] */
+    {
+        {   /* Mono x Mono */
+            1.000000000f  /* FC */
+        },
+        {   /* Mono x Stereo */
+            1.000000000f,  /* FL */
+            1.000000000f  /* FR */
+        },
+        {   /* Mono x 2.1 */
+            1.000000000f,  /* FL */
+            1.000000000f,  /* FR */
+            0.000000000f  /* LFE */
+        },
+        {   /* Mono x Quad */
+            1.000000000f,  /* FL */
+            1.000000000f,  /* FR */
+            0.000000000f,  /* BL */
+            0.000000000f  /* BR */
+        },
+        {   /* Mono x 4.1 */
+            1.000000000f,  /* FL */
+            1.000000000f,  /* FR */
+            0.000000000f,  /* LFE */
+            0.000000000f,  /* BL */
+            0.000000000f  /* BR */
+        },
+        {   /* Mono x 5.1 */
+            1.000000000f,  /* FL */
+            1.000000000f,  /* FR */
+            0.000000000f,  /* FC */
+            0.000000000f,  /* LFE */
+            0.000000000f,  /* BL */
+            0.000000000f  /* BR */
+        },
+        {   /* Mono x 6.1 */
+            1.000000000f,  /* FL */
+            1.000000000f,  /* FR */
+            0.000000000f,  /* FC */
+            0.000000000f,  /* LFE */
+            0.000000000f,  /* BC */
+            0.000000000f,  /* SL */
+            0.000000000f  /* SR */
+        },
+        {   /* Mono x 7.1 */
+            1.000000000f,  /* FL */
+            1.000000000f,  /* FR */
+            0.000000000f,  /* FC */
+            0.000000000f,  /* LFE */
+            0.000000000f,  /* BL */
+            0.000000000f,  /* BR */
+            0.000000000f,  /* SL */
+            0.000000000f  /* SR */
+        }
+    },
+    {
+        {   /* Stereo x Mono */
+            0.500000000f, 0.500000000f  /* FC */
+        },
+        {   /* Stereo x Stereo */
+            1.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f  /* FR */
+        },
+        {   /* Stereo x 2.1 */
+            1.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f,  /* FR */
+            0.000000000f, 0.000000000f  /* LFE */
+        },
+        {   /* Stereo x Quad */
+            1.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f,  /* FR */
+            0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f  /* BR */
+        },
+        {   /* Stereo x 4.1 */
+            1.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f,  /* FR */
+            0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f  /* BR */
+        },
+        {   /* Stereo x 5.1 */
+            1.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f,  /* FR */
+            0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f  /* BR */
+        },
+        {   /* Stereo x 6.1 */
+            1.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f,  /* FR */
+            0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f,  /* BC */
+            0.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f  /* SR */
+        },
+        {   /* Stereo x 7.1 */
+            1.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f,  /* FR */
+            0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f,  /* BR */
+            0.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f  /* SR */
+        }
+    },
+    {
+        {   /* 2.1 x Mono */
+            0.333333343f, 0.333333343f, 0.333333343f  /* FC */
+        },
+        {   /* 2.1 x Stereo */
+            0.800000012f, 0.000000000f, 0.200000003f,  /* FL */
+            0.000000000f, 0.800000012f, 0.200000003f  /* FR */
+        },
+        {   /* 2.1 x 2.1 */
+            1.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f  /* LFE */
+        },
+        {   /* 2.1 x Quad */
+            0.888888896f, 0.000000000f, 0.111111112f,  /* FL */
+            0.000000000f, 0.888888896f, 0.111111112f,  /* FR */
+            0.000000000f, 0.000000000f, 0.111111112f,  /* BL */
+            0.000000000f, 0.000000000f, 0.111111112f  /* BR */
+        },
+        {   /* 2.1 x 4.1 */
+            1.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f  /* BR */
+        },
+        {   /* 2.1 x 5.1 */
+            1.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 1.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f  /* BR */
+        },
+        {   /* 2.1 x 6.1 */
+            1.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 1.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* BC */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f  /* SR */
+        },
+        {   /* 2.1 x 7.1 */
+            1.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 1.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* BR */
+            0.000000000f, 0.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f  /* SR */
+        }
+    },
+    {
+        {   /* Quad x Mono */
+            0.250000000f, 0.250000000f, 0.250000000f, 0.250000000f  /* FC */
+        },
+        {   /* Quad x Stereo */
+            0.421000004f, 0.000000000f, 0.358999997f, 0.219999999f,  /* FL */
+            0.000000000f, 0.421000004f, 0.219999999f, 0.358999997f  /* FR */
+        },
+        {   /* Quad x 2.1 */
+            0.421000004f, 0.000000000f, 0.358999997f, 0.219999999f,  /* FL */
+            0.000000000f, 0.421000004f, 0.219999999f, 0.358999997f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f  /* LFE */
+        },
+        {   /* Quad x Quad */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* BR */
+        },
+        {   /* Quad x 4.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* BR */
+        },
+        {   /* Quad x 5.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* BR */
+        },
+        {   /* Quad x 6.1 */
+            0.939999998f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 0.939999998f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.500000000f, 0.500000000f,  /* BC */
+            0.000000000f, 0.000000000f, 0.796000004f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.796000004f  /* SR */
+        },
+        {   /* Quad x 7.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f,  /* BR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f  /* SR */
+        }
+    },
+    {
+        {   /* 4.1 x Mono */
+            0.200000003f, 0.200000003f, 0.200000003f, 0.200000003f, 0.200000003f  /* FC */
+        },
+        {   /* 4.1 x Stereo */
+            0.374222219f, 0.000000000f, 0.111111112f, 0.319111109f, 0.195555553f,  /* FL */
+            0.000000000f, 0.374222219f, 0.111111112f, 0.195555553f, 0.319111109f  /* FR */
+        },
+        {   /* 4.1 x 2.1 */
+            0.421000004f, 0.000000000f, 0.000000000f, 0.358999997f, 0.219999999f,  /* FL */
+            0.000000000f, 0.421000004f, 0.000000000f, 0.219999999f, 0.358999997f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f  /* LFE */
+        },
+        {   /* 4.1 x Quad */
+            0.941176474f, 0.000000000f, 0.058823530f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 0.941176474f, 0.058823530f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.058823530f, 0.941176474f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.058823530f, 0.000000000f, 0.941176474f  /* BR */
+        },
+        {   /* 4.1 x 4.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* BR */
+        },
+        {   /* 4.1 x 5.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* BR */
+        },
+        {   /* 4.1 x 6.1 */
+            0.939999998f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 0.939999998f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.500000000f, 0.500000000f,  /* BC */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.796000004f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.796000004f  /* SR */
+        },
+        {   /* 4.1 x 7.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f,  /* BR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f  /* SR */
+        }
+    },
+    {
+        {   /* 5.1 x Mono */
+            0.166666672f, 0.166666672f, 0.166666672f, 0.166666672f, 0.166666672f, 0.166666672f  /* FC */
+        },
+        {   /* 5.1 x Stereo */
+            0.294545442f, 0.000000000f, 0.208181813f, 0.090909094f, 0.251818180f, 0.154545456f,  /* FL */
+            0.000000000f, 0.294545442f, 0.208181813f, 0.090909094f, 0.154545456f, 0.251818180f  /* FR */
+        },
+        {   /* 5.1 x 2.1 */
+            0.324000001f, 0.000000000f, 0.229000002f, 0.000000000f, 0.277000010f, 0.170000002f,  /* FL */
+            0.000000000f, 0.324000001f, 0.229000002f, 0.000000000f, 0.170000002f, 0.277000010f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f  /* LFE */
+        },
+        {   /* 5.1 x Quad */
+            0.558095276f, 0.000000000f, 0.394285709f, 0.047619049f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 0.558095276f, 0.394285709f, 0.047619049f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.047619049f, 0.558095276f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.047619049f, 0.000000000f, 0.558095276f  /* BR */
+        },
+        {   /* 5.1 x 4.1 */
+            0.586000025f, 0.000000000f, 0.414000005f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 0.586000025f, 0.414000005f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.586000025f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.586000025f  /* BR */
+        },
+        {   /* 5.1 x 5.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* BR */
+        },
+        {   /* 5.1 x 6.1 */
+            0.939999998f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 0.939999998f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.939999998f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.500000000f, 0.500000000f,  /* BC */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.796000004f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.796000004f  /* SR */
+        },
+        {   /* 5.1 x 7.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f,  /* BR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f  /* SR */
+        }
+    },
+    {
+        {   /* 6.1 x Mono */
+            0.143142849f, 0.143142849f, 0.143142849f, 0.142857149f, 0.143142849f, 0.143142849f, 0.143142849f  /* FC */
+        },
+        {   /* 6.1 x Stereo */
+            0.247384623f, 0.000000000f, 0.174461529f, 0.076923080f, 0.174461529f, 0.226153851f, 0.100615382f,  /* FL */
+            0.000000000f, 0.247384623f, 0.174461529f, 0.076923080f, 0.174461529f, 0.100615382f, 0.226153851f  /* FR */
+        },
+        {   /* 6.1 x 2.1 */
+            0.268000007f, 0.000000000f, 0.188999996f, 0.000000000f, 0.188999996f, 0.245000005f, 0.108999997f,  /* FL */
+            0.000000000f, 0.268000007f, 0.188999996f, 0.000000000f, 0.188999996f, 0.108999997f, 0.245000005f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f  /* LFE */
+        },
+        {   /* 6.1 x Quad */
+            0.463679999f, 0.000000000f, 0.327360004f, 0.040000003f, 0.000000000f, 0.168960005f, 0.000000000f,  /* FL */
+            0.000000000f, 0.463679999f, 0.327360004f, 0.040000003f, 0.000000000f, 0.000000000f, 0.168960005f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.040000003f, 0.327360004f, 0.431039989f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.040000003f, 0.327360004f, 0.000000000f, 0.431039989f  /* BR */
+        },
+        {   /* 6.1 x 4.1 */
+            0.483000010f, 0.000000000f, 0.340999991f, 0.000000000f, 0.000000000f, 0.175999999f, 0.000000000f,  /* FL */
+            0.000000000f, 0.483000010f, 0.340999991f, 0.000000000f, 0.000000000f, 0.000000000f, 0.175999999f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.340999991f, 0.449000001f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.340999991f, 0.000000000f, 0.449000001f  /* BR */
+        },
+        {   /* 6.1 x 5.1 */
+            0.611000001f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.223000005f, 0.000000000f,  /* FL */
+            0.000000000f, 0.611000001f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.223000005f,  /* FR */
+            0.000000000f, 0.000000000f, 0.611000001f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.432000011f, 0.568000019f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.432000011f, 0.000000000f, 0.568000019f  /* BR */
+        },
+        {   /* 6.1 x 6.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* BC */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* SR */
+        },
+        {   /* 6.1 x 7.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.707000017f, 0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.707000017f, 0.000000000f, 0.000000000f,  /* BR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* SR */
+        }
+    },
+    {
+        {   /* 7.1 x Mono */
+            0.125125006f, 0.125125006f, 0.125125006f, 0.125000000f, 0.125125006f, 0.125125006f, 0.125125006f, 0.125125006f  /* FC */
+        },
+        {   /* 7.1 x Stereo */
+            0.211866662f, 0.000000000f, 0.150266662f, 0.066666670f, 0.181066677f, 0.111066669f, 0.194133341f, 0.085866667f,  /* FL */
+            0.000000000f, 0.211866662f, 0.150266662f, 0.066666670f, 0.111066669f, 0.181066677f, 0.085866667f, 0.194133341f  /* FR */
+        },
+        {   /* 7.1 x 2.1 */
+            0.226999998f, 0.000000000f, 0.160999998f, 0.000000000f, 0.194000006f, 0.119000003f, 0.208000004f, 0.092000000f,  /* FL */
+            0.000000000f, 0.226999998f, 0.160999998f, 0.000000000f, 0.119000003f, 0.194000006f, 0.092000000f, 0.208000004f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f  /* LFE */
+        },
+        {   /* 7.1 x Quad */
+            0.466344833f, 0.000000000f, 0.329241365f, 0.034482758f, 0.000000000f, 0.000000000f, 0.169931039f, 0.000000000f,  /* FL */
+            0.000000000f, 0.466344833f, 0.329241365f, 0.034482758f, 0.000000000f, 0.000000000f, 0.000000000f, 0.169931039f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.034482758f, 0.466344833f, 0.000000000f, 0.433517247f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.034482758f, 0.000000000f, 0.466344833f, 0.000000000f, 0.433517247f  /* BR */
+        },
+        {   /* 7.1 x 4.1 */
+            0.483000010f, 0.000000000f, 0.340999991f, 0.000000000f, 0.000000000f, 0.000000000f, 0.175999999f, 0.000000000f,  /* FL */
+            0.000000000f, 0.483000010f, 0.340999991f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.175999999f,  /* FR */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.483000010f, 0.000000000f, 0.449000001f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.483000010f, 0.000000000f, 0.449000001f  /* BR */
+        },
+        {   /* 7.1 x 5.1 */
+            0.518000007f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.188999996f, 0.000000000f,  /* FL */
+            0.000000000f, 0.518000007f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.188999996f,  /* FR */
+            0.000000000f, 0.000000000f, 0.518000007f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.518000007f, 0.000000000f, 0.481999993f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.518000007f, 0.000000000f, 0.481999993f  /* BR */
+        },
+        {   /* 7.1 x 6.1 */
+            0.541000009f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 0.541000009f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 0.541000009f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.287999988f, 0.287999988f, 0.000000000f, 0.000000000f,  /* BC */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.458999991f, 0.000000000f, 0.541000009f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.458999991f, 0.000000000f, 0.541000009f  /* SR */
+        },
+        {   /* 7.1 x 7.1 */
+            1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FL */
+            0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FR */
+            0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* FC */
+            0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* LFE */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f, 0.000000000f,  /* BL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f, 0.000000000f,  /* BR */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f, 0.000000000f,  /* SL */
+            0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 0.000000000f, 1.000000000f  /* SR */
+        }
+    }
+};
+
@@ -24,6 +24,8 @@
 
 #include "SDL_audioqueue.h"
 #include "SDL_audioresample.h"
+#include "../cpuinfo/SDL_cpuinfo_c.h"
+#include "../SDL_properties_c.h"
 
 #ifndef SDL_INT_MAX
 #define SDL_INT_MAX ((int)(~0u>>1))
@@ -132,6 +134,208 @@ static void SDL_TARGETING("sse") SDL_ConvertMonoToStereo_SSE(float *dst, const f
 // Include the autogenerated channel converters...
 #include "SDL_audio_channel_converters.h"
 
+// SIMD versions of the channel converters above for mixing surround sound (4.1 and up) down to stereo or mono.
+// These use channel_converter_matrices: each output sample is the dot product of an input frame with one row of the
+// matrix, so they multiply whole frames at once and then sum the products for several output samples together.
+// The other conversions have few inputs per output, or mostly copy samples around, and the compiler already does
+// about as well with the generated converters (4.1 to stereo included, so that one isn't sent here).
+
+// Finish off any leftovers with scalar operations.
+#define FINISH_SURROUND_DOWNMIX()                                              \
+    for (; i < num_frames; i++, src += src_channels, dst += dst_channels) {    \
+        for (k = 0; k < dst_channels; k++) {                                   \
+            float sum = 0.0f;                                                  \
+            for (j = 0; j < src_channels; j++) {                               \
+                sum += src[j] * matrix[(k * src_channels) + j];                \
+            }                                                                  \
+            dst[k] = sum;                                                      \
+        }                                                                      \
+    }
+
+#ifdef SDL_SSE3_INTRINSICS
+static void SDL_TARGETING("sse3") SDL_ConvertSurroundDown_SSE3(float *dst, const float *src, int num_frames, int src_channels, int dst_channels, const float *matrix)
+{
+    // The second half of each frame is loaded 4 floats wide and masked, so stop before that reads past the last frame.
+    const int safe_frames = num_frames - ((8 + src_channels - 1) / src_channels) + 1;
+    const __m128 mask = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_set1_epi32(src_channels - 4), _mm_setr_epi32(0, 1, 2, 3)));
+    float rows[2 * 8];
+    int i = 0, j, k;
+
+    LOG_DEBUG_AUDIO_CONVERT("surround", "stereo/mono (using SSE3)");
+
+    SDL_assert((src_channels > 4) && (dst_channels <= 2));
+
+    SDL_zeroa(rows);
+    for (k = 0; k < dst_channels; k++) {
+        for (j = 0; j < src_channels; j++) {
+            rows[(k * 8) + j] = matrix[(k * src_channels) + j];
+        }
+    }
+
+    const __m128 row0_low = _mm_loadu_ps(rows), row0_high = _mm_loadu_ps(rows + 4);
+    const __m128 row1_low = _mm_loadu_ps(rows + 8), row1_high = _mm_loadu_ps(rows + 12);
+
+    #define SURROUND_FRAME_PRODUCTS_SSE3(frame, low, high) \
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(frame), low), _mm_mul_ps(_mm_and_ps(_mm_loadu_ps((frame) + 4), mask), high))
+
+    if (dst_channels == 2) {
+        for (; i + 2 <= safe_frames; i += 2, src += src_channels * 2, dst += 4) {
+            const __m128 left0 = SURROUND_FRAME_PRODUCTS_SSE3(src, row0_low, row0_high);
+            const __m128 right0 = SURROUND_FRAME_PRODUCTS_SSE3(src, row1_low, row1_high);
+            const __m128 left1 = SURROUND_FRAME_PRODUCTS_SSE3(src + src_channels, row0_low, row0_high);
+            const __m128 right1 = SURROUND_FRAME_PRODUCTS_SSE3(src + src_channels, row1_low, row1_high);
+            _mm_storeu_ps(dst, _mm_hadd_ps(_mm_hadd_ps(left0, right0), _mm_hadd_ps(left1, right1)));
+        }
+    } else {
+        for (; i + 4 <= safe_frames; i += 4, src += src_channels * 4, dst += 4) {
+            const __m128 sum0 = SURROUND_FRAME_PRODUCTS_SSE3(src, row0_low, row0_high);
+            const __m128 sum1 = SURROUND_FRAME_PRODUCTS_SSE3(src + src_channels, row0_low, row0_high);
+            const __m128 sum2 = SURROUND_FRAME_PRODUCTS_SSE3(src + (src_channels * 2), row0_low, row0_high);
+            const __m128 sum3 = SURROUND_FRAME_PRODUCTS_SSE3(src + (src_channels * 3), row0_low, row0_high);
+            _mm_storeu_ps(dst, _mm_hadd_ps(_mm_hadd_ps(sum0, sum1), _mm_hadd_ps(sum2, sum3)));
+        }
+    }
+
+    #undef SURROUND_FRAME_PRODUCTS_SSE3
+
+    FINISH_SURROUND_DOWNMIX();
+}
+#endif
+
+#ifdef SDL_AVX2_INTRINSICS
+static void SDL_TARGETING("avx2") SDL_ConvertSurroundDown_AVX2(float *dst, const float *src, int num_frames, int src_channels, int dst_channels, const float *matrix)
+{
+    // Masked loads never touch the channels past the end of the frame, so there's no need to stop early.
+    const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(src_channels), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256 row0 = _mm256_maskload_ps(matrix, mask);
+    int i = 0, j, k;
+
+    LOG_DEBUG_AUDIO_CONVERT("surround", "stereo/mono (using AVX2)");
+
+    SDL_assert((src_channels > 4) && (dst_channels <= 2));
+
+    // hadd works within 128-bit halves, so the two halves of each pair of sums get added last.
+    #define SUM_HALVES_AVX2(a, b) _mm256_add_ps(_mm256_permute2f128_ps(a, b, 0x20), _mm256_permute2f128_ps(a, b, 0x31))
+
+    if (dst_channels == 2) {
+        const __m256 row1 = _mm256_maskload_ps(matrix + src_channels, mask);
+        for (; i + 4 <= num_frames; i += 4, src += src_channels * 4, dst += 8) {
+            const __m256 frame0 = _mm256_maskload_ps(src, mask);
+            const __m256 frame1 = _mm256_maskload_ps(src + src_channels, mask);
+            const __m256 frame2 = _mm256_maskload_ps(src + (src_channels * 2), mask);
+            const __m256 frame3 = _mm256_maskload_ps(src + (src_channels * 3), mask);
+            const __m256 sums01 = _mm256_hadd_ps(_mm256_hadd_ps(_mm256_mul_ps(frame0, row0), _mm256_mul_ps(frame0, row1)),
+                                                 _mm256_hadd_ps(_mm256_mul_ps(frame1, row0), _mm256_mul_ps(frame1, row1)));
+            const __m256 sums23 = _mm256_hadd_ps(_mm256_hadd_ps(_mm256_mul_ps(frame2, row0), _mm256_mul_ps(frame2, row1)),
+                                                 _mm256_hadd_ps(_mm256_mul_ps(frame3, row0), _mm256_mul_ps(frame3, row1)));
+            _mm256_storeu_ps(dst, SUM_HALVES_AVX2(sums01, sums23));
+        }
+    } else {
+        for (; i + 8 <= num_frames; i += 8, src += src_channels * 8, dst += 8) {
+            __m256 products[8];
+            for (j = 0; j < 8; j++) {
+                products[j] = _mm256_mul_ps(_mm256_maskload_ps(src + (src_channels * j), mask), row0);
+            }
+            const __m256 sums0123 = _mm256_hadd_ps(_mm256_hadd_ps(products[0], products[1]), _mm256_hadd_ps(products[2], products[3]));
+            const __m256 sums4567 = _mm256_hadd_ps(_mm256_hadd_ps(products[4], products[5]), _mm256_hadd_ps(products[6], products[7]));
+            _mm256_storeu_ps(dst, SUM_HALVES_AVX2(sums0123, sums4567));
+        }
+    }
+
+    #undef SUM_HALVES_AVX2
+
+    FINISH_SURROUND_DOWNMIX();
+}
+#endif
+
+#ifdef SDL_NEON_INTRINSICS
+static void SDL_ConvertSurroundDown_NEON(float *dst, const float *src, int num_frames, int src_channels, int dst_channels, const float *matrix)
+{
+    // The second half of each frame is loaded 4 floats wide and masked, so stop before that reads past the last frame.
+    static const int32_t lanes[4] = { 0, 1, 2, 3 };
+    const int safe_frames = num_frames - ((8 + src_channels - 1) / src_channels) + 1;
+    const uint32x4_t mask = vcgtq_s32(vdupq_n_s32(src_channels - 4), vld1q_s32(lanes));
+    float rows[2 * 8];
+    int i = 0, j, k;
+
+    LOG_DEBUG_AUDIO_CONVERT("surround", "stereo/mono (using NEON)");
+
+    SDL_assert((src_channels > 4) && (dst_channels <= 2));
+
+    SDL_zeroa(rows);
+    for (k = 0; k < dst_channels; k++) {
+        for (j = 0; j < src_channels; j++) {
+            rows[(k * 8) + j] = matrix[(k * src_channels) + j];
+        }
+    }
+
+    const float32x4_t row0_low = vld1q_f32(rows), row0_high = vld1q_f32(rows + 4);
+    const float32x4_t row1_low = vld1q_f32(rows + 8), row1_high = vld1q_f32(rows + 12);
+
+    // Each frame's products, already summed down to two lanes.
+    #define SURROUND_FRAME_SUMS_NEON(frame, low, high, result) { \
+        const float32x4_t products = vmlaq_f32(vmulq_f32(vld1q_f32(frame), low), vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vld1q_f32((frame) + 4)), mask)), high); \
+        result = vadd_f32(vget_low_f32(products), vget_high_f32(products)); \
+    }
+
+    if (dst_channels == 2) {
+        for (; i + 2 <= safe_frames; i += 2, src += src_channels * 2, dst += 4) {
+            float32x2_t left0, right0, left1, right1;
+            SURROUND_FRAME_SUMS_NEON(src, row0_low, row0_high, left0);
+            SURROUND_FRAME_SUMS_NEON(src, row1_low, row1_high, right0);
+            SURROUND_FRAME_SUMS_NEON(src + src_channels, row0_low, row0_high, left1);
+            SURROUND_FRAME_SUMS_NEON(src + src_channels, row1_low, row1_high, right1);
+            vst1q_f32(dst, vcombine_f32(vpadd_f32(left0, right0), vpadd_f32(left1, right1)));
+        }
+    } else {
+        for (; i + 4 <= safe_frames; i += 4, src += src_channels * 4, dst += 4) {
+            float32x2_t sum0, sum1, sum2, sum3;
+            SURROUND_FRAME_SUMS_NEON(src, row0_low, row0_high, sum0);
+            SURROUND_FRAME_SUMS_NEON(src + src_channels, row0_low, row0_high, sum1);
+            SURROUND_FRAME_SUMS_NEON(src + (src_channels * 2), row0_low, row0_high, sum2);
+            SURROUND_FRAME_SUMS_NEON(src + (src_channels * 3), row0_low, row0_high, sum3);
+            vst1q_f32(dst, vcombine_f32(vpadd_f32(sum0, sum1), vpadd_f32(sum2, sum3)));
+        }
+    }
+
+    #undef SURROUND_FRAME_SUMS_NEON
+
+    FINISH_SURROUND_DOWNMIX();
+}
+#endif
+
+#undef FINISH_SURROUND_DOWNMIX
+
+// This pointer gets set during SDL_ChooseAudioChannelConverters() to a SIMD implementation, or NULL to use the generated converters.
+static void (*SDL_ConvertSurroundDown)(float *dst, const float *src, int num_frames, int src_channels, int dst_channels, const float *matrix);
+
+void SDL_ChooseAudioChannelConverters(void)
+{
+    static SDL_bool converters_chosen = SDL_FALSE;
+    if (converters_chosen) {
+        return;
+    }
+
+#ifdef SDL_SSE3_INTRINSICS
+    if (SDL_HasSSE3()) {
+        SDL_ConvertSurroundDown = SDL_ConvertSurroundDown_SSE3;
+    }
+#endif
+
+#ifdef SDL_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        SDL_ConvertSurroundDown = SDL_ConvertSurroundDown_AVX2;
+    }
+#endif
+
+#ifdef SDL_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        SDL_ConvertSurroundDown = SDL_ConvertSurroundDown_NEON;
+    }
+#endif
+
+    converters_chosen = SDL_TRUE;
+}
 
 static void AudioConvertByteswap(void *dst, const void *src, int num_samples, int bitsize)
 {
@@ -161,30 +365,6 @@ static void AudioConvertByteswap(void *dst, const void *src, int num_samples, in
     }
 }
 
-static void AudioConvertToFloat(float *dst, const void *src, int num_samples, SDL_AudioFormat src_fmt)
-{
-    // Endian conversion is handled separately
-    switch (src_fmt & ~SDL_AUDIO_MASK_BIG_ENDIAN) {
-        case SDL_AUDIO_S8: SDL_Convert_S8_to_F32(dst, (const Sint8 *) src, num_samples); break;
-        case SDL_AUDIO_U8: SDL_Convert_U8_to_F32(dst, (const Uint8 *) src, num_samples); break;
-        case SDL_AUDIO_S16LE: SDL_Convert_S16_to_F32(dst, (const Sint16 *) src, num_samples); break;
-        case SDL_AUDIO_S32LE: SDL_Convert_S32_to_F32(dst, (const Sint32 *) src, num_samples); break;
-        default: SDL_assert(!"Unexpected audio format!"); break;
-    }
-}
-
-static void AudioConvertFromFloat(void *dst, const float *src, int num_samples, SDL_AudioFormat dst_fmt)
-{
-    // Endian conversion is handled separately
-    switch (dst_fmt & ~SDL_AUDIO_MASK_BIG_ENDIAN) {
-        case SDL_AUDIO_S8: SDL_Convert_F32_to_S8((Sint8 *) dst, src, num_samples); break;
-        case SDL_AUDIO_U8: SDL_Convert_F32_to_U8((Uint8 *) dst, src, num_samples); break;
-        case SDL_AUDIO_S16LE: SDL_Convert_F32_to_S16((Sint16 *) dst, src, num_samples); break;
-        case SDL_AUDIO_S32LE: SDL_Convert_F32_to_S32((Sint32 *) dst, src, num_samples); break;
-        default: SDL_assert(!"Unexpected audio format!"); break;
-    }
-}
-
 static SDL_bool SDL_IsSupportedAudioFormat(const SDL_AudioFormat fmt)
 {
     switch (fmt) {
@@ -211,36 +391,99 @@ static SDL_bool SDL_IsSupportedChannelCount(const int channels)
 }
 
 
-// This does type and channel conversions _but not resampling_ (resampling happens in SDL_AudioStream).
+// Calculate the largest frame size needed to convert between the two formats.
+static int CalculateMaxFrameSize(SDL_AudioFormat src_format, int src_channels, SDL_AudioFormat dst_format, int dst_channels)
+{
+    const int src_format_size = SDL_AUDIO_BYTESIZE(src_format);
+    const int dst_format_size = SDL_AUDIO_BYTESIZE(dst_format);
+    const int max_app_format_size = SDL_max(src_format_size, dst_format_size);
+    const int max_format_size = SDL_max(max_app_format_size, sizeof (float));  // ConvertAudio and ResampleAudio use floats.
+    const int max_channels = SDL_max(src_channels, dst_channels);
+    return max_format_size * max_channels;
+}
+
+// The steps a conversion plan can be made of. These all have to work in-place, too.
+static void ConvertStepCopy(const SDL_AudioConvertStep *step, void *dst, const void *src, int num_frames)
+{
+    if (src != dst) {
+        SDL_memcpy(dst, src, num_frames * step->frame_size);
+    }
+}
+
+static void ConvertStepByteswap16(const SDL_AudioConvertStep *step, void *dst, const void *src, int num_frames)
+{
+    AudioConvertByteswap(dst, src, num_frames * step->src_channels, 16);
+}
+
+static void ConvertStepByteswap32(const SDL_AudioConvertStep *step, void *dst, const void *src, int num_frames)
+{
+    AudioConvertByteswap(dst, src, num_frames * step->src_channels, 32);
+}
+
+#define CONVERT_STEP_TO_FLOAT(fmt, type) \
+    static void ConvertStep##fmt##ToFloat(const SDL_AudioConvertStep *step, void *dst, const void *src, int num_frames) \
+    { \
+        SDL_Convert_##fmt##_to_F32((float *) dst, (const type *) src, num_frames * step->src_channels); \
+    }
+
+#define CONVERT_STEP_FROM_FLOAT(fmt, type) \
+    static void ConvertStepFloatTo##fmt(const SDL_AudioConvertStep *step, void *dst, const void *src, int num_frames) \
+    { \
+        SDL_Convert_F32_to_##fmt((type *) dst, (const float *) src, num_frames * step->src_channels); \
+    }
+
+CONVERT_STEP_TO_FLOAT(S8, Sint8)
+CONVERT_STEP_TO_FLOAT(U8, Uint8)
+CONVERT_STEP_TO_FLOAT(S16, Sint16)
+CONVERT_STEP_TO_FLOAT(S32, Sint32)
+CONVERT_STEP_FROM_FLOAT(S8, Sint8)
+CONVERT_STEP_FROM_FLOAT(U8, Uint8)
+CONVERT_STEP_FROM_FLOAT(S16, Sint16)
+CONVERT_STEP_FROM_FLOAT(S32, Sint32)
+
+#undef CONVERT_STEP_TO_FLOAT
+#undef CONVERT_STEP_FROM_FLOAT
+
+static void ConvertStepChannels(const SDL_AudioConvertStep *step, void *dst, const void *src, int num_frames)
+{
+    step->channel_converter((float *) dst, (const float *) src, num_frames);
+}
+
+static void ConvertStepSurroundDown(const SDL_AudioConvertStep *step, void *dst, const void *src, int num_frames)
+{
+    SDL_ConvertSurroundDown((float *) dst, (const float *) src, num_frames, step->src_channels, step->dst_channels, step->matrix);
+}
+
+static SDL_AudioConvertStep *AddAudioConvertStep(SDL_AudioConvertPlan *plan, void (*convert)(const SDL_AudioConvertStep *, void *, const void *, int), int channels, SDL_bool to_scratch)
+{
+    SDL_assert(plan->num_steps < SDL_arraysize(plan->steps));
+    SDL_AudioConvertStep *step = &plan->steps[plan->num_steps++];
+    SDL_zerop(step);
+    step->convert = convert;
+    step->src_channels = step->dst_channels = channels;
+    step->to_scratch = to_scratch;
+    return step;
+}
+
+// Decide how to do type and channel conversions between two formats, so RunAudioConvertPlan can just do them.
 // This does not check parameter validity, (beyond asserts), it expects you did that already!
-// All of this has to function as if src==dst==scratch (conversion in-place), but as a convenience
-// if you're just going to copy the final output elsewhere, you can specify a different output pointer.
-//
-// The scratch buffer must be able to store `num_frames * CalculateMaxSampleFrameSize(src_format, src_channels, dst_format, dst_channels)` bytes.
-// If the scratch buffer is NULL, this restriction applies to the output buffer instead.
-void ConvertAudio(int num_frames, const void *src, SDL_AudioFormat src_format, int src_channels,
-                  void *dst, SDL_AudioFormat dst_format, int dst_channels, void* scratch)
+void BuildAudioConvertPlan(SDL_AudioConvertPlan *plan, SDL_AudioFormat src_format, int src_channels, SDL_AudioFormat dst_format, int dst_channels)
 {
-    SDL_assert(src != NULL);
-    SDL_assert(dst != NULL);
     SDL_assert(SDL_IsSupportedAudioFormat(src_format));
     SDL_assert(SDL_IsSupportedAudioFormat(dst_format));
     SDL_assert(SDL_IsSupportedChannelCount(src_channels));
     SDL_assert(SDL_IsSupportedChannelCount(dst_channels));
 
-    if (!num_frames) {
-        return;  // no data to convert, quit.
-    }
-
 #if DEBUG_AUDIO_CONVERT
     SDL_Log("SDL_AUDIO_CONVERT: Convert format %04x->%04x, channels %u->%u", src_format, dst_format, src_channels, dst_channels);
 #endif
 
+    SDL_zerop(plan);
+    plan->max_frame_size = CalculateMaxFrameSize(src_format, src_channels, dst_format, dst_channels);
+
     const int src_bitsize = (int) SDL_AUDIO_BITSIZE(src_format);
     const int dst_bitsize = (int) SDL_AUDIO_BITSIZE(dst_format);
 
-    const int dst_sample_frame_size = (dst_bitsize / 8) * dst_channels;
-
     /* Type conversion goes like this now:
         - byteswap to CPU native format first if necessary.
         - convert to native Float32 if necessary.
@@ -257,31 +500,20 @@ void ConvertAudio(int num_frames, const void *src, SDL_AudioFormat src_format, i
 
     // see if we can skip float conversion entirely.
     if (src_channels == dst_channels) {
-        if (src_format == dst_format) {
-            // nothing to do, we're already in the right format, just copy it over if necessary.
-            if (src != dst) {
-                SDL_memcpy(dst, src, num_frames * dst_sample_frame_size);
-            }
+        // nothing to do if we're already in the right format (or it's a byteswap of a 1-byte format), just copy it over if necessary.
+        const SDL_bool same_type = (src_format & ~SDL_AUDIO_MASK_BIG_ENDIAN) == (dst_format & ~SDL_AUDIO_MASK_BIG_ENDIAN);
+        if ((src_format == dst_format) || (same_type && (src_bitsize == 8))) {
+            AddAudioConvertStep(plan, ConvertStepCopy, dst_channels, SDL_FALSE)->frame_size = (dst_bitsize / 8) * dst_channels;
             return;
         }
 
         // just a byteswap needed?
-        if ((src_format & ~SDL_AUDIO_MASK_BIG_ENDIAN) == (dst_format & ~SDL_AUDIO_MASK_BIG_ENDIAN)) {
-            if (src_bitsize == 8) {
-                if (src != dst) {
-                    SDL_memcpy(dst, src, num_frames * dst_sample_frame_size);
-                }
-                return;  // nothing to do, it's a 1-byte format.
-            }
-            AudioConvertByteswap(dst, src, num_frames * src_channels, src_bitsize);
+        if (same_type) {
+            AddAudioConvertStep(plan, (src_bitsize == 16) ? ConvertStepByteswap16 : ConvertStepByteswap32, src_channels, SDL_FALSE);
             return;  // all done.
         }
     }
 
-    if (!scratch) {
-        scratch = dst;
-    }
-
     const SDL_bool srcbyteswap = (SDL_AUDIO_ISBIGENDIAN(src_format) != 0) == (SDL_BYTEORDER == SDL_LIL_ENDIAN) && (src_bitsize > 8);
     const SDL_bool srcconvert = !SDL_AUDIO_ISFLOAT(src_format);
     const SDL_bool channelconvert = src_channels != dst_channels;
@@ -291,15 +523,21 @@ void ConvertAudio(int num_frames, const void *src, SDL_AudioFormat src_format, i
     // make sure we're in native byte order.
     if (srcbyteswap) {
         // No point writing straight to dst. If we only need a byteswap, we wouldn't be bere.
-        AudioConvertByteswap(scratch, src, num_frames * src_channels, src_bitsize);
-        src = scratch;
+        AddAudioConvertStep(plan, (src_bitsize == 16) ? ConvertStepByteswap16 : ConvertStepByteswap32, src_channels, SDL_TRUE);
     }
 
     // get us to float format.
     if (srcconvert) {
-        void* buf = (channelconvert || dstconvert || dstbyteswap) ? scratch : dst;
-        AudioConvertToFloat((float *) buf, src, num_frames * src_channels, src_format);
-        src = buf;
+        void (*convert)(const SDL_AudioConvertStep *, void *, const void *, int) = NULL;
+        // Endian conversion is handled separately
+        switch (src_format & ~SDL_AUDIO_MASK_BIG_ENDIAN) {
+            case SDL_AUDIO_S8: convert = ConvertStepS8ToFloat; break;
+            case SDL_AUDIO_U8: convert = ConvertStepU8ToFloat; break;
+            case SDL_AUDIO_S16LE: convert = ConvertStepS16ToFloat; break;
+            case SDL_AUDIO_S32LE: convert = ConvertStepS32ToFloat; break;
+            default: SDL_assert(!"Unexpected audio format!"); break;
+        }
+        AddAudioConvertStep(plan, convert, src_channels, channelconvert || dstconvert || dstbyteswap);
     }
 
     // Channel conversion
@@ -307,6 +545,7 @@ void ConvertAudio(int num_frames, const void *src, SDL_AudioFormat src_format, i
     if (channelconvert) {
         SDL_AudioChannelConverter channel_converter;
         SDL_AudioChannelConverter override = NULL;
+        SDL_AudioConvertStep *step;
 
         // SDL_IsSupportedChannelCount should have caught these asserts, or we added a new format and forgot to update the table.
         SDL_assert(src_channels <= SDL_arraysize(channel_converters));
@@ -326,41 +565,80 @@ void ConvertAudio(int num_frames, const void *src, SDL_AudioFormat src_format, i
             #endif
         }
 
-        if (override) {
-            channel_converter = override;
+        if (!override && SDL_ConvertSurroundDown && (dst_channels <= 2) && (src_channels > ((dst_channels == 1) ? 4 : 5))) {
+            step = AddAudioConvertStep(plan, ConvertStepSurroundDown, src_channels, dstconvert || dstbyteswap);
+            step->matrix = channel_converter_matrices[src_channels - 1][dst_channels - 1];
+        } else {
+            step = AddAudioConvertStep(plan, ConvertStepChannels, src_channels, dstconvert || dstbyteswap);
+            step->channel_converter = override ? override : channel_converter;
         }
-
-        void* buf = (dstconvert || dstbyteswap) ? scratch : dst;
-        channel_converter((float *) buf, (const float *) src, num_frames);
-        src = buf;
+        step->dst_channels = dst_channels;
     }
 
     // Resampling is not done in here. SDL_AudioStream handles that.
 
     // Move to final data type.
     if (dstconvert) {
-        AudioConvertFromFloat(dst, (const float *) src, num_frames * dst_channels, dst_format);
-        src = dst;
+        void (*convert)(const SDL_AudioConvertStep *, void *, const void *, int) = NULL;
+        // Endian conversion is handled separately
+        switch (dst_format & ~SDL_AUDIO_MASK_BIG_ENDIAN) {
+            case SDL_AUDIO_S8: convert = ConvertStepFloatToS8; break;
+            case SDL_AUDIO_U8: convert = ConvertStepFloatToU8; break;
+            case SDL_AUDIO_S16LE: convert = ConvertStepFloatToS16; break;
+            case SDL_AUDIO_S32LE: convert = ConvertStepFloatToS32; break;
+            default: SDL_assert(!"Unexpected audio format!"); break;
+        }
+        AddAudioConvertStep(plan, convert, dst_channels, SDL_FALSE);
     }
 
     // make sure we're in final byte order.
     if (dstbyteswap) {
-        AudioConvertByteswap(dst, src, num_frames * dst_channels, dst_bitsize);
-        src = dst;  // we've written to dst, future work will convert in-place.
+        AddAudioConvertStep(plan, (dst_bitsize == 16) ? ConvertStepByteswap16 : ConvertStepByteswap32, dst_channels, SDL_FALSE);
     }
 
-    SDL_assert(src == dst);  // if we got here, we _had_ to have done _something_. Otherwise, we should have memcpy'd!
+    SDL_assert(!plan->steps[plan->num_steps - 1].to_scratch);  // the last step _has_ to write to dst.
 }
 
-// Calculate the largest frame size needed to convert between the two formats.
-static int CalculateMaxFrameSize(SDL_AudioFormat src_format, int src_channels, SDL_AudioFormat dst_format, int dst_channels)
+// All of this has to function as if src==dst==scratch (conversion in-place), but as a convenience
+// if you're just going to copy the final output elsewhere, you can specify a different output pointer.
+//
+// The scratch buffer must be able to store `num_frames * plan->max_frame_size` bytes.
+// If the scratch buffer is NULL, this restriction applies to the output buffer instead.
+void RunAudioConvertPlan(const SDL_AudioConvertPlan *plan, int num_frames, const void *src, void *dst, void *scratch)
 {
-    const int src_format_size = SDL_AUDIO_BYTESIZE(src_format);
-    const int dst_format_size = SDL_AUDIO_BYTESIZE(dst_format);
-    const int max_app_format_size = SDL_max(src_format_size, dst_format_size);
-    const int max_format_size = SDL_max(max_app_format_size, sizeof (float));  // ConvertAudio and ResampleAudio use floats.
-    const int max_channels = SDL_max(src_channels, dst_channels);
-    return max_format_size * max_channels;
+    SDL_assert(plan->num_steps > 0);
+    SDL_assert(src != NULL);
+    SDL_assert(dst != NULL);
+
+    if (!num_frames) {
+        return;  // no data to convert, quit.
+    }
+
+    if (!scratch) {
+        scratch = dst;
+    }
+
+    for (int i = 0; i < plan->num_steps; i++) {
+        const SDL_AudioConvertStep *step = &plan->steps[i];
+        void *buf = step->to_scratch ? scratch : dst;
+        step->convert(step, buf, src, num_frames);
+        src = buf;
+    }
+}
+
+// This does type and channel conversions _but not resampling_ (resampling happens in SDL_AudioStream).
+// SDL_AudioStream keeps plans for its conversions; this builds a new one every time, for one-off conversions.
+// All of this has to function as if src==dst==scratch (conversion in-place), but as a convenience
+// if you're just going to copy the final output elsewhere, you can specify a different output pointer.
+//
+// The scratch buffer must be able to store `num_frames * CalculateMaxSampleFrameSize(src_format, src_channels, dst_format, dst_channels)` bytes.
+// If the scratch buffer is NULL, this restriction applies to the output buffer instead.
+void ConvertAudio(int num_frames, const void *src, SDL_AudioFormat src_format, int src_channels,
+                  void *dst, SDL_AudioFormat dst_format, int dst_channels, void* scratch)
+{
+    SDL_AudioConvertPlan plan;
+    BuildAudioConvertPlan(&plan, src_format, src_channels, dst_format, dst_channels);
+    RunAudioConvertPlan(&plan, num_frames, src, dst, scratch);
 }
 
 static Sint64 GetAudioStreamResampleRate(SDL_AudioStream* stream, int src_freq, Sint64 resample_offset)
@@ -377,13 +655,55 @@ static Sint64 GetAudioStreamResampleRate(SDL_AudioStream* stream, int src_freq,
     return resample_rate;
 }
 
+void UpdateAudioStreamConvertPlans(SDL_AudioStream *stream)
+{
+    const SDL_AudioSpec *src_spec = &stream->input_spec;
+    const SDL_AudioSpec *dst_spec = &stream->dst_spec;
+
+    if (!src_spec->format || !dst_spec->format) {
+        SDL_zero(stream->convert_plan);
+        SDL_zero(stream->resample_input_plan);
+        SDL_zero(stream->resample_output_plan);
+        return;
+    }
+
+    // If increasing channels, do it after resampling, since we'd just
+    // do more work to resample duplicate channels. If we're decreasing, do
+    // it first so we resample the interpolated data instead of interpolating
+    // the resampled data.
+    const int resample_channels = SDL_min(src_spec->channels, dst_spec->channels);
+
+    BuildAudioConvertPlan(&stream->convert_plan, src_spec->format, src_spec->channels, dst_spec->format, dst_spec->channels);
+    BuildAudioConvertPlan(&stream->resample_input_plan, src_spec->format, src_spec->channels, SDL_AUDIO_F32, resample_channels);
+    BuildAudioConvertPlan(&stream->resample_output_plan, SDL_AUDIO_F32, resample_channels, dst_spec->format, dst_spec->channels);
+}
+
+void UpdateAudioStreamRingFrameSize(SDL_AudioStream *stream)
+{
+    // The lock-free path can't call the put callback, and can't check the formats without racing whoever changes them.
+    const SDL_bool usable = stream->ring && !stream->put_callback && stream->src_spec.format && stream->dst_spec.format;
+    SDL_AtomicSet(&stream->ring_frame_size, usable ? SDL_AUDIO_FRAMESIZE(stream->src_spec) : 0);
+}
+
+void UpdateAudioStreamUnityGains(SDL_AudioStream *stream)
+{
+    int unity = 1;
+    for (int i = 0; i < SDL_MAX_AUDIO_CHANNELS; i++) {
+        if (((stream->gain * stream->channel_gains[i]) != 1.0f) || (stream->mixed_gains[i] != 1.0f)) {
+            unity = 0;
+            break;
+        }
+    }
+    SDL_AtomicSet(&stream->unity_gains, unity);
+}
+
 static int UpdateAudioStreamInputSpec(SDL_AudioStream *stream, const SDL_AudioSpec *spec)
 {
     if (AUDIO_SPECS_EQUAL(stream->input_spec, *spec)) {
         return 0;
     }
 
-    const size_t history_buffer_allocation = SDL_GetResamplerHistoryFrames() * SDL_AUDIO_FRAMESIZE(*spec);
+    const size_t history_buffer_allocation = SDL_GetResamplerHistoryFrames(stream->resampler_quality) * SDL_AUDIO_FRAMESIZE(*spec);
     Uint8 *history_buffer = stream->history_buffer;
 
     if (stream->history_buffer_allocation < history_buffer_allocation) {
@@ -398,13 +718,122 @@ static int UpdateAudioStreamInputSpec(SDL_AudioStream *stream, const SDL_AudioSp
 
     SDL_memset(history_buffer, SDL_GetSilenceValueForFormat(spec->format), history_buffer_allocation);
     SDL_copyp(&stream->input_spec, spec);
+    UpdateAudioStreamConvertPlans(stream);
 
     return 0;
 }
 
+// Picks up changes to the stream's "SDL.audiostream.resampler_quality" property, resizing the history buffer to match.
+static int UpdateAudioStreamResamplerQuality(SDL_AudioStream *stream)
+{
+    SDL_AudioResamplerQuality quality = SDL_AUDIO_RESAMPLER_SINC;
+    if (stream->props) {
+        const Sint64 value = SDL_GetNumberProperty(stream->props, "SDL.audiostream.resampler_quality", SDL_AUDIO_RESAMPLER_SINC);
+        quality = (SDL_AudioResamplerQuality) SDL_clamp(value, SDL_AUDIO_RESAMPLER_NEAREST, SDL_AUDIO_RESAMPLER_SINC);
+    }
+
+    if (quality == stream->resampler_quality) {
+        return 0;
+    }
+
+    const int frame_size = SDL_AUDIO_FRAMESIZE(stream->input_spec);
+    Uint8 *history_buffer = stream->history_buffer;
+
+    if (history_buffer && frame_size) {
+        // Keep the most recent frames, and pad with silence if the history got longer.
+        const size_t old_history_bytes = SDL_GetResamplerHistoryFrames(stream->resampler_quality) * frame_size;
+        const size_t history_bytes = SDL_GetResamplerHistoryFrames(quality) * frame_size;
+        const Uint8 silence = SDL_GetSilenceValueForFormat(stream->input_spec.format);
+
+        if (history_bytes > stream->history_buffer_allocation) {
+            history_buffer = (Uint8 *) SDL_aligned_alloc(SDL_SIMDGetAlignment(), history_bytes);
+            if (!history_buffer) {
+                return SDL_OutOfMemory();
+            }
+            SDL_memcpy(history_buffer + (history_bytes - old_history_bytes), stream->history_buffer, old_history_bytes);
+            SDL_aligned_free(stream->history_buffer);
+            stream->history_buffer = history_buffer;
+            stream->history_buffer_allocation = history_bytes;
+            SDL_memset(history_buffer, silence, history_bytes - old_history_bytes);
+        } else if (history_bytes > old_history_bytes) {
+            SDL_memmove(history_buffer + (history_bytes - old_history_bytes), history_buffer, old_history_bytes);
+            SDL_memset(history_buffer, silence, history_bytes - old_history_bytes);
+        } else {
+            SDL_memmove(history_buffer, history_buffer + (old_history_bytes - history_bytes), history_bytes);
+        }
+    }
+
+    stream->resampler_quality = quality;
+
+    return 0;
+}
+
+// Picks up the stream's "SDL.audiostream.get_callback.*" and watermark properties. These can't fail, unlike the resampler quality.
+static void UpdateAudioStreamCallbackBatching(SDL_AudioStream *stream)
+{
+    if (!stream->props) {
+        return;  // nobody set any properties, so they're all still the defaults.
+    }
+
+    const Sint64 quantum = SDL_GetNumberProperty(stream->props, "SDL.audiostream.get_callback.quantum", 0);
+    const Sint64 prefetch = SDL_GetNumberProperty(stream->props, "SDL.audiostream.get_callback.prefetch", 0);
+    stream->get_callback_quantum = (int) SDL_clamp(quantum, 0, SDL_INT_MAX);
+    stream->get_callback_prefetch = (int) SDL_clamp(prefetch, 0, SDL_INT_MAX);
+    stream->get_callback_async = SDL_GetBooleanProperty(stream->props, "SDL.audiostream.get_callback.async", SDL_FALSE);
+    stream->low_watermark = SDL_GetNumberProperty(stream->props, "SDL.audiostream.low_watermark", 0);
+    stream->high_watermark = SDL_GetNumberProperty(stream->props, "SDL.audiostream.high_watermark", 0);
+}
+
+// Latches the stream's properties, if any properties were changed since the last time. You must hold stream->lock.
+// Looking properties up takes their locks, which the device thread shouldn't do every time it reads from the stream.
+static int UpdateAudioStreamProperties(SDL_AudioStream *stream)
+{
+    const Uint32 serial = SDL_GetPropertiesSerial();
+    if (serial == stream->props_serial) {
+        return 0;
+    }
+
+    UpdateAudioStreamCallbackBatching(stream);
+
+    if (UpdateAudioStreamResamplerQuality(stream) != 0) {
+        return -1;  // try again next time.
+    }
+
+    stream->props_serial = serial;
+    return 0;
+}
+
+// Queues an event each time the amount of queued input crosses one of the stream's watermarks. You must hold stream->lock.
+static void CheckAudioStreamWatermarks(SDL_AudioStream *stream)
+{
+    UpdateAudioStreamProperties(stream);  // if the resampler couldn't be updated, the get path will report it.
+
+    const Sint64 low = stream->low_watermark;
+    const Sint64 high = stream->high_watermark;
+    if ((low <= 0) && (high <= 0) && (stream->watermark_state == 0)) {
+        return;
+    }
+
+    const Sint64 queued = (Sint64) SDL_min(stream->total_bytes_queued, SDL_INT_MAX);
+    int state = 0;
+    if ((low > 0) && (queued < low)) {
+        state = -1;
+    } else if ((high > 0) && (queued >= high)) {
+        state = 1;
+    }
+
+    if (state != stream->watermark_state) {
+        stream->watermark_state = state;
+        if (state != 0) {
+            SDL_QueueAudioStreamWatermarkEvent(stream, (state < 0) ? SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK : SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK, (int) queued);
+        }
+    }
+}
+
 SDL_AudioStream *SDL_CreateAudioStream(const SDL_AudioSpec *src_spec, const SDL_AudioSpec *dst_spec)
 {
     SDL_ChooseAudioConverters();
+    SDL_ChooseAudioChannelConverters();
     SDL_SetupAudioResampler();
 
     SDL_AudioStream *retval = (SDL_AudioStream *)SDL_calloc(1, sizeof(SDL_AudioStream));
@@ -414,6 +843,14 @@ SDL_AudioStream *SDL_CreateAudioStream(const SDL_AudioSpec *src_spec, const SDL_
     }
 
     retval->freq_ratio = 1.0f;
+    retval->gain = 1.0f;
+    for (int i = 0; i < SDL_MAX_AUDIO_CHANNELS; i++) {
+        retval->channel_gains[i] = 1.0f;
+        retval->mixed_gains[i] = 1.0f;
+    }
+    SDL_AtomicSet(&retval->unity_gains, 1);
+    retval->resampler_quality = SDL_AUDIO_RESAMPLER_SINC;
+    retval->props_serial = SDL_GetPropertiesSerial();
     retval->queue = SDL_CreateAudioQueue(4096);
 
     if (!retval->queue) {
@@ -446,7 +883,11 @@ SDL_PropertiesID SDL_GetAudioStreamProperties(SDL_AudioStream *stream)
     }
     if (stream->props == 0) {
         stream->props = SDL_CreateProperties();
+        if (stream->props == 0) {
+            return 0;
+        }
     }
+
     return stream->props;
 }
 
@@ -470,6 +911,7 @@ int SDL_SetAudioStreamPutCallback(SDL_AudioStream *stream, SDL_AudioStreamCallba
     SDL_LockMutex(stream->lock);
     stream->put_callback = callback;
     stream->put_callback_userdata = userdata;
+    UpdateAudioStreamRingFrameSize(stream);
     SDL_UnlockMutex(stream->lock);
     return 0;
 }
@@ -516,6 +958,19 @@ int SDL_GetAudioStreamFormat(SDL_AudioStream *stream, SDL_AudioSpec *src_spec, S
     return 0;
 }
 
+// Hand anything the producer put in the single-producer ring buffer to the queue, which reads it straight out of the ring. You must hold stream->lock.
+static int DrainAudioStreamRing(SDL_AudioStream *stream)
+{
+    if (!stream->ring) {
+        return 0;
+    }
+
+    size_t moved = 0;
+    const int retval = SDL_MoveAudioRingToQueue(stream->ring, stream->queue, &stream->src_spec, &moved);
+    stream->total_bytes_queued += moved;
+    return retval;
+}
+
 int SDL_SetAudioStreamFormat(SDL_AudioStream *stream, const SDL_AudioSpec *src_spec, const SDL_AudioSpec *dst_spec)
 {
     if (!stream) {
@@ -566,13 +1021,21 @@ int SDL_SetAudioStreamFormat(SDL_AudioStream *stream, const SDL_AudioSpec *src_s
     }
 
     if (src_spec) {
+        // anything the producer already put in the ring buffer is in the old format.
+        if (DrainAudioStreamRing(stream) != 0) {
+            SDL_UnlockMutex(stream->lock);
+            return -1;
+        }
         SDL_copyp(&stream->src_spec, src_spec);
     }
 
     if (dst_spec) {
         SDL_copyp(&stream->dst_spec, dst_spec);
+        UpdateAudioStreamConvertPlans(stream);
     }
 
+    UpdateAudioStreamRingFrameSize(stream);
+
     SDL_UnlockMutex(stream->lock);
 
     return 0;
@@ -615,6 +1078,108 @@ int SDL_SetAudioStreamFrequencyRatio(SDL_AudioStream *stream, float freq_ratio)
     return 0;
 }
 
+float SDL_GetAudioStreamGain(SDL_AudioStream *stream)
+{
+    if (!stream) {
+        SDL_InvalidParamError("stream");
+        return -1.0f;
+    }
+
+    SDL_LockMutex(stream->lock);
+    const float gain = stream->gain;
+    SDL_UnlockMutex(stream->lock);
+
+    return gain;
+}
+
+int SDL_SetAudioStreamGain(SDL_AudioStream *stream, float gain)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (!(gain >= 0.0f)) {  // this catches NaN, too.
+        return SDL_InvalidParamError("gain");
+    }
+
+    SDL_LockMutex(stream->lock);
+    stream->gain = gain;
+    UpdateAudioStreamUnityGains(stream);
+    SDL_UnlockMutex(stream->lock);
+
+    return 0;
+}
+
+int SDL_GetAudioStreamChannelGains(SDL_AudioStream *stream, float *gains, int num_channels)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (!gains) {
+        return SDL_InvalidParamError("gains");
+    } else if ((num_channels < 1) || (num_channels > SDL_MAX_AUDIO_CHANNELS)) {
+        return SDL_InvalidParamError("num_channels");
+    }
+
+    SDL_LockMutex(stream->lock);
+    SDL_memcpy(gains, stream->channel_gains, num_channels * sizeof (float));
+    SDL_UnlockMutex(stream->lock);
+
+    return 0;
+}
+
+int SDL_SetAudioStreamChannelGains(SDL_AudioStream *stream, const float *gains, int num_channels)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (gains && ((num_channels < 1) || (num_channels > SDL_MAX_AUDIO_CHANNELS))) {
+        return SDL_InvalidParamError("num_channels");
+    }
+
+    for (int i = 0; gains && (i < num_channels); i++) {
+        if (!(gains[i] >= 0.0f)) {
+            return SDL_InvalidParamError("gains");
+        }
+    }
+
+    SDL_LockMutex(stream->lock);
+    for (int i = 0; i < SDL_MAX_AUDIO_CHANNELS; i++) {
+        stream->channel_gains[i] = (gains && (i < num_channels)) ? gains[i] : 1.0f;
+    }
+    UpdateAudioStreamUnityGains(stream);
+    SDL_UnlockMutex(stream->lock);
+
+    return 0;
+}
+
+int SDL_SetAudioStreamSingleProducer(SDL_AudioStream *stream, int buffer_size)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (buffer_size < 0) {
+        return SDL_InvalidParamError("buffer_size");
+    }
+
+    SDL_AudioRing *ring = NULL;
+    if (buffer_size > 0) {
+        ring = SDL_CreateAudioRing(buffer_size);
+        if (!ring) {
+            return -1;
+        }
+    }
+
+    SDL_LockMutex(stream->lock);
+    const int retval = DrainAudioStreamRing(stream);
+    if (retval == 0) {
+        SDL_AudioRing *old_ring = stream->ring;
+        stream->ring = ring;
+        ring = old_ring;
+        UpdateAudioStreamRingFrameSize(stream);
+    }
+    SDL_UnlockMutex(stream->lock);
+
+    SDL_DestroyAudioRing(ring);  // the old one, or the new one if we failed.
+
+    return retval;
+}
+
 static int CheckAudioStreamIsFullySetup(SDL_AudioStream *stream)
 {
     if (stream->src_spec.format == 0) {
@@ -642,6 +1207,17 @@ int SDL_PutAudioStreamData(SDL_AudioStream *stream, const void *buf, int len)
         return 0; // nothing to do.
     }
 
+    // In single-producer mode, only this thread changes the ring, so it's safe to look at without the lock.
+    // Everything else this needs to know is latched in ring_frame_size whenever it changes.
+    // Watermarks aren't checked here; the next locked put or read drains the ring and checks them.
+    const int ring_frame_size = SDL_AtomicGet(&stream->ring_frame_size);
+    if (ring_frame_size && ((len % ring_frame_size) == 0)) {
+        if (SDL_WriteToAudioRing(stream->ring, (const Uint8 *) buf, len)) {
+            return 0;
+        }
+        // didn't fit, so do it the slow way.
+    }
+
     SDL_LockMutex(stream->lock);
 
     if (CheckAudioStreamIsFullySetup(stream) != 0) {
@@ -654,6 +1230,12 @@ int SDL_PutAudioStreamData(SDL_AudioStream *stream, const void *buf, int len)
         return SDL_SetError("Can't add partial sample frames");
     }
 
+    // keep things in order: anything already in the ring buffer goes first.
+    if (DrainAudioStreamRing(stream) != 0) {
+        SDL_UnlockMutex(stream->lock);
+        return -1;
+    }
+
     SDL_AudioTrack* track = NULL;
 
     // When copying in large amounts of data, try and do as much work as possible
@@ -692,6 +1274,7 @@ int SDL_PutAudioStreamData(SDL_AudioStream *stream, const void *buf, int len)
             const int newavail = SDL_GetAudioStreamAvailable(stream) - prev_available;
             stream->put_callback(stream->put_callback_userdata, stream, newavail, newavail);
         }
+        CheckAudioStreamWatermarks(stream);
     }
 
     SDL_UnlockMutex(stream->lock);
@@ -699,6 +1282,59 @@ int SDL_PutAudioStreamData(SDL_AudioStream *stream, const void *buf, int len)
     return retval;
 }
 
+int SDL_PutAudioStreamDataNoCopy(SDL_AudioStream *stream, const void *buf, int len, SDL_AudioStreamDataCompleteCallback callback, void *userdata)
+{
+#if DEBUG_AUDIOSTREAM
+    SDL_Log("AUDIOSTREAM: wants to put %d bytes without copying", len);
+#endif
+
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (!buf) {
+        return SDL_InvalidParamError("buf");
+    } else if (len < 0) {
+        return SDL_InvalidParamError("len");
+    } else if (len == 0) {
+        if (callback) {
+            callback(userdata, buf, len);  // nothing to do, and we're already done with it.
+        }
+        return 0;
+    }
+
+    SDL_LockMutex(stream->lock);
+
+    if (CheckAudioStreamIsFullySetup(stream) != 0) {
+        SDL_UnlockMutex(stream->lock);
+        return -1;
+    }
+
+    if ((len % SDL_AUDIO_FRAMESIZE(stream->src_spec)) != 0) {
+        SDL_UnlockMutex(stream->lock);
+        return SDL_SetError("Can't add partial sample frames");
+    }
+
+    SDL_AudioTrack *track = (DrainAudioStreamRing(stream) == 0) ? SDL_CreateReferencedAudioTrack(&stream->src_spec, (const Uint8 *) buf, len, callback, userdata) : NULL;
+    if (!track) {
+        SDL_UnlockMutex(stream->lock);
+        return -1;
+    }
+
+    const int prev_available = stream->put_callback ? SDL_GetAudioStreamAvailable(stream) : 0;
+
+    SDL_AddTrackToAudioQueue(stream->queue, track);
+
+    stream->total_bytes_queued += len;
+    if (stream->put_callback) {
+        const int newavail = SDL_GetAudioStreamAvailable(stream) - prev_available;
+        stream->put_callback(stream->put_callback_userdata, stream, newavail, newavail);
+    }
+    CheckAudioStreamWatermarks(stream);
+
+    SDL_UnlockMutex(stream->lock);
+
+    return 0;
+}
+
 int SDL_FlushAudioStream(SDL_AudioStream *stream)
 {
     if (!stream) {
@@ -706,10 +1342,11 @@ int SDL_FlushAudioStream(SDL_AudioStream *stream)
     }
 
     SDL_LockMutex(stream->lock);
+    const int retval = DrainAudioStreamRing(stream);
     SDL_FlushAudioQueue(stream->queue);
     SDL_UnlockMutex(stream->lock);
 
-    return 0;
+    return retval;
 }
 
 /* this does not save the previous contents of stream->work_buffer. It's a work buffer!!
@@ -735,7 +1372,7 @@ static Uint8 *EnsureAudioStreamWorkBufferSize(SDL_AudioStream *stream, size_t ne
 static void UpdateAudioStreamHistoryBuffer(SDL_AudioStream* stream,
     Uint8* input_buffer, int input_bytes, Uint8* left_padding, int padding_bytes)
 {
-    const int history_buffer_frames = SDL_GetResamplerHistoryFrames();
+    const int history_buffer_frames = SDL_GetResamplerHistoryFrames(stream->resampler_quality);
 
     // Even if we aren't currently resampling, we always need to update the history buffer
     Uint8 *history_buffer = stream->history_buffer;
@@ -788,7 +1425,7 @@ static Sint64 NextAudioStreamIter(SDL_AudioStream* stream, void** inout_iter,
         // Past the end of the track, the right padding is filled with silence.
         // But we only want to do that if the track is actually finished (flushed).
         if (!flushed) {
-            output_frames -= SDL_GetResamplerPaddingFrames(resample_rate);
+            output_frames -= SDL_GetResamplerPaddingFrames(resample_rate, stream->resampler_quality);
         }
 
         output_frames = SDL_GetResamplerOutputFrames(output_frames, resample_rate, &resample_offset);
@@ -845,6 +1482,32 @@ static Sint64 GetAudioStreamHead(SDL_AudioStream* stream, SDL_AudioSpec* out_spe
     return NextAudioStreamIter(stream, &iter, &resample_offset, out_spec, out_flushed);
 }
 
+SDL_bool SDL_IsAudioStreamWaitingForData(SDL_AudioStream *stream, int frames)
+{
+    if (stream->get_callback) {
+        return SDL_FALSE;  // it'll make its own data when asked.
+    }
+
+    DrainAudioStreamRing(stream);  // if this fails, the producer's data will still be there next time.
+
+    void *iter = SDL_BeginAudioQueueIter(stream->queue);
+    Sint64 resample_offset = stream->resample_offset;
+    Sint64 available_frames = 0;
+
+    while (iter) {
+        SDL_AudioSpec spec;
+        SDL_bool flushed;
+        available_frames += NextAudioStreamIter(stream, &iter, &resample_offset, &spec, &flushed);
+
+        // a flushed track has to play out what it has, even if that doesn't fill the request.
+        if (flushed || (available_frames >= frames)) {
+            return SDL_FALSE;
+        }
+    }
+
+    return SDL_TRUE;
+}
+
 // You must hold stream->lock and validate your parameters before calling this!
 // Enough input data MUST be available!
 static int GetAudioStreamDataInternal(SDL_AudioStream *stream, void *buf, int output_frames)
@@ -859,7 +1522,7 @@ static int GetAudioStreamDataInternal(SDL_AudioStream *stream, void *buf, int ou
     const SDL_AudioFormat dst_format = dst_spec->format;
     const int dst_channels = dst_spec->channels;
 
-    const int max_frame_size = CalculateMaxFrameSize(src_format, src_channels, dst_format, dst_channels);
+    const int max_frame_size = stream->convert_plan.max_frame_size;
     const Sint64 resample_rate = GetAudioStreamResampleRate(stream, src_spec->freq, stream->resample_offset);
 
 #if DEBUG_AUDIOSTREAM
@@ -897,7 +1560,7 @@ static int GetAudioStreamDataInternal(SDL_AudioStream *stream, void *buf, int ou
 
         // Convert the data, if necessary
         if (buf != input_buffer) {
-            ConvertAudio(output_frames, input_buffer, src_format, src_channels, buf, dst_format, dst_channels, input_buffer);
+            RunAudioConvertPlan(&stream->convert_plan, output_frames, input_buffer, buf, input_buffer);
         }
 
         return 0;
@@ -911,7 +1574,7 @@ static int GetAudioStreamDataInternal(SDL_AudioStream *stream, void *buf, int ou
     const int input_frames = (int) SDL_GetResamplerInputFrames(output_frames, resample_rate, stream->resample_offset);
     const int input_bytes = input_frames * src_frame_size;
 
-    const int resampler_padding_frames = SDL_GetResamplerPaddingFrames(resample_rate);
+    const int resampler_padding_frames = SDL_GetResamplerPaddingFrames(resample_rate, stream->resampler_quality);
 
     // If increasing channels, do it after resampling, since we'd just
     // do more work to resample duplicate channels. If we're decreasing, do
@@ -930,7 +1593,7 @@ static int GetAudioStreamDataInternal(SDL_AudioStream *stream, void *buf, int ou
     // ResampleAudio also requires an additional buffer if it can't write straight to the output:
     //   resample_frame_size * output_frames
     //
-    // Note, ConvertAudio requires (num_frames * max_sample_frame_size) of scratch space
+    // Note, RunAudioConvertPlan requires (num_frames * max_sample_frame_size) of scratch space
     const int work_buffer_frames = input_frames + (resampler_padding_frames * 2);
     int work_buffer_capacity = work_buffer_frames * max_frame_size;
     int resample_buffer_offset = -1;
@@ -993,7 +1656,7 @@ static int GetAudioStreamDataInternal(SDL_AudioStream *stream, void *buf, int ou
     SDL_assert(work_buffer_frames == input_frames + (resampler_padding_frames * 2));
 
     // Resampling! get the work buffer to float32 format, etc, in-place.
-    ConvertAudio(work_buffer_frames, work_buffer, src_format, src_channels, work_buffer, SDL_AUDIO_F32, resample_channels, NULL);
+    RunAudioConvertPlan(&stream->resample_input_plan, work_buffer_frames, work_buffer, work_buffer, NULL);
 
     // Update the work_buffer pointers based on the new frame size
     input_buffer = work_buffer + ((input_buffer - work_buffer) / src_frame_size * resample_frame_size);
@@ -1003,14 +1666,28 @@ static int GetAudioStreamDataInternal(SDL_AudioStream *stream, void *buf, int ou
     // Decide where the resampled output goes
     void* resample_buffer = (resample_buffer_offset != -1) ? (work_buffer + resample_buffer_offset) : buf;
 
-    SDL_ResampleAudio(resample_channels,
-                  (const float *) input_buffer, input_frames,
-                  (float*) resample_buffer, output_frames,
-                  resample_rate, &stream->resample_offset);
+    // Rates with a small rational ratio (44100Hz <-> 48000Hz, etc) can use a precomputed filter bank, unless the ratio is being nudged.
+    SDL_ResamplerPolyphase *polyphase = &stream->polyphase;
+    const SDL_bool use_polyphase = (stream->resampler_quality == SDL_AUDIO_RESAMPLER_SINC) && (stream->freq_ratio == 1.0f);
+    if (use_polyphase && ((polyphase->src_rate != src_spec->freq) || (polyphase->dst_rate != dst_spec->freq))) {
+        SDL_SetupResamplerPolyphase(polyphase, src_spec->freq, dst_spec->freq);
+    }
+
+    if (use_polyphase && polyphase->filters) {
+        SDL_ResampleAudioPolyphase(polyphase, resample_channels,
+                      (const float *) input_buffer, input_frames,
+                      (float*) resample_buffer, output_frames,
+                      &stream->resample_offset);
+    } else {
+        SDL_ResampleAudio(resample_channels,
+                      (const float *) input_buffer, input_frames,
+                      (float*) resample_buffer, output_frames,
+                      resample_rate, stream->resampler_quality, &stream->resample_offset);
+    }
 
     // Convert to the final format, if necessary
     if (buf != resample_buffer) {
-        ConvertAudio(output_frames, resample_buffer, SDL_AUDIO_F32, resample_channels, buf, dst_format, dst_channels, work_buffer);
+        RunAudioConvertPlan(&stream->resample_output_plan, output_frames, resample_buffer, buf, work_buffer);
     }
 
     return 0;
@@ -1037,7 +1714,7 @@ int SDL_GetAudioStreamData(SDL_AudioStream *stream, void *voidbuf, int len)
 
     SDL_LockMutex(stream->lock);
 
-    if (CheckAudioStreamIsFullySetup(stream) != 0) {
+    if ((CheckAudioStreamIsFullySetup(stream) != 0) || (UpdateAudioStreamProperties(stream) != 0) || (DrainAudioStreamRing(stream) != 0)) {
         SDL_UnlockMutex(stream->lock);
         return -1;
     }
@@ -1065,7 +1742,28 @@ int SDL_GetAudioStreamData(SDL_AudioStream *stream, void *voidbuf, int len)
 
         total_request *= SDL_AUDIO_FRAMESIZE(stream->src_spec);  // convert sample frames to bytes.
         additional_request *= SDL_AUDIO_FRAMESIZE(stream->src_spec);  // convert sample frames to bytes.
-        stream->get_callback(stream->get_callback_userdata, stream, (int) SDL_min(additional_request, SDL_INT_MAX), (int) SDL_min(total_request, SDL_INT_MAX));
+
+        if (!stream->get_callback_quantum && !stream->get_callback_prefetch && !stream->get_callback_async) {
+            stream->get_callback(stream->get_callback_userdata, stream, (int) SDL_min(additional_request, SDL_INT_MAX), (int) SDL_min(total_request, SDL_INT_MAX));
+        } else {
+            // Batched: only bother the callback when this read comes up short or the queue is below the prefetch watermark, and then ask for plenty.
+            additional_request = SDL_max(additional_request, ((Sint64) stream->get_callback_prefetch) - ((Sint64) stream->total_bytes_queued));
+            if (additional_request > 0) {
+                additional_request = SDL_max(additional_request, stream->get_callback_quantum);
+                total_request = SDL_max(total_request, additional_request);
+                const int additional_amount = (int) SDL_min(additional_request, SDL_INT_MAX);
+                const int total_amount = (int) SDL_min(total_request, SDL_INT_MAX);
+                if (!stream->get_callback_async || !SDL_RequestAudioStreamPrefetch(stream, additional_amount, total_amount)) {
+                    stream->get_callback(stream->get_callback_userdata, stream, additional_amount, total_amount);
+                }
+            }
+        }
+
+        // the producer might have been busy while the callback ran.
+        if (DrainAudioStreamRing(stream) != 0) {
+            SDL_UnlockMutex(stream->lock);
+            return -1;
+        }
     }
 
     // Process the data in chunks to avoid allocating too much memory (and potential integer overflows)
@@ -1109,6 +1807,8 @@ int SDL_GetAudioStreamData(SDL_AudioStream *stream, void *voidbuf, int len)
         total += output_frames * dst_frame_size;
     }
 
+    CheckAudioStreamWatermarks(stream);
+
     SDL_UnlockMutex(stream->lock);
 
 #if DEBUG_AUDIOSTREAM
@@ -1132,6 +1832,8 @@ int SDL_GetAudioStreamAvailable(SDL_AudioStream *stream)
         return 0;
     }
 
+    DrainAudioStreamRing(stream);  // if this fails, just report what made it into the queue.
+
     Sint64 count = GetAudioStreamAvailableFrames(stream, NULL);
 
     // convert from sample frames to bytes in destination format.
@@ -1151,6 +1853,7 @@ int SDL_GetAudioStreamQueued(SDL_AudioStream *stream)
     }
 
     SDL_LockMutex(stream->lock);
+    DrainAudioStreamRing(stream);  // if this fails, just report what made it into the queue.
     const Uint64 total = stream->total_bytes_queued;
     SDL_UnlockMutex(stream->lock);
 
@@ -1166,6 +1869,7 @@ int SDL_ClearAudioStream(SDL_AudioStream *stream)
 
     SDL_LockMutex(stream->lock);
 
+    DrainAudioStreamRing(stream);  // it's all getting thrown away, so it doesn't matter if this fails.
     SDL_ClearAudioQueue(stream->queue);
     SDL_zero(stream->input_spec);
     stream->resample_offset = 0;
@@ -1181,8 +1885,6 @@ void SDL_DestroyAudioStream(SDL_AudioStream *stream)
         return;
     }
 
-    SDL_DestroyProperties(stream->props);
-
     OnAudioStreamDestroy(stream);
 
     const SDL_bool simplified = stream->simplified;
@@ -1195,9 +1897,16 @@ void SDL_DestroyAudioStream(SDL_AudioStream *stream)
         SDL_UnbindAudioStream(stream);
     }
 
+    OnAudioStreamUnbound(stream);
+
+    // do this after unbinding, so the device thread is done with the stream; property cleanup callbacks might free things a get callback uses.
+    SDL_DestroyProperties(stream->props);
+
+    SDL_ReleaseResamplerPolyphase(&stream->polyphase);
     SDL_aligned_free(stream->history_buffer);
     SDL_aligned_free(stream->work_buffer);
     SDL_DestroyAudioQueue(stream->queue);
+    SDL_DestroyAudioRing(stream->ring);
     SDL_DestroyMutex(stream->lock);
 
     SDL_free(stream);
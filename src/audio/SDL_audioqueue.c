@@ -50,6 +50,7 @@ struct SDL_AudioChunk
     SDL_AudioChunk *next;
     size_t head;
     size_t tail;
+    int size_class;  // index into chunk_pool, or -1 if this chunk doesn't belong in the pool.
     Uint8 data[SDL_VARIABLE_LENGTH_ARRAY];
 };
 
@@ -62,14 +63,67 @@ typedef struct SDL_ChunkedAudioTrack
     SDL_AudioChunk *head;
     SDL_AudioChunk *tail;
     size_t queued_bytes;
+} SDL_ChunkedAudioTrack;
+
+// Free chunks are shared by every queue in the process, so streams coming and going (and data
+// being put on one thread and read on another) recycle memory instead of going to the allocator.
+// Chunks are sorted into power-of-two size classes; each class has its own spinlock, which is
+// only ever held long enough to push or pop one list node.
+#define CHUNK_POOL_MIN_SHIFT 10  // 1 KiB
+#define CHUNK_POOL_NUM_CLASSES 7  // ...up to 64 KiB
+
+// Each size class keeps at most this many bytes of free chunks; anything released past this goes back to the allocator.
+#define CHUNK_POOL_HIGH_WATER (256 * 1024)
 
+typedef struct SDL_AudioChunkPoolClass
+{
+    SDL_SpinLock lock;
     SDL_AudioChunk *free_chunks;
-    size_t num_free_chunks;
-} SDL_ChunkedAudioTrack;
+    size_t num_free;
+    size_t num_allocated;
+    Uint64 hits;
+    Uint64 misses;
+} SDL_AudioChunkPoolClass;
+
+static SDL_AudioChunkPoolClass chunk_pool[CHUNK_POOL_NUM_CLASSES];
+
+static int GetAudioChunkSizeClass(size_t chunk_size)
+{
+    for (int i = 0; i < CHUNK_POOL_NUM_CLASSES; ++i) {
+        if (chunk_size <= ((size_t)1 << (CHUNK_POOL_MIN_SHIFT + i))) {
+            return i;
+        }
+    }
+    return -1;
+}
 
 static void DestroyAudioChunk(SDL_AudioChunk *chunk)
 {
-    SDL_free(chunk);
+    const int size_class = chunk->size_class;
+
+    if (size_class < 0) {
+        SDL_free(chunk);
+        return;
+    }
+
+    SDL_AudioChunkPoolClass *pool = &chunk_pool[size_class];
+    const size_t class_size = (size_t)1 << (CHUNK_POOL_MIN_SHIFT + size_class);
+    SDL_bool keep;
+
+    SDL_AtomicLock(&pool->lock);
+    keep = ((pool->num_free + 1) * class_size <= CHUNK_POOL_HIGH_WATER);
+    if (keep) {
+        chunk->next = pool->free_chunks;
+        pool->free_chunks = chunk;
+        ++pool->num_free;
+    } else {
+        --pool->num_allocated;
+    }
+    SDL_AtomicUnlock(&pool->lock);
+
+    if (!keep) {
+        SDL_free(chunk);
+    }
 }
 
 static void DestroyAudioChunks(SDL_AudioChunk *chunk)
@@ -90,10 +144,40 @@ static void ResetAudioChunk(SDL_AudioChunk *chunk)
 
 static SDL_AudioChunk *CreateAudioChunk(size_t chunk_size)
 {
-    SDL_AudioChunk *chunk = (SDL_AudioChunk *)SDL_malloc(sizeof(*chunk) + chunk_size);
+    const int size_class = GetAudioChunkSizeClass(chunk_size);
+    SDL_AudioChunk *chunk = NULL;
+
+    if (size_class >= 0) {
+        SDL_AudioChunkPoolClass *pool = &chunk_pool[size_class];
+
+        SDL_AtomicLock(&pool->lock);
+        chunk = pool->free_chunks;
+        if (chunk) {
+            pool->free_chunks = chunk->next;
+            --pool->num_free;
+            ++pool->hits;
+        } else {
+            ++pool->misses;
+            ++pool->num_allocated;  // claim it now; given back below if the allocation fails.
+        }
+        SDL_AtomicUnlock(&pool->lock);
+
+        chunk_size = (size_t)1 << (CHUNK_POOL_MIN_SHIFT + size_class);
+    }
 
     if (!chunk) {
-        return NULL;
+        chunk = (SDL_AudioChunk *)SDL_malloc(sizeof(*chunk) + chunk_size);
+
+        if (!chunk) {
+            if (size_class >= 0) {
+                SDL_AtomicLock(&chunk_pool[size_class].lock);
+                --chunk_pool[size_class].num_allocated;
+                SDL_AtomicUnlock(&chunk_pool[size_class].lock);
+            }
+            return NULL;
+        }
+
+        chunk->size_class = size_class;
     }
 
     ResetAudioChunk(chunk);
@@ -101,35 +185,49 @@ static SDL_AudioChunk *CreateAudioChunk(size_t chunk_size)
     return chunk;
 }
 
-static void DestroyAudioTrackChunk(SDL_ChunkedAudioTrack *track, SDL_AudioChunk *chunk)
+int SDL_GetAudioChunkPoolStats(SDL_AudioChunkPoolStats *stats)
 {
-    // Keeping a list of free chunks reduces memory allocations,
-    // But also increases the amount of work to perform when freeing the track.
-    const size_t max_free_bytes = 64 * 1024;
-
-    if (track->chunk_size * track->num_free_chunks < max_free_bytes) {
-        chunk->next = track->free_chunks;
-        track->free_chunks = chunk;
-        ++track->num_free_chunks;
-    } else {
-        DestroyAudioChunk(chunk);
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
     }
-}
 
-static SDL_AudioChunk *CreateAudioTrackChunk(SDL_ChunkedAudioTrack *track)
-{
-    if (track->num_free_chunks > 0) {
-        SDL_AudioChunk *chunk = track->free_chunks;
+    SDL_zerop(stats);
 
-        track->free_chunks = chunk->next;
-        --track->num_free_chunks;
+    for (int i = 0; i < CHUNK_POOL_NUM_CLASSES; ++i) {
+        SDL_AudioChunkPoolClass *pool = &chunk_pool[i];
+        const size_t class_size = (size_t)1 << (CHUNK_POOL_MIN_SHIFT + i);
 
-        ResetAudioChunk(chunk);
-
-        return chunk;
+        SDL_AtomicLock(&pool->lock);
+        stats->allocated_bytes += pool->num_allocated * class_size;
+        stats->free_bytes += pool->num_free * class_size;
+        stats->num_allocated += pool->num_allocated;
+        stats->num_free += pool->num_free;
+        stats->hits += pool->hits;
+        stats->misses += pool->misses;
+        SDL_AtomicUnlock(&pool->lock);
     }
 
-    return CreateAudioChunk(track->chunk_size);
+    return 0;
+}
+
+void SDL_TrimAudioChunkPool(void)
+{
+    for (int i = 0; i < CHUNK_POOL_NUM_CLASSES; ++i) {
+        SDL_AudioChunkPoolClass *pool = &chunk_pool[i];
+
+        SDL_AtomicLock(&pool->lock);
+        SDL_AudioChunk *chunk = pool->free_chunks;
+        pool->num_allocated -= pool->num_free;
+        pool->free_chunks = NULL;
+        pool->num_free = 0;
+        SDL_AtomicUnlock(&pool->lock);
+
+        while (chunk) {
+            SDL_AudioChunk *next = chunk->next;
+            SDL_free(chunk);
+            chunk = next;
+        }
+    }
 }
 
 static size_t AvailChunkedAudioTrack(void *ctx)
@@ -147,7 +245,7 @@ static int WriteToChunkedAudioTrack(void *ctx, const Uint8 *data, size_t len)
 
     // Handle the first chunk
     if (!chunk) {
-        chunk = CreateAudioTrackChunk(track);
+        chunk = CreateAudioChunk(track->chunk_size);
 
         if (!chunk) {
             return SDL_OutOfMemory();
@@ -174,7 +272,7 @@ static int WriteToChunkedAudioTrack(void *ctx, const Uint8 *data, size_t len)
             break;
         }
 
-        SDL_AudioChunk *next = CreateAudioTrackChunk(track);
+        SDL_AudioChunk *next = CreateAudioChunk(track->chunk_size);
         chunk->next = next;
         chunk = next;
     }
@@ -222,7 +320,7 @@ static size_t ReadFromChunkedAudioTrack(void *ctx, Uint8 *data, size_t len, SDL_
         }
 
         if (advance) {
-            DestroyAudioTrackChunk(track, chunk);
+            DestroyAudioChunk(chunk);
         }
 
         chunk = next;
@@ -247,7 +345,6 @@ static void DestroyChunkedAudioTrack(void *ctx)
 {
     SDL_ChunkedAudioTrack *track = ctx;
     DestroyAudioChunks(track->head);
-    DestroyAudioChunks(track->free_chunks);
     SDL_free(track);
 }
 
@@ -271,6 +368,85 @@ static SDL_AudioTrack *CreateChunkedAudioTrack(const SDL_AudioSpec *spec, size_t
     return &track->track;
 }
 
+typedef struct SDL_ReferencedAudioTrack
+{
+    SDL_AudioTrack track;
+
+    const Uint8 *data;
+    size_t len;
+    size_t head;
+
+    SDL_AudioStreamDataCompleteCallback callback;
+    void *userdata;
+} SDL_ReferencedAudioTrack;
+
+static void ReleaseReferencedAudioTrack(SDL_ReferencedAudioTrack *track)
+{
+    SDL_AudioStreamDataCompleteCallback callback = track->callback;
+
+    if (callback) {
+        track->callback = NULL;  // only call it once.
+        callback(track->userdata, track->data, (int) track->len);
+    }
+}
+
+static size_t AvailReferencedAudioTrack(void *ctx)
+{
+    SDL_ReferencedAudioTrack *track = ctx;
+
+    return track->len - track->head;
+}
+
+static size_t ReadFromReferencedAudioTrack(void *ctx, Uint8 *data, size_t len, SDL_bool advance)
+{
+    SDL_ReferencedAudioTrack *track = ctx;
+
+    size_t to_read = track->len - track->head;
+    to_read = SDL_min(to_read, len);
+    SDL_memcpy(data, &track->data[track->head], to_read);
+
+    if (advance) {
+        track->head += to_read;
+
+        // The app can have its buffer back as soon as we've read all of it, instead of waiting for the track to be popped.
+        if (track->head == track->len) {
+            ReleaseReferencedAudioTrack(track);
+        }
+    }
+
+    return to_read;
+}
+
+static void DestroyReferencedAudioTrack(void *ctx)
+{
+    SDL_ReferencedAudioTrack *track = ctx;
+    ReleaseReferencedAudioTrack(track);
+    SDL_free(track);
+}
+
+SDL_AudioTrack *SDL_CreateReferencedAudioTrack(const SDL_AudioSpec *spec, const Uint8 *data, size_t len, SDL_AudioStreamDataCompleteCallback callback, void *userdata)
+{
+    SDL_ReferencedAudioTrack *track = (SDL_ReferencedAudioTrack *)SDL_calloc(1, sizeof(*track));
+
+    if (!track) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    SDL_copyp(&track->track.spec, spec);
+    track->track.avail = AvailReferencedAudioTrack;
+    track->track.write = NULL;  // we never copy anything in, so new data has to go in a new track.
+    track->track.read = ReadFromReferencedAudioTrack;
+    track->track.destroy = DestroyReferencedAudioTrack;
+
+    track->data = data;
+    track->len = len;
+    track->callback = callback;
+    track->userdata = userdata;
+
+    return &track->track;
+}
+
 SDL_AudioQueue *SDL_CreateAudioQueue(size_t chunk_size)
 {
     SDL_AudioQueue *queue = (SDL_AudioQueue *)SDL_calloc(1, sizeof(*queue));
@@ -514,3 +690,187 @@ int SDL_PeekIntoAudioQueue(SDL_AudioQueue *queue, Uint8 *data, size_t len)
         track = track->next;
     }
 }
+
+struct SDL_AudioRing
+{
+    Uint8 *data;
+    Uint32 mask;
+
+    // These count up forever (wrapping around), and are masked to get a position in `data`.
+    SDL_AtomicInt read_pos;  // only changed by the thread reading from the queue, once the data has been read.
+    SDL_AtomicInt write_pos;  // only changed by the thread writing data in.
+    Uint32 queued_pos;  // how far the queue's ring tracks reach. Only touched by the thread reading from the queue.
+
+    SDL_AtomicInt refcount;  // the owner, plus one for each ring track still reading from `data`.
+};
+
+// A track that reads straight out of a ring buffer, covering the bytes between `head` and `tail`.
+// While it's the last track in its queue, newly written data is added to it instead of being copied.
+typedef struct SDL_RingAudioTrack
+{
+    SDL_AudioTrack track;
+
+    SDL_AudioRing *ring;
+    Uint32 head;
+    Uint32 tail;
+} SDL_RingAudioTrack;
+
+static void ReleaseAudioRing(SDL_AudioRing *ring)
+{
+    if (SDL_AtomicDecRef(&ring->refcount)) {
+        SDL_free(ring->data);
+        SDL_free(ring);
+    }
+}
+
+SDL_AudioRing *SDL_CreateAudioRing(size_t capacity)
+{
+    const size_t max_capacity = 1u << 30;
+    size_t size = 1;
+
+    if (capacity > max_capacity) {
+        SDL_SetError("Ring buffer is too large");
+        return NULL;
+    }
+
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    SDL_AudioRing *ring = (SDL_AudioRing *)SDL_calloc(1, sizeof(*ring));
+
+    if (!ring) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    ring->data = (Uint8 *)SDL_malloc(size);
+
+    if (!ring->data) {
+        SDL_free(ring);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    ring->mask = (Uint32)(size - 1);
+    SDL_AtomicSet(&ring->refcount, 1);
+
+    return ring;
+}
+
+void SDL_DestroyAudioRing(SDL_AudioRing *ring)
+{
+    if (ring) {
+        ReleaseAudioRing(ring);  // tracks that still use it keep it alive until they're done.
+    }
+}
+
+SDL_bool SDL_WriteToAudioRing(SDL_AudioRing *ring, const Uint8 *data, size_t len)
+{
+    const Uint32 write_pos = (Uint32)SDL_AtomicGet(&ring->write_pos);
+    const Uint32 read_pos = (Uint32)SDL_AtomicGet(&ring->read_pos);
+    const size_t available = (size_t)ring->mask + 1 - (write_pos - read_pos);
+
+    if (len > available) {
+        return SDL_FALSE;
+    }
+
+    const Uint32 offset = write_pos & ring->mask;
+    const size_t first = SDL_min(len, (size_t)ring->mask + 1 - offset);
+    SDL_memcpy(&ring->data[offset], data, first);
+    SDL_memcpy(ring->data, &data[first], len - first);
+
+    // Publish the data. This is a full barrier, so the reader can't see the new position before the data.
+    SDL_AtomicSet(&ring->write_pos, (int)(write_pos + (Uint32)len));
+
+    return SDL_TRUE;
+}
+
+static size_t AvailRingAudioTrack(void *ctx)
+{
+    SDL_RingAudioTrack *track = ctx;
+
+    return track->tail - track->head;
+}
+
+static size_t ReadFromRingAudioTrack(void *ctx, Uint8 *data, size_t len, SDL_bool advance)
+{
+    SDL_RingAudioTrack *track = ctx;
+    SDL_AudioRing *ring = track->ring;
+
+    size_t to_read = track->tail - track->head;
+    to_read = SDL_min(to_read, len);
+
+    const Uint32 offset = track->head & ring->mask;
+    const size_t first = SDL_min(to_read, (size_t)ring->mask + 1 - offset);
+    SDL_memcpy(data, &ring->data[offset], first);
+    SDL_memcpy(&data[first], ring->data, to_read - first);
+
+    if (advance) {
+        track->head += (Uint32)to_read;
+
+        // Hand the space back to the writer, now that we're done reading it.
+        SDL_AtomicSet(&ring->read_pos, (int)track->head);
+    }
+
+    return to_read;
+}
+
+static void DestroyRingAudioTrack(void *ctx)
+{
+    SDL_RingAudioTrack *track = ctx;
+    SDL_AudioRing *ring = track->ring;
+
+    // Anything left unread is being thrown away, so the writer can have that space back too.
+    SDL_AtomicSet(&ring->read_pos, (int)track->tail);
+    ReleaseAudioRing(ring);
+    SDL_free(track);
+}
+
+int SDL_MoveAudioRingToQueue(SDL_AudioRing *ring, SDL_AudioQueue *queue, const SDL_AudioSpec *spec, size_t *out_moved)
+{
+    const Uint32 write_pos = (Uint32)SDL_AtomicGet(&ring->write_pos);
+    const size_t len = write_pos - ring->queued_pos;
+
+    *out_moved = 0;
+
+    if (len == 0) {
+        return 0;
+    }
+
+    // If the ring's track is still the last one, just let it see the new data. That's the usual case, so
+    // the thread reading from the queue doesn't allocate or copy anything until it actually reads the data.
+    SDL_AudioTrack *tail = queue->tail;
+
+    if (tail && (tail->read == ReadFromRingAudioTrack) && ((SDL_RingAudioTrack *)tail)->ring == ring &&
+        !tail->flushed && AUDIO_SPECS_EQUAL(tail->spec, *spec)) {
+        SDL_RingAudioTrack *track = (SDL_RingAudioTrack *)tail;
+        SDL_assert(track->tail == ring->queued_pos);
+        track->tail = write_pos;
+    } else {
+        // Something else was queued since, so the data after that needs a track of its own.
+        SDL_RingAudioTrack *track = (SDL_RingAudioTrack *)SDL_calloc(1, sizeof(*track));
+
+        if (!track) {
+            return SDL_OutOfMemory();
+        }
+
+        SDL_copyp(&track->track.spec, spec);
+        track->track.avail = AvailRingAudioTrack;
+        track->track.write = NULL;  // data comes in through the ring, not through the queue.
+        track->track.read = ReadFromRingAudioTrack;
+        track->track.destroy = DestroyRingAudioTrack;
+
+        track->ring = ring;
+        track->head = ring->queued_pos;
+        track->tail = write_pos;
+        SDL_AtomicIncRef(&ring->refcount);
+
+        SDL_AddTrackToAudioQueue(queue, &track->track);
+    }
+
+    ring->queued_pos = write_pos;
+    *out_moved = len;
+
+    return 0;
+}
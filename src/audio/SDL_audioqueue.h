@@ -27,6 +27,7 @@
 
 typedef struct SDL_AudioQueue SDL_AudioQueue;
 typedef struct SDL_AudioTrack SDL_AudioTrack;
+typedef struct SDL_AudioRing SDL_AudioRing;
 
 // Create a new audio queue
 SDL_AudioQueue *SDL_CreateAudioQueue(size_t chunk_size);
@@ -55,6 +56,10 @@ int SDL_WriteToAudioQueue(SDL_AudioQueue *queue, const SDL_AudioSpec *spec, cons
 // Create a track without needing to hold any locks
 SDL_AudioTrack *SDL_CreateChunkedAudioTrack(const SDL_AudioSpec *spec, const Uint8 *data, size_t len, size_t chunk_size);
 
+// Create a track that reads straight from `data` instead of copying it. `callback` (if not NULL) is called when the track is done with the data.
+// The track can't be written to; writing to the queue after this starts a new track.
+SDL_AudioTrack *SDL_CreateReferencedAudioTrack(const SDL_AudioSpec *spec, const Uint8 *data, size_t len, SDL_AudioStreamDataCompleteCallback callback, void *userdata);
+
 // Add a track to the end of the queue
 // REQUIRES: `track != NULL`
 void SDL_AddTrackToAudioQueue(SDL_AudioQueue *queue, SDL_AudioTrack *track);
@@ -74,4 +79,24 @@ int SDL_ReadFromAudioQueue(SDL_AudioQueue *queue, Uint8 *data, size_t len);
 // REQUIRES: There must be enough data in the queue, unless it has been flushed, in which case missing data is filled with silence.
 int SDL_PeekIntoAudioQueue(SDL_AudioQueue *queue, Uint8 *data, size_t len);
 
+// A lock-free ring buffer that one thread writes to while another thread reads its contents through a queue.
+// The capacity is rounded up to a power of two.
+SDL_AudioRing *SDL_CreateAudioRing(size_t capacity);
+
+// Destroy a ring buffer. Data that was already moved to a queue stays readable until it is read or cleared.
+void SDL_DestroyAudioRing(SDL_AudioRing *ring);
+
+// Write all of `data` to the ring, or nothing if there isn't room for all of it
+// REQUIRES: Only one thread writes to the ring at a time
+SDL_bool SDL_WriteToAudioRing(SDL_AudioRing *ring, const Uint8 *data, size_t len);
+
+// Move everything currently in the ring to the end of the queue, without copying it. The queue reads the data
+// straight out of the ring, and the writer gets the space back once it has been read. `out_moved` is set to the
+// number of bytes moved, even on failure.
+// REQUIRES: Only one thread moves data out of the ring and reads from the queue at a time
+int SDL_MoveAudioRingToQueue(SDL_AudioRing *ring, SDL_AudioQueue *queue, const SDL_AudioSpec *spec, size_t *out_moved);
+
+// Free every chunk sitting in the shared pool. Chunks still in use go back into the pool when released.
+void SDL_TrimAudioChunkPool(void);
+
 #endif // SDL_audioqueue_h_
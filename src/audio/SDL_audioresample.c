@@ -22,6 +22,7 @@
 
 #include "SDL_sysaudio.h"
 #include "SDL_audioresample.h"
+#include "../cpuinfo/SDL_cpuinfo_c.h"
 
 // SDL's resampler uses a "bandlimited interpolation" algorithm:
 //     https://ccrma.stanford.edu/~jos/resample/
@@ -39,17 +40,40 @@
 
 #define RESAMPLER_FULL_FILTER_SIZE (RESAMPLER_SAMPLES_PER_FRAME * (RESAMPLER_SAMPLES_PER_ZERO_CROSSING + 1))
 
-static void ResampleFrame_Scalar(const float *src, float *dst, const float *raw_filter, float interp, int chans)
+static float FullResamplerFilter[RESAMPLER_FULL_FILTER_SIZE];
+
+// Find the first input frame, the nearest filter and the interpolation weight for the output frame at `srcpos`.
+SDL_FORCE_INLINE const float *GetResamplerFrame(const float *src, int chans, Sint64 srcpos, const float **filter, float *interp)
 {
-    int i, chan;
+    const int srcindex = (int)(Sint32)(srcpos >> 32);
+    const Uint32 srcfraction = (Uint32)(srcpos & 0xFFFFFFFF);
 
-    float filter[RESAMPLER_SAMPLES_PER_FRAME];
+    *filter = &FullResamplerFilter[(srcfraction >> RESAMPLER_FILTER_INTERP_BITS) * RESAMPLER_SAMPLES_PER_FRAME];
+    *interp = (float)(srcfraction & (RESAMPLER_FILTER_INTERP_RANGE - 1)) * (1.0f / RESAMPLER_FILTER_INTERP_RANGE);
 
-    // Interpolate between the nearest two filters
-    for (i = 0; i < RESAMPLER_SAMPLES_PER_FRAME; i++) {
-        filter[i] = (raw_filter[i] * (1.0f - interp)) + (raw_filter[i + RESAMPLER_SAMPLES_PER_FRAME] * interp);
+    return &src[(srcindex - (RESAMPLER_ZERO_CROSSINGS - 1)) * chans];
+}
+
+// Same as GetResamplerFrame, for a position tracked as a whole input frame plus one of the polyphase bank's phases. This also steps to the next output frame.
+SDL_FORCE_INLINE const float *GetResamplerPolyphaseFrame(const SDL_ResamplerPolyphase *polyphase, const float *src, int chans, int *srcindex, int *phase, const float **filter)
+{
+    const float *frame = &src[(*srcindex - (RESAMPLER_ZERO_CROSSINGS - 1)) * chans];
+    *filter = &polyphase->filters[*phase * RESAMPLER_SAMPLES_PER_FRAME];
+
+    *srcindex += polyphase->step;
+    *phase += polyphase->phase_step;
+    if (*phase >= polyphase->phases) {
+        *phase -= polyphase->phases;
+        *srcindex += 1;
     }
 
+    return frame;
+}
+
+static void ApplyResamplerFilter_Scalar(const float *src, float *dst, const float *filter, int chans)
+{
+    int i, chan;
+
     if (chans == 2) {
         float out[2];
         out[0] = 0.0f;
@@ -88,29 +112,24 @@ static void ResampleFrame_Scalar(const float *src, float *dst, const float *raw_
     }
 }
 
-#ifdef SDL_SSE_INTRINSICS
-static void SDL_TARGETING("sse") ResampleFrame_SSE(const float *src, float *dst, const float *raw_filter, float interp, int chans)
+static void ResampleFrame_Scalar(const float *src, float *dst, const float *raw_filter, float interp, int chans)
 {
-#if RESAMPLER_SAMPLES_PER_FRAME != 10
-#error Invalid samples per frame
-#endif
+    int i;
 
-    // Load the filter
-    __m128 f0 = _mm_loadu_ps(raw_filter + 0);
-    __m128 f1 = _mm_loadu_ps(raw_filter + 4);
-    __m128 f2 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(raw_filter + 8));
+    float filter[RESAMPLER_SAMPLES_PER_FRAME];
 
-    __m128 g0 = _mm_loadu_ps(raw_filter + 10);
-    __m128 g1 = _mm_loadu_ps(raw_filter + 14);
-    __m128 g2 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(raw_filter + 18));
+    // Interpolate between the nearest two filters
+    for (i = 0; i < RESAMPLER_SAMPLES_PER_FRAME; i++) {
+        filter[i] = (raw_filter[i] * (1.0f - interp)) + (raw_filter[i + RESAMPLER_SAMPLES_PER_FRAME] * interp);
+    }
 
-    __m128 interp1 = _mm_set1_ps(interp);
-    __m128 interp2 = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_set1_ps(interp));
+    ApplyResamplerFilter_Scalar(src, dst, filter, chans);
+}
 
-    // Linear interpolate the filter
-    f0 = _mm_add_ps(_mm_mul_ps(f0, interp2), _mm_mul_ps(g0, interp1));
-    f1 = _mm_add_ps(_mm_mul_ps(f1, interp2), _mm_mul_ps(g1, interp1));
-    f2 = _mm_add_ps(_mm_mul_ps(f2, interp2), _mm_mul_ps(g2, interp1));
+#ifdef SDL_SSE_INTRINSICS
+SDL_FORCE_INLINE void SDL_TARGETING("sse") ResampleFrameWithFilter_SSE(const float *src, float *dst, __m128 f0, __m128 f1, __m128 f2, int chans)
+{
+    __m128 g0, g1;
 
     if (chans == 2) {
         // Duplicate each of the filter elements
@@ -179,11 +198,475 @@ static void SDL_TARGETING("sse") ResampleFrame_SSE(const float *src, float *dst,
         _mm_store_ss(&dst[chan], f0);
     }
 }
+
+static void SDL_TARGETING("sse") ResampleFrame_SSE(const float *src, float *dst, const float *raw_filter, float interp, int chans)
+{
+#if RESAMPLER_SAMPLES_PER_FRAME != 10
+#error Invalid samples per frame
+#endif
+
+    // Load the filter
+    __m128 f0 = _mm_loadu_ps(raw_filter + 0);
+    __m128 f1 = _mm_loadu_ps(raw_filter + 4);
+    __m128 f2 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(raw_filter + 8));
+
+    __m128 g0 = _mm_loadu_ps(raw_filter + 10);
+    __m128 g1 = _mm_loadu_ps(raw_filter + 14);
+    __m128 g2 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(raw_filter + 18));
+
+    __m128 interp1 = _mm_set1_ps(interp);
+    __m128 interp2 = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_set1_ps(interp));
+
+    // Linear interpolate the filter
+    f0 = _mm_add_ps(_mm_mul_ps(f0, interp2), _mm_mul_ps(g0, interp1));
+    f1 = _mm_add_ps(_mm_mul_ps(f1, interp2), _mm_mul_ps(g1, interp1));
+    f2 = _mm_add_ps(_mm_mul_ps(f2, interp2), _mm_mul_ps(g2, interp1));
+
+    ResampleFrameWithFilter_SSE(src, dst, f0, f1, f2, chans);
+}
+
+static void SDL_TARGETING("sse") ApplyResamplerFilter_SSE(const float *src, float *dst, const float *filter, int chans)
+{
+    ResampleFrameWithFilter_SSE(src, dst, _mm_loadu_ps(filter + 0), _mm_loadu_ps(filter + 4), _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(filter + 8)), chans);
+}
 #endif
 
 static void (*ResampleFrame)(const float *src, float *dst, const float *raw_filter, float interp, int chans);
+static void (*ApplyResamplerFilter)(const float *src, float *dst, const float *filter, int chans);
 
-static float FullResamplerFilter[RESAMPLER_FULL_FILTER_SIZE];
+static void ResampleFrames_Generic(const float *src, float *dst, int chans, int outframes, Sint64 srcpos, Sint64 resample_rate)
+{
+    int i;
+
+    for (i = 0; i < outframes; i++) {
+        const float *filter;
+        float interp;
+        const float *frame = GetResamplerFrame(src, chans, srcpos, &filter, &interp);
+        srcpos += resample_rate;
+
+        ResampleFrame(frame, dst, filter, interp, chans);
+        dst += chans;
+    }
+}
+
+static void ResamplePolyphaseFrames_Generic(const SDL_ResamplerPolyphase *polyphase, const float *src, float *dst, int chans, int outframes, int srcindex, int phase)
+{
+    int i;
+
+    for (i = 0; i < outframes; i++) {
+        const float *filter;
+        const float *frame = GetResamplerPolyphaseFrame(polyphase, src, chans, &srcindex, &phase, &filter);
+
+        ApplyResamplerFilter(frame, dst, filter, chans);
+        dst += chans;
+    }
+}
+
+#ifdef SDL_AVX2_INTRINSICS
+// The AVX2 kernels interpolate the two filter phases with FMA, so they also require SDL_HasFMA().
+
+// Interpolate between the nearest two filters: f + ((g - f) * interp)
+SDL_FORCE_INLINE void SDL_TARGETING("avx2,fma") InterpolateResamplerFilter_AVX2(const float *filter, float interp, __m256 *f0, __m128 *f1)
+{
+    const __m256 interp8 = _mm256_set1_ps(interp);
+
+    *f0 = _mm256_loadu_ps(filter + 0);
+    *f1 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(filter + 8));
+    *f0 = _mm256_fmadd_ps(_mm256_sub_ps(_mm256_loadu_ps(filter + 10), *f0), interp8, *f0);
+    *f1 = _mm_fmadd_ps(_mm_sub_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(filter + 18)), *f1), _mm256_castps256_ps128(interp8), *f1);
+}
+
+// Returns four partial sums for a mono output frame.
+SDL_FORCE_INLINE __m128 SDL_TARGETING("avx2,fma") ResampleMonoFrame_AVX2(const float *frame, __m256 f0, __m128 f1)
+{
+    const __m256 sum = _mm256_mul_ps(f0, _mm256_loadu_ps(frame + 0));
+    return _mm_fmadd_ps(f1, _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(frame + 8)),
+                        _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1)));
+}
+
+// Returns two partial sums for each channel of a stereo output frame, as LRLR.
+SDL_FORCE_INLINE __m128 SDL_TARGETING("avx2,fma") ResampleStereoFrame_AVX2(const float *frame, __m256 f0, __m128 f1)
+{
+    // Duplicate each of the filter elements, to line up with the interleaved input
+    __m256 sum = _mm256_mul_ps(_mm256_permutevar8x32_ps(f0, _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3)), _mm256_loadu_ps(frame + 0));
+    sum = _mm256_fmadd_ps(_mm256_permutevar8x32_ps(f0, _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7)), _mm256_loadu_ps(frame + 8), sum);
+    return _mm_fmadd_ps(_mm_unpacklo_ps(f1, f1), _mm_loadu_ps(frame + 16),
+                        _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1)));
+}
+
+// Reduce the partial sums of four mono output frames, or two stereo ones, and store them.
+SDL_FORCE_INLINE void SDL_TARGETING("avx2,fma") StoreMonoFrames_AVX2(float *dst, __m128 sum0, __m128 sum1, __m128 sum2, __m128 sum3)
+{
+    _mm_storeu_ps(dst, _mm_hadd_ps(_mm_hadd_ps(sum0, sum1), _mm_hadd_ps(sum2, sum3)));
+}
+
+SDL_FORCE_INLINE void SDL_TARGETING("avx2,fma") StoreStereoFrames_AVX2(float *dst, __m128 sum0, __m128 sum1)
+{
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_shuffle_ps(sum0, sum1, _MM_SHUFFLE(1, 0, 1, 0)), _mm_shuffle_ps(sum0, sum1, _MM_SHUFFLE(3, 2, 3, 2))));
+}
+
+SDL_FORCE_INLINE void SDL_TARGETING("avx2,fma") ResampleFrameWithFilter_AVX2(const float *src, float *dst, __m256 f0, __m128 f1, int chans)
+{
+    if (chans == 1) {
+        __m128 sum = ResampleMonoFrame_AVX2(src, f0, f1);
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        _mm_store_ss(dst, _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1))));
+        return;
+    }
+
+    if (chans == 2) {
+        const __m128 sum = ResampleStereoFrame_AVX2(src, f0, f1);
+        _mm_storel_pi((__m64 *)dst, _mm_add_ps(sum, _mm_movehl_ps(sum, sum)));
+        return;
+    }
+
+    // 8 lanes of -1 followed by 8 lanes of 0; loading from &masks[8 - n] gives a mask for the first n lanes.
+    static const int masks[16] = { -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    float filter[RESAMPLER_SAMPLES_PER_FRAME];
+    _mm256_storeu_ps(filter + 0, f0);
+    _mm_storel_pi((__m64 *)(filter + 8), f1);
+
+    int i, chan = 0;
+
+    for (; chan + 8 <= chans; chan += 8) {
+        __m256 sum = _mm256_setzero_ps();
+
+        for (i = 0; i < RESAMPLER_SAMPLES_PER_FRAME; i++) {
+            sum = _mm256_fmadd_ps(_mm256_loadu_ps(&src[i * chans + chan]), _mm256_broadcast_ss(&filter[i]), sum);
+        }
+
+        _mm256_storeu_ps(&dst[chan], sum);
+    }
+
+    if (chan < chans) {
+        const __m256i mask = _mm256_loadu_si256((const __m256i *)&masks[8 - (chans - chan)]);
+        __m256 sum = _mm256_setzero_ps();
+
+        for (i = 0; i < RESAMPLER_SAMPLES_PER_FRAME; i++) {
+            sum = _mm256_fmadd_ps(_mm256_maskload_ps(&src[i * chans + chan], mask), _mm256_broadcast_ss(&filter[i]), sum);
+        }
+
+        _mm256_maskstore_ps(&dst[chan], mask, sum);
+    }
+}
+
+static void SDL_TARGETING("avx2,fma") ResampleFrame_AVX2(const float *src, float *dst, const float *raw_filter, float interp, int chans)
+{
+#if RESAMPLER_SAMPLES_PER_FRAME != 10
+#error Invalid samples per frame
+#endif
+
+    __m256 f0;
+    __m128 f1;
+    InterpolateResamplerFilter_AVX2(raw_filter, interp, &f0, &f1);
+    ResampleFrameWithFilter_AVX2(src, dst, f0, f1, chans);
+}
+
+static void SDL_TARGETING("avx2,fma") ApplyResamplerFilter_AVX2(const float *src, float *dst, const float *filter, int chans)
+{
+    ResampleFrameWithFilter_AVX2(src, dst, _mm256_loadu_ps(filter + 0), _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(filter + 8)), chans);
+}
+
+// Mono and stereo produce several output frames per iteration, so the horizontal sums can share shuffles and stores.
+static void SDL_TARGETING("avx2,fma") ResampleFrames_AVX2(const float *src, float *dst, int chans, int outframes, Sint64 srcpos, Sint64 resample_rate)
+{
+    const float *filter;
+    const float *frame[4];
+    __m256 f0[4];
+    __m128 f1[4];
+    float interp;
+    int i = 0, j;
+
+    if (chans == 1) {
+        for (; i + 4 <= outframes; i += 4) {
+            for (j = 0; j < 4; j++) {
+                frame[j] = GetResamplerFrame(src, 1, srcpos, &filter, &interp);
+                InterpolateResamplerFilter_AVX2(filter, interp, &f0[j], &f1[j]);
+                srcpos += resample_rate;
+            }
+
+            StoreMonoFrames_AVX2(dst, ResampleMonoFrame_AVX2(frame[0], f0[0], f1[0]), ResampleMonoFrame_AVX2(frame[1], f0[1], f1[1]),
+                                 ResampleMonoFrame_AVX2(frame[2], f0[2], f1[2]), ResampleMonoFrame_AVX2(frame[3], f0[3], f1[3]));
+            dst += 4;
+        }
+    } else if (chans == 2) {
+        for (; i + 2 <= outframes; i += 2) {
+            for (j = 0; j < 2; j++) {
+                frame[j] = GetResamplerFrame(src, 2, srcpos, &filter, &interp);
+                InterpolateResamplerFilter_AVX2(filter, interp, &f0[j], &f1[j]);
+                srcpos += resample_rate;
+            }
+
+            StoreStereoFrames_AVX2(dst, ResampleStereoFrame_AVX2(frame[0], f0[0], f1[0]), ResampleStereoFrame_AVX2(frame[1], f0[1], f1[1]));
+            dst += 4;
+        }
+    }
+
+    for (; i < outframes; i++) {
+        frame[0] = GetResamplerFrame(src, chans, srcpos, &filter, &interp);
+        srcpos += resample_rate;
+
+        ResampleFrame_AVX2(frame[0], dst, filter, interp, chans);
+        dst += chans;
+    }
+}
+
+static void SDL_TARGETING("avx2,fma") ResamplePolyphaseFrames_AVX2(const SDL_ResamplerPolyphase *polyphase, const float *src, float *dst, int chans, int outframes, int srcindex, int phase)
+{
+    const float *filter;
+    const float *frame[4];
+    __m256 f0[4];
+    __m128 f1[4];
+    int i = 0, j;
+
+    if (chans == 1) {
+        for (; i + 4 <= outframes; i += 4) {
+            for (j = 0; j < 4; j++) {
+                frame[j] = GetResamplerPolyphaseFrame(polyphase, src, 1, &srcindex, &phase, &filter);
+                f0[j] = _mm256_loadu_ps(filter + 0);
+                f1[j] = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(filter + 8));
+            }
+
+            StoreMonoFrames_AVX2(dst, ResampleMonoFrame_AVX2(frame[0], f0[0], f1[0]), ResampleMonoFrame_AVX2(frame[1], f0[1], f1[1]),
+                                 ResampleMonoFrame_AVX2(frame[2], f0[2], f1[2]), ResampleMonoFrame_AVX2(frame[3], f0[3], f1[3]));
+            dst += 4;
+        }
+    } else if (chans == 2) {
+        for (; i + 2 <= outframes; i += 2) {
+            for (j = 0; j < 2; j++) {
+                frame[j] = GetResamplerPolyphaseFrame(polyphase, src, 2, &srcindex, &phase, &filter);
+                f0[j] = _mm256_loadu_ps(filter + 0);
+                f1[j] = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(filter + 8));
+            }
+
+            StoreStereoFrames_AVX2(dst, ResampleStereoFrame_AVX2(frame[0], f0[0], f1[0]), ResampleStereoFrame_AVX2(frame[1], f0[1], f1[1]));
+            dst += 4;
+        }
+    }
+
+    for (; i < outframes; i++) {
+        frame[0] = GetResamplerPolyphaseFrame(polyphase, src, chans, &srcindex, &phase, &filter);
+
+        ApplyResamplerFilter_AVX2(frame[0], dst, filter, chans);
+        dst += chans;
+    }
+}
+#endif
+
+#ifdef SDL_NEON_INTRINSICS
+// ARMv7 NEON has no fused multiply-add, so fall back to a separate multiply and add there.
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define RESAMPLER_NEON_FMAQ(a, b, c) vfmaq_f32(a, b, c)
+#define RESAMPLER_NEON_FMA(a, b, c)  vfma_f32(a, b, c)
+#else
+#define RESAMPLER_NEON_FMAQ(a, b, c) vmlaq_f32(a, b, c)
+#define RESAMPLER_NEON_FMA(a, b, c)  vmla_f32(a, b, c)
+#endif
+
+typedef struct ResamplerFilter_NEON
+{
+    float32x4_t f0;
+    float32x4_t f1;
+    float32x2_t f2;
+} ResamplerFilter_NEON;
+
+SDL_FORCE_INLINE ResamplerFilter_NEON LoadResamplerFilter_NEON(const float *filter)
+{
+    ResamplerFilter_NEON retval;
+
+    retval.f0 = vld1q_f32(filter + 0);
+    retval.f1 = vld1q_f32(filter + 4);
+    retval.f2 = vld1_f32(filter + 8);
+
+    return retval;
+}
+
+// Interpolate between the nearest two filters: f + ((g - f) * interp)
+SDL_FORCE_INLINE ResamplerFilter_NEON InterpolateResamplerFilter_NEON(const float *filter, float interp)
+{
+    const float32x4_t interp4 = vdupq_n_f32(interp);
+    ResamplerFilter_NEON retval = LoadResamplerFilter_NEON(filter);
+
+    retval.f0 = RESAMPLER_NEON_FMAQ(retval.f0, vsubq_f32(vld1q_f32(filter + 10), retval.f0), interp4);
+    retval.f1 = RESAMPLER_NEON_FMAQ(retval.f1, vsubq_f32(vld1q_f32(filter + 14), retval.f1), interp4);
+    retval.f2 = RESAMPLER_NEON_FMA(retval.f2, vsub_f32(vld1_f32(filter + 18), retval.f2), vget_low_f32(interp4));
+
+    return retval;
+}
+
+// Returns four partial sums for a mono output frame.
+SDL_FORCE_INLINE float32x4_t ResampleMonoFrame_NEON(const float *frame, const ResamplerFilter_NEON f)
+{
+    float32x4_t sum = vmulq_f32(f.f0, vld1q_f32(frame + 0));
+    sum = RESAMPLER_NEON_FMAQ(sum, f.f1, vld1q_f32(frame + 4));
+    return vcombine_f32(RESAMPLER_NEON_FMA(vget_low_f32(sum), f.f2, vld1_f32(frame + 8)), vget_high_f32(sum));
+}
+
+// Returns the left and right results for a stereo output frame.
+SDL_FORCE_INLINE float32x2_t ResampleStereoFrame_NEON(const float *frame, const ResamplerFilter_NEON f)
+{
+    // Duplicate each of the filter elements, to line up with the interleaved input
+    const float32x4x2_t d0 = vzipq_f32(f.f0, f.f0);
+    const float32x4x2_t d1 = vzipq_f32(f.f1, f.f1);
+    const float32x2x2_t d2 = vzip_f32(f.f2, f.f2);
+
+    float32x4_t sum = vmulq_f32(d0.val[0], vld1q_f32(frame + 0));
+    sum = RESAMPLER_NEON_FMAQ(sum, d0.val[1], vld1q_f32(frame + 4));
+    sum = RESAMPLER_NEON_FMAQ(sum, d1.val[0], vld1q_f32(frame + 8));
+    sum = RESAMPLER_NEON_FMAQ(sum, d1.val[1], vld1q_f32(frame + 12));
+    sum = RESAMPLER_NEON_FMAQ(sum, vcombine_f32(d2.val[0], d2.val[1]), vld1q_f32(frame + 16));
+    return vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+}
+
+// Reduce the partial sums of four mono output frames and store them.
+SDL_FORCE_INLINE void StoreMonoFrames_NEON(float *dst, float32x4_t sum0, float32x4_t sum1, float32x4_t sum2, float32x4_t sum3)
+{
+    const float32x2_t sum01 = vpadd_f32(vpadd_f32(vget_low_f32(sum0), vget_high_f32(sum0)), vpadd_f32(vget_low_f32(sum1), vget_high_f32(sum1)));
+    const float32x2_t sum23 = vpadd_f32(vpadd_f32(vget_low_f32(sum2), vget_high_f32(sum2)), vpadd_f32(vget_low_f32(sum3), vget_high_f32(sum3)));
+    vst1q_f32(dst, vcombine_f32(sum01, sum23));
+}
+
+SDL_FORCE_INLINE void ResampleFrameWithFilter_NEON(const float *src, float *dst, const ResamplerFilter_NEON f, int chans)
+{
+    if (chans == 1) {
+        const float32x4_t sum = ResampleMonoFrame_NEON(src, f);
+        const float32x2_t pair = vpadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+        vst1_lane_f32(dst, vpadd_f32(pair, pair), 0);
+        return;
+    }
+
+    if (chans == 2) {
+        vst1_f32(dst, ResampleStereoFrame_NEON(src, f));
+        return;
+    }
+
+    float filter[RESAMPLER_SAMPLES_PER_FRAME];
+    vst1q_f32(filter + 0, f.f0);
+    vst1q_f32(filter + 4, f.f1);
+    vst1_f32(filter + 8, f.f2);
+
+    int i, chan = 0;
+
+    for (; chan + 4 <= chans; chan += 4) {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+
+        for (i = 0; i < RESAMPLER_SAMPLES_PER_FRAME; i++) {
+            sum = RESAMPLER_NEON_FMAQ(sum, vld1q_f32(&src[i * chans + chan]), vdupq_n_f32(filter[i]));
+        }
+
+        vst1q_f32(&dst[chan], sum);
+    }
+
+    for (; chan < chans; chan++) {
+        float sum = 0.0f;
+
+        for (i = 0; i < RESAMPLER_SAMPLES_PER_FRAME; i++) {
+            sum += src[i * chans + chan] * filter[i];
+        }
+
+        dst[chan] = sum;
+    }
+}
+
+static void ResampleFrame_NEON(const float *src, float *dst, const float *raw_filter, float interp, int chans)
+{
+#if RESAMPLER_SAMPLES_PER_FRAME != 10
+#error Invalid samples per frame
+#endif
+
+    ResampleFrameWithFilter_NEON(src, dst, InterpolateResamplerFilter_NEON(raw_filter, interp), chans);
+}
+
+static void ApplyResamplerFilter_NEON(const float *src, float *dst, const float *filter, int chans)
+{
+    ResampleFrameWithFilter_NEON(src, dst, LoadResamplerFilter_NEON(filter), chans);
+}
+
+// Mono and stereo produce several output frames per iteration, so the horizontal sums can share shuffles and stores.
+static void ResampleFrames_NEON(const float *src, float *dst, int chans, int outframes, Sint64 srcpos, Sint64 resample_rate)
+{
+    const float *filter;
+    const float *frame;
+    float32x4_t sum[4];
+    float32x2_t stereo[2];
+    float interp;
+    int i = 0, j;
+
+    if (chans == 1) {
+        for (; i + 4 <= outframes; i += 4) {
+            for (j = 0; j < 4; j++) {
+                frame = GetResamplerFrame(src, 1, srcpos, &filter, &interp);
+                srcpos += resample_rate;
+                sum[j] = ResampleMonoFrame_NEON(frame, InterpolateResamplerFilter_NEON(filter, interp));
+            }
+
+            StoreMonoFrames_NEON(dst, sum[0], sum[1], sum[2], sum[3]);
+            dst += 4;
+        }
+    } else if (chans == 2) {
+        for (; i + 2 <= outframes; i += 2) {
+            for (j = 0; j < 2; j++) {
+                frame = GetResamplerFrame(src, 2, srcpos, &filter, &interp);
+                srcpos += resample_rate;
+                stereo[j] = ResampleStereoFrame_NEON(frame, InterpolateResamplerFilter_NEON(filter, interp));
+            }
+
+            vst1q_f32(dst, vcombine_f32(stereo[0], stereo[1]));
+            dst += 4;
+        }
+    }
+
+    for (; i < outframes; i++) {
+        frame = GetResamplerFrame(src, chans, srcpos, &filter, &interp);
+        srcpos += resample_rate;
+
+        ResampleFrame_NEON(frame, dst, filter, interp, chans);
+        dst += chans;
+    }
+}
+
+static void ResamplePolyphaseFrames_NEON(const SDL_ResamplerPolyphase *polyphase, const float *src, float *dst, int chans, int outframes, int srcindex, int phase)
+{
+    const float *filter;
+    const float *frame;
+    float32x4_t sum[4];
+    float32x2_t stereo[2];
+    int i = 0, j;
+
+    if (chans == 1) {
+        for (; i + 4 <= outframes; i += 4) {
+            for (j = 0; j < 4; j++) {
+                frame = GetResamplerPolyphaseFrame(polyphase, src, 1, &srcindex, &phase, &filter);
+                sum[j] = ResampleMonoFrame_NEON(frame, LoadResamplerFilter_NEON(filter));
+            }
+
+            StoreMonoFrames_NEON(dst, sum[0], sum[1], sum[2], sum[3]);
+            dst += 4;
+        }
+    } else if (chans == 2) {
+        for (; i + 2 <= outframes; i += 2) {
+            for (j = 0; j < 2; j++) {
+                frame = GetResamplerPolyphaseFrame(polyphase, src, 2, &srcindex, &phase, &filter);
+                stereo[j] = ResampleStereoFrame_NEON(frame, LoadResamplerFilter_NEON(filter));
+            }
+
+            vst1q_f32(dst, vcombine_f32(stereo[0], stereo[1]));
+            dst += 4;
+        }
+    }
+
+    for (; i < outframes; i++) {
+        frame = GetResamplerPolyphaseFrame(polyphase, src, chans, &srcindex, &phase, &filter);
+
+        ApplyResamplerFilter_NEON(frame, dst, filter, chans);
+        dst += chans;
+    }
+}
+#endif
+
+static void (*ResampleFrames)(const float *src, float *dst, int chans, int outframes, Sint64 srcpos, Sint64 resample_rate);
+static void (*ResamplePolyphaseFrames)(const SDL_ResamplerPolyphase *polyphase, const float *src, float *dst, int chans, int outframes, int srcindex, int phase);
 
 void SDL_SetupAudioResampler(void)
 {
@@ -215,10 +698,32 @@ void SDL_SetupAudioResampler(void)
     }
 
     ResampleFrame = ResampleFrame_Scalar;
+    ApplyResamplerFilter = ApplyResamplerFilter_Scalar;
+    ResampleFrames = ResampleFrames_Generic;
+    ResamplePolyphaseFrames = ResamplePolyphaseFrames_Generic;
 
 #ifdef SDL_SSE_INTRINSICS
     if (SDL_HasSSE()) {
         ResampleFrame = ResampleFrame_SSE;
+        ApplyResamplerFilter = ApplyResamplerFilter_SSE;
+    }
+#endif
+
+#ifdef SDL_AVX2_INTRINSICS
+    if (SDL_HasAVX2() && SDL_HasFMA()) {
+        ResampleFrame = ResampleFrame_AVX2;
+        ApplyResamplerFilter = ApplyResamplerFilter_AVX2;
+        ResampleFrames = ResampleFrames_AVX2;
+        ResamplePolyphaseFrames = ResamplePolyphaseFrames_AVX2;
+    }
+#endif
+
+#ifdef SDL_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        ResampleFrame = ResampleFrame_NEON;
+        ApplyResamplerFilter = ApplyResamplerFilter_NEON;
+        ResampleFrames = ResampleFrames_NEON;
+        ResamplePolyphaseFrames = ResamplePolyphaseFrames_NEON;
     }
 #endif
 
@@ -236,18 +741,26 @@ Sint64 SDL_GetResampleRate(int src_rate, int dst_rate)
     return sample_rate;
 }
 
-int SDL_GetResamplerHistoryFrames(void)
+int SDL_GetResamplerHistoryFrames(SDL_AudioResamplerQuality quality)
 {
     // Even if we aren't currently resampling, make sure to keep enough history in case we need to later.
 
-    return RESAMPLER_MAX_PADDING_FRAMES;
+    switch (quality) {
+    case SDL_AUDIO_RESAMPLER_NEAREST:
+    case SDL_AUDIO_RESAMPLER_LINEAR:
+        return 1;  // srcpos can start at -1, and we also sample `srcpos + 1`.
+    case SDL_AUDIO_RESAMPLER_CUBIC:
+        return 2;  // we sample from `srcpos - 1` to `srcpos + 2`.
+    default:
+        return RESAMPLER_MAX_PADDING_FRAMES;
+    }
 }
 
-int SDL_GetResamplerPaddingFrames(Sint64 resample_rate)
+int SDL_GetResamplerPaddingFrames(Sint64 resample_rate, SDL_AudioResamplerQuality quality)
 {
     // This must always be <= SDL_GetResamplerHistoryFrames()
 
-    return resample_rate ? RESAMPLER_MAX_PADDING_FRAMES : 0;
+    return resample_rate ? SDL_GetResamplerHistoryFrames(quality) : 0;
 }
 
 // These are not general purpose. They do not check for all possible underflow/overflow
@@ -307,29 +820,248 @@ Sint64 SDL_GetResamplerOutputFrames(Sint64 input_frames, Sint64 resample_rate, S
     return output_frames;
 }
 
-void SDL_ResampleAudio(int chans, const float *src, int inframes, float *dst, int outframes,
-                       Sint64 resample_rate, Sint64 *inout_resample_offset)
+// The cheaper tiers don't have a filter table, so they don't bother with SIMD; they're already far faster than the sinc resampler.
+#define RESAMPLER_FRACTION(srcpos) ((float)((srcpos) & 0xFFFFFFFF) * (1.0f / 4294967296.0f))
+
+static void ResampleFramesNearest(const float *src, float *dst, int chans, int outframes, Sint64 srcpos, Sint64 resample_rate)
 {
-    int i;
-    Sint64 srcpos = *inout_resample_offset;
+    int i, chan;
 
-    SDL_assert(resample_rate > 0);
+    for (i = 0; i < outframes; i++) {
+        const float *frame = &src[(int)(Sint32)((srcpos + 0x80000000) >> 32) * chans];
+        srcpos += resample_rate;
+
+        for (chan = 0; chan < chans; chan++) {
+            dst[chan] = frame[chan];
+        }
+        dst += chans;
+    }
+}
+
+static void ResampleFramesLinear(const float *src, float *dst, int chans, int outframes, Sint64 srcpos, Sint64 resample_rate)
+{
+    int i, chan;
 
     for (i = 0; i < outframes; i++) {
-        int srcindex = (int)(Sint32)(srcpos >> 32);
-        Uint32 srcfraction = (Uint32)(srcpos & 0xFFFFFFFF);
+        const float *frame = &src[(int)(Sint32)(srcpos >> 32) * chans];
+        const float t = RESAMPLER_FRACTION(srcpos);
         srcpos += resample_rate;
 
-        SDL_assert(srcindex >= -1 && srcindex < inframes);
+        for (chan = 0; chan < chans; chan++) {
+            dst[chan] = frame[chan] + ((frame[chan + chans] - frame[chan]) * t);
+        }
+        dst += chans;
+    }
+}
 
-        const float *filter = &FullResamplerFilter[(srcfraction >> RESAMPLER_FILTER_INTERP_BITS) * RESAMPLER_SAMPLES_PER_FRAME];
-        const float interp = (float)(srcfraction & (RESAMPLER_FILTER_INTERP_RANGE - 1)) * (1.0f / RESAMPLER_FILTER_INTERP_RANGE);
+static void ResampleFramesCubic(const float *src, float *dst, int chans, int outframes, Sint64 srcpos, Sint64 resample_rate)
+{
+    int i, chan;
 
-        const float *frame = &src[(srcindex - (RESAMPLER_ZERO_CROSSINGS - 1)) * chans];
-        ResampleFrame(frame, dst, filter, interp, chans);
+    for (i = 0; i < outframes; i++) {
+        const float *frame = &src[(int)(Sint32)(srcpos >> 32) * chans];
+        const float t = RESAMPLER_FRACTION(srcpos);
+        srcpos += resample_rate;
 
+        // Catmull-Rom spline through frame[-1], frame[0], frame[1] and frame[2].
+        for (chan = 0; chan < chans; chan++) {
+            const float y0 = frame[chan - chans];
+            const float y1 = frame[chan];
+            const float y2 = frame[chan + chans];
+            const float y3 = frame[chan + (chans * 2)];
+            const float a = (-0.5f * y0) + (1.5f * y1) - (1.5f * y2) + (0.5f * y3);
+            const float b = y0 - (2.5f * y1) + (2.0f * y2) - (0.5f * y3);
+            const float c = (-0.5f * y0) + (0.5f * y2);
+            dst[chan] = (((((a * t) + b) * t) + c) * t) + y1;
+        }
         dst += chans;
     }
+}
+
+#undef RESAMPLER_FRACTION
+
+void SDL_ResampleAudio(int chans, const float *src, int inframes, float *dst, int outframes,
+                       Sint64 resample_rate, SDL_AudioResamplerQuality quality, Sint64 *inout_resample_offset)
+{
+    const Sint64 srcpos = *inout_resample_offset;
+    const Sint64 endpos = srcpos + ((Sint64)outframes * resample_rate);
+
+    SDL_assert(resample_rate > 0);
+    SDL_assert((outframes <= 0) || ((int)(Sint32)(srcpos >> 32) >= -1));
+    SDL_assert((outframes <= 0) || ((int)(Sint32)((endpos - resample_rate) >> 32) < inframes));
+
+    if (outframes > 0) {
+        switch (quality) {
+        case SDL_AUDIO_RESAMPLER_NEAREST:
+            ResampleFramesNearest(src, dst, chans, outframes, srcpos, resample_rate);
+            break;
+        case SDL_AUDIO_RESAMPLER_LINEAR:
+            ResampleFramesLinear(src, dst, chans, outframes, srcpos, resample_rate);
+            break;
+        case SDL_AUDIO_RESAMPLER_CUBIC:
+            ResampleFramesCubic(src, dst, chans, outframes, srcpos, resample_rate);
+            break;
+        default:
+            ResampleFrames(src, dst, chans, outframes, srcpos, resample_rate);
+            break;
+        }
+    }
+
+    *inout_resample_offset = endpos - ((Sint64)inframes << 32);
+}
+
+// Polyphase filter banks only depend on the number of phases, so streams using the same one share it.
+typedef struct SDL_ResamplerPolyphaseBank
+{
+    int phases;
+    int refcount;
+    struct SDL_ResamplerPolyphaseBank *next;
+    float filters[1];  // actually (phases * RESAMPLER_SAMPLES_PER_FRAME) long.
+} SDL_ResamplerPolyphaseBank;
+
+static SDL_SpinLock polyphase_banks_lock;
+static SDL_ResamplerPolyphaseBank *polyphase_banks;
+
+static const float *ObtainResamplerPolyphaseBank(int phases)
+{
+    SDL_ResamplerPolyphaseBank *bank;
+    int i, j;
+
+    SDL_AtomicLock(&polyphase_banks_lock);
+    for (bank = polyphase_banks; bank; bank = bank->next) {
+        if (bank->phases == phases) {
+            bank->refcount++;
+            break;
+        }
+    }
+    SDL_AtomicUnlock(&polyphase_banks_lock);
+
+    if (bank) {
+        return bank->filters;
+    }
+
+    // Build it outside the lock. Phase `i` is the fractional position i/phases, interpolated from the full filter table in double precision.
+    bank = (SDL_ResamplerPolyphaseBank *)SDL_malloc(sizeof(*bank) + ((phases * RESAMPLER_SAMPLES_PER_FRAME) - 1) * sizeof(float));
+    if (!bank) {
+        return NULL;
+    }
+
+    bank->phases = phases;
+    bank->refcount = 1;
+
+    for (i = 0; i < phases; i++) {
+        const double pos = ((double)i * RESAMPLER_SAMPLES_PER_ZERO_CROSSING) / phases;
+        const int index = (int)pos;
+        const double interp = pos - index;
+        const float *filter = &FullResamplerFilter[index * RESAMPLER_SAMPLES_PER_FRAME];
+
+        for (j = 0; j < RESAMPLER_SAMPLES_PER_FRAME; j++) {
+            bank->filters[(i * RESAMPLER_SAMPLES_PER_FRAME) + j] = (float)((filter[j] * (1.0 - interp)) + (filter[j + RESAMPLER_SAMPLES_PER_FRAME] * interp));
+        }
+    }
+
+    SDL_AtomicLock(&polyphase_banks_lock);
+    bank->next = polyphase_banks;
+    polyphase_banks = bank;
+    SDL_AtomicUnlock(&polyphase_banks_lock);
+
+    return bank->filters;
+}
+
+static void ReleaseResamplerPolyphaseBank(const float *filters)
+{
+    SDL_ResamplerPolyphaseBank *bank;
+    SDL_ResamplerPolyphaseBank *prev = NULL;
+
+    SDL_AtomicLock(&polyphase_banks_lock);
+    for (bank = polyphase_banks; bank; prev = bank, bank = bank->next) {
+        if (bank->filters == filters) {
+            if (--bank->refcount == 0) {
+                if (prev) {
+                    prev->next = bank->next;
+                } else {
+                    polyphase_banks = bank->next;
+                }
+            } else {
+                bank = NULL;  // still in use.
+            }
+            break;
+        }
+    }
+    SDL_AtomicUnlock(&polyphase_banks_lock);
+
+    SDL_free(bank);
+}
+
+static int GreatestCommonDivisor(int a, int b)
+{
+    while (b != 0) {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+SDL_bool SDL_SetupResamplerPolyphase(SDL_ResamplerPolyphase *polyphase, int src_rate, int dst_rate)
+{
+    SDL_assert(src_rate > 0);
+    SDL_assert(dst_rate > 0);
+
+    SDL_ReleaseResamplerPolyphase(polyphase);
+    polyphase->src_rate = src_rate;
+    polyphase->dst_rate = dst_rate;
+
+    const int divisor = GreatestCommonDivisor(src_rate, dst_rate);
+    const int phases = dst_rate / divisor;
+    if ((src_rate == dst_rate) || (phases > RESAMPLER_MAX_POLYPHASE_PHASES)) {
+        return SDL_FALSE;  // not a ratio we handle; use the interpolating resampler.
+    }
+
+    polyphase->filters = ObtainResamplerPolyphaseBank(phases);
+    if (!polyphase->filters) {
+        return SDL_FALSE;  // out of memory is fine, the interpolating resampler still works.
+    }
+
+    polyphase->phases = phases;
+    polyphase->step = (src_rate / divisor) / phases;
+    polyphase->phase_step = (src_rate / divisor) % phases;
+    return SDL_TRUE;
+}
+
+void SDL_ReleaseResamplerPolyphase(SDL_ResamplerPolyphase *polyphase)
+{
+    if (polyphase->filters) {
+        ReleaseResamplerPolyphaseBank(polyphase->filters);
+    }
+    SDL_zerop(polyphase);
+}
+
+void SDL_ResampleAudioPolyphase(const SDL_ResamplerPolyphase *polyphase, int chans, const float *src, int inframes, float *dst, int outframes,
+                                Sint64 *inout_resample_offset)
+{
+    const Sint64 phases = polyphase->phases;
+    const Sint64 srcpos = *inout_resample_offset;
+    int srcindex = (int)(Sint32)(srcpos >> 32);
+
+    // The 32:32 position is never exactly i/phases, so round it to the nearest phase.
+    int phase = (int)((((srcpos & 0xFFFFFFFF) * phases) + 0x80000000) >> 32);
+    if (phase == phases) {
+        phase = 0;
+        srcindex++;
+    }
+
+    SDL_assert(polyphase->filters != NULL);
+    SDL_assert(srcindex >= -1);
+
+    if (outframes > 0) {
+        ResamplePolyphaseFrames(polyphase, src, dst, chans, outframes, srcindex, phase);
+    }
+
+    // Work out where we stopped with exact integer math, then convert back to 32:32, so rounding errors don't build up between calls.
+    const Sint64 advance = ((Sint64)outframes * polyphase->phase_step) + phase;
+    const Sint64 endindex = srcindex + ((Sint64)outframes * polyphase->step) + (advance / phases);
+    const Sint64 endphase = advance % phases;
 
-    *inout_resample_offset = srcpos - ((Sint64)inframes << 32);
+    *inout_resample_offset = ((endindex - inframes) * 0x100000000) + (((endphase << 32) + (phases / 2)) / phases);
 }
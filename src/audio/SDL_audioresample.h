@@ -28,8 +28,9 @@
 
 Sint64 SDL_GetResampleRate(int src_rate, int dst_rate);
 
-int SDL_GetResamplerHistoryFrames(void);
-int SDL_GetResamplerPaddingFrames(Sint64 resample_rate);
+// The cheaper quality tiers look at fewer neighbouring frames, so they need less history and padding.
+int SDL_GetResamplerHistoryFrames(SDL_AudioResamplerQuality quality);
+int SDL_GetResamplerPaddingFrames(Sint64 resample_rate, SDL_AudioResamplerQuality quality);
 
 Sint64 SDL_GetResamplerInputFrames(Sint64 output_frames, Sint64 resample_rate, Sint64 resample_offset);
 Sint64 SDL_GetResamplerOutputFrames(Sint64 input_frames, Sint64 resample_rate, Sint64 *inout_resample_offset);
@@ -38,6 +39,31 @@ Sint64 SDL_GetResamplerOutputFrames(Sint64 input_frames, Sint64 resample_rate, S
 // REQUIRES: `inframes >= SDL_GetResamplerInputFrames(outframes)`
 // REQUIRES: At least `SDL_GetResamplerPaddingFrames(...)` extra frames to the left of src, and right of src+inframes
 void SDL_ResampleAudio(int chans, const float *src, int inframes, float *dst, int outframes,
-                       Sint64 resample_rate, Sint64 *inout_resample_offset);
+                       Sint64 resample_rate, SDL_AudioResamplerQuality quality, Sint64 *inout_resample_offset);
+
+// A bank of precomputed filters for resampling between two rates with a small rational ratio,
+// like 44100Hz and 48000Hz (147:160). This skips interpolating between filter phases.
+// Set up with SDL_SetupResamplerPolyphase; the filters are shared between everything using the same number of phases.
+#define RESAMPLER_MAX_POLYPHASE_PHASES 1024
+
+typedef struct SDL_ResamplerPolyphase
+{
+    int src_rate;  // the rates this was set up for, even if it turned out to be unusable.
+    int dst_rate;
+    int phases;  // dst_rate / gcd(src_rate, dst_rate)
+    int step;  // whole input frames to step per output frame.
+    int phase_step;  // phases to step per output frame.
+    const float *filters;  // (phases * samples-per-frame) floats, or NULL if this ratio isn't handled.
+} SDL_ResamplerPolyphase;
+
+// Returns SDL_TRUE if this pair of rates can use SDL_ResampleAudioPolyphase.
+// This releases whatever `polyphase` held before; release it with SDL_ReleaseResamplerPolyphase when done.
+SDL_bool SDL_SetupResamplerPolyphase(SDL_ResamplerPolyphase *polyphase, int src_rate, int dst_rate);
+void SDL_ReleaseResamplerPolyphase(SDL_ResamplerPolyphase *polyphase);
+
+// Same as SDL_ResampleAudio with SDL_AUDIO_RESAMPLER_SINC, with the same requirements, but for the rates `polyphase` was set up for.
+// `inout_resample_offset` is snapped to the nearest filter phase.
+void SDL_ResampleAudioPolyphase(const SDL_ResamplerPolyphase *polyphase, int chans, const float *src, int inframes, float *dst, int outframes,
+                                Sint64 *inout_resample_offset);
 
 #endif // SDL_audioresample_h_
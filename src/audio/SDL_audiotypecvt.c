@@ -753,9 +753,9 @@ static void SDL_Convert_F32_to_S8_NEON(Sint8 *dst, const float *src, int num_sam
 
     SDL_assert(!i || !(((size_t)dst) & 15));
 
-    // Make sure src is aligned too.
-    if (!(((size_t)src) & 15)) {
-        // Aligned! Do NEON blocks as long as we have 16 bytes available.
+    // src doesn't have to be aligned, vld1q_f32 only needs it to be float-aligned. (The output might be a device buffer, which isn't aligned to our float buffers.)
+    {
+        // Do NEON blocks as long as we have 16 bytes available.
         const float32x4_t one = vdupq_n_f32(1.0f);
         const float32x4_t negone = vdupq_n_f32(-1.0f);
         const float32x4_t mulby127 = vdupq_n_f32(127.0f);
@@ -811,9 +811,9 @@ static void SDL_Convert_F32_to_U8_NEON(Uint8 *dst, const float *src, int num_sam
 
     SDL_assert(!i || !(((size_t)dst) & 15));
 
-    // Make sure src is aligned too.
-    if (!(((size_t)src) & 15)) {
-        // Aligned! Do NEON blocks as long as we have 16 bytes available.
+    // src doesn't have to be aligned, vld1q_f32 only needs it to be float-aligned. (The output might be a device buffer, which isn't aligned to our float buffers.)
+    {
+        // Do NEON blocks as long as we have 16 bytes available.
         const float32x4_t one = vdupq_n_f32(1.0f);
         const float32x4_t negone = vdupq_n_f32(-1.0f);
         const float32x4_t mulby127 = vdupq_n_f32(127.0f);
@@ -870,9 +870,9 @@ static void SDL_Convert_F32_to_S16_NEON(Sint16 *dst, const float *src, int num_s
 
     SDL_assert(!i || !(((size_t)dst) & 15));
 
-    // Make sure src is aligned too.
-    if (!(((size_t)src) & 15)) {
-        // Aligned! Do NEON blocks as long as we have 16 bytes available.
+    // src doesn't have to be aligned, vld1q_f32 only needs it to be float-aligned. (The output might be a device buffer, which isn't aligned to our float buffers.)
+    {
+        // Do NEON blocks as long as we have 16 bytes available.
         const float32x4_t one = vdupq_n_f32(1.0f);
         const float32x4_t negone = vdupq_n_f32(-1.0f);
         const float32x4_t mulby32767 = vdupq_n_f32(32767.0f);
@@ -923,10 +923,10 @@ static void SDL_Convert_F32_to_S32_NEON(Sint32 *dst, const float *src, int num_s
     }
 
     SDL_assert(!i || !(((size_t)dst) & 15));
-    SDL_assert(!i || !(((size_t)src) & 15));
 
+    // src doesn't have to be aligned, vld1q_f32 only needs it to be float-aligned.
     {
-        // Aligned! Do NEON blocks as long as we have 16 bytes available.
+        // Do NEON blocks as long as we have 16 bytes available.
         const float32x4_t one = vdupq_n_f32(1.0f);
         const float32x4_t negone = vdupq_n_f32(-1.0f);
         const float32x4_t mulby8388607 = vdupq_n_f32(8388607.0f);
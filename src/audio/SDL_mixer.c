@@ -82,7 +82,287 @@ static const Uint8 mix8[] = {
 #define ADJUST_VOLUME_U8(s, v)    ((s) = (Uint8)(((((s) - 128) * (v)) / SDL_MIX_MAXVOLUME) + 128))
 
 
-// !!! FIXME: this needs some SIMD magic.
+#define SDL_MIX_FLOAT_MAX 3.402823466e+38F
+
+// Float mixing kernels: dst[i] += src[i] * volume, clamped to the float range like the old double-precision path.
+// There's no need to widen to double; the sum only needs clamping when it overflows to infinity.
+
+static void SDL_MixFloat32_Scalar(float *dst, const float *src, int num_samples, float volume)
+{
+    int i;
+
+    LOG_DEBUG_AUDIO_CONVERT("F32", "F32 mix");
+
+    for (i = 0; i < num_samples; ++i) {
+        const float sample = dst[i] + (src[i] * volume);
+        dst[i] = SDL_clamp(sample, -SDL_MIX_FLOAT_MAX, SDL_MIX_FLOAT_MAX);
+    }
+}
+
+#ifdef SDL_SSE_INTRINSICS
+static void SDL_TARGETING("sse") SDL_MixFloat32_SSE(float *dst, const float *src, int num_samples, float volume)
+{
+    const __m128 vol = _mm_set1_ps(volume);
+    const __m128 maxval = _mm_set1_ps(SDL_MIX_FLOAT_MAX);
+    const __m128 minval = _mm_set1_ps(-SDL_MIX_FLOAT_MAX);
+    int i = 0;
+
+    LOG_DEBUG_AUDIO_CONVERT("F32", "F32 mix (using SSE)");
+
+    for (; i + 8 <= num_samples; i += 8) {
+        __m128 sum1 = _mm_add_ps(_mm_loadu_ps(&dst[i]), _mm_mul_ps(_mm_loadu_ps(&src[i]), vol));
+        __m128 sum2 = _mm_add_ps(_mm_loadu_ps(&dst[i + 4]), _mm_mul_ps(_mm_loadu_ps(&src[i + 4]), vol));
+        sum1 = _mm_max_ps(minval, _mm_min_ps(maxval, sum1));
+        sum2 = _mm_max_ps(minval, _mm_min_ps(maxval, sum2));
+        _mm_storeu_ps(&dst[i], sum1);
+        _mm_storeu_ps(&dst[i + 4], sum2);
+    }
+
+    SDL_MixFloat32_Scalar(&dst[i], &src[i], num_samples - i, volume);
+}
+#endif
+
+#ifdef SDL_AVX_INTRINSICS
+static void SDL_TARGETING("avx") SDL_MixFloat32_AVX(float *dst, const float *src, int num_samples, float volume)
+{
+    const __m256 vol = _mm256_set1_ps(volume);
+    const __m256 maxval = _mm256_set1_ps(SDL_MIX_FLOAT_MAX);
+    const __m256 minval = _mm256_set1_ps(-SDL_MIX_FLOAT_MAX);
+    int i = 0;
+
+    LOG_DEBUG_AUDIO_CONVERT("F32", "F32 mix (using AVX)");
+
+    for (; i + 16 <= num_samples; i += 16) {
+        __m256 sum1 = _mm256_add_ps(_mm256_loadu_ps(&dst[i]), _mm256_mul_ps(_mm256_loadu_ps(&src[i]), vol));
+        __m256 sum2 = _mm256_add_ps(_mm256_loadu_ps(&dst[i + 8]), _mm256_mul_ps(_mm256_loadu_ps(&src[i + 8]), vol));
+        sum1 = _mm256_max_ps(minval, _mm256_min_ps(maxval, sum1));
+        sum2 = _mm256_max_ps(minval, _mm256_min_ps(maxval, sum2));
+        _mm256_storeu_ps(&dst[i], sum1);
+        _mm256_storeu_ps(&dst[i + 8], sum2);
+    }
+
+    // Avoid the AVX-SSE transition penalty in whatever runs next
+    _mm256_zeroupper();
+
+    SDL_MixFloat32_Scalar(&dst[i], &src[i], num_samples - i, volume);
+}
+#endif
+
+#ifdef SDL_NEON_INTRINSICS
+static void SDL_MixFloat32_NEON(float *dst, const float *src, int num_samples, float volume)
+{
+    const float32x4_t vol = vdupq_n_f32(volume);
+    const float32x4_t maxval = vdupq_n_f32(SDL_MIX_FLOAT_MAX);
+    const float32x4_t minval = vdupq_n_f32(-SDL_MIX_FLOAT_MAX);
+    int i = 0;
+
+    LOG_DEBUG_AUDIO_CONVERT("F32", "F32 mix (using NEON)");
+
+    for (; i + 8 <= num_samples; i += 8) {
+        float32x4_t sum1 = vmlaq_f32(vld1q_f32(&dst[i]), vld1q_f32(&src[i]), vol);
+        float32x4_t sum2 = vmlaq_f32(vld1q_f32(&dst[i + 4]), vld1q_f32(&src[i + 4]), vol);
+        sum1 = vmaxq_f32(minval, vminq_f32(maxval, sum1));
+        sum2 = vmaxq_f32(minval, vminq_f32(maxval, sum2));
+        vst1q_f32(&dst[i], sum1);
+        vst1q_f32(&dst[i + 4], sum2);
+    }
+
+    SDL_MixFloat32_Scalar(&dst[i], &src[i], num_samples - i, volume);
+}
+#endif
+
+/* Per-channel gain kernels. Frame i of channel c is scaled by start_gains[c] + (steps[c] * i), where each step is a
+   channel's change in gain divided by the number of frames, so the next buffer picks up where this one left off. */
+
+static void GetMixGainSteps(int num_frames, int channels, const float *start_gains, const float *end_gains, float *steps)
+{
+    for (int c = 0; c < channels; c++) {
+        steps[c] = (end_gains[c] - start_gains[c]) / (float) num_frames;
+    }
+}
+
+static void MixFloat32GainsFromFrame(float *dst, const float *src, int frame, int num_frames, int channels, const float *start_gains, const float *steps)
+{
+    for (; frame < num_frames; frame++) {
+        for (int c = 0; c < channels; c++) {
+            const int i = (frame * channels) + c;
+            const float sample = dst[i] + (src[i] * (start_gains[c] + (steps[c] * (float) frame)));
+            dst[i] = SDL_clamp(sample, -SDL_MIX_FLOAT_MAX, SDL_MIX_FLOAT_MAX);
+        }
+    }
+}
+
+static void SDL_MixFloat32Gains_Scalar(float *dst, const float *src, int num_frames, int channels, const float *start_gains, const float *end_gains)
+{
+    float steps[SDL_MAX_AUDIO_CHANNELS];
+
+    LOG_DEBUG_AUDIO_CONVERT("F32", "F32 mix with gains");
+
+    GetMixGainSteps(num_frames, channels, start_gains, end_gains, steps);
+    MixFloat32GainsFromFrame(dst, src, 0, num_frames, channels, start_gains, steps);
+}
+
+/* The SIMD versions work in blocks of lcm(channels, lanes) samples, so every lane of a vector always holds the same channel
+   (and each block needs at most SDL_MAX_AUDIO_CHANNELS vectors: 7 channels of SSE is 28 samples). Each vector's gains are
+   set up once for the first block, along with how much they change from one block to the next. */
+static int GetMixGainBlock(int channels, int lanes, const float *start_gains, const float *steps, float *block_gains, float *block_steps)
+{
+    int block_samples = channels;
+    while (block_samples % lanes) {
+        block_samples += channels;
+    }
+
+    const int block_frames = block_samples / channels;
+    for (int i = 0; i < block_samples; i++) {
+        const int c = i % channels;
+        block_gains[i] = start_gains[c] + (steps[c] * (float) (i / channels));
+        block_steps[i] = steps[c] * (float) block_frames;
+    }
+
+    return block_frames;
+}
+
+#ifdef SDL_SSE_INTRINSICS
+static void SDL_TARGETING("sse") SDL_MixFloat32Gains_SSE(float *dst, const float *src, int num_frames, int channels, const float *start_gains, const float *end_gains)
+{
+    float steps[SDL_MAX_AUDIO_CHANNELS];
+    float block_gains[SDL_MAX_AUDIO_CHANNELS * 4];
+    float block_steps[SDL_MAX_AUDIO_CHANNELS * 4];
+    const __m128 maxval = _mm_set1_ps(SDL_MIX_FLOAT_MAX);
+    const __m128 minval = _mm_set1_ps(-SDL_MIX_FLOAT_MAX);
+
+    LOG_DEBUG_AUDIO_CONVERT("F32", "F32 mix with gains (using SSE)");
+
+    GetMixGainSteps(num_frames, channels, start_gains, end_gains, steps);
+    const int block_frames = GetMixGainBlock(channels, 4, start_gains, steps, block_gains, block_steps);
+    const int block_vectors = (block_frames * channels) / 4;
+    const int num_blocks = num_frames / block_frames;
+
+    for (int block = 0; block < num_blocks; block++) {
+        const __m128 blockval = _mm_set1_ps((float) block);
+        const int offset = block * block_frames * channels;
+        for (int v = 0; v < block_vectors; v++) {
+            const int i = offset + (v * 4);
+            const __m128 gain = _mm_add_ps(_mm_loadu_ps(&block_gains[v * 4]), _mm_mul_ps(_mm_loadu_ps(&block_steps[v * 4]), blockval));
+            __m128 sum = _mm_add_ps(_mm_loadu_ps(&dst[i]), _mm_mul_ps(_mm_loadu_ps(&src[i]), gain));
+            sum = _mm_max_ps(minval, _mm_min_ps(maxval, sum));
+            _mm_storeu_ps(&dst[i], sum);
+        }
+    }
+
+    MixFloat32GainsFromFrame(dst, src, num_blocks * block_frames, num_frames, channels, start_gains, steps);
+}
+#endif
+
+#ifdef SDL_AVX_INTRINSICS
+static void SDL_TARGETING("avx") SDL_MixFloat32Gains_AVX(float *dst, const float *src, int num_frames, int channels, const float *start_gains, const float *end_gains)
+{
+    float steps[SDL_MAX_AUDIO_CHANNELS];
+    float block_gains[SDL_MAX_AUDIO_CHANNELS * 8];
+    float block_steps[SDL_MAX_AUDIO_CHANNELS * 8];
+    const __m256 maxval = _mm256_set1_ps(SDL_MIX_FLOAT_MAX);
+    const __m256 minval = _mm256_set1_ps(-SDL_MIX_FLOAT_MAX);
+
+    LOG_DEBUG_AUDIO_CONVERT("F32", "F32 mix with gains (using AVX)");
+
+    GetMixGainSteps(num_frames, channels, start_gains, end_gains, steps);
+    const int block_frames = GetMixGainBlock(channels, 8, start_gains, steps, block_gains, block_steps);
+    const int block_vectors = (block_frames * channels) / 8;
+    const int num_blocks = num_frames / block_frames;
+
+    for (int block = 0; block < num_blocks; block++) {
+        const __m256 blockval = _mm256_set1_ps((float) block);
+        const int offset = block * block_frames * channels;
+        for (int v = 0; v < block_vectors; v++) {
+            const int i = offset + (v * 8);
+            const __m256 gain = _mm256_add_ps(_mm256_loadu_ps(&block_gains[v * 8]), _mm256_mul_ps(_mm256_loadu_ps(&block_steps[v * 8]), blockval));
+            __m256 sum = _mm256_add_ps(_mm256_loadu_ps(&dst[i]), _mm256_mul_ps(_mm256_loadu_ps(&src[i]), gain));
+            sum = _mm256_max_ps(minval, _mm256_min_ps(maxval, sum));
+            _mm256_storeu_ps(&dst[i], sum);
+        }
+    }
+
+    // Avoid the AVX-SSE transition penalty in whatever runs next
+    _mm256_zeroupper();
+
+    MixFloat32GainsFromFrame(dst, src, num_blocks * block_frames, num_frames, channels, start_gains, steps);
+}
+#endif
+
+#ifdef SDL_NEON_INTRINSICS
+static void SDL_MixFloat32Gains_NEON(float *dst, const float *src, int num_frames, int channels, const float *start_gains, const float *end_gains)
+{
+    float steps[SDL_MAX_AUDIO_CHANNELS];
+    float block_gains[SDL_MAX_AUDIO_CHANNELS * 4];
+    float block_steps[SDL_MAX_AUDIO_CHANNELS * 4];
+    const float32x4_t maxval = vdupq_n_f32(SDL_MIX_FLOAT_MAX);
+    const float32x4_t minval = vdupq_n_f32(-SDL_MIX_FLOAT_MAX);
+
+    LOG_DEBUG_AUDIO_CONVERT("F32", "F32 mix with gains (using NEON)");
+
+    GetMixGainSteps(num_frames, channels, start_gains, end_gains, steps);
+    const int block_frames = GetMixGainBlock(channels, 4, start_gains, steps, block_gains, block_steps);
+    const int block_vectors = (block_frames * channels) / 4;
+    const int num_blocks = num_frames / block_frames;
+
+    for (int block = 0; block < num_blocks; block++) {
+        const float32x4_t blockval = vdupq_n_f32((float) block);
+        const int offset = block * block_frames * channels;
+        for (int v = 0; v < block_vectors; v++) {
+            const int i = offset + (v * 4);
+            const float32x4_t gain = vmlaq_f32(vld1q_f32(&block_gains[v * 4]), vld1q_f32(&block_steps[v * 4]), blockval);
+            float32x4_t sum = vmlaq_f32(vld1q_f32(&dst[i]), vld1q_f32(&src[i]), gain);
+            sum = vmaxq_f32(minval, vminq_f32(maxval, sum));
+            vst1q_f32(&dst[i], sum);
+        }
+    }
+
+    MixFloat32GainsFromFrame(dst, src, num_blocks * block_frames, num_frames, channels, start_gains, steps);
+}
+#endif
+
+// Function pointer set to a CPU-specific implementation.
+void (*SDL_MixFloat32)(float *dst, const float *src, int num_samples, float volume) = NULL;
+void (*SDL_MixFloat32Gains)(float *dst, const float *src, int num_frames, int channels, const float *start_gains, const float *end_gains) = NULL;
+
+void SDL_ChooseAudioMixers(void)
+{
+    static SDL_bool mixers_chosen = SDL_FALSE;
+    if (mixers_chosen) {
+        return;
+    }
+
+#ifdef SDL_AVX_INTRINSICS
+    if (SDL_HasAVX()) {
+        SDL_MixFloat32 = SDL_MixFloat32_AVX;
+        SDL_MixFloat32Gains = SDL_MixFloat32Gains_AVX;
+        mixers_chosen = SDL_TRUE;
+        return;
+    }
+#endif
+
+#ifdef SDL_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        SDL_MixFloat32 = SDL_MixFloat32_SSE;
+        SDL_MixFloat32Gains = SDL_MixFloat32Gains_SSE;
+        mixers_chosen = SDL_TRUE;
+        return;
+    }
+#endif
+
+#ifdef SDL_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        SDL_MixFloat32 = SDL_MixFloat32_NEON;
+        SDL_MixFloat32Gains = SDL_MixFloat32Gains_NEON;
+        mixers_chosen = SDL_TRUE;
+        return;
+    }
+#endif
+
+    SDL_MixFloat32 = SDL_MixFloat32_Scalar;
+    SDL_MixFloat32Gains = SDL_MixFloat32Gains_Scalar;
+    mixers_chosen = SDL_TRUE;
+}
 
 int SDL_MixAudioFormat(Uint8 *dst, const Uint8 *src, SDL_AudioFormat format,
                         Uint32 len, int volume)
@@ -230,58 +510,33 @@ int SDL_MixAudioFormat(Uint8 *dst, const Uint8 *src, SDL_AudioFormat format,
     } break;
 
     case SDL_AUDIO_F32LE:
-    {
-        const float fmaxvolume = 1.0f / ((float)SDL_MIX_MAXVOLUME);
-        const float fvolume = (float)volume;
-        const float *src32 = (float *)src;
-        float *dst32 = (float *)dst;
-        float src1, src2;
-        double dst_sample;
-        // !!! FIXME: are these right?
-        const double max_audioval = 3.402823466e+38F;
-        const double min_audioval = -3.402823466e+38F;
-
-        len /= 4;
-        while (len--) {
-            src1 = ((SDL_SwapFloatLE(*src32) * fvolume) * fmaxvolume);
-            src2 = SDL_SwapFloatLE(*dst32);
-            src32++;
-
-            dst_sample = ((double)src1) + ((double)src2);
-            if (dst_sample > max_audioval) {
-                dst_sample = max_audioval;
-            } else if (dst_sample < min_audioval) {
-                dst_sample = min_audioval;
-            }
-            *(dst32++) = SDL_SwapFloatLE((float)dst_sample);
-        }
-    } break;
-
     case SDL_AUDIO_F32BE:
     {
-        const float fmaxvolume = 1.0f / ((float)SDL_MIX_MAXVOLUME);
-        const float fvolume = (float)volume;
-        const float *src32 = (float *)src;
-        float *dst32 = (float *)dst;
-        float src1, src2;
-        double dst_sample;
-        // !!! FIXME: are these right?
-        const double max_audioval = 3.402823466e+38F;
-        const double min_audioval = -3.402823466e+38F;
+        // The kernels multiply by volume / SDL_MIX_MAXVOLUME, which is exact since the divisor is a power of two.
+        const float fvolume = (float)volume / ((float)SDL_MIX_MAXVOLUME);
 
-        len /= 4;
-        while (len--) {
-            src1 = ((SDL_SwapFloatBE(*src32) * fvolume) * fmaxvolume);
-            src2 = SDL_SwapFloatBE(*dst32);
-            src32++;
+        if (format == SDL_AUDIO_F32) {
+            SDL_ChooseAudioMixers();
+            SDL_MixFloat32((float *)dst, (const float *)src, (int)(len / 4), fvolume);
+        } else {
+            const Uint32 *src32 = (const Uint32 *)src;
+            Uint32 *dst32 = (Uint32 *)dst;
+            union
+            {
+                Uint32 u32;
+                float f32;
+            } src1, dst1;
 
-            dst_sample = ((double)src1) + ((double)src2);
-            if (dst_sample > max_audioval) {
-                dst_sample = max_audioval;
-            } else if (dst_sample < min_audioval) {
-                dst_sample = min_audioval;
+            len /= 4;
+            while (len--) {
+                float sample;
+
+                src1.u32 = SDL_Swap32(*(src32++));
+                dst1.u32 = SDL_Swap32(*dst32);
+                sample = dst1.f32 + (src1.f32 * fvolume);
+                dst1.f32 = SDL_clamp(sample, -SDL_MIX_FLOAT_MAX, SDL_MIX_FLOAT_MAX);
+                *(dst32++) = SDL_Swap32(dst1.u32);
             }
-            *(dst32++) = SDL_SwapFloatBE((float)dst_sample);
         }
     } break;
 
@@ -25,6 +25,7 @@
 #define SDL_sysaudio_h_
 
 #include "../SDL_hashtable.h"
+#include "SDL_audioresample.h"
 
 #define DEBUG_AUDIOSTREAM 0
 #define DEBUG_AUDIO_CONVERT 0
@@ -45,6 +46,15 @@ extern void (*SDL_Convert_F32_to_U8)(Uint8 *dst, const float *src, int num_sampl
 extern void (*SDL_Convert_F32_to_S16)(Sint16 *dst, const float *src, int num_samples);
 extern void (*SDL_Convert_F32_to_S32)(Sint32 *dst, const float *src, int num_samples);
 
+// This pointer gets set during SDL_ChooseAudioMixers() to a SIMD implementation: dst[i] += src[i] * volume
+extern void (*SDL_MixFloat32)(float *dst, const float *src, int num_samples, float volume);
+
+// The most channels SDL supports, for sizing per-channel arrays.
+#define SDL_MAX_AUDIO_CHANNELS 8
+
+// Also set during SDL_ChooseAudioMixers(): like SDL_MixFloat32, but with a volume per channel, ramped linearly from start_gains to end_gains over the buffer.
+extern void (*SDL_MixFloat32Gains)(float *dst, const float *src, int num_frames, int channels, const float *start_gains, const float *end_gains);
+
 // !!! FIXME: These are wordy and unlocalized...
 #define DEFAULT_OUTPUT_DEVNAME "System audio output device"
 #define DEFAULT_INPUT_DEVNAME  "System audio capture device"
@@ -60,6 +70,27 @@ extern void (*SDL_Convert_F32_to_S32)(Sint32 *dst, const float *src, int num_sam
 
 #define AUDIO_SPECS_EQUAL(x, y) (((x).format == (y).format) && ((x).channels == (y).channels) && ((x).freq == (y).freq))
 
+// ConvertAudio's work, decided up front: a fixed list of steps that each convert a buffer of frames.
+#define SDL_AUDIO_CONVERT_MAX_STEPS 5  // byteswap, to float, channels, from float, byteswap.
+
+typedef struct SDL_AudioConvertStep
+{
+    void (*convert)(const struct SDL_AudioConvertStep *step, void *dst, const void *src, int num_frames);
+    int src_channels;
+    int dst_channels;
+    int frame_size;  // bytes per frame, for steps that only copy.
+    void (*channel_converter)(float *dst, const float *src, int num_frames);
+    const float *matrix;
+    SDL_bool to_scratch;  // SDL_TRUE to write to the scratch buffer, SDL_FALSE to write to the output.
+} SDL_AudioConvertStep;
+
+typedef struct SDL_AudioConvertPlan
+{
+    int num_steps;  // zero if the plan hasn't been built.
+    int max_frame_size;  // the scratch buffer needs this many bytes per frame.
+    SDL_AudioConvertStep steps[SDL_AUDIO_CONVERT_MAX_STEPS];
+} SDL_AudioConvertPlan;
+
 typedef struct SDL_AudioDevice SDL_AudioDevice;
 typedef struct SDL_LogicalAudioDevice SDL_LogicalAudioDevice;
 
@@ -74,6 +105,8 @@ const SDL_AudioFormat *SDL_ClosestAudioFormats(SDL_AudioFormat format);
 
 // Must be called at least once before using converters.
 extern void SDL_ChooseAudioConverters(void);
+extern void SDL_ChooseAudioChannelConverters(void);
+extern void SDL_ChooseAudioMixers(void);
 extern void SDL_SetupAudioResampler(void);
 
 /* Backends should call this as devices are added to the system (such as
@@ -106,6 +139,12 @@ extern void SDL_UpdatedAudioDeviceFormat(SDL_AudioDevice *device);
 // Backends can call this to get a standardized name for a thread to power a specific audio device.
 extern char *SDL_GetAudioThreadName(SDL_AudioDevice *device, char *buf, size_t buflen);
 
+// Backends should call this when the platform reports an underrun (output) or overrun (capture). Safe to call from any thread.
+extern void SDL_AudioDeviceReportXrun(SDL_AudioDevice *device);
+
+// A PollDevice for backends that just pace themselves on a clock: ready once every `interval_ns`, otherwise sets *wait_ns. Always returns 0 or 1.
+extern int SDL_PollAudioDeviceTimer(SDL_AudioDevice *device, Uint64 interval_ns, Uint64 *wait_ns);
+
 // Backends can call these to change a device's refcount.
 extern void RefPhysicalAudioDevice(SDL_AudioDevice *device);
 extern void UnrefPhysicalAudioDevice(SDL_AudioDevice *device);
@@ -123,9 +162,34 @@ extern void SDL_AudioThreadFinalize(SDL_AudioDevice *device);
 extern void ConvertAudio(int num_frames, const void *src, SDL_AudioFormat src_format, int src_channels,
                          void *dst, SDL_AudioFormat dst_format, int dst_channels, void* scratch);
 
+// The same thing in two parts, for conversions that happen over and over: decide how to convert once, then run it on each buffer.
+extern void BuildAudioConvertPlan(SDL_AudioConvertPlan *plan, SDL_AudioFormat src_format, int src_channels, SDL_AudioFormat dst_format, int dst_channels);
+extern void RunAudioConvertPlan(const SDL_AudioConvertPlan *plan, int num_frames, const void *src, void *dst, void *scratch);
+
 // Special case to let something in SDL_audiocvt.c access something in SDL_audio.c. Don't use this.
 extern void OnAudioStreamCreated(SDL_AudioStream *stream);
 extern void OnAudioStreamDestroy(SDL_AudioStream *stream);
+extern void OnAudioStreamUnbound(SDL_AudioStream *stream);  // during SDL_DestroyAudioStream, once no device thread can reach the stream.
+
+// Call with stream->lock held. Asks the prefetch worker to run the stream's get callback; returns SDL_FALSE if it can't, so call it yourself.
+extern SDL_bool SDL_RequestAudioStreamPrefetch(SDL_AudioStream *stream, int additional_amount, int total_amount);
+
+// Queues an SDL_EVENT_AUDIO_STREAM_*_WATERMARK event for the next SDL_UpdateAudio, replacing one of the same type that hasn't gone out yet.
+// Doesn't allocate or take any locks besides a spinlock, so device threads can call it. Does nothing if the audio subsystem isn't initialized.
+extern void SDL_QueueAudioStreamWatermarkEvent(SDL_AudioStream *stream, Uint32 type, int queued);
+
+// SDL_TRUE if reading `frames` from the stream would have to pad with silence until someone puts more data in:
+// it has less than that queued, hasn't been flushed, and has no get callback. You must hold stream->lock.
+extern SDL_bool SDL_IsAudioStreamWaitingForData(SDL_AudioStream *stream, int frames);
+
+// Call this with stream->lock held after changing a stream's dst_spec directly, so it recompiles its conversion plans.
+extern void UpdateAudioStreamConvertPlans(SDL_AudioStream *stream);
+
+// Call this with stream->lock held after changing a stream's specs, put callback or ring buffer, so SDL_PutAudioStreamData's lock-free path sees it.
+extern void UpdateAudioStreamRingFrameSize(SDL_AudioStream *stream);
+
+// Call this with stream->lock held after changing a stream's gains or mixed_gains, so the device can check unity_gains without locking the stream.
+extern void UpdateAudioStreamUnityGains(SDL_AudioStream *stream);
 
 typedef struct SDL_AudioDriverImpl
 {
@@ -141,6 +205,8 @@ typedef struct SDL_AudioDriverImpl
     void (*FlushCapture)(SDL_AudioDevice *device);
     void (*CloseDevice)(SDL_AudioDevice *device);
     void (*FreeDeviceHandle)(SDL_AudioDevice *device); // SDL is done with this device; free the handle from SDL_AddAudioDevice()
+    int (*PollDevice)(SDL_AudioDevice *device, Uint64 *wait_ns);  // Optional (NULL if unsupported): a WaitDevice/WaitCaptureDevice that doesn't block, so a shared thread can drive this device. Return 1 if ready, 0 if not (set *wait_ns to about how long until it will be), -1 on failure. Must not need ThreadInit.
+    int (*ResizeDevice)(SDL_AudioDevice *device, int *sample_frames);  // Optional (NULL if unsupported): resize an opened output device's buffer. Called on the device thread with the lock held; update *sample_frames if you can't do exactly that size.
     void (*DeinitializeStart)(void); // SDL calls this, then starts destroying objects, then calls Deinitialize. This is a good place to stop hotplug detection.
     void (*Deinitialize)(void);
 
@@ -156,6 +222,8 @@ typedef struct SDL_PendingAudioDeviceEvent
 {
     Uint32 type;
     SDL_AudioDeviceID devid;
+    SDL_AudioStream *stream;  // for SDL_EVENT_AUDIO_STREAM_* events, instead of devid.
+    int queued;
     struct SDL_PendingAudioDeviceEvent *next;
 } SDL_PendingAudioDeviceEvent;
 
@@ -171,6 +239,13 @@ typedef struct SDL_AudioDriver
     SDL_AudioDeviceID default_capture_device_id;
     SDL_PendingAudioDeviceEvent pending_events;
     SDL_PendingAudioDeviceEvent *pending_events_tail;
+    SDL_SpinLock pending_stream_events_lock;  // only held long enough to link or unlink one stream's watermark event, so device threads can queue them.
+    SDL_PendingAudioDeviceEvent pending_stream_events;  // list of streams' watermark_events nodes; nothing is allocated to queue them.
+    SDL_PendingAudioDeviceEvent *pending_stream_events_tail;
+    struct SDL_AudioMixPool *mix_pool;  // optional worker threads for parallel mixing (SDL_HINT_AUDIO_MIX_THREADS). NULL if disabled.
+    struct SDL_AudioPrefetcher *prefetcher;  // runs get callbacks for streams with "SDL.audiostream.get_callback.async" set.
+    struct SDL_SharedAudioThread **shared_threads;  // optional threads that each drive several devices (SDL_HINT_AUDIO_SHARED_DEVICE_THREADS). NULL if disabled.
+    int num_shared_threads;
 
     // !!! FIXME: most (all?) of these don't have to be atomic.
     SDL_AtomicInt output_device_count;
@@ -188,18 +263,44 @@ struct SDL_AudioStream
 
     SDL_AudioStreamCallback get_callback;
     void *get_callback_userdata;
+    int get_callback_quantum;  // these three are latched from the stream's properties each time data is read.
+    int get_callback_prefetch;
+    SDL_bool get_callback_async;
+    int prefetch_additional;  // what the prefetch worker should ask the get callback for.
+    int prefetch_total;
+    SDL_bool prefetch_queued;  // protected by the prefetch worker's lock, not this stream's, like next_prefetch.
+    SDL_AudioStream *next_prefetch;
+    int watermark_state;  // -1 below the low watermark, 1 at or above the high watermark, 0 otherwise.
+    Sint64 low_watermark;  // latched from the stream's properties when data is put or read after they changed.
+    Sint64 high_watermark;
+    SDL_PendingAudioDeviceEvent watermark_events[2];  // [0] low, [1] high. Protected by current_audio.pending_stream_events_lock, like watermark_event_queued.
+    SDL_bool watermark_event_queued[2];  // SDL_TRUE while watermark_events[i] is in current_audio.pending_stream_events.
     SDL_AudioStreamCallback put_callback;
     void *put_callback_userdata;
 
     SDL_AudioSpec src_spec;
     SDL_AudioSpec dst_spec;
     float freq_ratio;
+    float gain;  // SDL_SetAudioStreamGain
+    float channel_gains[SDL_MAX_AUDIO_CHANNELS];  // SDL_SetAudioStreamChannelGains
+    float mixed_gains[SDL_MAX_AUDIO_CHANNELS];  // what the device mix last scaled each channel by; the next mix ramps from here.
+    SDL_AtomicInt unity_gains;  // 1 if every gain is 1.0f and no ramp is in progress, so the device mix doesn't need to scale anything.
+    SDL_AudioResamplerQuality resampler_quality;  // latched from the stream's properties when data is read after they changed.
+    Uint32 props_serial;  // SDL_GetPropertiesSerial() when the stream's properties were last latched.
 
     struct SDL_AudioQueue* queue;
     Uint64 total_bytes_queued;
+    struct SDL_AudioRing *ring;  // single-producer mode: SDL_PutAudioStreamData writes here without locking. NULL if not in use.
+    SDL_AtomicInt ring_frame_size;  // src_spec's frame size while SDL_PutAudioStreamData may use the ring without locking, 0 otherwise.
 
     SDL_AudioSpec input_spec; // The spec of input data currently being processed
     Sint64 resample_offset;
+    SDL_ResamplerPolyphase polyphase;  // precomputed filters, if input_spec's rate and dst_spec's rate allow it.
+
+    // Conversions between input_spec and dst_spec, rebuilt whenever either of them changes.
+    SDL_AudioConvertPlan convert_plan;  // straight to dst_spec, when not resampling.
+    SDL_AudioConvertPlan resample_input_plan;  // to float32 with the channel count the resampler works in.
+    SDL_AudioConvertPlan resample_output_plan;  // from the resampler's output to dst_spec.
 
     Uint8 *work_buffer;    // used for scratch space during data conversion/resampling.
     size_t work_buffer_allocation;
@@ -270,6 +371,7 @@ struct SDL_AudioDevice
     int (*WaitCaptureDevice)(SDL_AudioDevice *device);
     int (*CaptureFromDevice)(SDL_AudioDevice *device, void *buffer, int buflen);
     void (*FlushCapture)(SDL_AudioDevice *device);
+    int (*PollDevice)(SDL_AudioDevice *device, Uint64 *wait_ns);
 
     // human-readable name of the device. ("SoundBlaster Pro 16")
     char *name;
@@ -313,9 +415,40 @@ struct SDL_AudioDevice
     // Size of work_buffer (and mix_buffer) in bytes.
     int work_buffer_size;
 
+    // Converts the final float32 mix to the device's format.
+    SDL_AudioConvertPlan output_plan;
+
+    // Per-partition scratch and partial mix buffers for parallel mixing, each work_buffer_size bytes. NULL if not used.
+    //  Partition 0 runs on the device thread and uses work_buffer directly, so these hold (num_mix_partitions - 1) buffers.
+    Uint8 *mix_partition_scratch;
+    float *mix_partition_partials;
+    int num_mix_partitions;
+
+    // Timing counters for SDL_GetAudioDeviceStats. Only the device thread writes `stats`, bumping `stats_sequence` to odd before and even after,
+    //  so readers can copy it out without locking (they retry if the sequence changed underneath them). xruns can come from anywhere, so they're separate.
+    SDL_AudioDeviceStats stats;
+    SDL_AtomicInt stats_sequence;
+    SDL_AtomicInt xruns;
+    Uint64 wait_finished_ns;  // when WaitDevice last returned, or 0 if the backend drives the iterate functions itself.
+    Uint64 last_period_ns;  // when the previous period started, for interval_histogram.
+    Uint64 next_poll_ns;  // when SDL_PollAudioDeviceTimer will next report this device ready.
+
+    // Adaptive buffer sizing (SDL_HINT_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES). Only the device thread touches these. adaptive_max_frames is 0 if this is off.
+    int adaptive_min_frames;
+    int adaptive_max_frames;
+    int adaptive_settle_periods;  // periods to ignore after a resize, while the backend settles.
+    int adaptive_last_xruns;
+    SDL_bool adaptive_tried_smaller;  // SDL_TRUE if the last resize was a step down that hasn't proven itself yet.
+    Uint64 adaptive_hold_ns;  // how long things have to be calm before we try a smaller buffer.
+    Uint64 adaptive_calm_since_ns;
+    Uint64 adaptive_max_process_ns;  // worst processing time since adaptive_calm_since_ns.
+
     // A thread to feed the audio device
     SDL_Thread *thread;
 
+    // If non-NULL, this device has no thread of its own; this shared thread drives it instead.
+    struct SDL_SharedAudioThread *shared_thread;
+
     // SDL_TRUE if this physical device is currently opened by the backend.
     SDL_bool currently_opened;
 
@@ -36,6 +36,17 @@
 #include "SDL_wave.h"
 #include "SDL_sysaudio.h"
 
+/* Map WAVE files into memory when streaming them from a path, so PCM data
+ * can be handed to the audio stream without being read or copied.
+ */
+#if defined(__LINUX__) || defined(__MACOS__) || defined(__FREEBSD__) || defined(__NETBSD__) || defined(__OPENBSD__)
+#define SDL_WAVE_STREAM_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /* Reads the value stored at the location of the f1 pointer, multiplies it
  * with the second argument and then stores the result to f1.
  * Returns 0 on success, or -1 if the multiplication overflows, in which case f1
@@ -633,10 +644,14 @@ static int MS_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
     return 0;
 }
 
-static int MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+/* Decodes file->sampleframes sample frames from the blocks in the chunk data
+ * into `output`. `outputsize` is the size of `output` in bytes on entry and
+ * the number of bytes decoded on return.
+ */
+static int MS_ADPCM_DecodeInto(WaveFile *file, Sint16 *output, size_t *outputsize)
 {
     int result;
-    size_t bytesleft, outputsize;
+    size_t bytesleft;
     WaveChunk *chunk = &file->chunk;
     ADPCM_DecoderState state;
     MS_ADPCM_ChannelState cstate[2];
@@ -644,20 +659,6 @@ static int MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     SDL_zero(state);
     SDL_zeroa(cstate);
 
-    if (chunk->size != chunk->length) {
-        /* Could not read everything. Recalculate number of sample frames. */
-        if (MS_ADPCM_CalculateSampleFrames(file, chunk->size) < 0) {
-            return -1;
-        }
-    }
-
-    /* Nothing to decode, nothing to return. */
-    if (file->sampleframes == 0) {
-        *audio_buf = NULL;
-        *audio_len = 0;
-        return 0;
-    }
-
     state.blocksize = file->format.blockalign;
     state.channels = file->format.channels;
     state.blockheadersize = (size_t)state.channels * 7;
@@ -671,20 +672,9 @@ static int MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     state.input.size = chunk->size;
     state.input.pos = 0;
 
-    /* The output size in bytes. May get modified if data is truncated. */
-    outputsize = (size_t)state.framestotal;
-    if (SafeMult(&outputsize, state.framesize)) {
-        return SDL_OutOfMemory();
-    } else if (outputsize > SDL_MAX_UINT32 || state.framestotal > SIZE_MAX) {
-        return SDL_SetError("WAVE file too big");
-    }
-
     state.output.pos = 0;
-    state.output.size = outputsize / sizeof(Sint16);
-    state.output.data = (Sint16 *)SDL_calloc(1, outputsize);
-    if (!state.output.data) {
-        return SDL_OutOfMemory();
-    }
+    state.output.size = *outputsize / sizeof(Sint16);
+    state.output.data = output;
 
     state.cstate = cstate;
 
@@ -697,14 +687,12 @@ static int MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 
         if (state.output.size - state.output.pos < (Uint64)state.framesleft * state.channels) {
             /* Somehow didn't allocate enough space for the output. */
-            SDL_free(state.output.data);
             return SDL_SetError("Unexpected overflow in MS ADPCM decoder");
         }
 
         /* Initialize decoder with the values from the block header. */
         result = MS_ADPCM_DecodeBlockHeader(&state);
         if (result == -1) {
-            SDL_free(state.output.data);
             return -1;
         }
 
@@ -713,12 +701,10 @@ static int MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         if (result == -1) {
             /* Unexpected end. Stop decoding and return partial data if necessary. */
             if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
-                SDL_free(state.output.data);
                 return SDL_SetError("Truncated data chunk");
             } else if (file->trunchint != TruncDropFrame) {
                 state.output.pos -= state.output.pos % (state.samplesperblock * state.channels);
             }
-            outputsize = state.output.pos * sizeof(Sint16); /* Can't overflow, is always smaller. */
             break;
         }
 
@@ -726,7 +712,52 @@ static int MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         bytesleft = state.input.size - state.input.pos;
     }
 
-    *audio_buf = (Uint8 *)state.output.data;
+    /* May be smaller than the buffer if data is truncated. */
+    *outputsize = state.output.pos * sizeof(Sint16);
+
+    return 0;
+}
+
+static int MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    WaveChunk *chunk = &file->chunk;
+    const size_t framesize = (size_t)file->format.channels * sizeof(Sint16);
+    size_t outputsize;
+    Sint16 *output;
+
+    if (chunk->size != chunk->length) {
+        /* Could not read everything. Recalculate number of sample frames. */
+        if (MS_ADPCM_CalculateSampleFrames(file, chunk->size) < 0) {
+            return -1;
+        }
+    }
+
+    /* Nothing to decode, nothing to return. */
+    if (file->sampleframes == 0) {
+        *audio_buf = NULL;
+        *audio_len = 0;
+        return 0;
+    }
+
+    /* The output size in bytes. May get modified if data is truncated. */
+    outputsize = (size_t)file->sampleframes;
+    if (SafeMult(&outputsize, framesize)) {
+        return SDL_OutOfMemory();
+    } else if (outputsize > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
+        return SDL_SetError("WAVE file too big");
+    }
+
+    output = (Sint16 *)SDL_calloc(1, outputsize);
+    if (!output) {
+        return SDL_OutOfMemory();
+    }
+
+    if (MS_ADPCM_DecodeInto(file, output, &outputsize) < 0) {
+        SDL_free(output);
+        return -1;
+    }
+
+    *audio_buf = (Uint8 *)output;
     *audio_len = (Uint32)outputsize;
 
     return 0;
@@ -1027,28 +1058,18 @@ static int IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
     return retval;
 }
 
-static int IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+/* Decodes file->sampleframes sample frames from the blocks in the chunk data
+ * into `output`. `outputsize` is the size of `output` in bytes on entry and
+ * the number of bytes decoded on return.
+ */
+static int IMA_ADPCM_DecodeInto(WaveFile *file, Sint16 *output, size_t *outputsize)
 {
     int result;
-    size_t bytesleft, outputsize;
+    size_t bytesleft;
     WaveChunk *chunk = &file->chunk;
     ADPCM_DecoderState state;
     Sint8 *cstate;
 
-    if (chunk->size != chunk->length) {
-        /* Could not read everything. Recalculate number of sample frames. */
-        if (IMA_ADPCM_CalculateSampleFrames(file, chunk->size) < 0) {
-            return -1;
-        }
-    }
-
-    /* Nothing to decode, nothing to return. */
-    if (file->sampleframes == 0) {
-        *audio_buf = NULL;
-        *audio_len = 0;
-        return 0;
-    }
-
     SDL_zero(state);
     state.channels = file->format.channels;
     state.blocksize = file->format.blockalign;
@@ -1062,24 +1083,12 @@ static int IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len
     state.input.size = chunk->size;
     state.input.pos = 0;
 
-    /* The output size in bytes. May get modified if data is truncated. */
-    outputsize = (size_t)state.framestotal;
-    if (SafeMult(&outputsize, state.framesize)) {
-        return SDL_OutOfMemory();
-    } else if (outputsize > SDL_MAX_UINT32 || state.framestotal > SIZE_MAX) {
-        return SDL_SetError("WAVE file too big");
-    }
-
     state.output.pos = 0;
-    state.output.size = outputsize / sizeof(Sint16);
-    state.output.data = (Sint16 *)SDL_malloc(outputsize);
-    if (!state.output.data) {
-        return SDL_OutOfMemory();
-    }
+    state.output.size = *outputsize / sizeof(Sint16);
+    state.output.data = output;
 
     cstate = (Sint8 *)SDL_calloc(state.channels, sizeof(Sint8));
     if (!cstate) {
-        SDL_free(state.output.data);
         return SDL_OutOfMemory();
     }
     state.cstate = cstate;
@@ -1093,7 +1102,6 @@ static int IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len
 
         if (state.output.size - state.output.pos < (Uint64)state.framesleft * state.channels) {
             /* Somehow didn't allocate enough space for the output. */
-            SDL_free(state.output.data);
             SDL_free(cstate);
             return SDL_SetError("Unexpected overflow in IMA ADPCM decoder");
         }
@@ -1108,13 +1116,11 @@ static int IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len
         if (result == -1) {
             /* Unexpected end. Stop decoding and return partial data if necessary. */
             if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
-                SDL_free(state.output.data);
                 SDL_free(cstate);
                 return SDL_SetError("Truncated data chunk");
             } else if (file->trunchint != TruncDropFrame) {
                 state.output.pos -= state.output.pos % (state.samplesperblock * state.channels);
             }
-            outputsize = state.output.pos * sizeof(Sint16); /* Can't overflow, is always smaller. */
             break;
         }
 
@@ -1122,14 +1128,59 @@ static int IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len
         bytesleft = state.input.size - state.input.pos;
     }
 
-    *audio_buf = (Uint8 *)state.output.data;
-    *audio_len = (Uint32)outputsize;
+    /* May be smaller than the buffer if data is truncated. */
+    *outputsize = state.output.pos * sizeof(Sint16);
 
     SDL_free(cstate);
 
     return 0;
 }
 
+static int IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    WaveChunk *chunk = &file->chunk;
+    const size_t framesize = (size_t)file->format.channels * sizeof(Sint16);
+    size_t outputsize;
+    Sint16 *output;
+
+    if (chunk->size != chunk->length) {
+        /* Could not read everything. Recalculate number of sample frames. */
+        if (IMA_ADPCM_CalculateSampleFrames(file, chunk->size) < 0) {
+            return -1;
+        }
+    }
+
+    /* Nothing to decode, nothing to return. */
+    if (file->sampleframes == 0) {
+        *audio_buf = NULL;
+        *audio_len = 0;
+        return 0;
+    }
+
+    /* The output size in bytes. May get modified if data is truncated. */
+    outputsize = (size_t)file->sampleframes;
+    if (SafeMult(&outputsize, framesize)) {
+        return SDL_OutOfMemory();
+    } else if (outputsize > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
+        return SDL_SetError("WAVE file too big");
+    }
+
+    output = (Sint16 *)SDL_malloc(outputsize);
+    if (!output) {
+        return SDL_OutOfMemory();
+    }
+
+    if (IMA_ADPCM_DecodeInto(file, output, &outputsize) < 0) {
+        SDL_free(output);
+        return -1;
+    }
+
+    *audio_buf = (Uint8 *)output;
+    *audio_len = (Uint32)outputsize;
+
+    return 0;
+}
+
 static int LAW_Init(WaveFile *file, size_t datalength)
 {
     WaveFormat *format = &file->format;
@@ -1158,7 +1209,10 @@ static int LAW_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static int LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+/* Expands `sample_count` companded samples from `src` to 16-bit samples in
+ * `dst`. This works backwards, so `src` and `dst` may point to the same buffer.
+ */
+static int LAW_DecodeSamples(WaveFile *file, const Uint8 *src, Sint16 *dst, size_t sample_count)
 {
 #ifdef SDL_WAVE_LAW_LUT
     const Sint16 alaw_lut[256] = {
@@ -1198,53 +1252,8 @@ static int LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0
     };
 #endif
+    size_t i = sample_count;
 
-    WaveFormat *format = &file->format;
-    WaveChunk *chunk = &file->chunk;
-    size_t i, sample_count, expanded_len;
-    Uint8 *src;
-    Sint16 *dst;
-
-    if (chunk->length != chunk->size) {
-        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
-        if (file->sampleframes < 0) {
-            return -1;
-        }
-    }
-
-    /* Nothing to decode, nothing to return. */
-    if (file->sampleframes == 0) {
-        *audio_buf = NULL;
-        *audio_len = 0;
-        return 0;
-    }
-
-    sample_count = (size_t)file->sampleframes;
-    if (SafeMult(&sample_count, format->channels)) {
-        return SDL_OutOfMemory();
-    }
-
-    expanded_len = sample_count;
-    if (SafeMult(&expanded_len, sizeof(Sint16))) {
-        return SDL_OutOfMemory();
-    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
-        return SDL_SetError("WAVE file too big");
-    }
-
-    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
-    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
-    if (!src) {
-        return SDL_OutOfMemory();
-    }
-    chunk->data = NULL;
-    chunk->size = 0;
-
-    dst = (Sint16 *)src;
-
-    /* Work backwards, since we're expanding in-place. `format` will
-     * inform the caller about the byte order.
-     */
-    i = sample_count;
     switch (file->format.encoding) {
 #ifdef SDL_WAVE_LAW_LUT
     case ALAW_CODE:
@@ -1290,10 +1299,59 @@ static int LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         break;
 #endif
     default:
-        SDL_free(src);
         return SDL_SetError("Unknown companded encoding");
     }
 
+    return 0;
+}
+
+static int LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    size_t sample_count, expanded_len;
+    Uint8 *src;
+
+    if (chunk->length != chunk->size) {
+        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
+        if (file->sampleframes < 0) {
+            return -1;
+        }
+    }
+
+    /* Nothing to decode, nothing to return. */
+    if (file->sampleframes == 0) {
+        *audio_buf = NULL;
+        *audio_len = 0;
+        return 0;
+    }
+
+    sample_count = (size_t)file->sampleframes;
+    if (SafeMult(&sample_count, format->channels)) {
+        return SDL_OutOfMemory();
+    }
+
+    expanded_len = sample_count;
+    if (SafeMult(&expanded_len, sizeof(Sint16))) {
+        return SDL_OutOfMemory();
+    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
+        return SDL_SetError("WAVE file too big");
+    }
+
+    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
+    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
+    if (!src) {
+        return SDL_OutOfMemory();
+    }
+    chunk->data = NULL;
+    chunk->size = 0;
+
+    /* Expanding in-place. `format` will inform the caller about the byte order. */
+    if (LAW_DecodeSamples(file, src, (Sint16 *)src, sample_count) < 0) {
+        SDL_free(src);
+        return -1;
+    }
+
     *audio_buf = src;
     *audio_len = (Uint32)expanded_len;
 
@@ -1343,11 +1401,34 @@ static int PCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Shifts `sample_count` 24-bit samples from `src` to 32 bits in `dst`. This
+ * works backwards, so `src` and `dst` may point to the same buffer.
+ */
+static void PCM_Sint24ToSint32(const Uint8 *src, Uint8 *dst, size_t sample_count)
+{
+    size_t i;
+
+    for (i = sample_count; i > 0; i--) {
+        const size_t o = i - 1;
+        uint8_t b[4];
+
+        b[0] = 0;
+        b[1] = src[o * 3];
+        b[2] = src[o * 3 + 1];
+        b[3] = src[o * 3 + 2];
+
+        dst[o * 4 + 0] = b[0];
+        dst[o * 4 + 1] = b[1];
+        dst[o * 4 + 2] = b[2];
+        dst[o * 4 + 3] = b[3];
+    }
+}
+
 static int PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, expanded_len, sample_count;
+    size_t expanded_len, sample_count;
     Uint8 *ptr;
 
     sample_count = (size_t)file->sampleframes;
@@ -1375,21 +1456,8 @@ static int PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *
     *audio_buf = ptr;
     *audio_len = (Uint32)expanded_len;
 
-    /* work from end to start, since we're expanding in-place. */
-    for (i = sample_count; i > 0; i--) {
-        const size_t o = i - 1;
-        uint8_t b[4];
-
-        b[0] = 0;
-        b[1] = ptr[o * 3];
-        b[2] = ptr[o * 3 + 1];
-        b[3] = ptr[o * 3 + 2];
-
-        ptr[o * 4 + 0] = b[0];
-        ptr[o * 4 + 1] = b[1];
-        ptr[o * 4 + 2] = b[2];
-        ptr[o * 4 + 3] = b[3];
-    }
+    /* expanding in-place. */
+    PCM_Sint24ToSint32(ptr, ptr, sample_count);
 
     return 0;
 }
@@ -1769,7 +1837,11 @@ static int WaveCheckFormat(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static int WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+/* Finds and checks the fmt and data chunks, and fills in `spec`. On success,
+ * file->chunk is the data chunk, with none of its data read yet, and
+ * `endposition` is where the WAVE data ends in the stream.
+ */
+static int WaveLoadHeaders(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Sint64 *endposition)
 {
     int result;
     Uint32 chunkcount = 0;
@@ -1978,11 +2050,70 @@ static int WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 *
     WaveDebugDumpFormat(file, RIFFchunk.length, fmtchunk.length, datachunk.length);
 #endif
 
+    /* Setting up the specs. All unsupported formats were filtered out
+     * by checks earlier in this function.
+     */
+    spec->freq = format->frequency;
+    spec->channels = (Uint8)format->channels;
+    spec->format = 0;
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+    case ALAW_CODE:
+    case MULAW_CODE:
+        /* These can be easily stored in the byte order of the system. */
+        spec->format = SDL_AUDIO_S16;
+        break;
+    case IEEE_FLOAT_CODE:
+        spec->format = SDL_AUDIO_F32LE;
+        break;
+    case PCM_CODE:
+        switch (format->bitspersample) {
+        case 8:
+            spec->format = SDL_AUDIO_U8;
+            break;
+        case 16:
+            spec->format = SDL_AUDIO_S16LE;
+            break;
+        case 24: /* Has been shifted to 32 bits. */
+        case 32:
+            spec->format = SDL_AUDIO_S32LE;
+            break;
+        default:
+            /* Just in case something unexpected happened in the checks. */
+            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
+        }
+        break;
+    default:
+        return SDL_SetError("Unexpected data format");
+    }
+
     WaveFreeChunkData(chunk);
 
-    /* Process data chunk. */
     *chunk = datachunk;
 
+    if (RIFFlengthknown) {
+        *endposition = RIFFend;
+    } else {
+        *endposition = lastchunkpos;
+    }
+
+    return 0;
+}
+
+static int WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    int result;
+    Sint64 endposition = 0;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+
+    if (WaveLoadHeaders(src, file, spec, &endposition) < 0) {
+        return -1;
+    }
+
+    /* Process data chunk. */
     if (chunk->length > 0) {
         result = WaveReadChunkData(src, chunk);
         if (result == -1) {
@@ -2026,51 +2157,8 @@ static int WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 *
         break;
     }
 
-    /* Setting up the specs. All unsupported formats were filtered out
-     * by checks earlier in this function.
-     */
-    spec->freq = format->frequency;
-    spec->channels = (Uint8)format->channels;
-    spec->format = 0;
-
-    switch (format->encoding) {
-    case MS_ADPCM_CODE:
-    case IMA_ADPCM_CODE:
-    case ALAW_CODE:
-    case MULAW_CODE:
-        /* These can be easily stored in the byte order of the system. */
-        spec->format = SDL_AUDIO_S16;
-        break;
-    case IEEE_FLOAT_CODE:
-        spec->format = SDL_AUDIO_F32LE;
-        break;
-    case PCM_CODE:
-        switch (format->bitspersample) {
-        case 8:
-            spec->format = SDL_AUDIO_U8;
-            break;
-        case 16:
-            spec->format = SDL_AUDIO_S16LE;
-            break;
-        case 24: /* Has been shifted to 32 bits. */
-        case 32:
-            spec->format = SDL_AUDIO_S32LE;
-            break;
-        default:
-            /* Just in case something unexpected happened in the checks. */
-            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
-        }
-        break;
-    default:
-        return SDL_SetError("Unexpected data format");
-    }
-
     /* Report the end position back to the cleanup code. */
-    if (RIFFlengthknown) {
-        chunk->position = RIFFend;
-    } else {
-        chunk->position = lastchunkpos;
-    }
+    chunk->position = endposition;
 
     return 0;
 }
@@ -2127,3 +2215,350 @@ int SDL_LoadWAV(const char *path, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32
     return SDL_LoadWAV_RW(SDL_RWFromFile(path, "rb"), 1, spec, audio_buf, audio_len);
 }
 
+/* Sample frames decoded per batch when streaming. */
+#define WAVE_STREAM_BATCH_FRAMES 4096
+
+typedef struct WaveStream
+{
+    WaveFile file;
+    SDL_RWops *src;
+    SDL_bool freesrc;
+    void *mapping;        /* The file mapped into memory behind `src`, if any. */
+    size_t mappinglength;
+    const Uint8 *mapped;  /* The data chunk, if `src` is in memory and it can be read in place. */
+    Sint64 dataposition;  /* Position of the data chunk in `src`. */
+    size_t datalength;    /* Number of bytes of the data chunk that are actually in `src`. */
+    size_t datapos;       /* Number of bytes of the data chunk that were decoded so far. */
+    Sint64 framesleft;    /* Number of sample frames still to be decoded. */
+    size_t batchsize;     /* Number of data chunk bytes decoded at a time. Whole blocks. */
+    Uint8 *input;         /* batchsize bytes, if the data has to be read. */
+    Uint8 *output;        /* Decoded samples, if the data has to be decoded. */
+    size_t outputsize;
+    SDL_bool finished;
+} WaveStream;
+
+static void WaveStreamDestroy(WaveStream *ws)
+{
+    if (!ws) {
+        return;
+    }
+
+    SDL_free(ws->input);
+    SDL_free(ws->output);
+    SDL_free(ws->file.decoderdata);
+    if (ws->freesrc && ws->src) {
+        SDL_RWclose(ws->src);
+    }
+#ifdef SDL_WAVE_STREAM_MMAP
+    if (ws->mapping) {
+        munmap(ws->mapping, ws->mappinglength);
+    }
+#endif
+    SDL_free(ws);
+}
+
+static void SDLCALL WaveStreamCleanup(void *userdata, void *value)
+{
+    WaveStreamDestroy((WaveStream *)value);
+}
+
+/* Decodes the next batch of the data chunk and puts it into the audio stream.
+ * Returns the number of bytes put, 0 at the end of the data, or -1 on error.
+ */
+static int WaveStreamDecodeBatch(WaveStream *ws, SDL_AudioStream *stream)
+{
+    WaveFile *file = &ws->file;
+    WaveFormat *format = &file->format;
+    const size_t channels = format->channels;
+    size_t length = SDL_min(ws->batchsize, ws->datalength - ws->datapos);
+    size_t outputlength;
+    Sint64 frames;
+    Uint8 *input;
+
+    if (length == 0 || ws->framesleft <= 0) {
+        return 0;
+    }
+
+    if (ws->mapped) {
+        input = (Uint8 *)ws->mapped + ws->datapos; /* Only read from. */
+    } else {
+        const Sint64 position = ws->dataposition + (Sint64)ws->datapos;
+        if (SDL_RWseek(ws->src, position, SDL_RW_SEEK_SET) != position) {
+            return SDL_SetError("Could not seek to WAVE data");
+        }
+        length = SDL_RWread(ws->src, ws->input, length);
+        if (length == 0) {
+            return 0;
+        }
+        input = ws->input;
+    }
+    ws->datapos += length;
+
+    switch (format->encoding) {
+    case PCM_CODE:
+    case IEEE_FLOAT_CODE:
+        frames = SDL_min((Sint64)(length / format->blockalign), ws->framesleft);
+        if (format->encoding == PCM_CODE && format->bitspersample == 24) {
+            PCM_Sint24ToSint32(input, ws->output, (size_t)frames * channels);
+            input = ws->output;
+            outputlength = (size_t)frames * channels * sizeof(Sint32);
+        } else {
+            outputlength = (size_t)frames * format->blockalign;
+        }
+        break;
+    case ALAW_CODE:
+    case MULAW_CODE:
+        frames = SDL_min((Sint64)(length / format->blockalign), ws->framesleft);
+        if (LAW_DecodeSamples(file, input, (Sint16 *)ws->output, (size_t)frames * channels) < 0) {
+            return -1;
+        }
+        input = ws->output;
+        outputlength = (size_t)frames * channels * sizeof(Sint16);
+        break;
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+    {
+        /* The decoders work on file->chunk; point it at this batch. */
+        const size_t blocks = (length + format->blockalign - 1) / format->blockalign;
+        int result;
+
+        file->sampleframes = SDL_min((Sint64)(blocks * format->samplesperblock), ws->framesleft);
+        file->chunk.data = input;
+        file->chunk.size = length;
+        file->chunk.length = (Uint32)length;
+
+        outputlength = ws->outputsize;
+        if (format->encoding == MS_ADPCM_CODE) {
+            result = MS_ADPCM_DecodeInto(file, (Sint16 *)ws->output, &outputlength);
+        } else {
+            result = IMA_ADPCM_DecodeInto(file, (Sint16 *)ws->output, &outputlength);
+        }
+
+        file->chunk.data = NULL;
+        file->chunk.size = 0;
+
+        if (result < 0) {
+            return -1;
+        }
+        input = ws->output;
+        frames = (Sint64)(outputlength / (channels * sizeof(Sint16)));
+        break;
+    }
+    default:
+        return SDL_SetError("Unexpected data format");
+    }
+
+    ws->framesleft -= frames;
+
+    if (outputlength > 0 && SDL_PutAudioStreamData(stream, input, (int)outputlength) < 0) {
+        return -1;
+    }
+
+    return (int)outputlength;
+}
+
+static void SDLCALL WaveStreamGetCallback(void *userdata, SDL_AudioStream *stream, int additional_amount, int total_amount)
+{
+    WaveStream *ws = (WaveStream *)userdata;
+
+    while (additional_amount > 0 && !ws->finished) {
+        const int result = WaveStreamDecodeBatch(ws, stream);
+        if (result < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Stopped decoding WAVE data: %s", SDL_GetError());
+        }
+        if (result <= 0 || ws->framesleft <= 0) {
+            /* Nothing more is coming; let the stream give up everything it has. */
+            ws->finished = SDL_TRUE;
+            SDL_FlushAudioStream(stream);
+            break;
+        }
+        additional_amount -= result;
+    }
+}
+
+static SDL_AudioStream *CreateWaveStream(SDL_RWops *src, SDL_bool freesrc, const SDL_AudioSpec *dst_spec, void *mapping, size_t mappinglength)
+{
+    SDL_AudioStream *stream = NULL;
+    SDL_AudioSpec spec;
+    WaveStream *ws;
+    WaveFormat *format;
+    Sint64 endposition = 0;
+    Sint64 size;
+
+    ws = (WaveStream *)SDL_calloc(1, sizeof(*ws));
+    if (!ws) {
+        SDL_OutOfMemory();
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+#ifdef SDL_WAVE_STREAM_MMAP
+        if (mapping) {
+            munmap(mapping, mappinglength);
+        }
+#endif
+        return NULL;
+    }
+
+    ws->src = src;
+    ws->freesrc = freesrc;
+    ws->mapping = mapping;
+    ws->mappinglength = mappinglength;
+    ws->file.riffhint = WaveGetRiffSizeHint();
+    ws->file.trunchint = WaveGetTruncationHint();
+    ws->file.facthint = WaveGetFactChunkHint();
+    format = &ws->file.format;
+
+    if (WaveLoadHeaders(src, &ws->file, &spec, &endposition) < 0) {
+        goto failed;
+    }
+
+    /* Only the headers were read. Figure out how much data is really there
+     * and trim the number of sample frames like the decoders would.
+     */
+    ws->dataposition = ws->file.chunk.position;
+    ws->datalength = ws->file.chunk.length;
+    size = SDL_RWsize(src);
+    if (size >= 0) {
+        ws->datalength = (size_t)SDL_clamp(size - ws->dataposition, 0, (Sint64)ws->datalength);
+    }
+
+    if (ws->datalength != ws->file.chunk.length) {
+        /* I/O issues or corrupt file. */
+        if (ws->file.trunchint == TruncVeryStrict || ws->file.trunchint == TruncStrict) {
+            SDL_SetError("Could not read data of WAVE data chunk");
+            goto failed;
+        }
+
+        switch (format->encoding) {
+        case MS_ADPCM_CODE:
+            if (MS_ADPCM_CalculateSampleFrames(&ws->file, ws->datalength) < 0) {
+                goto failed;
+            }
+            break;
+        case IMA_ADPCM_CODE:
+            if (IMA_ADPCM_CalculateSampleFrames(&ws->file, ws->datalength) < 0) {
+                goto failed;
+            }
+            break;
+        default:
+            ws->file.sampleframes = WaveAdjustToFactValue(&ws->file, ws->datalength / format->blockalign);
+            if (ws->file.sampleframes < 0) {
+                goto failed;
+            }
+            break;
+        }
+    }
+    ws->framesleft = ws->file.sampleframes;
+
+    if (src->type == SDL_RWOPS_MEMORY || src->type == SDL_RWOPS_MEMORY_RO) {
+        ws->mapped = src->hidden.mem.base + ws->dataposition;
+    }
+
+    stream = SDL_CreateAudioStream(&spec, dst_spec);
+    if (!stream) {
+        goto failed;
+    }
+
+    /* The stream owns the decoder from here on, and frees it when it's destroyed. */
+    if (SDL_SetPropertyWithCleanup(SDL_GetAudioStreamProperties(stream), "SDL.audiostream.wave", ws, WaveStreamCleanup, NULL) < 0) {
+        SDL_DestroyAudioStream(stream);
+        return NULL;
+    }
+
+    if (ws->mapped && (format->encoding == IEEE_FLOAT_CODE || (format->encoding == PCM_CODE && format->bitspersample != 24))) {
+        /* Nothing to decode: the stream can read the samples right where they are. */
+        const size_t maxlength = ((size_t)INT_MAX / format->blockalign) * format->blockalign;
+        size_t remaining = (size_t)ws->framesleft * format->blockalign;
+        const Uint8 *data = ws->mapped;
+
+        while (remaining > 0) {
+            const size_t length = SDL_min(remaining, maxlength);
+            if (SDL_PutAudioStreamDataNoCopy(stream, data, (int)length, NULL, NULL) < 0) {
+                SDL_DestroyAudioStream(stream);
+                return NULL;
+            }
+            data += length;
+            remaining -= length;
+        }
+
+        ws->framesleft = 0;
+        ws->finished = SDL_TRUE;
+        SDL_FlushAudioStream(stream);
+        return stream;
+    }
+
+    /* Everything else is decoded a batch at a time as the stream asks for more. */
+    if (format->encoding == MS_ADPCM_CODE || format->encoding == IMA_ADPCM_CODE) {
+        const size_t blocks = SDL_max(WAVE_STREAM_BATCH_FRAMES / format->samplesperblock, 1);
+        ws->batchsize = blocks * format->blockalign;
+        ws->outputsize = blocks * format->samplesperblock * SDL_AUDIO_FRAMESIZE(spec);
+    } else {
+        ws->batchsize = (size_t)WAVE_STREAM_BATCH_FRAMES * format->blockalign;
+        if (format->encoding != PCM_CODE || format->bitspersample == 24) {
+            ws->outputsize = (size_t)WAVE_STREAM_BATCH_FRAMES * SDL_AUDIO_FRAMESIZE(spec);
+        }
+    }
+
+    if (!ws->mapped) {
+        ws->input = (Uint8 *)SDL_malloc(ws->batchsize);
+    }
+    if (ws->outputsize > 0) {
+        ws->output = (Uint8 *)SDL_malloc(ws->outputsize);
+    }
+    if ((!ws->mapped && !ws->input) || (ws->outputsize > 0 && !ws->output)) {
+        SDL_OutOfMemory();
+        SDL_DestroyAudioStream(stream);
+        return NULL;
+    }
+
+    if (SDL_SetAudioStreamGetCallback(stream, WaveStreamGetCallback, ws) < 0) {
+        SDL_DestroyAudioStream(stream);
+        return NULL;
+    }
+
+    return stream;
+
+failed:
+    WaveStreamDestroy(ws);
+    return NULL;
+}
+
+SDL_AudioStream *SDL_CreateAudioStreamFromWAV_RW(SDL_RWops *src, SDL_bool freesrc, const SDL_AudioSpec *dst_spec)
+{
+    if (!src) {
+        return NULL; /* Error may come from RWops. */
+    }
+    return CreateWaveStream(src, freesrc, dst_spec, NULL, 0);
+}
+
+SDL_AudioStream *SDL_CreateAudioStreamFromWAV(const char *path, const SDL_AudioSpec *dst_spec)
+{
+#ifdef SDL_WAVE_STREAM_MMAP
+    if (path) {
+        const int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            struct stat st;
+            void *mapping = MAP_FAILED;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && (Uint64)st.st_size <= SIZE_MAX) {
+                mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+            close(fd);
+
+            if (mapping != MAP_FAILED) {
+                SDL_RWops *src;
+#ifdef MADV_SEQUENTIAL
+                madvise(mapping, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+                src = SDL_RWFromConstMem(mapping, (size_t)st.st_size);
+                if (src) {
+                    return CreateWaveStream(src, SDL_TRUE, dst_spec, mapping, (size_t)st.st_size);
+                }
+                munmap(mapping, (size_t)st.st_size);
+            }
+        }
+        /* Couldn't map it; fall back to reading the file normally. */
+    }
+#endif
+
+    return SDL_CreateAudioStreamFromWAV_RW(SDL_RWFromFile(path, "rb"), SDL_TRUE, dst_spec);
+}
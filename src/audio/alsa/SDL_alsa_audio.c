@@ -354,6 +354,9 @@ static int ALSA_WaitDevice(SDL_AudioDevice *device)
     while (!SDL_AtomicGet(&device->shutdown)) {
         const int rc = ALSA_snd_pcm_wait(device->hidden->pcm_handle, delay);
         if (rc < 0 && (rc != -EAGAIN)) {
+            if (rc == -EPIPE) {
+                SDL_AudioDeviceReportXrun(device);
+            }
             const int status = ALSA_snd_pcm_recover(device->hidden->pcm_handle, rc, 0);
             if (status < 0) {
                 // Hmm, not much we can do - abort
@@ -373,6 +376,30 @@ static int ALSA_WaitDevice(SDL_AudioDevice *device)
     return 0;
 }
 
+// This estimates when the device will be ready from snd_pcm_avail instead of polling the device's fds.
+static int ALSA_PollDevice(SDL_AudioDevice *device, Uint64 *wait_ns)
+{
+    snd_pcm_sframes_t avail = ALSA_snd_pcm_avail(device->hidden->pcm_handle);
+    if (avail < 0) {
+        if (avail == -EPIPE) {
+            SDL_AudioDeviceReportXrun(device);
+        }
+        const int status = ALSA_snd_pcm_recover(device->hidden->pcm_handle, (int) avail, 0);
+        if (status < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "ALSA: snd_pcm_avail failed (unrecoverable): %s", ALSA_snd_strerror((int) avail));
+            return -1;
+        }
+        return 1;  // recovered; after an xrun there's plenty of room (or data) again.
+    }
+
+    if (avail >= device->sample_frames) {
+        return 1;
+    }
+
+    *wait_ns = (((Uint64) (device->sample_frames - avail)) * SDL_NS_PER_SECOND) / device->spec.freq;
+    return 0;
+}
+
 static int ALSA_PlayDevice(SDL_AudioDevice *device, const Uint8 *buffer, int buflen)
 {
     SDL_assert(buffer == device->hidden->mixbuf);
@@ -388,6 +415,9 @@ static int ALSA_PlayDevice(SDL_AudioDevice *device, const Uint8 *buffer, int buf
         SDL_assert(rc != 0);  // assuming this can't happen if we used snd_pcm_wait and queried for available space.
         if (rc < 0) {
             SDL_assert(rc != -EAGAIN);  // assuming this can't happen if we used snd_pcm_wait and queried for available space. snd_pcm_recover won't handle it!
+            if (rc == -EPIPE) {
+                SDL_AudioDeviceReportXrun(device);  // underrun.
+            }
             const int status = ALSA_snd_pcm_recover(device->hidden->pcm_handle, rc, 0);
             if (status < 0) {
                 // Hmm, not much we can do - abort
@@ -440,6 +470,9 @@ static int ALSA_CaptureFromDevice(SDL_AudioDevice *device, void *buffer, int buf
     SDL_assert(rc != -EAGAIN);  // assuming this can't happen if we used snd_pcm_wait and queried for available space. snd_pcm_recover won't handle it!
 
     if (rc < 0) {
+        if (rc == -EPIPE) {
+            SDL_AudioDeviceReportXrun(device);  // overrun.
+        }
         const int status = ALSA_snd_pcm_recover(device->hidden->pcm_handle, rc, 0);
         if (status < 0) {
             // Hmm, not much we can do - abort
@@ -973,6 +1006,7 @@ static SDL_bool ALSA_Init(SDL_AudioDriverImpl *impl)
     impl->DetectDevices = ALSA_DetectDevices;
     impl->OpenDevice = ALSA_OpenDevice;
     impl->WaitDevice = ALSA_WaitDevice;
+    impl->PollDevice = ALSA_PollDevice;
     impl->GetDeviceBuf = ALSA_GetDeviceBuf;
     impl->PlayDevice = ALSA_PlayDevice;
     impl->CloseDevice = ALSA_CloseDevice;
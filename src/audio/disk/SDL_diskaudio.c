@@ -34,22 +34,139 @@
 #define DISKENVR_INFILE     "SDL_DISKAUDIOFILEIN"
 #define DISKDEFAULT_INFILE  "sdlaudio-in.raw"
 #define DISKENVR_IODELAY    "SDL_DISKAUDIODELAY"
+#define DISKENVR_FREEWHEEL  "SDL_DISKAUDIOFREEWHEEL"  // "1" to mix as fast as possible instead of in realtime.
+#define DISKENVR_FORMAT     "SDL_DISKAUDIOFORMAT"  // "raw" or "wav"; defaults to "wav" if the output file name ends in ".wav".
+#define DISKENVR_FRAMES     "SDL_DISKAUDIOFRAMES"  // stop after writing exactly this many sample frames.
+
+#define WAV_HEADER_SIZE 44
+
+// When freewheeling, there's no point in racing through silence before the app has bound (or unpaused) anything,
+// or while the app is still producing the next buffer's worth of data. Otherwise the file would get silence written
+// into it wherever the app happened to fall behind, so what gets rendered would depend on thread scheduling.
+static SDL_bool HasAnythingToMix(SDL_AudioDevice *device)
+{
+    SDL_bool retval = SDL_FALSE;
+    SDL_LockMutex(device->lock);
+    for (SDL_LogicalAudioDevice *logdev = device->logical_devices; logdev && !retval; logdev = logdev->next) {
+        if (SDL_AtomicGet(&logdev->paused)) {
+            continue;
+        } else if (logdev->postmix) {
+            retval = SDL_TRUE;  // the postmix callback makes data whenever we mix.
+            break;
+        }
+
+        for (SDL_AudioStream *stream = logdev->bound_streams; stream; stream = stream->next_binding) {
+            SDL_LockMutex(stream->lock);
+            retval = !SDL_IsAudioStreamWaitingForData(stream, device->sample_frames);
+            SDL_UnlockMutex(stream->lock);
+            if (retval) {
+                break;
+            }
+        }
+    }
+    SDL_UnlockMutex(device->lock);
+    return retval;
+}
 
 static int DISKAUDIO_WaitDevice(SDL_AudioDevice *device)
 {
-    SDL_Delay(device->hidden->io_delay);
+    if (device->hidden->freewheel) {
+        while (!device->iscapture && !SDL_AtomicGet(&device->shutdown) && !HasAnythingToMix(device)) {
+            SDL_Delay(10);
+        }
+    } else {
+        SDL_Delay(device->hidden->io_delay);
+    }
     return 0;
 }
 
+static int DISKAUDIO_PollDevice(SDL_AudioDevice *device, Uint64 *wait_ns)
+{
+    if (device->hidden->freewheel) {
+        if (!device->iscapture && !HasAnythingToMix(device)) {
+            *wait_ns = SDL_MS_TO_NS(10);
+            return 0;
+        }
+        return 1;
+    }
+    return SDL_PollAudioDeviceTimer(device, SDL_MS_TO_NS(device->hidden->io_delay), wait_ns);
+}
+
+static SDL_bool WriteWavHeader(SDL_AudioDevice *device, Uint32 data_size)
+{
+    SDL_RWops *io = device->hidden->io;
+    const SDL_AudioSpec *spec = &device->spec;
+    const Uint16 bits = (Uint16) SDL_AUDIO_BITSIZE(spec->format);
+    const Uint16 block_align = (Uint16) SDL_AUDIO_FRAMESIZE(*spec);
+
+    return SDL_RWseek(io, 0, SDL_RW_SEEK_SET) == 0 &&
+           SDL_WriteU32LE(io, 0x46464952) &&  // "RIFF"
+           SDL_WriteU32LE(io, (WAV_HEADER_SIZE - 8) + data_size) &&
+           SDL_WriteU32LE(io, 0x45564157) &&  // "WAVE"
+           SDL_WriteU32LE(io, 0x20746D66) &&  // "fmt "
+           SDL_WriteU32LE(io, 16) &&
+           SDL_WriteU16LE(io, SDL_AUDIO_ISFLOAT(spec->format) ? 3 : 1) &&  // IEEE_FLOAT or PCM
+           SDL_WriteU16LE(io, (Uint16) spec->channels) &&
+           SDL_WriteU32LE(io, (Uint32) spec->freq) &&
+           SDL_WriteU32LE(io, (Uint32) spec->freq * block_align) &&
+           SDL_WriteU16LE(io, block_align) &&
+           SDL_WriteU16LE(io, bits) &&
+           SDL_WriteU32LE(io, 0x61746164) &&  // "data"
+           SDL_WriteU32LE(io, data_size);
+}
+
+// Fill in the WAV header now that we know how big the data is, and close the file.
+static void FinishOutputFile(SDL_AudioDevice *device)
+{
+    struct SDL_PrivateAudioData *h = device->hidden;
+    if (h->io) {
+        if (h->wav && !WriteWavHeader(device, (Uint32) SDL_min(h->bytes_written, SDL_MAX_UINT32 - WAV_HEADER_SIZE))) {
+            SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "DISKAUDIO: Couldn't finish the WAV header: %s", SDL_GetError());
+        }
+        SDL_RWclose(h->io);
+        h->io = NULL;
+
+        if (h->freewheel && h->start_ns) {
+            const Uint64 frames = h->bytes_written / SDL_AUDIO_FRAMESIZE(device->spec);
+            const Uint64 elapsed_ns = SDL_max(SDL_GetTicksNS() - h->start_ns, 1);
+            const double audio_seconds = (double) frames / (double) device->spec.freq;
+            SDL_LogCritical(SDL_LOG_CATEGORY_AUDIO, "DISKAUDIO: Rendered %" SDL_PRIu64 " frames (%.2f seconds) in %.2f seconds, %.1fx realtime",
+                            frames, audio_seconds, (double) elapsed_ns / SDL_NS_PER_SECOND, (audio_seconds * SDL_NS_PER_SECOND) / (double) elapsed_ns);
+        }
+    }
+}
+
 static int DISKAUDIO_PlayDevice(SDL_AudioDevice *device, const Uint8 *buffer, int buffer_size)
 {
-    const int written = (int)SDL_RWwrite(device->hidden->io, buffer, (size_t)buffer_size);
+    struct SDL_PrivateAudioData *h = device->hidden;
+
+    if (!h->io) {
+        return -1;  // already finished writing a fixed-length file.
+    }
+
+    if (h->start_ns == 0) {
+        h->start_ns = SDL_GetTicksNS();
+    }
+
+    if (h->max_bytes > 0) {
+        buffer_size = (int) SDL_min((Uint64) buffer_size, h->max_bytes - h->bytes_written);
+    }
+
+    const int written = (int)SDL_RWwrite(h->io, buffer, (size_t)buffer_size);
     if (written != buffer_size) { // If we couldn't write, assume fatal error for now
         return -1;
     }
+    h->bytes_written += written;
 #ifdef DEBUG_AUDIO
     SDL_Log("DISKAUDIO: Wrote %d bytes of audio data", (int) written);
 #endif
+
+    if ((h->max_bytes > 0) && (h->bytes_written >= h->max_bytes)) {
+        // Done! Report the device as lost, so the app gets an SDL_EVENT_AUDIO_DEVICE_REMOVED to tell it the file is complete.
+        FinishOutputFile(device);
+        return -1;
+    }
+
     return 0;
 }
 
@@ -87,8 +204,12 @@ static void DISKAUDIO_FlushCapture(SDL_AudioDevice *device)
 static void DISKAUDIO_CloseDevice(SDL_AudioDevice *device)
 {
     if (device->hidden) {
-        if (device->hidden->io) {
-            SDL_RWclose(device->hidden->io);
+        if (device->iscapture) {
+            if (device->hidden->io) {
+                SDL_RWclose(device->hidden->io);
+            }
+        } else {
+            FinishOutputFile(device);
         }
         SDL_free(device->hidden->mixbuf);
         SDL_free(device->hidden);
@@ -105,6 +226,22 @@ static const char *get_filename(const SDL_bool iscapture)
     return devname;
 }
 
+static int DISKAUDIO_ResizeDevice(SDL_AudioDevice *device, int *sample_frames)
+{
+    const size_t buffer_size = (size_t) *sample_frames * SDL_AUDIO_FRAMESIZE(device->spec);
+    Uint8 *mixbuf = (Uint8 *) SDL_realloc(device->hidden->mixbuf, buffer_size);
+    if (!mixbuf) {
+        return SDL_OutOfMemory();
+    }
+    device->hidden->mixbuf = mixbuf;
+    SDL_memset(device->hidden->mixbuf, device->silence_value, buffer_size);
+
+    if (!device->hidden->freewheel && !SDL_getenv(DISKENVR_IODELAY)) {
+        device->hidden->io_delay = ((*sample_frames * 1000) / device->spec.freq);
+    }
+    return 0;
+}
+
 static int DISKAUDIO_OpenDevice(SDL_AudioDevice *device)
 {
     SDL_bool iscapture = device->iscapture;
@@ -116,7 +253,10 @@ static int DISKAUDIO_OpenDevice(SDL_AudioDevice *device)
         return SDL_OutOfMemory();
     }
 
-    if (envr) {
+    device->hidden->freewheel = SDL_getenv(DISKENVR_FREEWHEEL) && SDL_atoi(SDL_getenv(DISKENVR_FREEWHEEL));
+    if (device->hidden->freewheel) {
+        device->hidden->io_delay = 0;
+    } else if (envr) {
         device->hidden->io_delay = SDL_atoi(envr);
     } else {
         device->hidden->io_delay = ((device->sample_frames * 1000) / device->spec.freq);
@@ -130,6 +270,39 @@ static int DISKAUDIO_OpenDevice(SDL_AudioDevice *device)
 
     // Allocate mixing buffer
     if (!iscapture) {
+        const char *format = SDL_getenv(DISKENVR_FORMAT);
+        const char *frames = SDL_getenv(DISKENVR_FRAMES);
+        const size_t fnamelen = SDL_strlen(fname);
+
+        if (format) {
+            device->hidden->wav = (SDL_strcasecmp(format, "wav") == 0);
+        } else {
+            device->hidden->wav = (fnamelen >= 4) && (SDL_strcasecmp(fname + fnamelen - 4, ".wav") == 0);
+        }
+
+        if (device->hidden->wav) {
+            // WAV files are little endian, and 8-bit data is unsigned.
+            SDL_AudioFormat wavformat = device->spec.format;
+            if (wavformat == SDL_AUDIO_S8) {
+                wavformat = SDL_AUDIO_U8;
+            } else if (SDL_AUDIO_ISBIGENDIAN(wavformat)) {
+                wavformat = (SDL_AudioFormat) (wavformat & ~SDL_AUDIO_MASK_BIG_ENDIAN);
+            }
+            if (wavformat != device->spec.format) {
+                device->spec.format = wavformat;
+                SDL_UpdatedAudioDeviceFormat(device);
+            }
+
+            // Leave room for the header; it gets filled in when we know how much data there is.
+            if (!WriteWavHeader(device, 0)) {
+                return -1;
+            }
+        }
+
+        if (frames) {
+            device->hidden->max_bytes = (Uint64) SDL_strtoull(frames, NULL, 10) * SDL_AUDIO_FRAMESIZE(device->spec);
+        }
+
         device->hidden->mixbuf = (Uint8 *)SDL_malloc(device->buffer_size);
         if (!device->hidden->mixbuf) {
             return SDL_OutOfMemory();
@@ -139,6 +312,9 @@ static int DISKAUDIO_OpenDevice(SDL_AudioDevice *device)
 
     SDL_LogCritical(SDL_LOG_CATEGORY_AUDIO, "You are using the SDL disk i/o audio driver!");
     SDL_LogCritical(SDL_LOG_CATEGORY_AUDIO, " %s file [%s].\n", iscapture ? "Reading from" : "Writing to", fname);
+    if (device->hidden->freewheel) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_AUDIO, " Freewheeling: mixing as fast as possible, not in realtime!\n");
+    }
 
     return 0;  // We're ready to rock and roll. :-)
 }
@@ -156,6 +332,8 @@ static SDL_bool DISKAUDIO_Init(SDL_AudioDriverImpl *impl)
     impl->WaitCaptureDevice = DISKAUDIO_WaitDevice;
     impl->PlayDevice = DISKAUDIO_PlayDevice;
     impl->GetDeviceBuf = DISKAUDIO_GetDeviceBuf;
+    impl->PollDevice = DISKAUDIO_PollDevice;
+    impl->ResizeDevice = DISKAUDIO_ResizeDevice;
     impl->CaptureFromDevice = DISKAUDIO_CaptureFromDevice;
     impl->FlushCapture = DISKAUDIO_FlushCapture;
     impl->CloseDevice = DISKAUDIO_CloseDevice;
@@ -31,6 +31,11 @@ struct SDL_PrivateAudioData
     SDL_RWops *io;
     Uint32 io_delay;
     Uint8 *mixbuf;
+    SDL_bool freewheel;  // don't pace output in realtime, just go as fast as we can.
+    SDL_bool wav;  // write a WAV header instead of raw samples.
+    Uint64 max_bytes;  // stop after writing this much, if > 0.
+    Uint64 bytes_written;
+    Uint64 start_ns;  // when the first buffer was written, for throughput stats.
 };
 
 #endif // SDL_diskaudio_h_
@@ -34,6 +34,11 @@ static int DUMMYAUDIO_WaitDevice(SDL_AudioDevice *device)
     return 0;
 }
 
+static int DUMMYAUDIO_PollDevice(SDL_AudioDevice *device, Uint64 *wait_ns)
+{
+    return SDL_PollAudioDeviceTimer(device, SDL_MS_TO_NS(device->hidden->io_delay), wait_ns);
+}
+
 static int DUMMYAUDIO_OpenDevice(SDL_AudioDevice *device)
 {
     const char *envr = SDL_getenv(DUMMYENVR_IODELAY);
@@ -55,6 +60,20 @@ static int DUMMYAUDIO_OpenDevice(SDL_AudioDevice *device)
     return 0; // we're good; don't change reported device format.
 }
 
+static int DUMMYAUDIO_ResizeDevice(SDL_AudioDevice *device, int *sample_frames)
+{
+    Uint8 *mixbuf = (Uint8 *) SDL_realloc(device->hidden->mixbuf, (size_t) *sample_frames * SDL_AUDIO_FRAMESIZE(device->spec));
+    if (!mixbuf) {
+        return SDL_OutOfMemory();
+    }
+    device->hidden->mixbuf = mixbuf;
+
+    if (!SDL_getenv(DUMMYENVR_IODELAY)) {
+        device->hidden->io_delay = (Uint32) ((*sample_frames * 1000) / device->spec.freq);
+    }
+    return 0;
+}
+
 static void DUMMYAUDIO_CloseDevice(SDL_AudioDevice *device)
 {
     if (device->hidden) {
@@ -82,6 +101,8 @@ static SDL_bool DUMMYAUDIO_Init(SDL_AudioDriverImpl *impl)
     impl->CloseDevice = DUMMYAUDIO_CloseDevice;
     impl->WaitDevice = DUMMYAUDIO_WaitDevice;
     impl->GetDeviceBuf = DUMMYAUDIO_GetDeviceBuf;
+    impl->PollDevice = DUMMYAUDIO_PollDevice;
+    impl->ResizeDevice = DUMMYAUDIO_ResizeDevice;
     impl->WaitCaptureDevice = DUMMYAUDIO_WaitDevice;
     impl->CaptureFromDevice = DUMMYAUDIO_CaptureFromDevice;
 
@@ -107,6 +107,7 @@ static int (*PULSEAUDIO_pa_stream_connect_playback)(pa_stream *, const char *,
 static int (*PULSEAUDIO_pa_stream_connect_record)(pa_stream *, const char *,
                                                   const pa_buffer_attr *, pa_stream_flags_t);
 static const pa_buffer_attr *(*PULSEAUDIO_pa_stream_get_buffer_attr)(pa_stream *);
+static pa_operation *(*PULSEAUDIO_pa_stream_set_buffer_attr)(pa_stream *, const pa_buffer_attr *, pa_stream_success_cb_t, void *);
 static pa_stream_state_t (*PULSEAUDIO_pa_stream_get_state)(const pa_stream *);
 static size_t (*PULSEAUDIO_pa_stream_writable_size)(const pa_stream *);
 static size_t (*PULSEAUDIO_pa_stream_readable_size)(const pa_stream *);
@@ -222,6 +223,7 @@ static int load_pulseaudio_syms(void)
     SDL_PULSEAUDIO_SYM(pa_stream_connect_playback);
     SDL_PULSEAUDIO_SYM(pa_stream_connect_record);
     SDL_PULSEAUDIO_SYM(pa_stream_get_buffer_attr);
+    SDL_PULSEAUDIO_SYM(pa_stream_set_buffer_attr);
     SDL_PULSEAUDIO_SYM(pa_stream_get_state);
     SDL_PULSEAUDIO_SYM(pa_stream_writable_size);
     SDL_PULSEAUDIO_SYM(pa_stream_readable_size);
@@ -470,6 +472,44 @@ static Uint8 *PULSEAUDIO_GetDeviceBuf(SDL_AudioDevice *device, int *buffer_size)
     return device->hidden->mixbuf;
 }
 
+static void BufferAttrCallback(pa_stream *p, int success, void *userdata)
+{
+    PULSEAUDIO_pa_threaded_mainloop_signal(pulseaudio_threaded_mainloop, 0);  // so WaitForPulseOperation wakes up, even without pa_operation_set_state_callback.
+}
+
+// Change the target latency of a playing stream; the write callback will ask for data in the new size from here on.
+static int PULSEAUDIO_ResizeDevice(SDL_AudioDevice *device, int *sample_frames)
+{
+    struct SDL_PrivateAudioData *h = device->hidden;
+    const int frame_size = SDL_AUDIO_FRAMESIZE(device->spec);
+    int buffer_size = *sample_frames * frame_size;
+    pa_buffer_attr paattr;
+
+    Uint8 *mixbuf = (Uint8 *)SDL_realloc(h->mixbuf, buffer_size);
+    if (!mixbuf) {
+        return SDL_OutOfMemory();
+    }
+    h->mixbuf = mixbuf;
+    SDL_memset(h->mixbuf, device->silence_value, buffer_size);
+
+    paattr.fragsize = buffer_size;
+    paattr.tlength = buffer_size;
+    paattr.prebuf = -1;
+    paattr.maxlength = -1;
+    paattr.minreq = -1;
+
+    PULSEAUDIO_pa_threaded_mainloop_lock(pulseaudio_threaded_mainloop);
+    WaitForPulseOperation(PULSEAUDIO_pa_stream_set_buffer_attr(h->stream, &paattr, BufferAttrCallback, NULL));
+    const pa_buffer_attr *actual_bufattr = PULSEAUDIO_pa_stream_get_buffer_attr(h->stream);
+    if (actual_bufattr && (actual_bufattr->tlength < (Uint32) buffer_size)) {
+        buffer_size = (int) actual_bufattr->tlength;  // the server may round it off. (we keep the bigger mixbuf, that's fine.)
+    }
+    PULSEAUDIO_pa_threaded_mainloop_unlock(pulseaudio_threaded_mainloop);
+
+    *sample_frames = SDL_max(buffer_size / frame_size, 1);
+    return 0;
+}
+
 static void ReadCallback(pa_stream *p, size_t nbytes, void *userdata)
 {
     //SDL_Log("PULSEAUDIO READ CALLBACK! nbytes=%u", (unsigned int) nbytes);
@@ -1012,6 +1052,7 @@ static SDL_bool PULSEAUDIO_Init(SDL_AudioDriverImpl *impl)
     impl->PlayDevice = PULSEAUDIO_PlayDevice;
     impl->WaitDevice = PULSEAUDIO_WaitDevice;
     impl->GetDeviceBuf = PULSEAUDIO_GetDeviceBuf;
+    impl->ResizeDevice = PULSEAUDIO_ResizeDevice;
     impl->CloseDevice = PULSEAUDIO_CloseDevice;
     impl->DeinitializeStart = PULSEAUDIO_DeinitializeStart;
     impl->Deinitialize = PULSEAUDIO_Deinitialize;
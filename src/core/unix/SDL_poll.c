@@ -93,3 +93,102 @@ int SDL_IOReady(int fd, int flags, Sint64 timeoutNS)
 
     return result;
 }
+
+int SDL_IOReadyOrWakeup(int fd, int flags, int wakeup_fd, Sint64 timeoutNS)
+{
+    int result;
+
+    if (wakeup_fd < 0) {
+        return SDL_IOReady(fd, flags, timeoutNS);
+    }
+    SDL_assert(fd < 0 || (flags & (SDL_IOR_READ | SDL_IOR_WRITE)));
+
+    /* Note: We don't bother to account for elapsed time if we get EINTR */
+    do {
+#ifdef HAVE_POLL
+        struct pollfd info[2];
+        int timeoutMS;
+
+        /* poll() skips entries with a negative fd */
+        info[0].fd = fd;
+        info[0].events = 0;
+        info[0].revents = 0;
+        if (flags & SDL_IOR_READ) {
+            info[0].events |= POLLIN | POLLPRI;
+        }
+        if (flags & SDL_IOR_WRITE) {
+            info[0].events |= POLLOUT;
+        }
+        info[1].fd = wakeup_fd;
+        info[1].events = POLLIN;
+        info[1].revents = 0;
+
+        /* Round up so we don't wake up just before the deadline and spin */
+        if (timeoutNS > 0) {
+            timeoutMS = (int)SDL_NS_TO_MS(timeoutNS + (SDL_NS_PER_MS - 1));
+        } else if (timeoutNS == 0) {
+            timeoutMS = 0;
+        } else {
+            timeoutMS = -1;
+        }
+        result = poll(info, 2, timeoutMS);
+        if (result > 0) {
+            result = 0;
+            if (info[0].revents & (POLLIN | POLLPRI | POLLHUP | POLLERR)) {
+                result |= (flags & SDL_IOR_READ);
+            }
+            if (info[0].revents & (POLLOUT | POLLHUP | POLLERR)) {
+                result |= (flags & SDL_IOR_WRITE);
+            }
+            if (info[1].revents) {
+                result |= SDL_IOR_WAKEUP;
+            }
+        }
+#else
+        fd_set rfdset;
+        fd_set wfdset, *wfdp = NULL;
+        struct timeval tv, *tvp = NULL;
+        int maxfd = wakeup_fd;
+
+        /* If this assert triggers we'll corrupt memory here */
+        SDL_assert(fd < FD_SETSIZE && wakeup_fd < FD_SETSIZE);
+
+        FD_ZERO(&rfdset);
+        FD_SET(wakeup_fd, &rfdset);
+        if (fd >= 0) {
+            if (flags & SDL_IOR_READ) {
+                FD_SET(fd, &rfdset);
+            }
+            if (flags & SDL_IOR_WRITE) {
+                FD_ZERO(&wfdset);
+                FD_SET(fd, &wfdset);
+                wfdp = &wfdset;
+            }
+            maxfd = SDL_max(maxfd, fd);
+        }
+
+        if (timeoutNS >= 0) {
+            tv.tv_sec = (timeoutNS / SDL_NS_PER_SECOND);
+            tv.tv_usec = SDL_NS_TO_US(timeoutNS % SDL_NS_PER_SECOND);
+            tvp = &tv;
+        }
+
+        result = select(maxfd + 1, &rfdset, wfdp, NULL, tvp);
+        if (result > 0) {
+            result = 0;
+            if (fd >= 0 && (flags & SDL_IOR_READ) && FD_ISSET(fd, &rfdset)) {
+                result |= SDL_IOR_READ;
+            }
+            if (wfdp && FD_ISSET(fd, wfdp)) {
+                result |= SDL_IOR_WRITE;
+            }
+            if (FD_ISSET(wakeup_fd, &rfdset)) {
+                result |= SDL_IOR_WAKEUP;
+            }
+        }
+#endif /* HAVE_POLL */
+
+    } while (result < 0 && errno == EINTR && !(flags & SDL_IOR_NO_RETRY));
+
+    return result;
+}
@@ -27,7 +27,13 @@
 #define SDL_IOR_READ     0x1
 #define SDL_IOR_WRITE    0x2
 #define SDL_IOR_NO_RETRY 0x4
+#define SDL_IOR_WAKEUP   0x8
 
 extern int SDL_IOReady(int fd, int flags, Sint64 timeoutNS);
 
+/* Like SDL_IOReady(), but also returns when wakeup_fd becomes readable.
+   On success, returns the SDL_IOR_READ/SDL_IOR_WRITE conditions that are ready
+   on fd, plus SDL_IOR_WAKEUP if wakeup_fd is readable. Either fd may be -1. */
+extern int SDL_IOReadyOrWakeup(int fd, int flags, int wakeup_fd, Sint64 timeoutNS);
+
 #endif /* SDL_poll_h_ */
@@ -988,3 +988,16 @@
 #define SDL_GetBooleanProperty SDL_GetBooleanProperty_REAL
 #define SDL_CreateTextureWithProperties SDL_CreateTextureWithProperties_REAL
 #define SDL_CreateRendererWithProperties SDL_CreateRendererWithProperties_REAL
+#define SDL_PollEvents SDL_PollEvents_REAL
+#define SDL_GetMouseMotionSamples SDL_GetMouseMotionSamples_REAL
+#define SDL_GetEventMemoryStats SDL_GetEventMemoryStats_REAL
+#define SDL_PutAudioStreamDataNoCopy SDL_PutAudioStreamDataNoCopy_REAL
+#define SDL_SetAudioStreamSingleProducer SDL_SetAudioStreamSingleProducer_REAL
+#define SDL_CreateAudioStreamFromWAV_RW SDL_CreateAudioStreamFromWAV_RW_REAL
+#define SDL_CreateAudioStreamFromWAV SDL_CreateAudioStreamFromWAV_REAL
+#define SDL_GetAudioDeviceStats SDL_GetAudioDeviceStats_REAL
+#define SDL_GetAudioStreamGain SDL_GetAudioStreamGain_REAL
+#define SDL_SetAudioStreamGain SDL_SetAudioStreamGain_REAL
+#define SDL_GetAudioStreamChannelGains SDL_GetAudioStreamChannelGains_REAL
+#define SDL_SetAudioStreamChannelGains SDL_SetAudioStreamChannelGains_REAL
+#define SDL_GetAudioChunkPoolStats SDL_GetAudioChunkPoolStats_REAL
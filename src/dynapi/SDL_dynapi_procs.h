@@ -1013,3 +1013,16 @@ SDL_DYNAPI_PROC(int,SDL_SetBooleanProperty,(SDL_PropertiesID a, const char *b, S
 SDL_DYNAPI_PROC(SDL_bool,SDL_GetBooleanProperty,(SDL_PropertiesID a, const char *b, SDL_bool c),(a,b,c),return)
 SDL_DYNAPI_PROC(SDL_Texture*,SDL_CreateTextureWithProperties,(SDL_Renderer *a, SDL_PropertiesID b),(a,b),return)
 SDL_DYNAPI_PROC(SDL_Renderer*,SDL_CreateRendererWithProperties,(SDL_PropertiesID a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_PollEvents,(SDL_Event *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetMouseMotionSamples,(SDL_MouseMotionEvent *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetEventMemoryStats,(SDL_EventMemoryStats *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_PutAudioStreamDataNoCopy,(SDL_AudioStream *a, const void *b, int c, SDL_AudioStreamDataCompleteCallback d, void *e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(int,SDL_SetAudioStreamSingleProducer,(SDL_AudioStream *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_AudioStream*,SDL_CreateAudioStreamFromWAV_RW,(SDL_RWops *a, SDL_bool b, const SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_AudioStream*,SDL_CreateAudioStreamFromWAV,(const char *a, const SDL_AudioSpec *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetAudioDeviceStats,(SDL_AudioDeviceID a, SDL_AudioDeviceStats *b),(a,b),return)
+SDL_DYNAPI_PROC(float,SDL_GetAudioStreamGain,(SDL_AudioStream *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_SetAudioStreamGain,(SDL_AudioStream *a, float b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetAudioStreamChannelGains,(SDL_AudioStream *a, float *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_SetAudioStreamChannelGains,(SDL_AudioStream *a, const float *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_GetAudioChunkPoolStats,(SDL_AudioChunkPoolStats *a),(a),return)
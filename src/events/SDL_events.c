@@ -34,6 +34,15 @@
 #endif
 #include "../video/SDL_sysvideo.h"
 
+#ifdef __LINUX__
+#define SDL_USE_EVENT_WAKEUP_FD
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "../core/unix/SDL_poll.h"
+#endif
+
 #undef SDL_PRIs64
 #if (defined(__WIN32__) || defined(__GDK__)) && !defined(__CYGWIN__)
 #define SDL_PRIs64 "I64d"
@@ -51,17 +60,34 @@ typedef struct SDL_EventWatcher
 {
     SDL_EventFilter callback;
     void *userdata;
-    SDL_bool removed;
+    int id;              /* the same in every snapshot the watcher has been copied into */
+    SDL_AtomicInt removed; /* set in every snapshot when the watcher is removed, checked before each call */
 } SDL_EventWatcher;
 
-static SDL_Mutex *SDL_event_watchers_lock;
-static SDL_EventWatcher SDL_EventOK;
-static SDL_EventWatcher *SDL_event_watchers = NULL;
-static int SDL_event_watchers_count = 0;
-static SDL_bool SDL_event_watchers_dispatching = SDL_FALSE;
-static SDL_bool SDL_event_watchers_removed = SDL_FALSE;
+/* An immutable snapshot of the event filter and watchers. Changes build a new
+   snapshot and swap it in, so SDL_PushEvent() can dispatch without locking.
+   Replaced snapshots are freed once every thread that might still be
+   dispatching from them has finished (see SDL_WaitForEventWatchers). */
+typedef struct SDL_EventWatchList
+{
+    SDL_EventWatcher filter;
+    int count;
+    struct SDL_EventWatchList *next_retired;
+    SDL_EventWatcher watchers[1];
+} SDL_EventWatchList;
+
+static SDL_Mutex *SDL_event_watchers_lock;      /* serializes changes to the watcher list */
+static SDL_Mutex *SDL_event_watchers_sync_lock; /* serializes waiting for dispatches to finish */
+static SDL_EventWatchList *SDL_event_watchers = NULL;
+static SDL_EventWatchList *SDL_event_watchers_retired = NULL;
+static int SDL_event_watchers_next_id = 0;
+static SDL_AtomicInt SDL_event_watchers_epoch;
+static SDL_AtomicInt SDL_event_watchers_readers[2];
+static SDL_TLSID SDL_event_watchers_dispatching;
+
+static void SDL_FreeEventWatchLists(SDL_EventWatchList *list);
 static SDL_AtomicInt SDL_sentinel_pending;
-static Uint32 SDL_last_event_id = 0;
+static SDL_AtomicInt SDL_last_event_id;
 
 typedef struct
 {
@@ -79,83 +105,294 @@ typedef struct SDL_EventEntry
     struct SDL_EventEntry *next;
 } SDL_EventEntry;
 
+/* The lock only serializes consumers (and the slow path below); producers
+   append to SDL_EventRing without taking it. Events in the linked list are
+   always older than events in the ring, so consumers read the list first. */
 static struct
 {
     SDL_Mutex *lock;
-    SDL_bool active;
+    SDL_AtomicInt active; /* only changed with the lock held, producers check it without */
     SDL_AtomicInt count;
-    int max_events_seen;
+    SDL_AtomicInt max_events_seen;
+    SDL_AtomicInt out_of_order; /* events were removed from the middle of the queue since it was last empty */
     SDL_EventEntry *head;
     SDL_EventEntry *tail;
     SDL_EventEntry *free;
-} SDL_EventQ = { NULL, SDL_FALSE, { 0 }, 0, NULL, NULL, NULL };
+} SDL_EventQ = { NULL, { 0 }, { 0 }, { 0 }, { 0 }, NULL, NULL, NULL };
+
+/* Bounded lock-free multi-producer queue (Vyukov-style), consumed while
+   holding SDL_EventQ.lock. When it fills up, the producer takes the lock and
+   moves everything into the linked list, so SDL_MAX_QUEUED_EVENTS is still
+   enforced by SDL_EventQ.count alone. This is statically allocated so late
+   producers can't touch freed memory during shutdown. */
+#define SDL_EVENT_RING_SIZE 1024 /* must be a power of two */
+
+typedef struct SDL_EventRingCell
+{
+    SDL_AtomicInt sequence;
+    SDL_Event event;
+} SDL_EventRingCell;
+
+static struct
+{
+    SDL_bool initialized;
+    SDL_AtomicInt enqueue_pos;
+    Uint32 dequeue_pos; /* only touched with SDL_EventQ.lock held */
+    SDL_EventRingCell cells[SDL_EVENT_RING_SIZE];
+} SDL_EventRing;
+
+/* Get a list entry for a new event, recycling old ones -- called with the queue locked */
+static SDL_EventEntry *SDL_NewEventEntry(void)
+{
+    SDL_EventEntry *entry;
+
+    if (SDL_EventQ.free == NULL) {
+        entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
+    } else {
+        entry = SDL_EventQ.free;
+        SDL_EventQ.free = entry->next;
+    }
+    return entry;
+}
+
+/* Link an entry to the end of the list -- called with the queue locked */
+static void SDL_LinkEventEntry(SDL_EventEntry *entry)
+{
+    if (SDL_EventQ.tail) {
+        SDL_EventQ.tail->next = entry;
+        entry->prev = SDL_EventQ.tail;
+        SDL_EventQ.tail = entry;
+        entry->next = NULL;
+    } else {
+        SDL_assert(!SDL_EventQ.head);
+        SDL_EventQ.head = entry;
+        SDL_EventQ.tail = entry;
+        entry->prev = NULL;
+        entry->next = NULL;
+    }
+}
+
+/* Try to append an event to the ring, returns SDL_FALSE if it is full -- safe to call without the queue locked */
+static SDL_bool SDL_PushEventRing(const SDL_Event *event)
+{
+    Uint32 pos = (Uint32)SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+    SDL_EventRingCell *cell;
+
+    for (;;) {
+        Sint32 diff;
+
+        cell = &SDL_EventRing.cells[pos & (SDL_EVENT_RING_SIZE - 1)];
+        diff = (Sint32)((Uint32)SDL_AtomicGet(&cell->sequence) - pos);
+        if (diff == 0) {
+            if (SDL_AtomicCAS(&SDL_EventRing.enqueue_pos, (int)pos, (int)(pos + 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* The consumer hasn't released this cell yet, the ring is full */
+            return SDL_FALSE;
+        }
+        pos = (Uint32)SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+    }
+
+    SDL_copyp(&cell->event, event);
+
+    /* Publish the event to the consumer */
+    SDL_AtomicSet(&cell->sequence, (int)(pos + 1));
+    return SDL_TRUE;
+}
+
+/* Get the cell at the given ring position, or NULL if nothing has been published there -- called with the queue locked */
+static SDL_EventRingCell *SDL_GetEventRingCell(Uint32 pos)
+{
+    SDL_EventRingCell *cell = &SDL_EventRing.cells[pos & (SDL_EVENT_RING_SIZE - 1)];
+
+    if ((Sint32)((Uint32)SDL_AtomicGet(&cell->sequence) - (pos + 1)) < 0) {
+        return NULL;
+    }
+    return cell;
+}
+
+/* Release the oldest cell in the ring back to the producers -- called with the queue locked */
+static void SDL_ReleaseEventRingCell(SDL_EventRingCell *cell)
+{
+    const Uint32 pos = SDL_EventRing.dequeue_pos;
+
+    SDL_assert(cell == SDL_GetEventRingCell(pos));
+    SDL_AtomicSet(&cell->sequence, (int)(pos + SDL_EVENT_RING_SIZE));
+    SDL_EventRing.dequeue_pos = pos + 1;
+}
 
-typedef struct SDL_EventMemory
+/* Move all published events from the ring to the end of the list -- called with the queue locked */
+static SDL_bool SDL_MigrateEventRing(void)
+{
+    SDL_EventRingCell *cell;
+
+    while ((cell = SDL_GetEventRingCell(SDL_EventRing.dequeue_pos)) != NULL) {
+        SDL_EventEntry *entry = SDL_NewEventEntry();
+        if (entry == NULL) {
+            /* Whatever is left stays in the ring, still after the list in order */
+            return SDL_FALSE;
+        }
+        SDL_copyp(&entry->event, &cell->event);
+        SDL_ReleaseEventRingCell(cell);
+        SDL_LinkEventEntry(entry);
+    }
+    return SDL_TRUE;
+}
+
+/* Event memory is bump allocated out of arena blocks. Each block remembers the
+   newest event ID it was used for, and is recycled wholesale once the queue
+   has moved past that generation. */
+#define SDL_EVENT_MEMORY_BLOCK_SIZE    4096
+#define SDL_EVENT_MEMORY_ALIGNMENT     16
+#define SDL_EVENT_MEMORY_CACHED_BLOCKS 8
+
+typedef struct SDL_EventMemoryBlock
 {
     Uint32 eventID;
-    void *memory;
-    struct SDL_EventMemory *next;
-} SDL_EventMemory;
+    size_t size;
+    size_t used;
+    struct SDL_EventMemoryBlock *next;
+} SDL_EventMemoryBlock;
+
+/* The block header is padded so the data that follows it stays aligned */
+#define SDL_EVENT_MEMORY_HEADER_SIZE ((sizeof(SDL_EventMemoryBlock) + (SDL_EVENT_MEMORY_ALIGNMENT - 1)) & ~(size_t)(SDL_EVENT_MEMORY_ALIGNMENT - 1))
 
 static SDL_Mutex *SDL_event_memory_lock;
-static SDL_EventMemory *SDL_event_memory_head;
-static SDL_EventMemory *SDL_event_memory_tail;
+static SDL_EventMemoryBlock *SDL_event_memory_head;
+static SDL_EventMemoryBlock *SDL_event_memory_tail;
+static SDL_EventMemoryBlock *SDL_event_memory_free;
+static SDL_EventMemoryStats SDL_event_memory_stats;
+
+static SDL_EventMemoryBlock *SDL_NewEventMemoryBlock(size_t size)
+{
+    SDL_EventMemoryBlock *block;
+
+    if (size <= SDL_EVENT_MEMORY_BLOCK_SIZE && SDL_event_memory_free) {
+        block = SDL_event_memory_free;
+        SDL_event_memory_free = block->next;
+        --SDL_event_memory_stats.blocks_cached;
+    } else {
+        size = SDL_max(size, SDL_EVENT_MEMORY_BLOCK_SIZE);
+        block = (SDL_EventMemoryBlock *)SDL_malloc(SDL_EVENT_MEMORY_HEADER_SIZE + size);
+        if (!block) {
+            return NULL;
+        }
+        block->size = size;
+        ++SDL_event_memory_stats.heap_allocations;
+    }
+    block->used = 0;
+    block->next = NULL;
+
+    if (SDL_event_memory_tail) {
+        SDL_event_memory_tail->next = block;
+    } else {
+        SDL_event_memory_head = block;
+    }
+    SDL_event_memory_tail = block;
+    ++SDL_event_memory_stats.blocks_in_use;
+
+    return block;
+}
+
+static void SDL_ReleaseEventMemoryBlock(SDL_EventMemoryBlock *block, SDL_bool cache)
+{
+    --SDL_event_memory_stats.blocks_in_use;
+
+    if (cache && block->size == SDL_EVENT_MEMORY_BLOCK_SIZE &&
+        SDL_event_memory_stats.blocks_cached < SDL_EVENT_MEMORY_CACHED_BLOCKS) {
+        block->next = SDL_event_memory_free;
+        SDL_event_memory_free = block;
+        ++SDL_event_memory_stats.blocks_cached;
+    } else {
+        SDL_free(block);
+        ++SDL_event_memory_stats.heap_frees;
+    }
+}
 
 void *SDL_AllocateEventMemory(size_t size)
 {
-    void *memory = SDL_malloc(size);
-    if (!memory) {
+    void *memory = NULL;
+
+    /* Keep every allocation aligned like SDL_malloc() would */
+    if (size > SDL_SIZE_MAX - SDL_EVENT_MEMORY_ALIGNMENT) {
         SDL_OutOfMemory();
         return NULL;
     }
+    size = (size + (SDL_EVENT_MEMORY_ALIGNMENT - 1)) & ~(size_t)(SDL_EVENT_MEMORY_ALIGNMENT - 1);
+    if (size == 0) {
+        size = SDL_EVENT_MEMORY_ALIGNMENT;
+    }
 
     SDL_LockMutex(SDL_event_memory_lock);
     {
-        SDL_EventMemory *entry = (SDL_EventMemory *)SDL_malloc(sizeof(*entry));
-        if (entry) {
-            entry->eventID = SDL_last_event_id;
-            entry->memory = memory;
-            entry->next = NULL;
+        SDL_EventMemoryBlock *block = SDL_event_memory_tail;
 
-            if (SDL_event_memory_tail) {
-                SDL_event_memory_tail->next = entry;
-            } else {
-                SDL_event_memory_head = entry;
-            }
-            SDL_event_memory_tail = entry;
-        } else {
-            SDL_free(memory);
-            memory = NULL;
-            SDL_OutOfMemory();
+        if (!block || (block->size - block->used) < size) {
+            block = SDL_NewEventMemoryBlock(size);
+        }
+        if (block) {
+            memory = (Uint8 *)block + SDL_EVENT_MEMORY_HEADER_SIZE + block->used;
+            block->used += size;
+            block->eventID = (Uint32)SDL_AtomicGet(&SDL_last_event_id);
+
+            ++SDL_event_memory_stats.allocations;
+            SDL_event_memory_stats.bytes_allocated += size;
         }
     }
     SDL_UnlockMutex(SDL_event_memory_lock);
 
+    if (!memory) {
+        SDL_OutOfMemory();
+    }
     return memory;
 }
 
-static void SDL_FlushEventMemory(Uint32 eventID)
+int SDL_GetEventMemoryStats(SDL_EventMemoryStats *stats)
 {
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
     SDL_LockMutex(SDL_event_memory_lock);
     {
-        if (SDL_event_memory_head) {
-            while (SDL_event_memory_head) {
-                SDL_EventMemory *entry = SDL_event_memory_head;
+        SDL_copyp(stats, &SDL_event_memory_stats);
+    }
+    SDL_UnlockMutex(SDL_event_memory_lock);
 
-                if (eventID && (Sint32)(eventID - entry->eventID) < 0) {
-                    break;
-                }
+    return 0;
+}
 
-                /* If you crash here, your application has memory corruption
-                 * or freed memory in an event, which is no longer necessary.
-                 */
-                SDL_event_memory_head = entry->next;
-                SDL_free(entry->memory);
-                SDL_free(entry);
+static void SDL_FlushEventMemory(Uint32 eventID)
+{
+    SDL_LockMutex(SDL_event_memory_lock);
+    {
+        while (SDL_event_memory_head) {
+            SDL_EventMemoryBlock *block = SDL_event_memory_head;
+
+            if (eventID && (Sint32)(eventID - block->eventID) < 0) {
+                break;
             }
-            if (!SDL_event_memory_head) {
-                SDL_event_memory_tail = NULL;
+
+            /* If you crash here, your application has memory corruption
+             * or freed memory in an event, which is no longer necessary.
+             */
+            SDL_event_memory_head = block->next;
+            SDL_ReleaseEventMemoryBlock(block, eventID ? SDL_TRUE : SDL_FALSE);
+        }
+        if (!SDL_event_memory_head) {
+            SDL_event_memory_tail = NULL;
+        }
+
+        if (!eventID) {
+            /* Shutting down, return the cached blocks to the heap too */
+            while (SDL_event_memory_free) {
+                SDL_EventMemoryBlock *block = SDL_event_memory_free;
+                SDL_event_memory_free = block->next;
+                SDL_free(block);
+                ++SDL_event_memory_stats.heap_frees;
             }
+            SDL_event_memory_stats.blocks_cached = 0;
         }
     }
     SDL_UnlockMutex(SDL_event_memory_lock);
@@ -550,6 +787,15 @@ static void SDL_LogEvent(const SDL_Event *event)
         break;
 #undef PRINT_AUDIODEV_EVENT
 
+#define PRINT_AUDIOSTREAM_EVENT(event) (void)SDL_snprintf(details, sizeof(details), " (timestamp=%u stream=%p queued=%d)", (uint)event->astream.timestamp, (void *)event->astream.stream, event->astream.queued)
+        SDL_EVENT_CASE(SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK)
+        PRINT_AUDIOSTREAM_EVENT(event);
+        break;
+        SDL_EVENT_CASE(SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK)
+        PRINT_AUDIOSTREAM_EVENT(event);
+        break;
+#undef PRINT_AUDIOSTREAM_EVENT
+
         SDL_EVENT_CASE(SDL_EVENT_SENSOR_UPDATE)
         (void)SDL_snprintf(details, sizeof(details), " (timestamp=%u which=%d data[0]=%f data[1]=%f data[2]=%f data[3]=%f data[4]=%f data[5]=%f)",
                            (uint)event->sensor.timestamp, (int)event->sensor.which,
@@ -578,19 +824,121 @@ static void SDL_LogEvent(const SDL_Event *event)
 #undef uint
 }
 
+#ifdef SDL_USE_EVENT_WAKEUP_FD
+/* A single wakeup handle that every producer signals when a thread is blocked
+   waiting for events. It's an eventfd, or a pipe if that isn't available. */
+static int SDL_event_wakeup_fds[2] = { -1, -1 };
+static SDL_AtomicInt SDL_event_wakeup_waiters;
+static SDL_AtomicInt SDL_event_wakeup_signaled;
+
+static void SDL_CreateEventWakeup(void)
+{
+    if (SDL_event_wakeup_fds[0] >= 0) {
+        return;
+    }
+
+    SDL_event_wakeup_fds[0] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (SDL_event_wakeup_fds[0] >= 0) {
+        SDL_event_wakeup_fds[1] = SDL_event_wakeup_fds[0];
+    } else if (pipe(SDL_event_wakeup_fds) == 0) {
+        int i;
+        for (i = 0; i < 2; ++i) {
+            fcntl(SDL_event_wakeup_fds[i], F_SETFL, fcntl(SDL_event_wakeup_fds[i], F_GETFL) | O_NONBLOCK);
+            fcntl(SDL_event_wakeup_fds[i], F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        /* We'll fall back to the video driver wakeup and polling */
+        SDL_event_wakeup_fds[0] = -1;
+        SDL_event_wakeup_fds[1] = -1;
+    }
+    SDL_AtomicSet(&SDL_event_wakeup_signaled, 0);
+}
+
+static void SDL_DestroyEventWakeup(void)
+{
+    if (SDL_event_wakeup_fds[0] >= 0) {
+        close(SDL_event_wakeup_fds[0]);
+        if (SDL_event_wakeup_fds[1] != SDL_event_wakeup_fds[0]) {
+            close(SDL_event_wakeup_fds[1]);
+        }
+        SDL_event_wakeup_fds[0] = -1;
+        SDL_event_wakeup_fds[1] = -1;
+    }
+}
+
+static void SDL_SignalEventWakeup(void)
+{
+    /* Only make a system call if someone is waiting and hasn't been woken yet */
+    if (SDL_AtomicGet(&SDL_event_wakeup_waiters) > 0 && SDL_AtomicCAS(&SDL_event_wakeup_signaled, 0, 1)) {
+        const Uint64 value = 1;
+        const size_t size = (SDL_event_wakeup_fds[1] == SDL_event_wakeup_fds[0]) ? sizeof(value) : 1;
+        ssize_t result;
+
+        do {
+            result = write(SDL_event_wakeup_fds[1], &value, size);
+        } while (result < 0 && errno == EINTR);
+    }
+}
+
+/* Register as a waiter before the final check of the queue, so pushes after that check wake us */
+static void SDL_BeginEventWakeupWait(void)
+{
+    if (SDL_event_wakeup_fds[0] >= 0) {
+        SDL_AtomicIncRef(&SDL_event_wakeup_waiters);
+    }
+}
+
+static void SDL_EndEventWakeupWait(void)
+{
+    if (SDL_event_wakeup_fds[0] >= 0) {
+        SDL_AtomicDecRef(&SDL_event_wakeup_waiters);
+
+        if (SDL_AtomicGet(&SDL_event_wakeup_signaled)) {
+            Uint64 buf[8];
+
+            /* Drain before clearing the flag, so a concurrent signal isn't lost */
+            while (read(SDL_event_wakeup_fds[0], buf, sizeof(buf)) > 0) {
+            }
+            SDL_AtomicSet(&SDL_event_wakeup_signaled, 0);
+        }
+    }
+}
+
+int SDL_GetEventWakeupFD(void)
+{
+    return SDL_event_wakeup_fds[0];
+}
+#else
+#define SDL_SignalEventWakeup()
+#define SDL_BeginEventWakeupWait()
+#define SDL_EndEventWakeupWait()
+
+int SDL_GetEventWakeupFD(void)
+{
+    return -1;
+}
+#endif /* SDL_USE_EVENT_WAKEUP_FD */
+
+/* Returns SDL_TRUE if the video driver can wait on the shared wakeup handle instead of a wakeup window */
+static SDL_bool SDL_VideoWaitsOnEventWakeup(SDL_VideoDevice *_this)
+{
+    return (_this && _this->waits_on_event_wakeup && SDL_GetEventWakeupFD() >= 0) ? SDL_TRUE : SDL_FALSE;
+}
+
 void SDL_StopEventLoop(void)
 {
     const char *report = SDL_GetHint("SDL_EVENT_QUEUE_STATISTICS");
     int i;
     SDL_EventEntry *entry;
+    SDL_EventRingCell *cell;
 
     SDL_LockMutex(SDL_EventQ.lock);
 
-    SDL_EventQ.active = SDL_FALSE;
+    SDL_AtomicSet(&SDL_EventQ.active, 0);
 
     if (report && SDL_atoi(report)) {
         SDL_Log("SDL EVENT QUEUE: Maximum events in-flight: %d\n",
-                SDL_EventQ.max_events_seen);
+                SDL_AtomicGet(&SDL_EventQ.max_events_seen));
     }
 
     /* Clean out EventQ */
@@ -604,9 +952,13 @@ void SDL_StopEventLoop(void)
         SDL_free(entry);
         entry = next;
     }
+    while ((cell = SDL_GetEventRingCell(SDL_EventRing.dequeue_pos)) != NULL) {
+        SDL_ReleaseEventRingCell(cell);
+    }
 
     SDL_AtomicSet(&SDL_EventQ.count, 0);
-    SDL_EventQ.max_events_seen = 0;
+    SDL_AtomicSet(&SDL_EventQ.max_events_seen, 0);
+    SDL_AtomicSet(&SDL_EventQ.out_of_order, 0);
     SDL_EventQ.head = NULL;
     SDL_EventQ.tail = NULL;
     SDL_EventQ.free = NULL;
@@ -628,12 +980,17 @@ void SDL_StopEventLoop(void)
         SDL_DestroyMutex(SDL_event_watchers_lock);
         SDL_event_watchers_lock = NULL;
     }
-    if (SDL_event_watchers) {
-        SDL_free(SDL_event_watchers);
-        SDL_event_watchers = NULL;
-        SDL_event_watchers_count = 0;
+    if (SDL_event_watchers_sync_lock) {
+        SDL_DestroyMutex(SDL_event_watchers_sync_lock);
+        SDL_event_watchers_sync_lock = NULL;
     }
-    SDL_zero(SDL_EventOK);
+    SDL_free(SDL_AtomicSetPtr((void **)&SDL_event_watchers, NULL));
+    SDL_FreeEventWatchLists(SDL_event_watchers_retired);
+    SDL_event_watchers_retired = NULL;
+
+#ifdef SDL_USE_EVENT_WAKEUP_FD
+    SDL_DestroyEventWakeup();
+#endif
 
     SDL_UnlockMutex(SDL_EventQ.lock);
 
@@ -670,6 +1027,14 @@ int SDL_StartEventLoop(void)
         }
     }
 
+    if (SDL_event_watchers_sync_lock == NULL) {
+        SDL_event_watchers_sync_lock = SDL_CreateMutex();
+        if (SDL_event_watchers_sync_lock == NULL) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+            return -1;
+        }
+    }
+
     if (SDL_event_memory_lock == NULL) {
         SDL_event_memory_lock = SDL_CreateMutex();
         if (SDL_event_memory_lock == NULL) {
@@ -687,65 +1052,141 @@ int SDL_StartEventLoop(void)
     SDL_SetEventEnabled(SDL_EVENT_DROP_TEXT, SDL_FALSE);
 #endif
 
-    SDL_EventQ.active = SDL_TRUE;
+    if (!SDL_event_watchers_dispatching) {
+        SDL_event_watchers_dispatching = SDL_CreateTLS();
+    }
+
+#ifdef SDL_USE_EVENT_WAKEUP_FD
+    SDL_CreateEventWakeup();
+#endif
+
+    if (!SDL_EventRing.initialized) {
+        int i;
+
+        for (i = 0; i < SDL_EVENT_RING_SIZE; ++i) {
+            SDL_AtomicSet(&SDL_EventRing.cells[i].sequence, i);
+        }
+        SDL_AtomicSet(&SDL_EventRing.enqueue_pos, 0);
+        SDL_EventRing.dequeue_pos = 0;
+        SDL_EventRing.initialized = SDL_TRUE;
+    }
+
+    SDL_AtomicSet(&SDL_EventQ.active, 1);
     SDL_UnlockMutex(SDL_EventQ.lock);
     return 0;
 }
 
-/* Add an event to the event queue -- called with the queue locked */
+/* Add an event to the event queue -- safe to call without the queue locked */
 static int SDL_AddEvent(SDL_Event *event)
 {
-    SDL_EventEntry *entry;
-    const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
-    int final_count;
+    const int final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
+    int max_events_seen;
 
-    if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
-        SDL_SetError("Event queue is full (%d events)", initial_count);
+    if (final_count > SDL_MAX_QUEUED_EVENTS) {
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        SDL_SetError("Event queue is full (%d events)", final_count - 1);
         return 0;
     }
 
-    if (SDL_EventQ.free == NULL) {
-        entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
-        if (entry == NULL) {
-            return 0;
-        }
-    } else {
-        entry = SDL_EventQ.free;
-        SDL_EventQ.free = entry->next;
-    }
-
     if (SDL_EventLoggingVerbosity > 0) {
         SDL_LogEvent(event);
     }
 
-    SDL_copyp(&entry->event, event);
     if (event->type == SDL_EVENT_POLL_SENTINEL) {
         SDL_AtomicAdd(&SDL_sentinel_pending, 1);
     }
 
-    if (SDL_EventQ.tail) {
-        SDL_EventQ.tail->next = entry;
-        entry->prev = SDL_EventQ.tail;
-        SDL_EventQ.tail = entry;
-        entry->next = NULL;
-    } else {
-        SDL_assert(!SDL_EventQ.head);
-        SDL_EventQ.head = entry;
-        SDL_EventQ.tail = entry;
-        entry->prev = NULL;
-        entry->next = NULL;
+    if (!SDL_PushEventRing(event)) {
+        /* The ring is full, move what's in it to the list under the lock.
+           If another producer is still filling the oldest cell, nothing can
+           move until it's done, so let go of the lock and give it a chance
+           to run instead of keeping the consumers waiting on us. */
+        for (;;) {
+            SDL_bool migrated, pushed = SDL_FALSE;
+
+            SDL_LockMutex(SDL_EventQ.lock);
+            migrated = SDL_AtomicGet(&SDL_EventQ.active) && SDL_MigrateEventRing();
+            if (migrated) {
+                pushed = SDL_PushEventRing(event);
+            }
+            SDL_UnlockMutex(SDL_EventQ.lock);
+
+            if (pushed) {
+                break;
+            } else if (!migrated) {
+                if (event->type == SDL_EVENT_POLL_SENTINEL) {
+                    SDL_AtomicAdd(&SDL_sentinel_pending, -1);
+                }
+                SDL_AtomicAdd(&SDL_EventQ.count, -1);
+                return 0;
+            }
+            SDL_Delay(0);
+        }
     }
 
-    final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
-    if (final_count > SDL_EventQ.max_events_seen) {
-        SDL_EventQ.max_events_seen = final_count;
+    max_events_seen = SDL_AtomicGet(&SDL_EventQ.max_events_seen);
+    while (final_count > max_events_seen &&
+           !SDL_AtomicCAS(&SDL_EventQ.max_events_seen, max_events_seen, final_count)) {
+        max_events_seen = SDL_AtomicGet(&SDL_EventQ.max_events_seen);
     }
 
-    ++SDL_last_event_id;
+    SDL_AtomicAdd(&SDL_last_event_id, 1);
 
     return 1;
 }
 
+void SDL_LockEventQueue(void)
+{
+    SDL_LockMutex(SDL_EventQ.lock);
+}
+
+void SDL_UnlockEventQueue(void)
+{
+    SDL_UnlockMutex(SDL_EventQ.lock);
+}
+
+/* Fold a mouse motion event into the newest queued event, if that is motion for the same window, mouse and button state */
+static SDL_bool SDL_MergeMouseMotionEvent(const SDL_Event *event)
+{
+    SDL_Event *newest = NULL;
+    SDL_bool merged = SDL_FALSE;
+
+    SDL_assert(event->type == SDL_EVENT_MOUSE_MOTION);
+
+    SDL_LockMutex(SDL_EventQ.lock);
+    {
+        if (SDL_AtomicGet(&SDL_EventQ.active)) {
+            const Uint32 enqueue_pos = (Uint32)SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+
+            if (enqueue_pos != SDL_EventRing.dequeue_pos) {
+                /* This is NULL if another producer hasn't finished that cell yet */
+                SDL_EventRingCell *cell = SDL_GetEventRingCell(enqueue_pos - 1);
+                if (cell) {
+                    newest = &cell->event;
+                }
+            } else if (SDL_EventQ.tail) {
+                newest = &SDL_EventQ.tail->event;
+            }
+        }
+
+        /* Published events are only read by consumers holding the lock, so we can update it in place */
+        if (newest && newest->type == SDL_EVENT_MOUSE_MOTION &&
+            newest->motion.windowID == event->motion.windowID &&
+            newest->motion.which == event->motion.which &&
+            newest->motion.state == event->motion.state) {
+            newest->common.timestamp = event->common.timestamp ? event->common.timestamp : SDL_GetTicksNS();
+            newest->motion.x = event->motion.x;
+            newest->motion.y = event->motion.y;
+            newest->motion.xrel += event->motion.xrel;
+            newest->motion.yrel += event->motion.yrel;
+            merged = SDL_TRUE;
+        }
+    }
+    SDL_UnlockMutex(SDL_EventQ.lock);
+
+    return merged;
+}
+
 /* Remove an event from the queue -- called with the queue locked */
 static void SDL_CutEvent(SDL_EventEntry *entry)
 {
@@ -772,13 +1213,113 @@ static void SDL_CutEvent(SDL_EventEntry *entry)
     entry->next = SDL_EventQ.free;
     SDL_EventQ.free = entry;
     SDL_assert(SDL_AtomicGet(&SDL_EventQ.count) > 0);
-    SDL_AtomicAdd(&SDL_EventQ.count, -1);
+    if (SDL_AtomicAdd(&SDL_EventQ.count, -1) == 1) {
+        SDL_AtomicSet(&SDL_EventQ.out_of_order, 0);
+    } else if (entry->prev) {
+        SDL_AtomicSet(&SDL_EventQ.out_of_order, 1);
+    }
+}
+
+/* Remove the oldest event in the ring -- called with the queue locked */
+static void SDL_CutRingEvent(SDL_EventRingCell *cell)
+{
+    if (cell->event.type == SDL_EVENT_POLL_SENTINEL) {
+        SDL_AtomicAdd(&SDL_sentinel_pending, -1);
+    }
+
+    SDL_ReleaseEventRingCell(cell);
+    SDL_assert(SDL_AtomicGet(&SDL_EventQ.count) > 0);
+    if (SDL_AtomicAdd(&SDL_EventQ.count, -1) == 1) {
+        SDL_AtomicSet(&SDL_EventQ.out_of_order, 0);
+    }
+}
+
+/* Remove events from the front of the queue, regardless of type -- called with the queue locked */
+static int SDL_TakeEvents(SDL_Event *events, int numevents, SDL_bool include_sentinel)
+{
+    int used = 0;
+
+    while (used < numevents) {
+        SDL_EventRingCell *cell;
+
+        if (SDL_EventQ.head) {
+            SDL_copyp(&events[used], &SDL_EventQ.head->event);
+            SDL_CutEvent(SDL_EventQ.head);
+        } else if ((cell = SDL_GetEventRingCell(SDL_EventRing.dequeue_pos)) != NULL) {
+            SDL_copyp(&events[used], &cell->event);
+            SDL_CutRingEvent(cell);
+        } else {
+            break;
+        }
+
+        if (events[used].type == SDL_EVENT_POLL_SENTINEL) {
+            /* Skip it if we don't want it, or if there's another one pending */
+            if (!include_sentinel || SDL_AtomicGet(&SDL_sentinel_pending) > 0) {
+                continue;
+            }
+
+            /* That's the end of this poll cycle */
+            ++used;
+            break;
+        }
+        ++used;
+    }
+    return used;
+}
+
+/* Look at events in order without removing them -- called with the queue locked */
+static int SDL_ScanEvents(SDL_Event *events, int numevents, Uint32 minType, Uint32 maxType, SDL_bool include_sentinel)
+{
+    SDL_EventEntry *entry = SDL_EventQ.head;
+    Uint32 pos = SDL_EventRing.dequeue_pos;
+    int used = 0, sentinels_expected = 0;
+
+    while (events == NULL || used < numevents) {
+        const SDL_Event *event;
+        Uint32 type;
+
+        if (entry) {
+            event = &entry->event;
+            entry = entry->next;
+        } else {
+            SDL_EventRingCell *cell = SDL_GetEventRingCell(pos);
+            if (cell == NULL) {
+                break;
+            }
+            event = &cell->event;
+            ++pos;
+        }
+
+        type = event->type;
+        if (minType <= type && type <= maxType) {
+            if (events) {
+                SDL_copyp(&events[used], event);
+            }
+            if (type == SDL_EVENT_POLL_SENTINEL) {
+                /* Special handling for the sentinel event */
+                if (!include_sentinel) {
+                    /* Skip it, we don't want to include it */
+                    continue;
+                }
+                ++sentinels_expected;
+                if (SDL_AtomicGet(&SDL_sentinel_pending) > sentinels_expected) {
+                    /* Skip it, there's another one pending */
+                    continue;
+                }
+            }
+            ++used;
+        }
+    }
+    return used;
 }
 
 static int SDL_SendWakeupEvent(void)
 {
     SDL_VideoDevice *_this = SDL_GetVideoDevice();
-    if (_this == NULL || !_this->SendWakeupEvent) {
+
+    SDL_SignalEventWakeup();
+
+    if (_this == NULL || !_this->SendWakeupEvent || SDL_VideoWaitsOnEventWakeup(_this)) {
         return 0;
     }
 
@@ -800,15 +1341,27 @@ static int SDL_SendWakeupEvent(void)
 static int SDL_PeepEventsInternal(SDL_Event *events, int numevents, SDL_eventaction action,
                                   Uint32 minType, Uint32 maxType, SDL_bool include_sentinel)
 {
-    int i, used, sentinels_expected = 0;
+    int i, used = 0;
 
-    /* Lock the event queue */
-    used = 0;
+    /* Adding events doesn't need the lock, producers go straight to the ring */
+    if (action == SDL_ADDEVENT) {
+        if (!SDL_AtomicGet(&SDL_EventQ.active)) {
+            return -1;
+        }
+        for (i = 0; i < numevents; ++i) {
+            used += SDL_AddEvent(&events[i]);
+        }
+        if (used > 0) {
+            SDL_SendWakeupEvent();
+        }
+        return used;
+    }
 
+    /* Lock the event queue */
     SDL_LockMutex(SDL_EventQ.lock);
     {
         /* Don't look after we've quit */
-        if (!SDL_EventQ.active) {
+        if (!SDL_AtomicGet(&SDL_EventQ.active)) {
             /* We get a few spurious events at shutdown, so don't warn then */
             if (action == SDL_GETEVENT) {
                 SDL_SetError("The event system has been shut down");
@@ -816,50 +1369,57 @@ static int SDL_PeepEventsInternal(SDL_Event *events, int numevents, SDL_eventact
             SDL_UnlockMutex(SDL_EventQ.lock);
             return -1;
         }
-        if (action == SDL_ADDEVENT) {
-            for (i = 0; i < numevents; ++i) {
-                used += SDL_AddEvent(&events[i]);
-            }
+        if (action != SDL_GETEVENT || events == NULL) {
+            used = SDL_ScanEvents(events, numevents, minType, maxType, include_sentinel);
+        } else if (minType <= SDL_EVENT_FIRST && maxType >= SDL_EVENT_LAST) {
+            used = SDL_TakeEvents(events, numevents, include_sentinel);
         } else {
+            /* Removing from the middle of the queue, move everything into the list first.
+               If we run out of memory doing that, the entries we cut are recycled for the
+               rest of the ring, so keep going as long as that makes progress. */
             SDL_EventEntry *entry, *next;
             Uint32 type;
+            SDL_bool migrated, removed;
 
-            for (entry = SDL_EventQ.head; entry && (events == NULL || used < numevents); entry = next) {
-                next = entry->next;
-                type = entry->event.type;
-                if (minType <= type && type <= maxType) {
-                    if (events) {
-                        SDL_copyp(&events[used], &entry->event);
+            do {
+                migrated = SDL_MigrateEventRing();
+                removed = SDL_FALSE;
 
-                        if (action == SDL_GETEVENT) {
-                            SDL_CutEvent(entry);
-                        }
-                    }
-                    if (type == SDL_EVENT_POLL_SENTINEL) {
-                        /* Special handling for the sentinel event */
-                        if (!include_sentinel) {
-                            /* Skip it, we don't want to include it */
-                            continue;
-                        }
-                        if (events == NULL || action != SDL_GETEVENT) {
-                            ++sentinels_expected;
-                        }
-                        if (SDL_AtomicGet(&SDL_sentinel_pending) > sentinels_expected) {
-                            /* Skip it, there's another one pending */
-                            continue;
+                for (entry = SDL_EventQ.head; entry && used < numevents; entry = next) {
+                    next = entry->next;
+                    type = entry->event.type;
+                    if (minType <= type && type <= maxType) {
+                        SDL_copyp(&events[used], &entry->event);
+                        SDL_CutEvent(entry);
+                        removed = SDL_TRUE;
+
+                        if (type == SDL_EVENT_POLL_SENTINEL) {
+                            /* Special handling for the sentinel event */
+                            if (!include_sentinel) {
+                                /* Skip it, we don't want to include it */
+                                continue;
+                            }
+                            if (SDL_AtomicGet(&SDL_sentinel_pending) > 0) {
+                                /* Skip it, there's another one pending */
+                                continue;
+                            }
                         }
+                        ++used;
                     }
-                    ++used;
+                }
+            } while (!migrated && removed && used < numevents);
+
+            if (!migrated && used < numevents) {
+                /* Matching events may still be waiting in the ring, don't pretend there are none */
+                SDL_OutOfMemory();
+                if (used == 0) {
+                    used = -1;
                 }
             }
         }
     }
     SDL_UnlockMutex(SDL_EventQ.lock);
 
-    if (used > 0 && action == SDL_ADDEVENT) {
-        SDL_SendWakeupEvent();
-    }
-
     return used;
 }
 int SDL_PeepEvents(SDL_Event *events, int numevents, SDL_eventaction action,
@@ -887,6 +1447,7 @@ void SDL_FlushEvents(Uint32 minType, Uint32 maxType)
 {
     SDL_EventEntry *entry, *next;
     Uint32 type;
+    SDL_bool migrated, removed;
 
     /* Make sure the events are current */
 #if 0
@@ -900,16 +1461,26 @@ void SDL_FlushEvents(Uint32 minType, Uint32 maxType)
     SDL_LockMutex(SDL_EventQ.lock);
     {
         /* Don't look after we've quit */
-        if (!SDL_EventQ.active) {
+        if (!SDL_AtomicGet(&SDL_EventQ.active)) {
             SDL_UnlockMutex(SDL_EventQ.lock);
             return;
         }
-        for (entry = SDL_EventQ.head; entry; entry = next) {
-            next = entry->next;
-            type = entry->event.type;
-            if (minType <= type && type <= maxType) {
-                SDL_CutEvent(entry);
+        do {
+            migrated = SDL_MigrateEventRing();
+            removed = SDL_FALSE;
+            for (entry = SDL_EventQ.head; entry; entry = next) {
+                next = entry->next;
+                type = entry->event.type;
+                if (minType <= type && type <= maxType) {
+                    SDL_CutEvent(entry);
+                    removed = SDL_TRUE;
+                }
             }
+            /* Entries we just cut can take whatever was left in the ring */
+        } while (!migrated && removed);
+
+        if (!migrated) {
+            SDL_OutOfMemory();
         }
     }
     SDL_UnlockMutex(SDL_EventQ.lock);
@@ -920,10 +1491,20 @@ static void SDL_PumpEventsInternal(SDL_bool push_sentinel)
 {
     SDL_VideoDevice *_this = SDL_GetVideoDevice();
 
-    /* Free old event memory */
-    /*SDL_FlushEventMemory(SDL_last_event_id - SDL_MAX_QUEUED_EVENTS);*/
-    if (SDL_AtomicGet(&SDL_EventQ.count) == 0) {
-        SDL_FlushEventMemory(SDL_last_event_id);
+    /* Free event memory for generations the queue has moved past.
+       Events leave the queue in order unless they were picked out of the
+       middle, so everything older than the queued events can be released.
+       The oldest queued event has ID last_event_id - count + 1, and its
+       memory was stamped with the ID before that, so keep that block too. */
+    {
+        const Uint32 last_event_id = (Uint32)SDL_AtomicGet(&SDL_last_event_id);
+        const int count = SDL_AtomicGet(&SDL_EventQ.count);
+
+        if (count == 0) {
+            SDL_FlushEventMemory(last_event_id);
+        } else if (!SDL_AtomicGet(&SDL_EventQ.out_of_order) && (last_event_id - (Uint32)count) > 1) {
+            SDL_FlushEventMemory(last_event_id - count - 1);
+        }
     }
 
     /* Release any keys held down from last frame */
@@ -980,6 +1561,30 @@ SDL_bool SDL_PollEvent(SDL_Event *event)
     return SDL_WaitEventTimeoutNS(event, 0);
 }
 
+int SDL_PollEvents(SDL_Event *events, int numevents)
+{
+    int result;
+
+    if (events == NULL) {
+        return SDL_InvalidParamError("events");
+    }
+    if (numevents <= 0) {
+        return 0;
+    }
+
+    /* If there isn't a poll sentinel event pending, pump events and add one */
+    if (SDL_AtomicGet(&SDL_sentinel_pending) == 0) {
+        SDL_PumpEventsInternal(SDL_TRUE);
+    }
+
+    result = SDL_PeepEventsInternal(events, numevents, SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST, SDL_TRUE);
+    if (result > 0 && events[result - 1].type == SDL_EVENT_POLL_SENTINEL) {
+        /* Reached the end of a poll cycle */
+        --result;
+    }
+    return result;
+}
+
 static SDL_bool SDL_events_need_periodic_poll(void)
 {
     SDL_bool need_periodic_poll = SDL_FALSE;
@@ -1006,6 +1611,7 @@ static int SDL_WaitEventTimeout_Device(SDL_VideoDevice *_this, SDL_Window *wakeu
         */
         SDL_PumpEventsInternal(SDL_TRUE);
 
+        SDL_BeginEventWakeupWait();
         SDL_LockMutex(_this->wakeup_lock);
         {
             status = SDL_PeepEvents(event, 1, SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST);
@@ -1020,10 +1626,12 @@ static int SDL_WaitEventTimeout_Device(SDL_VideoDevice *_this, SDL_Window *wakeu
 
         if (status < 0) {
             /* Got an error: return */
+            SDL_EndEventWakeupWait();
             break;
         }
         if (status > 0) {
             /* There is an event, we can return. */
+            SDL_EndEventWakeupWait();
             return 1;
         }
         /* No events found in the queue, call WaitEventTimeout to wait for an event. */
@@ -1032,6 +1640,7 @@ static int SDL_WaitEventTimeout_Device(SDL_VideoDevice *_this, SDL_Window *wakeu
             if (elapsed >= timeoutNS) {
                 /* Set wakeup_window to NULL without holding the lock. */
                 _this->wakeup_window = NULL;
+                SDL_EndEventWakeupWait();
                 return 0;
             }
             loop_timeoutNS = (timeoutNS - elapsed);
@@ -1046,6 +1655,7 @@ static int SDL_WaitEventTimeout_Device(SDL_VideoDevice *_this, SDL_Window *wakeu
         status = _this->WaitEventTimeout(_this, loop_timeoutNS);
         /* Set wakeup_window to NULL without holding the lock. */
         _this->wakeup_window = NULL;
+        SDL_EndEventWakeupWait();
         if (status == 0 && need_periodic_poll && loop_timeoutNS == PERIODIC_POLL_INTERVAL_NS) {
             /* We may have woken up to poll. Try again */
             continue;
@@ -1160,9 +1770,14 @@ SDL_bool SDL_WaitEventTimeoutNS(SDL_Event *event, Sint64 timeoutNS)
     SDL_assert(timeoutNS != 0);
 
     if (_this && _this->WaitEventTimeout && _this->SendWakeupEvent && !SDL_events_need_polling()) {
-        /* Look if a shown window is available to send the wakeup event. */
-        wakeup_window = SDL_find_active_window(_this);
-        if (wakeup_window) {
+        /* Look if a shown window is available to send the wakeup event.
+           If the driver waits on the shared wakeup handle, we don't need one. */
+        if (SDL_VideoWaitsOnEventWakeup(_this)) {
+            wakeup_window = NULL;
+        } else {
+            wakeup_window = SDL_find_active_window(_this);
+        }
+        if (wakeup_window || SDL_VideoWaitsOnEventWakeup(_this)) {
             result = SDL_WaitEventTimeout_Device(_this, wakeup_window, event, start, timeoutNS);
             if (result > 0) {
                 return SDL_TRUE;
@@ -1176,6 +1791,45 @@ SDL_bool SDL_WaitEventTimeoutNS(SDL_Event *event, Sint64 timeoutNS)
         }
     }
 
+#ifdef SDL_USE_EVENT_WAKEUP_FD
+    if (!_this && SDL_GetEventWakeupFD() >= 0 && !SDL_events_need_polling()) {
+        /* Without a video driver, everything else arrives through SDL_PushEvent(),
+           so we can sleep until we're woken up or the deadline passes. */
+        const SDL_bool need_periodic_poll = SDL_events_need_periodic_poll();
+
+        for (;;) {
+            Sint64 loop_timeoutNS = -1;
+
+            SDL_PumpEventsInternal(SDL_TRUE);
+
+            SDL_BeginEventWakeupWait();
+            if (SDL_PeepEvents(event, 1, SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST) > 0) {
+                SDL_EndEventWakeupWait();
+                return SDL_TRUE;
+            }
+            if (timeoutNS > 0) {
+                Uint64 now = SDL_GetTicksNS();
+                if (now >= expiration) {
+                    /* Timeout expired and no events */
+                    SDL_EndEventWakeupWait();
+                    return SDL_FALSE;
+                }
+                loop_timeoutNS = (Sint64)(expiration - now);
+            }
+            if (need_periodic_poll) {
+                if (loop_timeoutNS >= 0) {
+                    loop_timeoutNS = SDL_min(loop_timeoutNS, PERIODIC_POLL_INTERVAL_NS);
+                } else {
+                    loop_timeoutNS = PERIODIC_POLL_INTERVAL_NS;
+                }
+            }
+            /* Use SDL_IOR_NO_RETRY so signals are turned into events by the next pump */
+            SDL_IOReadyOrWakeup(-1, SDL_IOR_NO_RETRY, SDL_GetEventWakeupFD(), loop_timeoutNS);
+            SDL_EndEventWakeupWait();
+        }
+    }
+#endif /* SDL_USE_EVENT_WAKEUP_FD */
+
     for (;;) {
         SDL_PumpEventsInternal(SDL_TRUE);
 
@@ -1196,46 +1850,78 @@ SDL_bool SDL_WaitEventTimeoutNS(SDL_Event *event, Sint64 timeoutNS)
     }
 }
 
-int SDL_PushEvent(SDL_Event *event)
+static SDL_bool SDL_DispatchEventWatchers(SDL_Event *event)
 {
-    if (!event->common.timestamp) {
-        event->common.timestamp = SDL_GetTicksNS();
+    const int epoch = SDL_AtomicGet(&SDL_event_watchers_epoch) & 1;
+    const SDL_bool nested = (SDL_GetTLS(SDL_event_watchers_dispatching) != NULL);
+    SDL_EventWatchList *list;
+    SDL_bool result = SDL_TRUE;
+
+    /* Let writers know we might be using the current snapshot */
+    SDL_AtomicIncRef(&SDL_event_watchers_readers[epoch]);
+    if (!nested) {
+        SDL_SetTLS(SDL_event_watchers_dispatching, (void *)1, NULL);
     }
 
-    if (SDL_EventOK.callback || SDL_event_watchers_count > 0) {
-        SDL_LockMutex(SDL_event_watchers_lock);
-        {
-            if (SDL_EventOK.callback && !SDL_EventOK.callback(SDL_EventOK.userdata, event)) {
-                SDL_UnlockMutex(SDL_event_watchers_lock);
-                return 0;
-            }
+    list = (SDL_EventWatchList *)SDL_AtomicGetPtr((void **)&SDL_event_watchers);
+    if (list) {
+        if (list->filter.callback && !SDL_AtomicGet(&list->filter.removed) && !list->filter.callback(list->filter.userdata, event)) {
+            result = SDL_FALSE;
+        } else {
+            int i;
 
-            if (SDL_event_watchers_count > 0) {
-                /* Make sure we only dispatch the current watcher list */
-                int i, event_watchers_count = SDL_event_watchers_count;
+            for (i = 0; i < list->count; ++i) {
+                SDL_EventWatcher *watcher = &list->watchers[i];
 
-                SDL_event_watchers_dispatching = SDL_TRUE;
-                for (i = 0; i < event_watchers_count; ++i) {
-                    if (!SDL_event_watchers[i].removed) {
-                        SDL_event_watchers[i].callback(SDL_event_watchers[i].userdata, event);
-                    }
-                }
-                SDL_event_watchers_dispatching = SDL_FALSE;
-
-                if (SDL_event_watchers_removed) {
-                    for (i = SDL_event_watchers_count; i--;) {
-                        if (SDL_event_watchers[i].removed) {
-                            --SDL_event_watchers_count;
-                            if (i < SDL_event_watchers_count) {
-                                SDL_memmove(&SDL_event_watchers[i], &SDL_event_watchers[i + 1], (SDL_event_watchers_count - i) * sizeof(SDL_event_watchers[i]));
-                            }
-                        }
-                    }
-                    SDL_event_watchers_removed = SDL_FALSE;
+                /* Don't call watchers that were removed while we were dispatching */
+                if (SDL_AtomicGet(&watcher->removed)) {
+                    continue;
                 }
+                watcher->callback(watcher->userdata, event);
             }
         }
-        SDL_UnlockMutex(SDL_event_watchers_lock);
+    }
+
+    if (!nested) {
+        SDL_SetTLS(SDL_event_watchers_dispatching, NULL, NULL);
+    }
+    SDL_AtomicDecRef(&SDL_event_watchers_readers[epoch]);
+
+    return result;
+}
+
+int SDL_PushEvent(SDL_Event *event)
+{
+    if (!event->common.timestamp) {
+        event->common.timestamp = SDL_GetTicksNS();
+    }
+
+    if (SDL_AtomicGetPtr((void **)&SDL_event_watchers) && !SDL_DispatchEventWatchers(event)) {
+        return 0;
+    }
+
+    if (SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0, 0) <= 0) {
+        return -1;
+    }
+
+    return 1;
+}
+
+int SDL_PushMouseMotionEvent(SDL_Event *event)
+{
+    if (!event->common.timestamp) {
+        event->common.timestamp = SDL_GetTicksNS();
+    }
+
+    /* The filter and watchers see every motion, and may rewrite it (e.g. into
+       render coordinates), so only merge once they're done with it. The
+       queued event went through them too, so both are in the same space. */
+    if (SDL_AtomicGetPtr((void **)&SDL_event_watchers) && !SDL_DispatchEventWatchers(event)) {
+        return 0;
+    }
+
+    if (SDL_MergeMouseMotionEvent(event)) {
+        return 1;
     }
 
     if (SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0, 0) <= 0) {
@@ -1245,16 +1931,143 @@ int SDL_PushEvent(SDL_Event *event)
     return 1;
 }
 
+static void SDL_FreeEventWatchLists(SDL_EventWatchList *list)
+{
+    while (list) {
+        SDL_EventWatchList *next = list->next_retired;
+        SDL_free(list);
+        list = next;
+    }
+}
+
+/* Make a copy of the current watcher list with room for extra watchers -- called with SDL_event_watchers_lock held */
+static SDL_EventWatchList *SDL_CopyEventWatchList(int extra)
+{
+    const SDL_EventWatchList *current = SDL_event_watchers;
+    const int count = current ? current->count : 0;
+    SDL_EventWatchList *list;
+
+    list = (SDL_EventWatchList *)SDL_malloc(sizeof(*list) + SDL_max(count + extra - 1, 0) * sizeof(list->watchers[0]));
+    if (!list) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    if (current) {
+        list->filter = current->filter;
+        SDL_memcpy(list->watchers, current->watchers, count * sizeof(list->watchers[0]));
+    } else {
+        SDL_zero(list->filter);
+    }
+    list->count = count;
+    list->next_retired = NULL;
+    return list;
+}
+
+/* Swap in a new watcher list, keeping the old one until dispatches finish -- called with SDL_event_watchers_lock held */
+static void SDL_PublishEventWatchList(SDL_EventWatchList *list)
+{
+    SDL_EventWatchList *old;
+
+    if (list && !list->filter.callback && list->count == 0) {
+        /* Nothing to dispatch, so SDL_PushEvent() can skip it entirely */
+        SDL_free(list);
+        list = NULL;
+    }
+
+    old = (SDL_EventWatchList *)SDL_AtomicSetPtr((void **)&SDL_event_watchers, list);
+    if (old) {
+        old->next_retired = SDL_event_watchers_retired;
+        SDL_event_watchers_retired = old;
+    }
+}
+
+static void SDL_MarkEventWatcherRemovedInList(SDL_EventWatchList *list, int id)
+{
+    int i;
+
+    if (list->filter.id == id) {
+        SDL_AtomicSet(&list->filter.removed, 1);
+    }
+    for (i = 0; i < list->count; ++i) {
+        if (list->watchers[i].id == id) {
+            SDL_AtomicSet(&list->watchers[i].removed, 1);
+        }
+    }
+}
+
+/* Flag a watcher as removed in the current list and every replaced one that might still be dispatched from,
+   so no thread starts calling it again -- called with SDL_event_watchers_lock held */
+static void SDL_MarkEventWatcherRemoved(int id)
+{
+    SDL_EventWatchList *list;
+
+    if (SDL_event_watchers) {
+        SDL_MarkEventWatcherRemovedInList(SDL_event_watchers, id);
+    }
+    for (list = SDL_event_watchers_retired; list; list = list->next_retired) {
+        SDL_MarkEventWatcherRemovedInList(list, id);
+    }
+}
+
+/* Wait until no thread is dispatching from a replaced watcher list, then free them.
+   After this returns, removed watchers and filters will not be called again, unless
+   we're inside a callback ourselves: then calls already in progress on other threads
+   may still be running, but no new ones will start. */
+static void SDL_WaitForEventWatchers(void)
+{
+    SDL_EventWatchList *retired;
+    int i;
+
+    if (SDL_GetTLS(SDL_event_watchers_dispatching)) {
+        /* We're inside a watcher callback and would wait on ourselves, or on another
+           thread that is waiting on us. The removed watcher is already flagged, and
+           the replaced lists will be freed by a later change or at shutdown. */
+        return;
+    }
+
+    SDL_LockMutex(SDL_event_watchers_sync_lock);
+    {
+        SDL_LockMutex(SDL_event_watchers_lock);
+        retired = SDL_event_watchers_retired;
+        SDL_event_watchers_retired = NULL;
+        SDL_UnlockMutex(SDL_event_watchers_lock);
+
+        /* Flip the epoch twice, waiting for the readers of the previous one each time.
+           The second flip covers readers that sampled the epoch just before the first. */
+        for (i = 0; i < 2; ++i) {
+            const int epoch = SDL_AtomicAdd(&SDL_event_watchers_epoch, 1) & 1;
+            while (SDL_AtomicGet(&SDL_event_watchers_readers[epoch]) > 0) {
+                SDL_Delay(0);
+            }
+        }
+
+        SDL_FreeEventWatchLists(retired);
+    }
+    SDL_UnlockMutex(SDL_event_watchers_sync_lock);
+}
+
 void SDL_SetEventFilter(SDL_EventFilter filter, void *userdata)
 {
     SDL_LockMutex(SDL_event_watchers_lock);
     {
         /* Set filter and discard pending events */
-        SDL_EventOK.callback = filter;
-        SDL_EventOK.userdata = userdata;
+        SDL_EventWatchList *list = SDL_CopyEventWatchList(0);
+        if (list) {
+            if (list->filter.callback) {
+                SDL_MarkEventWatcherRemoved(list->filter.id);
+            }
+            list->filter.callback = filter;
+            list->filter.userdata = userdata;
+            list->filter.id = ++SDL_event_watchers_next_id;
+            SDL_AtomicSet(&list->filter.removed, 0);
+            SDL_PublishEventWatchList(list);
+        }
         SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
     }
     SDL_UnlockMutex(SDL_event_watchers_lock);
+
+    SDL_WaitForEventWatchers();
 }
 
 SDL_bool SDL_GetEventFilter(SDL_EventFilter *filter, void **userdata)
@@ -1263,7 +2076,11 @@ SDL_bool SDL_GetEventFilter(SDL_EventFilter *filter, void **userdata)
 
     SDL_LockMutex(SDL_event_watchers_lock);
     {
-        event_ok = SDL_EventOK;
+        if (SDL_event_watchers) {
+            event_ok = SDL_event_watchers->filter;
+        } else {
+            SDL_zero(event_ok);
+        }
     }
     SDL_UnlockMutex(SDL_event_watchers_lock);
 
@@ -1282,62 +2099,87 @@ int SDL_AddEventWatch(SDL_EventFilter filter, void *userdata)
 
     SDL_LockMutex(SDL_event_watchers_lock);
     {
-        SDL_EventWatcher *event_watchers;
-
-        event_watchers = SDL_realloc(SDL_event_watchers, (SDL_event_watchers_count + 1) * sizeof(*event_watchers));
-        if (event_watchers) {
-            SDL_EventWatcher *watcher;
-
-            SDL_event_watchers = event_watchers;
-            watcher = &SDL_event_watchers[SDL_event_watchers_count];
+        SDL_EventWatchList *list = SDL_CopyEventWatchList(1);
+        if (list) {
+            SDL_EventWatcher *watcher = &list->watchers[list->count++];
             watcher->callback = filter;
             watcher->userdata = userdata;
-            watcher->removed = SDL_FALSE;
-            ++SDL_event_watchers_count;
+            watcher->id = ++SDL_event_watchers_next_id;
+            SDL_AtomicSet(&watcher->removed, 0);
+            SDL_PublishEventWatchList(list);
         } else {
-            SDL_OutOfMemory();
             result = -1;
         }
     }
     SDL_UnlockMutex(SDL_event_watchers_lock);
 
+    /* Nothing was removed, so there's no need to wait for dispatches here */
     return result;
 }
 
 void SDL_DelEventWatch(SDL_EventFilter filter, void *userdata)
 {
+    SDL_bool removed = SDL_FALSE;
+
     SDL_LockMutex(SDL_event_watchers_lock);
     {
+        const SDL_EventWatchList *current = SDL_event_watchers;
         int i;
 
-        for (i = 0; i < SDL_event_watchers_count; ++i) {
-            if (SDL_event_watchers[i].callback == filter && SDL_event_watchers[i].userdata == userdata) {
-                if (SDL_event_watchers_dispatching) {
-                    SDL_event_watchers[i].removed = SDL_TRUE;
-                    SDL_event_watchers_removed = SDL_TRUE;
-                } else {
-                    --SDL_event_watchers_count;
-                    if (i < SDL_event_watchers_count) {
-                        SDL_memmove(&SDL_event_watchers[i], &SDL_event_watchers[i + 1], (SDL_event_watchers_count - i) * sizeof(SDL_event_watchers[i]));
+        for (i = 0; current && i < current->count; ++i) {
+            if (current->watchers[i].callback == filter && current->watchers[i].userdata == userdata) {
+                SDL_EventWatchList *list = SDL_CopyEventWatchList(0);
+                if (list) {
+                    SDL_MarkEventWatcherRemoved(current->watchers[i].id);
+                    --list->count;
+                    if (i < list->count) {
+                        SDL_memmove(&list->watchers[i], &list->watchers[i + 1], (list->count - i) * sizeof(list->watchers[i]));
                     }
+                    SDL_PublishEventWatchList(list);
+                    removed = SDL_TRUE;
                 }
                 break;
             }
         }
     }
     SDL_UnlockMutex(SDL_event_watchers_lock);
+
+    if (removed) {
+        SDL_WaitForEventWatchers();
+    }
 }
 
 void SDL_FilterEvents(SDL_EventFilter filter, void *userdata)
 {
     SDL_LockMutex(SDL_EventQ.lock);
     {
-        SDL_EventEntry *entry, *next;
-        for (entry = SDL_EventQ.head; entry; entry = next) {
-            next = entry->next;
-            if (!filter(userdata, &entry->event)) {
-                SDL_CutEvent(entry);
+        SDL_EventEntry *entry, *next, *last = NULL;
+        SDL_bool migrated, removed;
+
+        /* Don't look after we've quit */
+        if (!SDL_AtomicGet(&SDL_EventQ.active)) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+            return;
+        }
+
+        /* If the ring can't be migrated in one go, filter what made it into
+           the list and use the entries that frees up for the rest. Each event
+           is only passed to the filter once. */
+        do {
+            migrated = SDL_MigrateEventRing();
+            removed = SDL_FALSE;
+            for (entry = last ? last->next : SDL_EventQ.head; entry; entry = next) {
+                next = entry->next;
+                if (!filter(userdata, &entry->event)) {
+                    SDL_CutEvent(entry);
+                    removed = SDL_TRUE;
+                }
             }
+            last = SDL_EventQ.tail;
+        } while (!migrated && removed);
+
+        if (!migrated) {
+            SDL_OutOfMemory();
         }
     }
     SDL_UnlockMutex(SDL_EventQ.lock);
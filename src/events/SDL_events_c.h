@@ -40,6 +40,16 @@ extern int SDL_StartEventLoop(void);
 extern void SDL_StopEventLoop(void);
 extern void SDL_QuitInterrupt(void);
 
+/* Like SDL_PushEvent(), but folds mouse motion into the newest queued event when it can */
+extern int SDL_PushMouseMotionEvent(SDL_Event *event);
+
+/* Lock the event queue, to guard state that is updated while events are sent */
+extern void SDL_LockEventQueue(void);
+extern void SDL_UnlockEventQueue(void);
+
+/* A readable fd that is signaled when events are pushed while a thread is waiting, or -1 if not supported */
+extern int SDL_GetEventWakeupFD(void);
+
 extern int SDL_SendAppEvent(SDL_EventType eventType);
 extern int SDL_SendKeymapChangedEvent(void);
 extern int SDL_SendLocaleChangedEvent(void);
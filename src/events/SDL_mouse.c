@@ -33,6 +33,9 @@
 
 /* #define DEBUG_MOUSE */
 
+/* The number of raw samples kept for SDL_GetMouseMotionSamples() */
+#define SDL_MAX_MOTION_SAMPLES 1024
+
 /* The mouse state */
 static SDL_Mouse SDL_mouse;
 
@@ -163,6 +166,46 @@ static void SDLCALL SDL_MouseRelativeWarpMotionChanged(void *userdata, const cha
     mouse->relative_mode_warp_motion = SDL_GetStringBoolean(hint, SDL_FALSE);
 }
 
+static void SDLCALL SDL_MouseCoalesceMotionChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_Mouse *mouse = (SDL_Mouse *)userdata;
+
+    mouse->coalesce_motion = (hint && *hint) ? SDL_clamp(SDL_atoi(hint), 0, 2) : 0;
+
+    SDL_LockEventQueue();
+    if (mouse->coalesce_motion < 2 && mouse->motion_samples) {
+        SDL_free(mouse->motion_samples);
+        mouse->motion_samples = NULL;
+        mouse->motion_sample_head = 0;
+        mouse->num_motion_samples = 0;
+    }
+    SDL_UnlockEventQueue();
+}
+
+/* Add a raw motion sample to the history -- called with the event queue locked */
+static void SDL_RecordMouseMotionSample(SDL_Mouse *mouse, const SDL_MouseMotionEvent *motion)
+{
+    int index;
+
+    if (!mouse->motion_samples) {
+        mouse->motion_samples = (SDL_MouseMotionEvent *)SDL_malloc(SDL_MAX_MOTION_SAMPLES * sizeof(*mouse->motion_samples));
+        if (!mouse->motion_samples) {
+            return;
+        }
+        mouse->motion_sample_head = 0;
+        mouse->num_motion_samples = 0;
+    }
+
+    if (mouse->num_motion_samples == SDL_MAX_MOTION_SAMPLES) {
+        /* Drop the oldest sample */
+        mouse->motion_sample_head = (mouse->motion_sample_head + 1) % SDL_MAX_MOTION_SAMPLES;
+        --mouse->num_motion_samples;
+    }
+    index = (mouse->motion_sample_head + mouse->num_motion_samples) % SDL_MAX_MOTION_SAMPLES;
+    SDL_copyp(&mouse->motion_samples[index], motion);
+    ++mouse->num_motion_samples;
+}
+
 /* Public functions */
 int SDL_PreInitMouse(void)
 {
@@ -202,6 +245,9 @@ int SDL_PreInitMouse(void)
     SDL_AddHintCallback(SDL_HINT_MOUSE_RELATIVE_WARP_MOTION,
                         SDL_MouseRelativeWarpMotionChanged, mouse);
 
+    SDL_AddHintCallback(SDL_HINT_MOUSE_COALESCE_MOTION,
+                        SDL_MouseCoalesceMotionChanged, mouse);
+
     mouse->was_touch_mouse_events = SDL_FALSE; /* no touch to mouse movement event pending */
 
     mouse->cursor_shown = SDL_TRUE;
@@ -674,7 +720,19 @@ static int SDL_PrivateSendMouseMotion(Uint64 timestamp, SDL_Window *window, SDL_
         event.motion.y = mouse->y;
         event.motion.xrel = xrel;
         event.motion.yrel = yrel;
-        posted = (SDL_PushEvent(&event) > 0);
+        if (mouse->coalesce_motion) {
+            if (!event.common.timestamp) {
+                event.common.timestamp = SDL_GetTicksNS();
+            }
+            if (mouse->coalesce_motion > 1) {
+                SDL_LockEventQueue();
+                SDL_RecordMouseMotionSample(mouse, &event.motion);
+                SDL_UnlockEventQueue();
+            }
+            posted = (SDL_PushMouseMotionEvent(&event) > 0);
+        } else {
+            posted = (SDL_PushEvent(&event) > 0);
+        }
     }
     if (relative) {
         mouse->last_x = mouse->x;
@@ -956,6 +1014,43 @@ void SDL_QuitMouse(void)
 
     SDL_DelHintCallback(SDL_HINT_MOUSE_RELATIVE_WARP_MOTION,
                         SDL_MouseRelativeWarpMotionChanged, mouse);
+
+    SDL_DelHintCallback(SDL_HINT_MOUSE_COALESCE_MOTION,
+                        SDL_MouseCoalesceMotionChanged, mouse);
+
+    SDL_LockEventQueue();
+    if (mouse->motion_samples) {
+        SDL_free(mouse->motion_samples);
+        mouse->motion_samples = NULL;
+    }
+    mouse->motion_sample_head = 0;
+    mouse->num_motion_samples = 0;
+    SDL_UnlockEventQueue();
+}
+
+int SDL_GetMouseMotionSamples(SDL_MouseMotionEvent *samples, int numsamples)
+{
+    SDL_Mouse *mouse = SDL_GetMouse();
+    int i, count;
+
+    if (!samples) {
+        return SDL_InvalidParamError("samples");
+    }
+    if (numsamples <= 0) {
+        return 0;
+    }
+
+    SDL_LockEventQueue();
+    {
+        count = SDL_min(numsamples, mouse->num_motion_samples);
+        for (i = 0; i < count; ++i) {
+            SDL_copyp(&samples[i], &mouse->motion_samples[mouse->motion_sample_head]);
+            mouse->motion_sample_head = (mouse->motion_sample_head + 1) % SDL_MAX_MOTION_SAMPLES;
+        }
+        mouse->num_motion_samples -= count;
+    }
+    SDL_UnlockEventQueue();
+    return count;
 }
 
 Uint32 SDL_GetMouseState(float *x, float *y)
@@ -105,6 +105,12 @@ typedef struct
     SDL_bool capture_desired;
     SDL_Window *capture_window;
 
+    /* Data for motion coalescing (SDL_HINT_MOUSE_COALESCE_MOTION) */
+    int coalesce_motion;
+    SDL_MouseMotionEvent *motion_samples;
+    int motion_sample_head;
+    int num_motion_samples;
+
     /* Data for input source state */
     int num_sources;
     SDL_MouseInputSource *sources;
@@ -0,0 +1,413 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2023 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/*
+
+ Event recording and replay for reproducible input benchmarks.
+
+ File format (little endian):
+   header: "SDLEVREC", Uint32 version, Uint32 sizeof(SDL_Event)
+   record: Uint64 time since recording started in ns,
+           Uint16 size, followed by the raw SDL_Event with pointers cleared
+                  and trailing zero bytes trimmed,
+           Uint8 string count, followed by that many (Uint8 field, Uint32 length, bytes)
+
+*/
+
+#include <SDL3/SDL_test.h>
+
+#define EVENTRECORD_MAGIC       "SDLEVREC"
+#define EVENTRECORD_VERSION     1
+#define EVENTRECORD_BUFFER_SIZE (64 * 1024)
+#define EVENTRECORD_MAX_STRINGS 2
+
+struct SDLTest_EventRecorder
+{
+    SDL_RWops *rw;
+    SDL_Mutex *lock;
+    Uint64 start;
+    Uint8 *buffer;
+    size_t used;
+    int count;
+    SDL_bool failed;
+};
+
+struct SDLTest_EventReplay
+{
+    SDL_RWops *rw;
+    float speed;
+    Uint64 start;
+    SDL_bool have_next;
+    Uint64 next_time;
+    SDL_Event next;
+    char *next_strings[EVENTRECORD_MAX_STRINGS];
+};
+
+/* Returns the string fields of an event, in a fixed order */
+static int GetEventStrings(SDL_Event *event, char ***strings)
+{
+    switch (event->type) {
+    case SDL_EVENT_TEXT_EDITING:
+        strings[0] = &event->edit.text;
+        return 1;
+    case SDL_EVENT_TEXT_INPUT:
+        strings[0] = &event->text.text;
+        return 1;
+    case SDL_EVENT_DROP_BEGIN:
+    case SDL_EVENT_DROP_FILE:
+    case SDL_EVENT_DROP_TEXT:
+    case SDL_EVENT_DROP_COMPLETE:
+    case SDL_EVENT_DROP_POSITION:
+        strings[0] = &event->drop.source;
+        strings[1] = &event->drop.data;
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+static SDL_bool FlushRecording(SDLTest_EventRecorder *recorder)
+{
+    if (recorder->used > 0) {
+        if (SDL_RWwrite(recorder->rw, recorder->buffer, recorder->used) != recorder->used) {
+            recorder->failed = SDL_TRUE;
+        }
+        recorder->used = 0;
+    }
+    return !recorder->failed;
+}
+
+static void AppendRecording(SDLTest_EventRecorder *recorder, const void *data, size_t size)
+{
+    if (recorder->used + size > EVENTRECORD_BUFFER_SIZE) {
+        FlushRecording(recorder);
+    }
+    if (size > EVENTRECORD_BUFFER_SIZE) {
+        if (SDL_RWwrite(recorder->rw, data, size) != size) {
+            recorder->failed = SDL_TRUE;
+        }
+        return;
+    }
+    SDL_memcpy(recorder->buffer + recorder->used, data, size);
+    recorder->used += size;
+}
+
+static void AppendRecordingU8(SDLTest_EventRecorder *recorder, Uint8 value)
+{
+    AppendRecording(recorder, &value, sizeof(value));
+}
+
+static void AppendRecordingU16(SDLTest_EventRecorder *recorder, Uint16 value)
+{
+    value = SDL_SwapLE16(value);
+    AppendRecording(recorder, &value, sizeof(value));
+}
+
+static void AppendRecordingU32(SDLTest_EventRecorder *recorder, Uint32 value)
+{
+    value = SDL_SwapLE32(value);
+    AppendRecording(recorder, &value, sizeof(value));
+}
+
+static void AppendRecordingU64(SDLTest_EventRecorder *recorder, Uint64 value)
+{
+    value = SDL_SwapLE64(value);
+    AppendRecording(recorder, &value, sizeof(value));
+}
+
+static int SDLCALL RecordEvent(void *userdata, SDL_Event *event)
+{
+    SDLTest_EventRecorder *recorder = (SDLTest_EventRecorder *)userdata;
+    SDL_Event copy;
+    char **fields[EVENTRECORD_MAX_STRINGS];
+    int num_strings, i;
+    Uint16 size;
+
+    SDL_copyp(&copy, event);
+    num_strings = GetEventStrings(&copy, fields);
+    for (i = 0; i < num_strings; ++i) {
+        *fields[i] = NULL;
+    }
+    if (copy.type >= SDL_EVENT_USER) {
+        copy.user.data1 = NULL;
+        copy.user.data2 = NULL;
+    }
+
+    /* Trim trailing padding and unused union space */
+    size = (Uint16)sizeof(copy);
+    while (size > 0 && ((const Uint8 *)&copy)[size - 1] == 0) {
+        --size;
+    }
+
+    SDL_LockMutex(recorder->lock);
+    {
+        AppendRecordingU64(recorder, event->common.timestamp > recorder->start ? (event->common.timestamp - recorder->start) : 0);
+        AppendRecordingU16(recorder, size);
+        AppendRecording(recorder, &copy, size);
+
+        num_strings = GetEventStrings(event, fields);
+        AppendRecordingU8(recorder, (Uint8)num_strings);
+        for (i = 0; i < num_strings; ++i) {
+            const char *string = *fields[i];
+            const Uint32 length = string ? (Uint32)SDL_strlen(string) : 0xFFFFFFFF;
+
+            AppendRecordingU8(recorder, (Uint8)i);
+            AppendRecordingU32(recorder, length);
+            if (string) {
+                AppendRecording(recorder, string, length);
+            }
+        }
+        ++recorder->count;
+    }
+    SDL_UnlockMutex(recorder->lock);
+
+    return 1;
+}
+
+SDLTest_EventRecorder *SDLTest_StartEventRecording(const char *file)
+{
+    SDLTest_EventRecorder *recorder;
+
+    recorder = (SDLTest_EventRecorder *)SDL_calloc(1, sizeof(*recorder));
+    if (!recorder) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    recorder->buffer = (Uint8 *)SDL_malloc(EVENTRECORD_BUFFER_SIZE);
+    if (!recorder->buffer) {
+        SDL_OutOfMemory();
+        SDL_free(recorder);
+        return NULL;
+    }
+    recorder->lock = SDL_CreateMutex();
+    recorder->rw = SDL_RWFromFile(file, "wb");
+    if (!recorder->lock || !recorder->rw) {
+        if (recorder->rw) {
+            SDL_RWclose(recorder->rw);
+        }
+        SDL_DestroyMutex(recorder->lock);
+        SDL_free(recorder->buffer);
+        SDL_free(recorder);
+        return NULL;
+    }
+
+    AppendRecording(recorder, EVENTRECORD_MAGIC, 8);
+    AppendRecordingU32(recorder, EVENTRECORD_VERSION);
+    AppendRecordingU32(recorder, (Uint32)sizeof(SDL_Event));
+
+    recorder->start = SDL_GetTicksNS();
+    if (SDL_AddEventWatch(RecordEvent, recorder) < 0) {
+        SDL_RWclose(recorder->rw);
+        SDL_DestroyMutex(recorder->lock);
+        SDL_free(recorder->buffer);
+        SDL_free(recorder);
+        return NULL;
+    }
+    return recorder;
+}
+
+int SDLTest_StopEventRecording(SDLTest_EventRecorder *recorder)
+{
+    int result;
+
+    if (!recorder) {
+        return SDL_InvalidParamError("recorder");
+    }
+
+    /* After this returns, the watcher is no longer running on any thread */
+    SDL_DelEventWatch(RecordEvent, recorder);
+
+    FlushRecording(recorder);
+    if (SDL_RWclose(recorder->rw) < 0) {
+        recorder->failed = SDL_TRUE;
+    }
+    if (recorder->failed) {
+        result = SDL_SetError("Couldn't write event recording");
+    } else {
+        result = recorder->count;
+    }
+
+    SDL_DestroyMutex(recorder->lock);
+    SDL_free(recorder->buffer);
+    SDL_free(recorder);
+    return result;
+}
+
+static void ClearReplayStrings(SDLTest_EventReplay *replay)
+{
+    int i;
+
+    for (i = 0; i < EVENTRECORD_MAX_STRINGS; ++i) {
+        SDL_free(replay->next_strings[i]);
+        replay->next_strings[i] = NULL;
+    }
+}
+
+/* Read the next event from the recording, returns -1 on error */
+static int ReadNextReplayEvent(SDLTest_EventReplay *replay)
+{
+    Uint16 size;
+    Uint8 num_strings, i;
+
+    ClearReplayStrings(replay);
+
+    if (!SDL_ReadU64LE(replay->rw, &replay->next_time)) {
+        /* End of the recording */
+        replay->have_next = SDL_FALSE;
+        return 0;
+    }
+
+    SDL_zero(replay->next);
+    if (!SDL_ReadU16LE(replay->rw, &size) || size > sizeof(replay->next) ||
+        SDL_RWread(replay->rw, &replay->next, size) != size ||
+        !SDL_ReadU8(replay->rw, &num_strings) || num_strings > EVENTRECORD_MAX_STRINGS) {
+        goto corrupt;
+    }
+
+    for (i = 0; i < num_strings; ++i) {
+        Uint8 field;
+        Uint32 length;
+
+        if (!SDL_ReadU8(replay->rw, &field) || field >= EVENTRECORD_MAX_STRINGS ||
+            !SDL_ReadU32LE(replay->rw, &length)) {
+            goto corrupt;
+        }
+        if (length == 0xFFFFFFFF) {
+            continue;
+        }
+        replay->next_strings[field] = (char *)SDL_malloc((size_t)length + 1);
+        if (!replay->next_strings[field]) {
+            replay->have_next = SDL_FALSE;
+            return SDL_OutOfMemory();
+        }
+        if (SDL_RWread(replay->rw, replay->next_strings[field], length) != length) {
+            goto corrupt;
+        }
+        replay->next_strings[field][length] = '\0';
+    }
+
+    replay->have_next = SDL_TRUE;
+    return 0;
+
+corrupt:
+    replay->have_next = SDL_FALSE;
+    return SDL_SetError("Event recording is corrupt");
+}
+
+SDLTest_EventReplay *SDLTest_OpenEventReplay(const char *file, float speed)
+{
+    SDLTest_EventReplay *replay;
+    char magic[8];
+    Uint32 version = 0, event_size = 0;
+
+    replay = (SDLTest_EventReplay *)SDL_calloc(1, sizeof(*replay));
+    if (!replay) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    replay->speed = speed;
+
+    replay->rw = SDL_RWFromFile(file, "rb");
+    if (!replay->rw) {
+        SDL_free(replay);
+        return NULL;
+    }
+
+    if (SDL_RWread(replay->rw, magic, sizeof(magic)) != sizeof(magic) ||
+        SDL_memcmp(magic, EVENTRECORD_MAGIC, sizeof(magic)) != 0 ||
+        !SDL_ReadU32LE(replay->rw, &version) || version != EVENTRECORD_VERSION ||
+        !SDL_ReadU32LE(replay->rw, &event_size) || event_size != sizeof(SDL_Event)) {
+        SDL_SetError("%s is not a compatible event recording", file);
+        SDLTest_CloseEventReplay(replay);
+        return NULL;
+    }
+
+    if (ReadNextReplayEvent(replay) < 0) {
+        SDLTest_CloseEventReplay(replay);
+        return NULL;
+    }
+    return replay;
+}
+
+int SDLTest_UpdateEventReplay(SDLTest_EventReplay *replay)
+{
+    Uint64 elapsed;
+    int pushed = 0;
+
+    if (!replay) {
+        return SDL_InvalidParamError("replay");
+    }
+
+    if (!replay->start) {
+        replay->start = SDL_GetTicksNS();
+    }
+    elapsed = SDL_GetTicksNS() - replay->start;
+
+    while (replay->have_next) {
+        char **fields[EVENTRECORD_MAX_STRINGS];
+        int num_strings, i;
+
+        if (replay->speed > 0.0f && (Uint64)((double)replay->next_time / replay->speed) > elapsed) {
+            break;
+        }
+
+        /* Event memory is released as the queue moves on, so allocate it right before pushing */
+        num_strings = GetEventStrings(&replay->next, fields);
+        for (i = 0; i < num_strings; ++i) {
+            const char *string = replay->next_strings[i];
+            if (string) {
+                const size_t length = SDL_strlen(string) + 1;
+                *fields[i] = (char *)SDL_AllocateEventMemory(length);
+                if (!*fields[i]) {
+                    return -1;
+                }
+                SDL_memcpy(*fields[i], string, length);
+            }
+        }
+
+        /* Let SDL_PushEvent() stamp it with the current time */
+        replay->next.common.timestamp = 0;
+        SDL_PushEvent(&replay->next);
+        ++pushed;
+
+        if (ReadNextReplayEvent(replay) < 0) {
+            return -1;
+        }
+    }
+    return pushed;
+}
+
+SDL_bool SDLTest_IsEventReplayDone(SDLTest_EventReplay *replay)
+{
+    return (!replay || !replay->have_next) ? SDL_TRUE : SDL_FALSE;
+}
+
+void SDLTest_CloseEventReplay(SDLTest_EventReplay *replay)
+{
+    if (!replay) {
+        return;
+    }
+    ClearReplayStrings(replay);
+    if (replay->rw) {
+        SDL_RWclose(replay->rw);
+    }
+    SDL_free(replay);
+}
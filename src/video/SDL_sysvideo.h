@@ -322,6 +322,7 @@ struct SDL_VideoDevice
     SDL_bool suspend_screensaver;
     SDL_Window *wakeup_window;
     SDL_Mutex *wakeup_lock; /* Initialized only if WaitEventTimeout/SendWakeupEvent are supported */
+    SDL_bool waits_on_event_wakeup; /* WaitEventTimeout also returns when SDL_GetEventWakeupFD() is signaled */
     int num_displays;
     SDL_VideoDisplay **displays;
     SDL_Window *windows;
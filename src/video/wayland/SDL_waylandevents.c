@@ -391,11 +391,15 @@ int Wayland_WaitEventTimeout(SDL_VideoDevice *_this, Sint64 timeoutNS)
      * If the default queue is empty, it will prepare us for our SDL_IOReady() call. */
     if (WAYLAND_wl_display_prepare_read(d->display) == 0) {
         /* Use SDL_IOR_NO_RETRY to ensure SIGINT will break us out of our wait */
-        int err = SDL_IOReady(WAYLAND_wl_display_get_fd(d->display), SDL_IOR_READ | SDL_IOR_NO_RETRY, timeoutNS);
-        if (err > 0) {
+        int err = SDL_IOReadyOrWakeup(WAYLAND_wl_display_get_fd(d->display), SDL_IOR_READ | SDL_IOR_NO_RETRY, SDL_GetEventWakeupFD(), timeoutNS);
+        if (err > 0 && (err & SDL_IOR_READ)) {
             /* There are new events available to read */
             WAYLAND_wl_display_read_events(d->display);
             return dispatch_queued_events(d);
+        } else if (err > 0) {
+            /* Another thread pushed an event, let the event core pick it up */
+            WAYLAND_wl_display_cancel_read(d->display);
+            return 1;
         } else if (err == 0) {
             /* No events available within the timeout */
             WAYLAND_wl_display_cancel_read(d->display);
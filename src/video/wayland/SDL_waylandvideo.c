@@ -179,6 +179,7 @@ static SDL_VideoDevice *Wayland_CreateDevice(void)
     device->PumpEvents = Wayland_PumpEvents;
     device->WaitEventTimeout = Wayland_WaitEventTimeout;
     device->SendWakeupEvent = Wayland_SendWakeupEvent;
+    device->waits_on_event_wakeup = SDL_TRUE;
 
 #ifdef SDL_VIDEO_OPENGL_EGL
     device->GL_SwapWindow = Wayland_GLES_SwapWindow;
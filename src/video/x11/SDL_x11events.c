@@ -1781,11 +1781,12 @@ int X11_WaitEventTimeout(SDL_VideoDevice *_this, Sint64 timeoutNS)
         return 0;
     } else {
         /* Use SDL_IOR_NO_RETRY to ensure SIGINT will break us out of our wait */
-        int err = SDL_IOReady(ConnectionNumber(display), SDL_IOR_READ | SDL_IOR_NO_RETRY, timeoutNS);
+        int err = SDL_IOReadyOrWakeup(ConnectionNumber(display), SDL_IOR_READ | SDL_IOR_NO_RETRY, SDL_GetEventWakeupFD(), timeoutNS);
         if (err > 0) {
             if (!X11_PollEvent(display, &xevent)) {
-                /* Someone may have beat us to reading the fd. Return 1 here to
-                 * trigger the normal spurious wakeup logic in the event core. */
+                /* Another thread pushed an event, or someone may have beat us to
+                 * reading the fd. Return 1 here to trigger the normal spurious
+                 * wakeup logic in the event core. */
                 return 1;
             }
         } else if (err == 0) {
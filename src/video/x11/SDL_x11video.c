@@ -178,6 +178,7 @@ static SDL_VideoDevice *X11_CreateDevice(void)
     device->PumpEvents = X11_PumpEvents;
     device->WaitEventTimeout = X11_WaitEventTimeout;
     device->SendWakeupEvent = X11_SendWakeupEvent;
+    device->waits_on_event_wakeup = SDL_TRUE;
 
     device->CreateSDLWindow = X11_CreateWindow;
     device->SetWindowTitle = X11_SetWindowTitle;
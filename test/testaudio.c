@@ -98,6 +98,8 @@ struct Thing
 
 
 static Uint64 app_ready_ticks = 0;
+static SDL_bool show_stats = SDL_FALSE;
+static Uint64 next_stats_ticks = 0;
 static SDLTest_CommonState *state = NULL;
 
 static Thing *things = NULL;
@@ -1017,6 +1019,46 @@ static void TickThings(void)
     }
 }
 
+/* Roughly where a percentile falls in one of the stats histograms, in microseconds (the top of its bucket). */
+static unsigned int StatsPercentile(const Uint64 *histogram, const double percentile)
+{
+    Uint64 total = 0;
+    Uint64 seen = 0;
+    int i;
+
+    for (i = 0; i < SDL_AUDIO_DEVICE_STATS_BUCKETS; i++) {
+        total += histogram[i];
+    }
+
+    for (i = 0; i < SDL_AUDIO_DEVICE_STATS_BUCKETS - 1; i++) {
+        seen += histogram[i];
+        if (seen >= (Uint64) (total * percentile)) {
+            break;
+        }
+    }
+    return 2u << i;
+}
+
+static void LogAudioDeviceStats(void)
+{
+    Thing *i;
+    for (i = things; i; i = i->next) {
+        SDL_AudioDeviceStats stats;
+        if ((i->what != THING_PHYSDEV) && (i->what != THING_PHYSDEV_CAPTURE)) {
+            continue;
+        } else if ((SDL_GetAudioDeviceStats(i->data.physdev.devid, &stats) < 0) || (stats.periods == 0)) {
+            continue;  /* never opened, nothing to say. */
+        }
+
+        SDL_Log("%s: %u periods of %uus, %u short reads, %u xruns | wait-to-play p99 <%uus max %uus | process p99 <%uus max %uus | interval p99 <%uus max %uus",
+                i->titlebar, (unsigned int) stats.periods, (unsigned int) (stats.period_ns / 1000),
+                (unsigned int) stats.short_reads, (unsigned int) stats.xruns,
+                StatsPercentile(stats.wait_to_play_histogram, 0.99), (unsigned int) (stats.max_wait_to_play_ns / 1000),
+                StatsPercentile(stats.process_histogram, 0.99), (unsigned int) (stats.max_process_ns / 1000),
+                StatsPercentile(stats.interval_histogram, 0.99), (unsigned int) (stats.max_interval_ns / 1000));
+    }
+}
+
 static void WindowResized(const int newwinw, const int newwinh)
 {
     Thing *i;
@@ -1052,11 +1094,15 @@ int SDL_AppInit(int argc, char *argv[])
         if (consumed == 0) {
             consumed = -1;
             /* add our own command lines here. */
+            if (SDL_strcasecmp(argv[i], "--stats") == 0) {
+                show_stats = SDL_TRUE;
+                consumed = 1;
+            }
         }
         if (consumed < 0) {
             static const char *options[] = {
                 /* add our own command lines here. */
-                /*"[--blend none|blend|add|mod|mul|sub]",*/
+                "[--stats]",
                 NULL
             };
             SDLTest_CommonLogUsage(state, argv[0], options);
@@ -1223,6 +1269,11 @@ int SDL_AppIterate(void)
     TickThings();
     Draw();
 
+    if (show_stats && (SDL_GetTicks() >= next_stats_ticks)) {
+        LogAudioDeviceStats();
+        next_stats_ticks = SDL_GetTicks() + 1000;
+    }
+
     if (saw_event) {
         saw_event = SDL_FALSE;  /* reset this so we know when SDL_AppEvent() runs again */
     } else {
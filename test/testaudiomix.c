@@ -0,0 +1,186 @@
+/*
+  Copyright (C) 1997-2023 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+
+/* Benchmark of SDL_MixAudioFormat() with float samples, mixing many streams
+   into one buffer the way the audio device thread does, and checking the
+   result against a straightforward scalar mix. */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+#define DEFAULT_STREAMS    64
+#define DEFAULT_ITERATIONS 200
+#define MAX_STREAMS        1024
+#define BUFFER_FRAMES      1024
+#define CHANNELS           2
+
+/* A fixed sequence of samples in [-1.0, 1.0), so runs are comparable */
+static float
+RandomSample(Uint32 *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return (float)(*seed >> 8) / 8388608.0f - 1.0f;
+}
+
+/* The same math as the mixer, done one sample at a time in double precision */
+static void
+ReferenceMix(float *dst, const float *src, int num_samples, int volume)
+{
+    int i;
+
+    for (i = 0; i < num_samples; ++i) {
+        const double sample = (double)dst[i] + ((double)src[i] * volume) / SDL_MIX_MAXVOLUME;
+        dst[i] = (float)SDL_clamp(sample, -3.402823466e+38, 3.402823466e+38);
+    }
+}
+
+static SDL_bool
+CheckMix(float **streams, int num_streams, int num_samples, float *dst, float *expected)
+{
+    int i, j;
+
+    for (i = 0; i < num_streams; ++i) {
+        const int volume = (i % 2) ? SDL_MIX_MAXVOLUME : (i % SDL_MIX_MAXVOLUME);
+        SDL_MixAudioFormat((Uint8 *)dst, (const Uint8 *)streams[i], SDL_AUDIO_F32, num_samples * sizeof(float), volume);
+        ReferenceMix(expected, streams[i], num_samples, volume);
+    }
+
+    for (j = 0; j < num_samples; ++j) {
+        if (SDL_fabsf(dst[j] - expected[j]) > 1e-5f * SDL_max(1.0f, SDL_fabsf(expected[j]))) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Mismatch at sample %d: got %g, expected %g\n", j, dst[j], expected[j]);
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+int main(int argc, char **argv)
+{
+    int num_streams = DEFAULT_STREAMS;
+    int iterations = DEFAULT_ITERATIONS;
+    const int num_samples = BUFFER_FRAMES * CHANNELS;
+    float **streams = NULL;
+    float *dst = NULL;
+    float *expected = NULL;
+    SDLTest_CommonState *state;
+    SDL_bool success = SDL_TRUE;
+    Uint64 start, elapsed;
+    double samples;
+    Uint32 seed = 0x12345678;
+    int i, j;
+
+    /* Initialize test framework */
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (!state) {
+        return 1;
+    }
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Parse commandline */
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (!consumed) {
+            if (SDL_strcmp(argv[i], "--streams") == 0 && argv[i + 1]) {
+                num_streams = SDL_clamp(SDL_atoi(argv[i + 1]), 1, MAX_STREAMS);
+                consumed = 2;
+            } else if (SDL_strcmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            }
+        }
+        if (consumed <= 0) {
+            static const char *options[] = { "[--streams N]", "[--iterations N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+
+        i += consumed;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    streams = (float **)SDL_calloc(num_streams, sizeof(*streams));
+    dst = (float *)SDL_calloc(num_samples, sizeof(float));
+    expected = (float *)SDL_calloc(num_samples, sizeof(float));
+    if (!streams || !dst || !expected) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        success = SDL_FALSE;
+        goto done;
+    }
+
+    for (i = 0; i < num_streams; ++i) {
+        streams[i] = (float *)SDL_malloc(num_samples * sizeof(float));
+        if (!streams[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+            success = SDL_FALSE;
+            goto done;
+        }
+        for (j = 0; j < num_samples; ++j) {
+            streams[i][j] = RandomSample(&seed);
+        }
+    }
+
+    /* Odd buffer offsets exercise the scalar tails of the SIMD kernels */
+    if (!CheckMix(streams, num_streams, num_samples, dst, expected) ||
+        !CheckMix(streams, num_streams, num_samples - 3, dst + 1, expected + 1)) {
+        success = SDL_FALSE;
+    }
+
+    start = SDL_GetTicksNS();
+    for (i = 0; i < iterations; ++i) {
+        SDL_memset(expected, 0, num_samples * sizeof(float));
+        for (j = 0; j < num_streams; ++j) {
+            ReferenceMix(expected, streams[j], num_samples, SDL_MIX_MAXVOLUME);
+        }
+    }
+    elapsed = SDL_GetTicksNS() - start;
+    samples = (double)iterations * num_streams * num_samples;
+    SDL_Log("Scalar double mix: %d streams of %d frames x %d channels, %.2f ms (%.1f Msamples/sec)\n",
+            num_streams, BUFFER_FRAMES, CHANNELS, (double)elapsed / SDL_NS_PER_MS,
+            elapsed ? (samples * SDL_NS_PER_SECOND) / elapsed / 1000000.0 : 0.0);
+
+    start = SDL_GetTicksNS();
+    for (i = 0; i < iterations; ++i) {
+        SDL_memset(dst, 0, num_samples * sizeof(float));
+        for (j = 0; j < num_streams; ++j) {
+            SDL_MixAudioFormat((Uint8 *)dst, (const Uint8 *)streams[j], SDL_AUDIO_F32, num_samples * sizeof(float), SDL_MIX_MAXVOLUME);
+        }
+    }
+    elapsed = SDL_GetTicksNS() - start;
+    SDL_Log("SDL_MixAudioFormat:  %d streams of %d frames x %d channels, %.2f ms (%.1f Msamples/sec)\n",
+            num_streams, BUFFER_FRAMES, CHANNELS, (double)elapsed / SDL_NS_PER_MS,
+            elapsed ? (samples * SDL_NS_PER_SECOND) / elapsed / 1000000.0 : 0.0);
+
+done:
+    if (streams) {
+        for (i = 0; i < num_streams; ++i) {
+            SDL_free(streams[i]);
+        }
+        SDL_free(streams);
+    }
+    SDL_free(dst);
+    SDL_free(expected);
+
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+
+    return success ? 0 : 1;
+}
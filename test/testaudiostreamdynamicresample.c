@@ -41,6 +41,30 @@ static Uint64 last_get_callback = 0;
 static int last_get_amount_additional = 0;
 static int last_get_amount_total = 0;
 
+/* --feeder: a low priority thread puts small chunks as if it were a game's audio thread.
+   --spsc: ...and it does so through the stream's lock-free single-producer path. */
+static SDL_bool use_feeder = SDL_FALSE;
+static SDL_bool use_spsc = SDL_FALSE;
+static SDL_Thread *feeder_thread = NULL;
+static SDL_AtomicInt feeder_quit;
+
+typedef struct FeederStats
+{
+    Uint64 put_count;
+    Uint64 put_total_ns;
+    Uint64 put_max_ns;
+    Uint64 get_count;
+    Uint64 get_last_ns;
+    Uint64 get_interval_total_ns;
+    Uint64 get_interval_min_ns;
+    Uint64 get_interval_max_ns;
+} FeederStats;
+
+static SDL_Mutex *stats_lock = NULL;
+static FeederStats stats;
+static FeederStats shown_stats;
+static Uint64 last_stats_log = 0;
+
 typedef struct Slider
 {
     SDL_FRect area;
@@ -208,6 +232,75 @@ static const char *AudioChansToStr(const int channels)
     return "?";
 }
 
+static int SDLCALL feeder_main(void *arg)
+{
+    const int frame_size = SDL_AUDIO_FRAMESIZE(spec);
+    const int chunk_len = (spec.freq / 100) * frame_size;  /* 10 milliseconds */
+    const Uint64 bytes_per_second = (Uint64)spec.freq * frame_size;
+    const Uint64 prefill = bytes_per_second / 10;
+    const Uint64 start = SDL_GetTicksNS();
+    Uint64 fed = 0;
+    Uint32 pos = 0;
+
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
+
+    while (!SDL_AtomicGet(&feeder_quit)) {
+        const Uint64 wanted = prefill + ((SDL_GetTicksNS() - start) * bytes_per_second) / SDL_NS_PER_SECOND;
+
+        while (fed < wanted) {
+            const int len = (int)SDL_min((Uint32)chunk_len, audio_len - pos);
+            const Uint64 put_start = SDL_GetTicksNS();
+            const int retval = SDL_PutAudioStreamData(stream, audio_buf + pos, len);
+            const Uint64 put_ns = SDL_GetTicksNS() - put_start;
+
+            if (retval < 0) {
+                SDL_Log("Feeder failed to put audio: %s", SDL_GetError());
+                return 0;
+            }
+
+            SDL_LockMutex(stats_lock);
+            stats.put_count++;
+            stats.put_total_ns += put_ns;
+            stats.put_max_ns = SDL_max(stats.put_max_ns, put_ns);
+            SDL_UnlockMutex(stats_lock);
+
+            fed += len;
+            pos += len;
+            if (pos >= audio_len) {
+                pos = 0;
+            }
+        }
+
+        SDL_Delay(1);
+    }
+
+    return 0;
+}
+
+static void update_stats(void)
+{
+    const Uint64 now = SDL_GetTicks();
+
+    if (!use_feeder || (now - last_stats_log) < 1000) {
+        return;
+    }
+
+    last_stats_log = now;
+
+    SDL_LockMutex(stats_lock);
+    SDL_copyp(&shown_stats, &stats);
+    stats.put_count = stats.put_total_ns = stats.put_max_ns = 0;
+    stats.get_count = stats.get_interval_total_ns = stats.get_interval_max_ns = 0;
+    stats.get_interval_min_ns = 0;
+    SDL_UnlockMutex(stats_lock);
+
+    SDL_Log("Put (%s): %" SDL_PRIu64 " calls, avg %" SDL_PRIu64 " us, max %" SDL_PRIu64 " us. Get callback interval: avg %" SDL_PRIu64 " us, min %" SDL_PRIu64 " us, max %" SDL_PRIu64 " us",
+            use_spsc ? "single producer" : "locked", shown_stats.put_count,
+            shown_stats.put_count ? (shown_stats.put_total_ns / shown_stats.put_count) / 1000 : 0, shown_stats.put_max_ns / 1000,
+            shown_stats.get_count ? (shown_stats.get_interval_total_ns / shown_stats.get_count) / 1000 : 0,
+            shown_stats.get_interval_min_ns / 1000, shown_stats.get_interval_max_ns / 1000);
+}
+
 static void loop(void)
 {
     int i, j;
@@ -233,14 +326,16 @@ static void loop(void)
                     SDL_PauseAudioDevice(state->audio_id);
                 }
             } else if (sym == SDLK_w) {
-                auto_loop = !auto_loop;
+                auto_loop = !auto_loop && !use_feeder;
             } else if (sym == SDLK_e) {
                 auto_flush = !auto_flush;
             } else if (sym == SDLK_a) {
                 SDL_ClearAudioStream(stream);
                 SDL_Log("Cleared audio stream");
             } else if (sym == SDLK_s) {
-                queue_audio();
+                if (!use_feeder) {
+                    queue_audio();
+                }
             } else if (sym == SDLK_d) {
                 float amount = 1.0f;
                 amount *= (e.key.keysym.mod & SDL_KMOD_CTRL) ? 10.0f : 1.0f;
@@ -295,6 +390,8 @@ static void loop(void)
         available_bytes = SDL_GetAudioStreamAvailable(stream);
         available_seconds = (float)available_bytes / (float)(SDL_AUDIO_FRAMESIZE(dst_spec) * dst_spec.freq);
 
+        update_stats();
+
         /* keep it looping. */
         if (auto_loop && (available_seconds < 10.0f)) {
             queue_audio();
@@ -341,6 +438,18 @@ static void loop(void)
 
         SDL_UnlockAudioStream(stream);
 
+        if (use_feeder) {
+            draw_textf(rend, 0, draw_y, "Put (%s): avg %i us, max %i us",
+                use_spsc ? "SPSC" : "locked",
+                (int)(shown_stats.put_count ? (shown_stats.put_total_ns / shown_stats.put_count) / 1000 : 0), (int)(shown_stats.put_max_ns / 1000));
+            draw_y += FONT_LINE_HEIGHT;
+
+            draw_textf(rend, 0, draw_y, "Get interval: avg %i us, min %i us, max %i us",
+                (int)(shown_stats.get_count ? (shown_stats.get_interval_total_ns / shown_stats.get_count) / 1000 : 0),
+                (int)(shown_stats.get_interval_min_ns / 1000), (int)(shown_stats.get_interval_max_ns / 1000));
+            draw_y += FONT_LINE_HEIGHT;
+        }
+
         draw_y = state->window_h - FONT_LINE_HEIGHT * 3;
 
         draw_textf(rend, 0, draw_y, "Wav: %6s/%6s/%i",
@@ -361,9 +470,24 @@ static void loop(void)
 
 static void SDLCALL our_get_callback(void *userdata, SDL_AudioStream *strm, int additional_amount, int total_amount)
 {
+    const Uint64 now = SDL_GetTicksNS();
+
     last_get_callback = SDL_GetTicks();
     last_get_amount_additional = additional_amount;
     last_get_amount_total = total_amount;
+
+    if (use_feeder) {
+        SDL_LockMutex(stats_lock);
+        if (stats.get_last_ns) {
+            const Uint64 interval = now - stats.get_last_ns;
+            stats.get_interval_total_ns += interval;
+            stats.get_interval_max_ns = SDL_max(stats.get_interval_max_ns, interval);
+            stats.get_interval_min_ns = stats.get_count ? SDL_min(stats.get_interval_min_ns, interval) : interval;
+            stats.get_count++;
+        }
+        stats.get_last_ns = now;
+        SDL_UnlockMutex(stats_lock);
+    }
 }
 
 int main(int argc, char *argv[])
@@ -387,13 +511,19 @@ int main(int argc, char *argv[])
 
         consumed = SDLTest_CommonArg(state, i);
         if (!consumed) {
-            if (!filename) {
+            if (SDL_strcmp(argv[i], "--feeder") == 0) {
+                use_feeder = SDL_TRUE;
+                consumed = 1;
+            } else if (SDL_strcmp(argv[i], "--spsc") == 0) {
+                use_feeder = use_spsc = SDL_TRUE;
+                consumed = 1;
+            } else if (!filename) {
                 filename = argv[i];
                 consumed = 1;
             }
         }
         if (consumed <= 0) {
-            static const char *options[] = { "[sample.wav]", NULL };
+            static const char *options[] = { "[--feeder]", "[--spsc]", "[sample.wav]", NULL };
             SDLTest_CommonLogUsage(state, argv[0], options);
             exit(1);
         }
@@ -430,8 +560,22 @@ int main(int argc, char *argv[])
     stream = SDL_CreateAudioStream(&spec, &spec);
     SDL_SetAudioStreamGetCallback(stream, our_get_callback, NULL);
 
+    if (use_spsc) {
+        /* room for a quarter second; the feeder stays about 100 milliseconds ahead. */
+        if (SDL_SetAudioStreamSingleProducer(stream, (spec.freq / 4) * SDL_AUDIO_FRAMESIZE(spec)) < 0) {
+            SDL_Log("Failed to enable single-producer mode: %s", SDL_GetError());
+        }
+    }
+
     SDL_BindAudioStream(state->audio_id, stream);
 
+    if (use_feeder) {
+        auto_loop = SDL_FALSE;
+        stats_lock = SDL_CreateMutex();
+        SDL_AtomicSet(&feeder_quit, 0);
+        feeder_thread = SDL_CreateThread(feeder_main, "Feeder", NULL);
+    }
+
 #ifdef __EMSCRIPTEN__
     emscripten_set_main_loop(loop, 0, 1);
 #else
@@ -440,8 +584,14 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    if (feeder_thread) {
+        SDL_AtomicSet(&feeder_quit, 1);
+        SDL_WaitThread(feeder_thread, NULL);
+    }
+
     SDLTest_CleanupTextDrawing();
     SDL_DestroyAudioStream(stream);
+    SDL_DestroyMutex(stats_lock);
     SDL_free(audio_buf);
     SDLTest_CommonQuit(state);
     return 0;
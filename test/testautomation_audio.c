@@ -1249,6 +1249,1245 @@ cleanup:
 
     return status;
 }
+
+#define NUM_PARALLEL_MIX_STREAMS 9
+
+static SDL_AtomicInt g_audio_postmixCalls;
+static float g_audio_postmixMin;
+static float g_audio_postmixMax;
+
+static void SDLCALL audio_parallelMixPostmix(void *userdata, const SDL_AudioSpec *spec, float *buffer, int buflen)
+{
+    int i;
+
+    /* only look at the first buffer; the streams might run dry after that. */
+    if (SDL_AtomicAdd(&g_audio_postmixCalls, 1) != 0) {
+        return;
+    }
+
+    g_audio_postmixMin = g_audio_postmixMax = buffer[0];
+    for (i = 1; i < buflen / (int)sizeof(float); i++) {
+        g_audio_postmixMin = SDL_min(g_audio_postmixMin, buffer[i]);
+        g_audio_postmixMax = SDL_max(g_audio_postmixMax, buffer[i]);
+    }
+}
+
+/**
+ * Mix several streams with the mixing thread pool enabled and check the result.
+ *
+ * \sa SDL_HINT_AUDIO_MIX_THREADS
+ * \sa SDL_SetAudioPostmixCallback
+ */
+static int audio_parallelMix(void *arg)
+{
+    SDL_AudioStream *streams[NUM_PARALLEL_MIX_STREAMS];
+    SDL_AudioDeviceID devid;
+    SDL_AudioSpec spec;
+    float *buffer = NULL;
+    float expected = 0.0f;
+    int init_count = 0;
+    int frames = 0;
+    int result;
+    int i, j;
+
+    SDL_zeroa(streams);
+    SDL_AtomicSet(&g_audio_postmixCalls, 0);
+
+    /* the hint is only checked when audio initializes, so make sure it really shuts down first. */
+    while (SDL_WasInit(SDL_INIT_AUDIO)) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        init_count++;
+    }
+    SDL_SetHint(SDL_HINT_AUDIO_MIX_THREADS, "3");
+    result = SDL_InitSubSystem(SDL_INIT_AUDIO);
+    SDLTest_AssertCheck(result == 0, "Call to SDL_InitSubSystem(SDL_INIT_AUDIO) with SDL_HINT_AUDIO_MIX_THREADS=3");
+
+    devid = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL);
+    SDLTest_AssertCheck(devid != 0, "Call to SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL)");
+    if (devid == 0) {
+        goto cleanup;
+    }
+
+    SDL_PauseAudioDevice(devid);
+    result = SDL_GetAudioDeviceFormat(devid, &spec, &frames);
+    SDLTest_AssertCheck(result == 0 && frames > 0, "Call to SDL_GetAudioDeviceFormat(), got %d sample frames", frames);
+    if (result != 0 || frames <= 0) {
+        goto cleanup;
+    }
+    spec.format = SDL_AUDIO_F32;
+
+    /* give each stream a different constant value, so we can tell if any went missing or got mixed twice. */
+    buffer = (float *)SDL_malloc(frames * spec.channels * sizeof(float));
+    SDLTest_AssertCheck(buffer != NULL, "Allocate sample buffer");
+    if (!buffer) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < NUM_PARALLEL_MIX_STREAMS; i++) {
+        const float value = 0.01f * (i + 1);
+        for (j = 0; j < frames * spec.channels; j++) {
+            buffer[j] = value;
+        }
+        expected += value;
+
+        streams[i] = SDL_CreateAudioStream(&spec, &spec);
+        SDLTest_AssertCheck(streams[i] != NULL, "Create audio stream %d", i);
+        if (!streams[i]) {
+            goto cleanup;
+        }
+        result = SDL_PutAudioStreamData(streams[i], buffer, frames * spec.channels * (int)sizeof(float));
+        SDLTest_AssertCheck(result == 0, "Put data into audio stream %d", i);
+    }
+
+    result = SDL_SetAudioPostmixCallback(devid, audio_parallelMixPostmix, NULL);
+    SDLTest_AssertCheck(result == 0, "Call to SDL_SetAudioPostmixCallback()");
+    result = SDL_BindAudioStreams(devid, streams, NUM_PARALLEL_MIX_STREAMS);
+    SDLTest_AssertCheck(result == 0, "Call to SDL_BindAudioStreams() with %d streams", NUM_PARALLEL_MIX_STREAMS);
+
+    SDL_ResumeAudioDevice(devid);
+    for (i = 0; (i < 100) && (SDL_AtomicGet(&g_audio_postmixCalls) == 0); i++) {
+        SDL_Delay(10);
+    }
+
+    SDLTest_AssertCheck(SDL_AtomicGet(&g_audio_postmixCalls) > 0, "Verify postmix callback ran");
+    if (SDL_AtomicGet(&g_audio_postmixCalls) > 0) {
+        SDLTest_AssertCheck(SDL_fabsf(g_audio_postmixMin - expected) < 0.0001f && SDL_fabsf(g_audio_postmixMax - expected) < 0.0001f,
+                            "Verify mixed samples; expected: %f got: %f..%f", expected, g_audio_postmixMin, g_audio_postmixMax);
+    }
+
+cleanup:
+    if (devid) {
+        SDL_CloseAudioDevice(devid);
+    }
+    for (i = 0; i < NUM_PARALLEL_MIX_STREAMS; i++) {
+        SDL_DestroyAudioStream(streams[i]);
+    }
+    SDL_free(buffer);
+
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    SDL_ResetHint(SDL_HINT_AUDIO_MIX_THREADS);
+    while (init_count-- > 0) {
+        audioSetUp(NULL);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * Resample with each resampler quality tier, switching tiers part way through.
+ *
+ * \sa SDL_GetAudioStreamProperties
+ */
+static int audio_resamplerQuality(void *arg)
+{
+  static const double max_errors[] = { 0.04, 0.001, 0.0001, 0.001 };
+  const int rate_in = 44100;
+  const int rate_out = 48000;
+  const int frames_in = rate_in;
+  const int frames_target = rate_out;
+  SDL_AudioSpec spec_in, spec_out;
+  float *buf_in = (float *)SDL_malloc(frames_in * sizeof(float));
+  float *buf_out = (float *)SDL_malloc(frames_target * sizeof(float));
+  int quality, i, ret, len_out;
+
+  SDLTest_AssertCheck(buf_in != NULL && buf_out != NULL, "Expected buffers to be created.");
+  if (buf_in == NULL || buf_out == NULL) {
+    SDL_free(buf_in);
+    SDL_free(buf_out);
+    return TEST_ABORTED;
+  }
+
+  for (i = 0; i < frames_in; ++i) {
+    buf_in[i] = (float)sine_wave_sample(i, rate_in, 440, 0);
+  }
+
+  spec_in.format = spec_out.format = SDL_AUDIO_F32;
+  spec_in.channels = spec_out.channels = 1;
+  spec_in.freq = rate_in;
+  spec_out.freq = rate_out;
+
+  for (quality = SDL_AUDIO_RESAMPLER_NEAREST; quality <= SDL_AUDIO_RESAMPLER_SINC; quality++) {
+    SDL_AudioStream *stream = SDL_CreateAudioStream(&spec_in, &spec_out);
+    double max_error = 0;
+
+    SDLTest_AssertCheck(stream != NULL, "Expected SDL_CreateAudioStream to succeed.");
+    if (stream == NULL) {
+      break;
+    }
+
+    ret = SDL_PutAudioStreamData(stream, buf_in, frames_in * sizeof(float));
+    SDLTest_AssertCheck(ret == 0, "Expected SDL_PutAudioStreamData to succeed.");
+    ret = SDL_FlushAudioStream(stream);
+    SDLTest_AssertCheck(ret == 0, "Expected SDL_FlushAudioStream to succeed.");
+
+    /* Start with the default (sinc), then switch, so the history buffer gets resized mid-stream. */
+    len_out = SDL_GetAudioStreamData(stream, buf_out, (frames_target / 4) * sizeof(float));
+    SDLTest_AssertCheck(len_out == (frames_target / 4) * (int)sizeof(float), "Expected %i bytes, got %i.", (frames_target / 4) * (int)sizeof(float), len_out);
+
+    ret = SDL_SetNumberProperty(SDL_GetAudioStreamProperties(stream), "SDL.audiostream.resampler_quality", quality);
+    SDLTest_AssertPass("Call to SDL_SetNumberProperty(props, \"SDL.audiostream.resampler_quality\", %d)", quality);
+    SDLTest_AssertCheck(ret == 0, "Expected SDL_SetNumberProperty to succeed.");
+
+    ret = SDL_GetAudioStreamData(stream, buf_out + (frames_target / 4), (frames_target - (frames_target / 4)) * sizeof(float));
+    len_out += ret;
+    SDLTest_AssertCheck(len_out == frames_target * (int)sizeof(float), "Expected %i bytes in total, got %i.", frames_target * (int)sizeof(float), len_out);
+    SDL_DestroyAudioStream(stream);
+
+    /* Only check what was resampled after the switch, and skip the tail end, which was resampled against silence past the end of the input. */
+    for (i = frames_target / 4; i < frames_target - 16; ++i) {
+      const double error = SDL_fabs(sine_wave_sample(i, rate_out, 440, 0) - buf_out[i]);
+      max_error = SDL_max(max_error, error);
+    }
+
+    SDLTest_AssertCheck(max_error <= max_errors[quality], "Expected quality %d to have a maximum error of at most %f, got %f.", quality, max_errors[quality], max_error);
+  }
+
+  SDL_free(buf_in);
+  SDL_free(buf_out);
+
+  return TEST_COMPLETED;
+}
+
+static int audio_convertPlanChange(void *arg)
+{
+  const int frames = 1024;
+  SDL_AudioSpec spec_in, spec_out;
+  Sint16 *buf_in = (Sint16 *)SDL_malloc(frames * 2 * sizeof(Sint16));
+  float buf_float[2 * 2];
+  Uint8 buf_swapped[2 * sizeof(Sint16)];
+  SDL_AudioStream *stream;
+  int i, ret;
+
+  SDLTest_AssertCheck(buf_in != NULL, "Expected buffer to be created.");
+  if (buf_in == NULL) {
+    return TEST_ABORTED;
+  }
+
+  for (i = 0; i < frames; ++i) {
+    buf_in[i * 2] = 1000;
+    buf_in[(i * 2) + 1] = 3000;
+  }
+
+  spec_in.format = SDL_AUDIO_S16;
+  spec_in.channels = 2;
+  spec_in.freq = 48000;
+  spec_out.format = SDL_AUDIO_F32;
+  spec_out.channels = 2;
+  spec_out.freq = 48000;
+
+  stream = SDL_CreateAudioStream(&spec_in, &spec_out);
+  SDLTest_AssertCheck(stream != NULL, "Expected SDL_CreateAudioStream to succeed.");
+  if (stream == NULL) {
+    SDL_free(buf_in);
+    return TEST_ABORTED;
+  }
+
+  ret = SDL_PutAudioStreamData(stream, buf_in, frames * 2 * sizeof(Sint16));
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_PutAudioStreamData to succeed.");
+
+  ret = SDL_GetAudioStreamData(stream, buf_float, sizeof(buf_float));
+  SDLTest_AssertCheck(ret == sizeof(buf_float), "Expected %i bytes, got %i.", (int)sizeof(buf_float), ret);
+  SDLTest_AssertCheck(SDL_fabsf(buf_float[2] - (1000.0f / 32768.0f)) < 1e-6f && SDL_fabsf(buf_float[3] - (3000.0f / 32768.0f)) < 1e-6f,
+                      "Expected float stereo output, got %f, %f.", buf_float[2], buf_float[3]);
+
+  /* Change the output format with data still queued; the stream has to pick a new conversion. */
+  spec_out.format = SDL_AUDIO_S16BE;
+  spec_out.channels = 1;
+  ret = SDL_SetAudioStreamFormat(stream, NULL, &spec_out);
+  SDLTest_AssertPass("Call to SDL_SetAudioStreamFormat(stream, NULL, S16BE mono)");
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_SetAudioStreamFormat to succeed.");
+
+  ret = SDL_GetAudioStreamData(stream, buf_swapped, sizeof(buf_swapped));
+  SDLTest_AssertCheck(ret == sizeof(buf_swapped), "Expected %i bytes, got %i.", (int)sizeof(buf_swapped), ret);
+  for (i = 0; i < 2; ++i) {
+    const Sint16 sample = (Sint16)((buf_swapped[i * 2] << 8) | buf_swapped[(i * 2) + 1]);
+    SDLTest_AssertCheck(SDL_abs(sample - 2000) <= 1, "Expected big-endian mono sample near 2000, got %d.", sample);
+  }
+
+  SDL_DestroyAudioStream(stream);
+  SDL_free(buf_in);
+
+  return TEST_COMPLETED;
+}
+
+typedef struct NoCopyCompletion
+{
+  const void *buf;
+  int buflen;
+  int calls;
+} NoCopyCompletion;
+
+static void SDLCALL audio_noCopyComplete(void *userdata, const void *buf, int buflen)
+{
+  NoCopyCompletion *completion = (NoCopyCompletion *)userdata;
+  completion->buf = buf;
+  completion->buflen = buflen;
+  completion->calls++;
+}
+
+static int audio_putNoCopy(void *arg)
+{
+  const int frames = 1000;
+  SDL_AudioSpec spec;
+  float *buf_in = (float *)SDL_malloc(frames * sizeof(float));
+  float *buf_out = (float *)SDL_malloc(frames * 2 * sizeof(float));
+  const float copied[4] = { 2.0f, 3.0f, 4.0f, 5.0f };
+  NoCopyCompletion completion;
+  SDL_AudioStream *stream;
+  int i, ret;
+
+  SDLTest_AssertCheck(buf_in != NULL && buf_out != NULL, "Expected buffers to be created.");
+  if (buf_in == NULL || buf_out == NULL) {
+    SDL_free(buf_in);
+    SDL_free(buf_out);
+    return TEST_ABORTED;
+  }
+
+  for (i = 0; i < frames; ++i) {
+    buf_in[i] = (float)i / (float)frames;
+  }
+
+  spec.format = SDL_AUDIO_F32;
+  spec.channels = 1;
+  spec.freq = 48000;
+
+  stream = SDL_CreateAudioStream(&spec, &spec);
+  SDLTest_AssertCheck(stream != NULL, "Expected SDL_CreateAudioStream to succeed.");
+  if (stream == NULL) {
+    SDL_free(buf_in);
+    SDL_free(buf_out);
+    return TEST_ABORTED;
+  }
+
+  /* Mix copied and uncopied data, and read it back in pieces. */
+  SDL_zero(completion);
+  ret = SDL_PutAudioStreamDataNoCopy(stream, buf_in, frames * sizeof(float), audio_noCopyComplete, &completion);
+  SDLTest_AssertPass("Call to SDL_PutAudioStreamDataNoCopy(stream, buf_in, %d, callback, userdata)", frames * (int)sizeof(float));
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_PutAudioStreamDataNoCopy to succeed.");
+  ret = SDL_PutAudioStreamData(stream, copied, sizeof(copied));
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_PutAudioStreamData to succeed.");
+  ret = SDL_GetAudioStreamAvailable(stream);
+  SDLTest_AssertCheck(ret == (frames + 4) * (int)sizeof(float), "Expected %d bytes available, got %d.", (frames + 4) * (int)sizeof(float), ret);
+
+  ret = SDL_GetAudioStreamData(stream, buf_out, (frames / 2) * sizeof(float));
+  SDLTest_AssertCheck(ret == (frames / 2) * (int)sizeof(float), "Expected %d bytes, got %d.", (frames / 2) * (int)sizeof(float), ret);
+  SDLTest_AssertCheck(completion.calls == 0, "Expected the buffer to still be in use, callback was called %d times.", completion.calls);
+
+  ret = SDL_GetAudioStreamData(stream, buf_out + (frames / 2), (frames - (frames / 2) + 4) * sizeof(float));
+  SDLTest_AssertCheck(ret == (frames - (frames / 2) + 4) * (int)sizeof(float), "Expected %d bytes, got %d.", (frames - (frames / 2) + 4) * (int)sizeof(float), ret);
+  SDLTest_AssertCheck(completion.calls == 1, "Expected the callback to be called once, got %d.", completion.calls);
+  SDLTest_AssertCheck(completion.buf == buf_in && completion.buflen == frames * (int)sizeof(float), "Expected the callback to get the original buffer and length.");
+  SDLTest_AssertCheck(SDL_memcmp(buf_out, buf_in, frames * sizeof(float)) == 0, "Expected the uncopied data to come out unchanged.");
+  SDLTest_AssertCheck(SDL_memcmp(buf_out + frames, copied, sizeof(copied)) == 0, "Expected the copied data to follow it.");
+
+  /* Data that never gets read is released when the stream is cleared, or destroyed. */
+  SDL_zero(completion);
+  ret = SDL_PutAudioStreamDataNoCopy(stream, buf_in, frames * sizeof(float), audio_noCopyComplete, &completion);
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_PutAudioStreamDataNoCopy to succeed.");
+  SDL_ClearAudioStream(stream);
+  SDLTest_AssertCheck(completion.calls == 1, "Expected SDL_ClearAudioStream to call the callback once, got %d.", completion.calls);
+
+  SDL_zero(completion);
+  ret = SDL_PutAudioStreamDataNoCopy(stream, buf_in, frames * sizeof(float), audio_noCopyComplete, &completion);
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_PutAudioStreamDataNoCopy to succeed.");
+  ret = SDL_PutAudioStreamDataNoCopy(stream, buf_in, 3, audio_noCopyComplete, &completion);
+  SDLTest_AssertCheck(ret == -1, "Expected SDL_PutAudioStreamDataNoCopy to fail with a partial frame, got %d.", ret);
+  SDL_DestroyAudioStream(stream);
+  SDLTest_AssertCheck(completion.calls == 1, "Expected SDL_DestroyAudioStream to call the callback once, got %d.", completion.calls);
+
+  SDL_free(buf_in);
+  SDL_free(buf_out);
+
+  return TEST_COMPLETED;
+}
+
+typedef struct
+{
+  SDL_AudioStream *stream;
+  int total_frames;
+  int chunk_frames;
+  int failures;
+} SingleProducerData;
+
+static int SDLCALL audio_singleProducerThread(void *arg)
+{
+  SingleProducerData *data = (SingleProducerData *)arg;
+  float *chunk = (float *)SDL_malloc(data->chunk_frames * sizeof(float));
+  int i, j;
+
+  if (chunk == NULL) {
+    data->failures++;
+    return 0;
+  }
+
+  for (i = 0; i < data->total_frames; i += data->chunk_frames) {
+    for (j = 0; j < data->chunk_frames; ++j) {
+      chunk[j] = (float)(i + j);
+    }
+    if (SDL_PutAudioStreamData(data->stream, chunk, data->chunk_frames * sizeof(float)) != 0) {
+      data->failures++;
+    }
+  }
+
+  SDL_free(chunk);
+  return 0;
+}
+
+static int audio_singleProducer(void *arg)
+{
+  const int total_frames = 48000;
+  const int read_frames = 333;
+  SDL_AudioSpec spec;
+  SingleProducerData data;
+  SDL_AudioStream *stream;
+  SDL_Thread *thread;
+  float *buf_out;
+  int frames_read = 0;
+  int mismatches = 0;
+  int i, ret;
+
+  spec.format = SDL_AUDIO_F32;
+  spec.channels = 1;
+  spec.freq = 48000;
+
+  /* Negative cases */
+  ret = SDL_SetAudioStreamSingleProducer(NULL, 1024);
+  SDLTest_AssertCheck(ret == -1, "Expected SDL_SetAudioStreamSingleProducer(NULL, 1024) to fail, got %d.", ret);
+
+  stream = SDL_CreateAudioStream(&spec, &spec);
+  SDLTest_AssertCheck(stream != NULL, "Expected SDL_CreateAudioStream to succeed.");
+  buf_out = (float *)SDL_malloc(read_frames * sizeof(float));
+  SDLTest_AssertCheck(buf_out != NULL, "Expected output buffer to be created.");
+  if (stream == NULL || buf_out == NULL) {
+    SDL_DestroyAudioStream(stream);
+    SDL_free(buf_out);
+    return TEST_ABORTED;
+  }
+
+  ret = SDL_SetAudioStreamSingleProducer(stream, -1);
+  SDLTest_AssertCheck(ret == -1, "Expected SDL_SetAudioStreamSingleProducer(stream, -1) to fail, got %d.", ret);
+
+  /* A small ring, so some puts have to fall back to the locked path. */
+  ret = SDL_SetAudioStreamSingleProducer(stream, 1024);
+  SDLTest_AssertPass("Call to SDL_SetAudioStreamSingleProducer(stream, 1024)");
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_SetAudioStreamSingleProducer to succeed, got %d.", ret);
+
+  data.stream = stream;
+  data.total_frames = total_frames;
+  data.chunk_frames = 100;
+  data.failures = 0;
+
+  thread = SDL_CreateThread(audio_singleProducerThread, "SingleProducer", &data);
+  SDLTest_AssertCheck(thread != NULL, "Expected SDL_CreateThread to succeed.");
+  if (thread == NULL) {
+    SDL_DestroyAudioStream(stream);
+    SDL_free(buf_out);
+    return TEST_ABORTED;
+  }
+
+  /* Read everything back while the producer is still running; it must arrive complete and in order. */
+  while (frames_read < total_frames) {
+    ret = SDL_GetAudioStreamData(stream, buf_out, read_frames * sizeof(float));
+    if (ret < 0) {
+      break;
+    }
+    for (i = 0; i < ret / (int)sizeof(float); ++i) {
+      if (buf_out[i] != (float)(frames_read + i)) {
+        mismatches++;
+      }
+    }
+    frames_read += ret / (int)sizeof(float);
+    if (ret == 0) {
+      SDL_Delay(1);
+    }
+  }
+
+  SDL_WaitThread(thread, NULL);
+
+  SDLTest_AssertCheck(data.failures == 0, "Expected every put to succeed, %d failed.", data.failures);
+  SDLTest_AssertCheck(frames_read == total_frames, "Expected %d frames, got %d.", total_frames, frames_read);
+  SDLTest_AssertCheck(mismatches == 0, "Expected the data to arrive in order, %d frames mismatched.", mismatches);
+
+  ret = SDL_GetAudioStreamAvailable(stream);
+  SDLTest_AssertCheck(ret == 0, "Expected nothing left in the stream, got %d bytes.", ret);
+
+  /* Turning it off again keeps anything still in the ring. */
+  buf_out[0] = 1.0f;
+  ret = SDL_PutAudioStreamData(stream, buf_out, sizeof(float));
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_PutAudioStreamData to succeed.");
+  ret = SDL_SetAudioStreamSingleProducer(stream, 0);
+  SDLTest_AssertCheck(ret == 0, "Expected SDL_SetAudioStreamSingleProducer(stream, 0) to succeed, got %d.", ret);
+  ret = SDL_GetAudioStreamAvailable(stream);
+  SDLTest_AssertCheck(ret == (int)sizeof(float), "Expected %d bytes available, got %d.", (int)sizeof(float), ret);
+
+  SDL_DestroyAudioStream(stream);
+  SDL_free(buf_out);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * Create and destroy batches of short-lived streams, and check their queue memory is recycled.
+ *
+ * \sa SDL_GetAudioChunkPoolStats
+ */
+static int audio_chunkPool(void *arg)
+{
+  const int num_streams = 8;
+  const int bytes_per_stream = 16 * 1024;
+  SDL_AudioStream *streams[8];
+  SDL_AudioSpec spec;
+  Uint8 *buf;
+  Sint64 misses_before = 0;
+  Sint64 hits_before = 0;
+  int round, i, ret;
+
+  spec.format = SDL_AUDIO_S16;
+  spec.channels = 2;
+  spec.freq = 44100;
+
+  buf = (Uint8 *)SDL_calloc(1, bytes_per_stream);
+  SDLTest_AssertCheck(buf != NULL, "Expected buffer to be created.");
+  if (buf == NULL) {
+    return TEST_ABORTED;
+  }
+
+  for (round = 0; round < 3; ++round) {
+    SDL_AudioChunkPoolStats stats;
+    Sint64 misses, hits;
+
+    for (i = 0; i < num_streams; ++i) {
+      streams[i] = SDL_CreateAudioStream(&spec, &spec);
+      SDLTest_AssertCheck(streams[i] != NULL, "Expected SDL_CreateAudioStream to succeed.");
+      if (streams[i] == NULL) {
+        SDL_free(buf);
+        return TEST_ABORTED;
+      }
+      ret = SDL_PutAudioStreamData(streams[i], buf, bytes_per_stream);
+      SDLTest_AssertCheck(ret == 0, "Expected SDL_PutAudioStreamData to succeed.");
+    }
+
+    ret = SDL_GetAudioChunkPoolStats(&stats);
+    SDLTest_AssertCheck(ret == 0, "Expected SDL_GetAudioChunkPoolStats to succeed.");
+    misses = (Sint64)stats.misses;
+    hits = (Sint64)stats.hits;
+    SDLTest_AssertCheck(stats.allocated_bytes >= (Uint64)(num_streams * bytes_per_stream),
+                        "Expected at least %d bytes allocated for the queued data.", num_streams * bytes_per_stream);
+
+    if (round == 0) {
+      SDLTest_AssertCheck(misses > 0, "Expected the first round to allocate chunks.");
+    } else {
+      /* The previous round's chunks should be reused, without allocating any more. */
+      SDLTest_AssertCheck(misses == misses_before, "Expected no new allocations in round %d, got %d.", round, (int)(misses - misses_before));
+      SDLTest_AssertCheck(hits > hits_before, "Expected chunks to be reused in round %d.", round);
+    }
+    misses_before = misses;
+    hits_before = hits;
+
+    /* Read half of each, then throw the streams away with the rest still queued. */
+    for (i = 0; i < num_streams; ++i) {
+      ret = SDL_GetAudioStreamData(streams[i], buf, bytes_per_stream / 2);
+      SDLTest_AssertCheck(ret == bytes_per_stream / 2, "Expected %d bytes, got %d.", bytes_per_stream / 2, ret);
+      SDL_DestroyAudioStream(streams[i]);
+    }
+  }
+
+  SDL_free(buf);
+
+  return TEST_COMPLETED;
+}
+
+/* Builds a small WAVE file in memory. */
+static Uint8 *audio_buildWave(Uint16 formattag, Uint16 channels, Uint16 bits, const Uint8 *data, Uint32 datalen, size_t *wavelen)
+{
+  const Uint32 blockalign = channels * (bits / 8);
+  const size_t len = 44 + datalen;
+  Uint8 *wave = (Uint8 *)SDL_malloc(len);
+  Uint8 *p = wave;
+
+  if (wave == NULL) {
+    return NULL;
+  }
+
+#define PUT32(v) do { Uint32 v32 = (Uint32)(v); p[0] = (Uint8)v32; p[1] = (Uint8)(v32 >> 8); p[2] = (Uint8)(v32 >> 16); p[3] = (Uint8)(v32 >> 24); p += 4; } while (0)
+#define PUT16(v) do { Uint16 v16 = (Uint16)(v); p[0] = (Uint8)v16; p[1] = (Uint8)(v16 >> 8); p += 2; } while (0)
+  SDL_memcpy(p, "RIFF", 4);
+  p += 4;
+  PUT32(36 + datalen);
+  SDL_memcpy(p, "WAVEfmt ", 8);
+  p += 8;
+  PUT32(16);
+  PUT16(formattag);
+  PUT16(channels);
+  PUT32(22050);
+  PUT32(22050 * blockalign);
+  PUT16(blockalign);
+  PUT16(bits);
+  SDL_memcpy(p, "data", 4);
+  p += 4;
+  PUT32(datalen);
+  SDL_memcpy(p, data, datalen);
+#undef PUT16
+#undef PUT32
+
+  *wavelen = len;
+  return wave;
+}
+
+/* Plays a WAVE file through a stream and checks it matches what SDL_LoadWAV_RW gives. */
+static void audio_checkWaveStream(const char *name, SDL_AudioStream *stream, const SDL_AudioSpec *spec, const Uint8 *expected, Uint32 expected_len)
+{
+  Uint8 *buf;
+  Uint32 total = 0;
+  int ret;
+
+  SDLTest_AssertCheck(stream != NULL, "%s: Expected a stream, got %s.", name, stream ? "one" : SDL_GetError());
+  if (stream == NULL) {
+    return;
+  }
+
+  buf = (Uint8 *)SDL_malloc(expected_len + 1024);
+  if (buf == NULL) {
+    SDL_DestroyAudioStream(stream);
+    return;
+  }
+
+  /* Read in odd-sized pieces, so reads don't line up with the decoder's batches. */
+  do {
+    const int want = SDL_min(3001 * SDL_AUDIO_FRAMESIZE(*spec), (int)(expected_len + 1024 - total));
+    ret = SDL_GetAudioStreamData(stream, buf + total, want);
+    if (ret > 0) {
+      total += (Uint32)ret;
+    }
+  } while (ret > 0 && total < expected_len + 1024);
+
+  SDLTest_AssertCheck(ret >= 0, "%s: Expected reads to succeed.", name);
+  SDLTest_AssertCheck(total == expected_len, "%s: Expected %u bytes, got %u.", name, (unsigned int)expected_len, (unsigned int)total);
+  SDLTest_AssertCheck(total == expected_len && SDL_memcmp(buf, expected, expected_len) == 0, "%s: Expected the same data as SDL_LoadWAV_RW.", name);
+
+  SDL_free(buf);
+  SDL_DestroyAudioStream(stream);
+}
+
+/**
+ * Stream WAVE files of various formats, and compare them to loading the whole file.
+ */
+static int audio_streamWave(void *arg)
+{
+  const struct {
+    const char *name;
+    Uint16 formattag;
+    Uint16 bits;
+  } formats[] = {
+    { "PCM 16-bit", 1, 16 },
+    { "PCM 24-bit", 1, 24 },
+    { "IEEE float", 3, 32 },
+    { "mu-law", 7, 8 },
+  };
+  const Uint32 frames = 20000; /* several decoder batches */
+  const Uint16 channels = 2;
+  Uint8 *data;
+  Uint32 i;
+  int f, ret;
+
+  data = (Uint8 *)SDL_malloc(frames * channels * 4);
+  SDLTest_AssertCheck(data != NULL, "Expected buffer to be created.");
+  if (data == NULL) {
+    return TEST_ABORTED;
+  }
+  for (i = 0; i < frames * channels * 4; ++i) {
+    data[i] = (Uint8)((i * 7) ^ (i >> 5));
+  }
+  /* Keep the float data in range. */
+  for (i = 0; i < frames * channels; ++i) {
+    data[i * 4 + 3] &= 0x3e;
+  }
+
+  for (f = 0; f < (int)SDL_arraysize(formats); ++f) {
+    const Uint32 datalen = frames * channels * (formats[f].bits / 8);
+    SDL_AudioSpec spec;
+    Uint8 *expected = NULL;
+    Uint32 expected_len = 0;
+    size_t wavelen = 0;
+    Uint8 *wave = audio_buildWave(formats[f].formattag, channels, formats[f].bits, data, datalen, &wavelen);
+
+    if (wave == NULL) {
+      continue;
+    }
+
+    ret = SDL_LoadWAV_RW(SDL_RWFromConstMem(wave, wavelen), SDL_TRUE, &spec, &expected, &expected_len);
+    SDLTest_AssertCheck(ret == 0, "%s: Expected SDL_LoadWAV_RW to succeed.", formats[f].name);
+    if (ret == 0) {
+      audio_checkWaveStream(formats[f].name, SDL_CreateAudioStreamFromWAV_RW(SDL_RWFromConstMem(wave, wavelen), SDL_TRUE, &spec), &spec, expected, expected_len);
+    }
+
+    SDL_free(expected);
+    SDL_free(wave);
+  }
+
+  SDL_free(data);
+
+  /* sample.wav is MS ADPCM. Try it from a file and from a path. */
+  {
+    SDL_AudioSpec spec;
+    Uint8 *expected = NULL;
+    Uint32 expected_len = 0;
+
+    ret = SDL_LoadWAV("sample.wav", &spec, &expected, &expected_len);
+    if (ret == 0) {
+      audio_checkWaveStream("sample.wav (file)", SDL_CreateAudioStreamFromWAV_RW(SDL_RWFromFile("sample.wav", "rb"), SDL_TRUE, &spec), &spec, expected, expected_len);
+      audio_checkWaveStream("sample.wav (path)", SDL_CreateAudioStreamFromWAV("sample.wav", &spec), &spec, expected, expected_len);
+      SDL_free(expected);
+    } else {
+      SDLTest_Log("Couldn't load sample.wav, skipping the ADPCM part: %s", SDL_GetError());
+    }
+  }
+
+  /* Negative cases */
+  SDLTest_AssertCheck(SDL_CreateAudioStreamFromWAV_RW(NULL, SDL_FALSE, NULL) == NULL, "Expected a NULL source to fail.");
+  SDLTest_AssertCheck(SDL_CreateAudioStreamFromWAV("this file does not exist.wav", NULL) == NULL, "Expected a missing file to fail.");
+
+  return TEST_COMPLETED;
+}
+
+static Uint64 audio_sumHistogram(const Uint64 *histogram)
+{
+  Uint64 total = 0;
+  int i;
+  for (i = 0; i < SDL_AUDIO_DEVICE_STATS_BUCKETS; i++) {
+    total += histogram[i];
+  }
+  return total;
+}
+
+/**
+ * Play a little audio and check the device's timing counters add up.
+ *
+ * \sa SDL_GetAudioDeviceStats
+ */
+static int audio_deviceStats(void *arg)
+{
+  SDL_AudioDeviceStats stats;
+  SDL_AudioDeviceStats default_stats;
+  SDL_AudioStream *stream = NULL;
+  SDL_AudioDeviceID devid;
+  SDL_AudioSpec spec;
+  Uint8 *buffer = NULL;
+  int frames = 0;
+  int result;
+  int i;
+
+  SDL_zero(stats);
+
+  result = SDL_GetAudioDeviceStats(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL);
+  SDLTest_AssertCheck(result < 0, "Call to SDL_GetAudioDeviceStats() with NULL stats should fail");
+  result = SDL_GetAudioDeviceStats(0, &stats);
+  SDLTest_AssertCheck(result < 0, "Call to SDL_GetAudioDeviceStats() with an invalid device should fail");
+
+  devid = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL);
+  SDLTest_AssertCheck(devid != 0, "Call to SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL)");
+  if (devid == 0) {
+    return TEST_ABORTED;
+  }
+
+  result = SDL_GetAudioDeviceFormat(devid, &spec, &frames);
+  SDLTest_AssertCheck(result == 0 && frames > 0, "Call to SDL_GetAudioDeviceFormat(), got %d sample frames", frames);
+  if (result != 0 || frames <= 0) {
+    goto cleanup;
+  }
+
+  /* one period of data, so the stream runs dry and we see short reads. */
+  buffer = (Uint8 *)SDL_calloc(frames, SDL_AUDIO_FRAMESIZE(spec));
+  stream = SDL_CreateAudioStream(&spec, &spec);
+  SDLTest_AssertCheck(buffer != NULL && stream != NULL, "Create audio stream and buffer");
+  if (!buffer || !stream) {
+    goto cleanup;
+  }
+  result = SDL_PutAudioStreamData(stream, buffer, frames * SDL_AUDIO_FRAMESIZE(spec));
+  SDLTest_AssertCheck(result == 0, "Put one period of data into the stream");
+  result = SDL_BindAudioStream(devid, stream);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_BindAudioStream()");
+
+  for (i = 0; i < 100; i++) {
+    result = SDL_GetAudioDeviceStats(devid, &stats);
+    if (result < 0 || (stats.periods >= 4 && stats.short_reads > 0)) {
+      break;
+    }
+    SDL_Delay(10);
+  }
+
+  SDLTest_AssertCheck(result == 0, "Call to SDL_GetAudioDeviceStats() on the logical device");
+  SDLTest_AssertCheck(stats.periods >= 4, "Verify the device processed some periods; got %u", (unsigned int)stats.periods);
+  SDLTest_AssertCheck(stats.period_ns == (((Uint64)frames) * SDL_NS_PER_SECOND) / spec.freq, "Verify period length; got %u ns", (unsigned int)stats.period_ns);
+  SDLTest_AssertCheck(stats.short_reads >= 1 && stats.short_reads < stats.periods, "Verify short reads once the stream ran dry; got %u", (unsigned int)stats.short_reads);
+  SDLTest_AssertCheck(audio_sumHistogram(stats.wait_to_play_histogram) == stats.periods, "Verify the wait-to-play histogram counts every period");
+  SDLTest_AssertCheck(audio_sumHistogram(stats.process_histogram) == stats.periods, "Verify the processing histogram counts every period");
+  SDLTest_AssertCheck(audio_sumHistogram(stats.interval_histogram) == stats.periods - 1, "Verify the interval histogram counts every period after the first");
+  SDLTest_AssertCheck(stats.max_wait_to_play_ns >= stats.max_process_ns, "Verify processing fits inside the wait-to-play time");
+  SDLTest_AssertCheck(stats.max_interval_ns > 0, "Verify a period interval was measured");
+
+  /* the default device ID reports the same physical device, so it can only have moved forward. */
+  result = SDL_GetAudioDeviceStats(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, &default_stats);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_GetAudioDeviceStats(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT)");
+  SDLTest_AssertCheck(default_stats.periods >= stats.periods, "Verify counters don't go backwards");
+
+cleanup:
+  SDL_DestroyAudioStream(stream);
+  SDL_free(buffer);
+  SDL_CloseAudioDevice(devid);
+
+  return TEST_COMPLETED;
+}
+
+/* Stalls the device thread, so adaptive sizing sees mixing eat the whole period. */
+static SDL_AtomicInt g_audio_stallPostmix;
+
+static void SDLCALL audio_stallPostmix(void *userdata, const SDL_AudioSpec *spec, float *buffer, int buflen)
+{
+  if (SDL_AtomicGet(&g_audio_stallPostmix)) {
+    SDL_Delay(10);
+  }
+}
+
+/**
+ * Open a device with adaptive buffer sizing, and check it starts small and grows when mixing falls behind.
+ *
+ * \sa SDL_HINT_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES
+ */
+static int audio_adaptiveSampleFrames(void *arg)
+{
+  SDL_AudioDeviceID devid;
+  SDL_AudioSpec spec;
+  int init_count = 0;
+  int default_frames = 0;
+  int initial_frames = 0;
+  int frames = 0;
+  int result;
+  int i;
+
+  /* the hint only matters when the physical device opens, so make sure nothing else has it open. */
+  while (SDL_WasInit(SDL_INIT_AUDIO)) {
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    init_count++;
+  }
+  result = SDL_InitSubSystem(SDL_INIT_AUDIO);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_InitSubSystem(SDL_INIT_AUDIO)");
+
+  /* See what size we get without the hint, first. */
+  devid = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL);
+  SDLTest_AssertCheck(devid != 0, "Call to SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL)");
+  if (devid == 0) {
+    goto cleanup;
+  }
+  SDL_GetAudioDeviceFormat(devid, &spec, &default_frames);
+  SDL_CloseAudioDevice(devid);
+
+  SDL_SetHint(SDL_HINT_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES, "1");
+  devid = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL);
+  SDLTest_AssertCheck(devid != 0, "Call to SDL_OpenAudioDevice() with SDL_HINT_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES=1");
+  if (devid == 0) {
+    goto cleanup;
+  }
+
+  result = SDL_GetAudioDeviceFormat(devid, &spec, &initial_frames);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_GetAudioDeviceFormat()");
+  SDLTest_AssertCheck(initial_frames == SDL_max(default_frames / 8, 32), "Verify the device starts small; expected %d frames, got %d", SDL_max(default_frames / 8, 32), initial_frames);
+
+  SDL_AtomicSet(&g_audio_stallPostmix, 1);
+  result = SDL_SetAudioPostmixCallback(devid, audio_stallPostmix, NULL);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_SetAudioPostmixCallback()");
+
+  frames = initial_frames;
+  for (i = 0; (i < 200) && (frames <= initial_frames); i++) {
+    SDL_Delay(10);
+    SDL_GetAudioDeviceFormat(devid, &spec, &frames);
+  }
+  SDL_AtomicSet(&g_audio_stallPostmix, 0);
+
+  SDLTest_AssertCheck(frames > initial_frames, "Verify the buffer grew when mixing fell behind; got %d frames", frames);
+  SDLTest_AssertCheck(frames <= default_frames, "Verify the buffer didn't grow past the usual size; got %d frames", frames);
+
+  SDL_CloseAudioDevice(devid);
+
+  /* An explicit buffer size from the app wins. */
+  SDL_SetHint(SDL_HINT_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES, "1");
+  SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, "777");
+  devid = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL);
+  SDLTest_AssertCheck(devid != 0, "Call to SDL_OpenAudioDevice() with both hints set");
+  if (devid != 0) {
+    SDL_GetAudioDeviceFormat(devid, &spec, &frames);
+    SDLTest_AssertCheck(frames == 777, "Verify SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES overrides adaptive sizing; got %d frames", frames);
+    SDL_CloseAudioDevice(devid);
+  }
+
+cleanup:
+  SDL_ResetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES);
+  SDL_ResetHint(SDL_HINT_AUDIO_DEVICE_ADAPTIVE_SAMPLE_FRAMES);
+  SDL_QuitSubSystem(SDL_INIT_AUDIO);
+  while (init_count-- > 0) {
+    audioSetUp(NULL);
+  }
+
+  return TEST_COMPLETED;
+}
+
+/* Counts postmix callbacks, so we can tell a device is being serviced. */
+static void SDLCALL audio_countPostmix(void *userdata, const SDL_AudioSpec *spec, float *buffer, int buflen)
+{
+  SDL_AtomicIncRef((SDL_AtomicInt *)userdata);
+}
+
+/**
+ * Open an output and a capture device with shared device threads, and check both keep getting serviced.
+ *
+ * \sa SDL_HINT_AUDIO_SHARED_DEVICE_THREADS
+ */
+static int audio_sharedDeviceThreads(void *arg)
+{
+  SDL_AudioDeviceID output = 0;
+  SDL_AudioDeviceID capture = 0;
+  SDL_AudioStream *stream = NULL;
+  SDL_AudioSpec spec;
+  SDL_AtomicInt output_count;
+  SDL_AtomicInt capture_count;
+  float silence[4096];
+  int init_count = 0;
+  int queued;
+  int result;
+  int i;
+
+  SDL_AtomicSet(&output_count, 0);
+  SDL_AtomicSet(&capture_count, 0);
+  SDL_zeroa(silence);
+
+  /* the hint is checked at init, so restart the subsystem with it set. */
+  while (SDL_WasInit(SDL_INIT_AUDIO)) {
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    init_count++;
+  }
+  SDL_SetHint(SDL_HINT_AUDIO_SHARED_DEVICE_THREADS, "1");
+  result = SDL_InitSubSystem(SDL_INIT_AUDIO);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_InitSubSystem(SDL_INIT_AUDIO) with SDL_HINT_AUDIO_SHARED_DEVICE_THREADS=1");
+
+  output = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL);
+  SDLTest_AssertCheck(output != 0, "Call to SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL)");
+  capture = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_CAPTURE, NULL);
+  SDLTest_AssertCheck(capture != 0, "Call to SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_CAPTURE, NULL)");
+  if ((output == 0) || (capture == 0)) {
+    goto cleanup;
+  }
+
+  result = SDL_SetAudioPostmixCallback(output, audio_countPostmix, &output_count);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_SetAudioPostmixCallback(output)");
+  result = SDL_SetAudioPostmixCallback(capture, audio_countPostmix, &capture_count);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_SetAudioPostmixCallback(capture)");
+
+  spec.format = SDL_AUDIO_F32;
+  spec.channels = 1;
+  spec.freq = 48000;
+  stream = SDL_CreateAudioStream(&spec, NULL);
+  SDLTest_AssertCheck(stream != NULL, "Call to SDL_CreateAudioStream()");
+  if (stream == NULL) {
+    goto cleanup;
+  }
+  result = SDL_BindAudioStream(output, stream);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_BindAudioStream(output)");
+  result = SDL_PutAudioStreamData(stream, silence, sizeof(silence));
+  SDLTest_AssertCheck(result == 0, "Call to SDL_PutAudioStreamData()");
+  result = SDL_FlushAudioStream(stream);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_FlushAudioStream()");
+
+  for (i = 0; i < 200; i++) {
+    if ((SDL_AtomicGet(&output_count) >= 4) && (SDL_AtomicGet(&capture_count) >= 4) && (SDL_GetAudioStreamQueued(stream) == 0)) {
+      break;
+    }
+    SDL_Delay(10);
+  }
+
+  SDLTest_AssertCheck(SDL_AtomicGet(&output_count) >= 4, "Verify the output device was serviced; %d postmix calls", SDL_AtomicGet(&output_count));
+  SDLTest_AssertCheck(SDL_AtomicGet(&capture_count) >= 4, "Verify the capture device was serviced; %d postmix calls", SDL_AtomicGet(&capture_count));
+  queued = SDL_GetAudioStreamQueued(stream);
+  SDLTest_AssertCheck(queued == 0, "Verify the bound stream was drained; %d bytes left", queued);
+
+  /* once closed, the shared thread must leave the output device alone, while the capture device keeps going. */
+  SDL_DestroyAudioStream(stream);
+  stream = NULL;
+  SDL_CloseAudioDevice(output);
+  output = 0;
+  result = SDL_AtomicGet(&output_count);
+  SDL_AtomicSet(&capture_count, 0);
+  SDL_Delay(100);
+  SDLTest_AssertCheck(SDL_AtomicGet(&output_count) == result, "Verify a closed device isn't serviced anymore");
+  SDLTest_AssertCheck(SDL_AtomicGet(&capture_count) > 0, "Verify the remaining device is still serviced; %d postmix calls", SDL_AtomicGet(&capture_count));
+
+cleanup:
+  SDL_DestroyAudioStream(stream);
+  if (output != 0) {
+    SDL_CloseAudioDevice(output);
+  }
+  if (capture != 0) {
+    SDL_CloseAudioDevice(capture);
+  }
+  SDL_QuitSubSystem(SDL_INIT_AUDIO);
+  SDL_ResetHint(SDL_HINT_AUDIO_SHARED_DEVICE_THREADS);
+  while (init_count-- > 0) {
+    audioSetUp(NULL);
+  }
+
+  return TEST_COMPLETED;
+}
+
+/* Keeps copies of the first few postmix buffers, to check what the device mixed. */
+#define AUDIO_GAINS_BUFFERS 4
+static float g_audio_gainsBuffers[AUDIO_GAINS_BUFFERS][8192];
+static int g_audio_gainsBufferLen;
+static SDL_AtomicInt g_audio_gainsBufferCount;
+
+static void SDLCALL audio_gainsPostmix(void *userdata, const SDL_AudioSpec *spec, float *buffer, int buflen)
+{
+  const int i = SDL_AtomicGet(&g_audio_gainsBufferCount);
+  if (i < AUDIO_GAINS_BUFFERS && buflen <= (int)sizeof(g_audio_gainsBuffers[i])) {
+    SDL_memcpy(g_audio_gainsBuffers[i], buffer, buflen);
+    g_audio_gainsBufferLen = buflen;
+    SDL_AtomicSet(&g_audio_gainsBufferCount, i + 1);
+  }
+}
+
+/**
+ * Set a stream's gain and channel gains, and check the device mix ramps to them.
+ *
+ * \sa SDL_SetAudioStreamGain
+ * \sa SDL_SetAudioStreamChannelGains
+ */
+static int audio_streamGains(void *arg)
+{
+  const float gain = 0.5f;
+  const float pan[2] = { 1.0f, 0.25f };
+  SDL_AudioDeviceID devid;
+  SDL_AudioStream *stream;
+  SDL_AudioSpec spec;
+  float gains[2];
+  float *data;
+  float expected, maxerr;
+  int num_frames, frames, channels;
+  int result;
+  int i, j;
+
+  /* some invalid calls first. */
+  result = SDL_SetAudioStreamGain(NULL, 1.0f);
+  SDLTest_AssertCheck(result == -1, "Verify SDL_SetAudioStreamGain(NULL) fails");
+  SDLTest_AssertCheck(SDL_GetAudioStreamGain(NULL) == -1.0f, "Verify SDL_GetAudioStreamGain(NULL) fails");
+
+  devid = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL);
+  SDLTest_AssertCheck(devid != 0, "Call to SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_OUTPUT, NULL)");
+  if (devid == 0) {
+    return TEST_ABORTED;
+  }
+  SDL_GetAudioDeviceFormat(devid, &spec, NULL);
+  channels = spec.channels;
+  if (channels < 2) {
+    SDLTest_Log("Default device is mono; skipping.");
+    SDL_CloseAudioDevice(devid);
+    return TEST_SKIPPED;
+  }
+
+  /* feed the stream at the device's own rate, so the only change to the data is the gains. */
+  spec.format = SDL_AUDIO_F32;
+  stream = SDL_CreateAudioStream(&spec, &spec);
+  SDLTest_AssertCheck(stream != NULL, "Call to SDL_CreateAudioStream()");
+  if (stream == NULL) {
+    SDL_CloseAudioDevice(devid);
+    return TEST_ABORTED;
+  }
+
+  SDLTest_AssertCheck(SDL_GetAudioStreamGain(stream) == 1.0f, "Verify a new stream has a gain of 1.0");
+  result = SDL_SetAudioStreamGain(stream, -1.0f);
+  SDLTest_AssertCheck(result == -1, "Verify SDL_SetAudioStreamGain() rejects a negative gain");
+  result = SDL_SetAudioStreamChannelGains(stream, pan, 9);
+  SDLTest_AssertCheck(result == -1, "Verify SDL_SetAudioStreamChannelGains() rejects 9 channels");
+
+  result = SDL_SetAudioStreamGain(stream, gain);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_SetAudioStreamGain(%f)", gain);
+  SDLTest_AssertCheck(SDL_GetAudioStreamGain(stream) == gain, "Verify SDL_GetAudioStreamGain() returns what was set");
+  result = SDL_SetAudioStreamChannelGains(stream, pan, 2);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_SetAudioStreamChannelGains()");
+  result = SDL_GetAudioStreamChannelGains(stream, gains, 2);
+  SDLTest_AssertCheck(result == 0 && gains[0] == pan[0] && gains[1] == pan[1], "Verify SDL_GetAudioStreamChannelGains() returns what was set");
+
+  num_frames = spec.freq;  /* one second is plenty. */
+  data = (float *)SDL_malloc(num_frames * channels * sizeof(float));
+  SDLTest_AssertCheck(data != NULL, "Allocate test data");
+  if (data == NULL) {
+    SDL_DestroyAudioStream(stream);
+    SDL_CloseAudioDevice(devid);
+    return TEST_ABORTED;
+  }
+  for (i = 0; i < num_frames * channels; i++) {
+    data[i] = 1.0f;
+  }
+  result = SDL_PutAudioStreamData(stream, data, num_frames * channels * (int)sizeof(float));
+  SDLTest_AssertCheck(result == 0, "Call to SDL_PutAudioStreamData()");
+  SDL_free(data);
+
+  /* pause while setting up, so the first buffer the postmix callback sees has the stream in it. */
+  SDL_AtomicSet(&g_audio_gainsBufferCount, 0);
+  SDL_PauseAudioDevice(devid);
+  SDL_SetAudioPostmixCallback(devid, audio_gainsPostmix, NULL);
+  result = SDL_BindAudioStream(devid, stream);
+  SDLTest_AssertCheck(result == 0, "Call to SDL_BindAudioStream()");
+  SDL_ResumeAudioDevice(devid);
+
+  for (i = 0; (i < 200) && (SDL_AtomicGet(&g_audio_gainsBufferCount) < 2); i++) {
+    SDL_Delay(10);
+  }
+  SDL_DestroyAudioStream(stream);
+  SDL_CloseAudioDevice(devid);
+
+  SDLTest_AssertCheck(SDL_AtomicGet(&g_audio_gainsBufferCount) >= 2, "Verify the device mixed at least two buffers");
+  if (SDL_AtomicGet(&g_audio_gainsBufferCount) < 2) {
+    return TEST_ABORTED;
+  }
+
+  /* The first buffer ramps from unity to the new gains, and the second one is all the way there. */
+  frames = g_audio_gainsBufferLen / (channels * (int)sizeof(float));
+  maxerr = 0.0f;
+  for (i = 0; i < frames; i++) {
+    for (j = 0; j < channels; j++) {
+      const float target = gain * ((j < 2) ? pan[j] : 1.0f);
+      expected = 1.0f + (((target - 1.0f) * i) / frames);
+      maxerr = SDL_max(maxerr, SDL_fabsf(g_audio_gainsBuffers[0][(i * channels) + j] - expected));
+    }
+  }
+  SDLTest_AssertCheck(maxerr < 0.0001f, "Verify the first buffer ramps to the new gains; max error %f", maxerr);
+
+  maxerr = 0.0f;
+  for (i = 0; i < frames; i++) {
+    for (j = 0; j < channels; j++) {
+      expected = gain * ((j < 2) ? pan[j] : 1.0f);
+      maxerr = SDL_max(maxerr, SDL_fabsf(g_audio_gainsBuffers[1][(i * channels) + j] - expected));
+    }
+  }
+  SDLTest_AssertCheck(maxerr < 0.0001f, "Verify the second buffer is scaled by the new gains; max error %f", maxerr);
+
+  return TEST_COMPLETED;
+}
+
+typedef struct GetCallbackBatchingData
+{
+  SDL_AtomicInt calls;
+  int min_additional;
+  SDL_threadID thread;
+} GetCallbackBatchingData;
+
+static void SDLCALL batching_get_callback(void *userdata, SDL_AudioStream *stream, int additional_amount, int total_amount)
+{
+  GetCallbackBatchingData *data = (GetCallbackBatchingData *)userdata;
+  static const Uint8 silence[8192];
+  int amount = SDL_min(additional_amount, (int)sizeof(silence));
+
+  (void)total_amount;
+  if (SDL_AtomicGet(&data->calls) == 0 || additional_amount < data->min_additional) {
+    data->min_additional = additional_amount;
+  }
+  data->thread = SDL_ThreadID();
+  SDL_PutAudioStreamData(stream, silence, amount);
+  SDL_AtomicIncRef(&data->calls);
+}
+
+/**
+ * Check batched and async get callbacks, and the queue watermark events.
+ *
+ * \sa SDL_SetAudioStreamGetCallback
+ * \sa SDL_GetAudioStreamProperties
+ */
+static int audio_getCallbackBatching(void *arg)
+{
+  const SDL_AudioSpec spec = { SDL_AUDIO_S16, 1, 8000 };
+  static Uint8 buf[4000];
+  GetCallbackBatchingData data;
+  SDL_AudioStream *stream;
+  SDL_PropertiesID props;
+  SDL_Event events[4];
+  int result;
+  int i;
+
+  /* a quantum: the callback should be asked for a big batch once, not topped up on every small read. */
+  stream = SDL_CreateAudioStream(&spec, &spec);
+  SDLTest_AssertCheck(stream != NULL, "Call to SDL_CreateAudioStream()");
+  if (stream == NULL) {
+    return TEST_ABORTED;
+  }
+  props = SDL_GetAudioStreamProperties(stream);
+  SDL_SetNumberProperty(props, "SDL.audiostream.get_callback.quantum", 4096);
+  SDL_zero(data);
+  SDL_SetAudioStreamGetCallback(stream, batching_get_callback, &data);
+  for (i = 0; i < 20; i++) {
+    result = SDL_GetAudioStreamData(stream, buf, 100);
+    SDLTest_AssertCheck(result == 100, "Read %d: expected 100 bytes, got %d", i, result);
+  }
+  SDLTest_AssertCheck(SDL_AtomicGet(&data.calls) == 1, "Verify the callback ran once (ran %d times)", SDL_AtomicGet(&data.calls));
+  SDLTest_AssertCheck(data.min_additional >= 4096, "Verify the callback was asked for at least the quantum (asked for %d)", data.min_additional);
+  SDLTest_AssertCheck(data.thread == SDL_ThreadID(), "Verify the callback ran on the reading thread");
+  SDL_DestroyAudioStream(stream);
+
+  /* async with a prefetch amount: the callback runs on another thread and keeps the queue topped up. */
+  stream = SDL_CreateAudioStream(&spec, &spec);
+  SDLTest_AssertCheck(stream != NULL, "Call to SDL_CreateAudioStream()");
+  if (stream == NULL) {
+    return TEST_ABORTED;
+  }
+  props = SDL_GetAudioStreamProperties(stream);
+  SDL_SetNumberProperty(props, "SDL.audiostream.get_callback.prefetch", 8000);
+  SDL_SetBooleanProperty(props, "SDL.audiostream.get_callback.async", SDL_TRUE);
+  SDL_zero(data);
+  SDL_SetAudioStreamGetCallback(stream, batching_get_callback, &data);
+  result = SDL_GetAudioStreamData(stream, buf, 100);
+  SDLTest_AssertCheck(result >= 0, "Call to SDL_GetAudioStreamData() on an empty async stream");
+  for (i = 0; (i < 500) && (SDL_GetAudioStreamQueued(stream) < 8000); i++) {
+    SDL_Delay(10);
+  }
+  SDLTest_AssertCheck(SDL_GetAudioStreamQueued(stream) >= 8000, "Verify the queue was filled to the prefetch amount (%d bytes queued)", SDL_GetAudioStreamQueued(stream));
+  SDLTest_AssertCheck(SDL_AtomicGet(&data.calls) >= 1, "Verify the callback ran");
+  SDL_DestroyAudioStream(stream);
+  /* the callback can't run anymore once the stream is gone, so data.thread is safe to look at now. */
+  SDLTest_AssertCheck(data.thread != SDL_ThreadID(), "Verify the callback ran on a different thread");
+
+  /* watermarks: one event per crossing. */
+  SDL_PumpEvents();
+  SDL_FlushEvents(SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK, SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK);
+  stream = SDL_CreateAudioStream(&spec, &spec);
+  SDLTest_AssertCheck(stream != NULL, "Call to SDL_CreateAudioStream()");
+  if (stream == NULL) {
+    return TEST_ABORTED;
+  }
+  props = SDL_GetAudioStreamProperties(stream);
+  SDL_SetNumberProperty(props, "SDL.audiostream.low_watermark", 1000);
+  SDL_SetNumberProperty(props, "SDL.audiostream.high_watermark", 4000);
+  SDL_PutAudioStreamData(stream, buf, 2000);
+  SDL_PutAudioStreamData(stream, buf, 2000);
+  SDL_GetAudioStreamData(stream, buf, 1000);
+  SDL_GetAudioStreamData(stream, buf, 2500);
+  SDL_PumpEvents();
+  result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK, SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK);
+  SDLTest_AssertCheck(result == 2, "Verify two watermark events were sent (got %d)", result);
+  if (result == 2) {
+    SDLTest_AssertCheck(events[0].type == SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK, "Verify the first event is a high watermark");
+    SDLTest_AssertCheck(events[0].astream.stream == stream, "Verify the first event is for our stream");
+    SDLTest_AssertCheck(events[0].astream.queued == 4000, "Verify 4000 bytes were queued (got %d)", events[0].astream.queued);
+    SDLTest_AssertCheck(events[1].type == SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK, "Verify the second event is a low watermark");
+    SDLTest_AssertCheck(events[1].astream.queued == 500, "Verify 500 bytes were queued (got %d)", events[1].astream.queued);
+  }
+
+  /* events that haven't been sent yet are dropped when the stream is destroyed. */
+  SDL_PutAudioStreamData(stream, buf, 4000);
+  SDL_DestroyAudioStream(stream);
+  SDL_PumpEvents();
+  result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_EVENT_AUDIO_STREAM_LOW_WATERMARK, SDL_EVENT_AUDIO_STREAM_HIGH_WATERMARK);
+  SDLTest_AssertCheck(result == 0, "Verify no events were sent for a destroyed stream (got %d)", result);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test Case References ================== */
 
 /* Audio test cases */
@@ -1326,12 +2565,61 @@ static const SDLTest_TestCaseReference audioTest18 = {
     audio_formatChange, "audio_formatChange", "Check handling of format changes.", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference audioTest19 = {
+    audio_parallelMix, "audio_parallelMix", "Mix several streams on the mixing thread pool.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest20 = {
+    audio_resamplerQuality, "audio_resamplerQuality", "Check each resampler quality tier, switching tiers mid-stream.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest21 = {
+    audio_convertPlanChange, "audio_convertPlanChange", "Change a stream's output format while it has data queued.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest22 = {
+    audio_putNoCopy, "audio_putNoCopy", "Queue data without copying it, and check when the stream gives it back.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest23 = {
+    audio_singleProducer, "audio_singleProducer", "Feed a stream from a single producer thread while reading it concurrently.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest24 = {
+    audio_chunkPool, "audio_chunkPool", "Check that queue memory is recycled between short-lived streams.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest25 = {
+    audio_streamWave, "audio_streamWave", "Stream WAVE files through an audio stream, decoding as needed.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest26 = {
+    audio_deviceStats, "audio_deviceStats", "Check an audio device's timing counters.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest27 = {
+    audio_adaptiveSampleFrames, "audio_adaptiveSampleFrames", "Check adaptive device buffer sizing.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest28 = {
+    audio_sharedDeviceThreads, "audio_sharedDeviceThreads", "Check several devices driven by a shared device thread.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest29 = {
+    audio_streamGains, "audio_streamGains", "Check per-stream gain and channel gains in the device mix.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference audioTest30 = {
+    audio_getCallbackBatching, "audio_getCallbackBatching", "Check batched and async get callbacks, and queue watermark events.", TEST_ENABLED
+};
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] = {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
     &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16,
-    &audioTest17, &audioTest18, NULL
+    &audioTest17, &audioTest18, &audioTest19, &audioTest20, &audioTest21, &audioTest22,
+    &audioTest23, &audioTest24, &audioTest25, &audioTest26, &audioTest27, &audioTest28, &audioTest29, &audioTest30, NULL
 };
 
 /* Audio test suite (global) */
@@ -1,6 +1,8 @@
 /**
  * Events test suite
  */
+#include <stdio.h>
+
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_test.h>
 #include "testautomation_suites.h"
@@ -175,6 +177,266 @@ static int events_addDelEventWatchWithUserdata(void *arg)
     return TEST_COMPLETED;
 }
 
+/**
+ * Pushes several user events and retrieves them in one call.
+ *
+ * \sa SDL_PollEvents
+ */
+static int events_pushAndPollEvents(void *arg)
+{
+    SDL_Event events[8];
+    SDL_Event event;
+    int i, result, received = 0;
+
+    /* Make sure the queue is empty */
+    while (SDL_PollEvent(&event)) {
+    }
+
+    for (i = 0; i < 5; ++i) {
+        SDL_zero(event);
+        event.type = SDL_EVENT_USER;
+        event.user.code = i;
+        SDL_PushEvent(&event);
+    }
+    SDLTest_AssertPass("Call to SDL_PushEvent()");
+
+    /* Retrieve them with a buffer that is too small for all of them */
+    do {
+        result = SDL_PollEvents(events, 2);
+        SDLTest_AssertPass("Call to SDL_PollEvents()");
+        SDLTest_AssertCheck(result >= 0 && result <= 2, "Check result from SDL_PollEvents, expected: 0-2, got: %d", result);
+        for (i = 0; i < result; ++i) {
+            if (events[i].type == SDL_EVENT_USER) {
+                SDLTest_AssertCheck(events[i].user.code == received, "Check event order, expected: %d, got: %d", received, (int)events[i].user.code);
+                ++received;
+            }
+        }
+    } while (result == 2);
+    SDLTest_AssertCheck(received == 5, "Check number of user events, expected: 5, got: %d", received);
+
+    result = SDL_PollEvents(events, SDL_arraysize(events));
+    SDLTest_AssertCheck(result == 0, "Check result from SDL_PollEvents on empty queue, expected: 0, got: %d", result);
+
+    result = SDL_PollEvents(NULL, 1);
+    SDLTest_AssertCheck(result < 0, "Check result from SDL_PollEvents with NULL events, expected: <0, got: %d", result);
+
+    return TEST_COMPLETED;
+}
+
+/* Counts calls and removes both watchers from inside the first one */
+static int g_watcherCalls[2];
+
+static int SDLCALL events_countingEventWatch(void *userdata, SDL_Event *event)
+{
+    ++g_watcherCalls[*(int *)userdata - 1];
+    return 0;
+}
+
+static int SDLCALL events_removingEventWatch(void *userdata, SDL_Event *event)
+{
+    events_countingEventWatch(userdata, event);
+    SDL_DelEventWatch(events_removingEventWatch, userdata);
+    SDL_DelEventWatch(events_countingEventWatch, (void *)&g_userdataValue2);
+    return 0;
+}
+
+/**
+ * Test removing event watchers from inside an event watcher.
+ *
+ * \sa SDL_AddEventWatch
+ * \sa SDL_DelEventWatch
+ */
+static int events_delEventWatchDuringDispatch(void *arg)
+{
+    SDL_Event event;
+
+    SDL_zero(event);
+    event.type = SDL_EVENT_USER;
+    g_watcherCalls[0] = 0;
+    g_watcherCalls[1] = 0;
+
+    SDL_AddEventWatch(events_removingEventWatch, (void *)&g_userdataValue1);
+    SDL_AddEventWatch(events_countingEventWatch, (void *)&g_userdataValue2);
+    SDLTest_AssertPass("Call to SDL_AddEventWatch()");
+
+    SDL_PushEvent(&event);
+    SDLTest_AssertPass("Call to SDL_PushEvent()");
+    SDLTest_AssertCheck(g_watcherCalls[0] == 1, "Check that the first watcher was called, expected: 1, got: %d", g_watcherCalls[0]);
+    SDLTest_AssertCheck(g_watcherCalls[1] == 0, "Check that the removed watcher was skipped, expected: 0, got: %d", g_watcherCalls[1]);
+
+    SDL_PushEvent(&event);
+    SDLTest_AssertCheck(g_watcherCalls[0] == 1 && g_watcherCalls[1] == 0, "Check that no watchers are called after removal, got: %d, %d", g_watcherCalls[0], g_watcherCalls[1]);
+
+    SDL_FlushEvent(SDL_EVENT_USER);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * Test that event memory is recycled without heap allocations in steady state.
+ *
+ * \sa SDL_AllocateEventMemory
+ * \sa SDL_GetEventMemoryStats
+ */
+static int events_eventMemoryRecycling(void *arg)
+{
+    SDL_EventMemoryStats before, after;
+    SDL_Event event;
+    int i, result;
+
+    /* Make sure the queue is empty */
+    while (SDL_PollEvent(&event)) {
+    }
+
+    /* Warm up the arena */
+    for (i = 0; i < 100; ++i) {
+        SDL_zero(event);
+        event.type = SDL_EVENT_USER;
+        event.user.data1 = SDL_AllocateEventMemory(64);
+        SDL_PushEvent(&event);
+        while (SDL_PollEvent(&event)) {
+        }
+    }
+
+    result = SDL_GetEventMemoryStats(&before);
+    SDLTest_AssertPass("Call to SDL_GetEventMemoryStats()");
+    SDLTest_AssertCheck(result == 0, "Check result from SDL_GetEventMemoryStats, expected: 0, got: %d", result);
+
+    for (i = 0; i < 1000; ++i) {
+        char *text = (char *)SDL_AllocateEventMemory(1 + i % 200);
+        SDLTest_AssertCheck(text != NULL, "Check result from SDL_AllocateEventMemory, expected: non-NULL");
+        SDLTest_AssertCheck(((uintptr_t)text % sizeof(void *)) == 0, "Check alignment of event memory");
+        if (!text) {
+            break;
+        }
+        SDL_memset(text, 'x', 1 + i % 200);
+
+        SDL_zero(event);
+        event.type = SDL_EVENT_USER;
+        event.user.data1 = text;
+        SDL_PushEvent(&event);
+        while (SDL_PollEvent(&event)) {
+        }
+    }
+
+    SDL_GetEventMemoryStats(&after);
+    SDLTest_AssertCheck(after.allocations - before.allocations == 1000, "Check number of allocations, expected: 1000, got: %d", (int)(after.allocations - before.allocations));
+    SDLTest_AssertCheck(after.heap_allocations == before.heap_allocations, "Check that no heap allocations were made, expected: %d, got: %d", (int)before.heap_allocations, (int)after.heap_allocations);
+
+    /* Memory of events that are still queued must survive pumping events */
+    for (i = 0; i < 4; ++i) {
+        char *text = (char *)SDL_AllocateEventMemory(64);
+        SDLTest_AssertCheck(text != NULL, "Check result from SDL_AllocateEventMemory, expected: non-NULL");
+        if (!text) {
+            break;
+        }
+        SDL_memset(text, 'a' + i, 64);
+
+        SDL_zero(event);
+        event.type = SDL_EVENT_USER;
+        event.user.code = i;
+        event.user.data1 = text;
+        SDL_PushEvent(&event);
+        SDL_PumpEvents();
+        SDLTest_AssertPass("Call to SDL_PumpEvents() with %d events queued", i + 1);
+    }
+    for (i = 0; i < 4; ++i) {
+        char *text = (char *)SDL_AllocateEventMemory(64);
+        if (text) {
+            SDL_memset(text, 'z', 64);
+        }
+    }
+    for (i = 0; SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_EVENT_USER, SDL_EVENT_USER) == 1; ++i) {
+        const char *text = (const char *)event.user.data1;
+        SDLTest_AssertCheck(text[0] == 'a' + event.user.code && text[63] == 'a' + event.user.code,
+                            "Check queued event memory, expected: '%c', got: '%c'", 'a' + event.user.code, text[0]);
+        SDL_PumpEvents();
+    }
+    SDLTest_AssertCheck(i == 4, "Check number of queued events, expected: 4, got: %d", i);
+
+    result = SDL_GetEventMemoryStats(NULL);
+    SDLTest_AssertCheck(result < 0, "Check result from SDL_GetEventMemoryStats with NULL stats, expected: <0, got: %d", result);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * Test recording events to a file and replaying them.
+ *
+ * \sa SDLTest_StartEventRecording
+ * \sa SDLTest_OpenEventReplay
+ */
+static int events_recordAndReplay(void *arg)
+{
+    static const char *filename = "events_recording";
+    SDLTest_EventRecorder *recorder;
+    SDLTest_EventReplay *replay;
+    SDL_Event event;
+    char *text;
+    int i, result, received = 0;
+
+    /* Make sure the queue is empty */
+    while (SDL_PollEvent(&event)) {
+    }
+
+    recorder = SDLTest_StartEventRecording(filename);
+    SDLTest_AssertCheck(recorder != NULL, "Check result from SDLTest_StartEventRecording, expected: non-NULL");
+    if (!recorder) {
+        return TEST_ABORTED;
+    }
+
+    for (i = 0; i < 3; ++i) {
+        SDL_zero(event);
+        event.type = SDL_EVENT_USER;
+        event.user.code = i;
+        event.user.data1 = (void *)&g_userdataValue1;
+        SDL_PushEvent(&event);
+    }
+    SDL_zero(event);
+    event.type = SDL_EVENT_DROP_FILE;
+    event.drop.x = 12.0f;
+    text = (char *)SDL_AllocateEventMemory(16);
+    SDL_strlcpy(text, "dropped.txt", 16);
+    event.drop.data = text;
+    SDL_PushEvent(&event);
+
+    result = SDLTest_StopEventRecording(recorder);
+    SDLTest_AssertPass("Call to SDLTest_StopEventRecording()");
+    SDLTest_AssertCheck(result == 4, "Check number of events recorded, expected: 4, got: %d", result);
+
+    while (SDL_PollEvent(&event)) {
+    }
+
+    replay = SDLTest_OpenEventReplay(filename, 0.0f);
+    SDLTest_AssertCheck(replay != NULL, "Check result from SDLTest_OpenEventReplay, expected: non-NULL");
+    if (!replay) {
+        (void)remove(filename);
+        return TEST_ABORTED;
+    }
+    result = SDLTest_UpdateEventReplay(replay);
+    SDLTest_AssertCheck(result == 4, "Check number of events replayed, expected: 4, got: %d", result);
+    SDLTest_AssertCheck(SDLTest_IsEventReplayDone(replay), "Check that the replay is done");
+    SDLTest_CloseEventReplay(replay);
+
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_EVENT_USER) {
+            SDLTest_AssertCheck(event.user.code == received, "Check event order, expected: %d, got: %d", received, (int)event.user.code);
+            SDLTest_AssertCheck(event.user.data1 == NULL, "Check that user data pointers are not replayed");
+            ++received;
+        } else if (event.type == SDL_EVENT_DROP_FILE) {
+            SDLTest_AssertCheck(event.drop.x == 12.0f, "Check drop position, expected: 12, got: %g", event.drop.x);
+            SDLTest_AssertCheck(event.drop.data && SDL_strcmp(event.drop.data, "dropped.txt") == 0,
+                                "Check drop data, expected: dropped.txt, got: %s", event.drop.data ? event.drop.data : "NULL");
+            ++received;
+        }
+    }
+    SDLTest_AssertCheck(received == 4, "Check number of events received, expected: 4, got: %d", received);
+
+    (void)remove(filename);
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Events test cases */
@@ -190,9 +452,25 @@ static const SDLTest_TestCaseReference eventsTest3 = {
     (SDLTest_TestCaseFp)events_addDelEventWatchWithUserdata, "events_addDelEventWatchWithUserdata", "Adds and deletes an event watch function with userdata", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference eventsTest4 = {
+    (SDLTest_TestCaseFp)events_pushAndPollEvents, "events_pushAndPollEvents", "Pushes several user events and polls them in batches", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference eventsTest5 = {
+    (SDLTest_TestCaseFp)events_delEventWatchDuringDispatch, "events_delEventWatchDuringDispatch", "Removes event watchers from inside an event watcher", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference eventsTest6 = {
+    (SDLTest_TestCaseFp)events_eventMemoryRecycling, "events_eventMemoryRecycling", "Allocates event memory in a loop and checks that it is recycled", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference eventsTest7 = {
+    (SDLTest_TestCaseFp)events_recordAndReplay, "events_recordAndReplay", "Records events to a file and replays them", TEST_ENABLED
+};
+
 /* Sequence of Events test cases */
 static const SDLTest_TestCaseReference *eventsTests[] = {
-    &eventsTest1, &eventsTest2, &eventsTest3, NULL
+    &eventsTest1, &eventsTest2, &eventsTest3, &eventsTest4, &eventsTest5, &eventsTest6, &eventsTest7, NULL
 };
 
 /* Events test suite (global) */
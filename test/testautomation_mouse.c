@@ -488,6 +488,83 @@ static int mouse_warpMouseInWindow(void *arg)
     return TEST_COMPLETED;
 }
 
+/* Counts motion events and scales them, like a renderer mapping them to its own coordinates */
+static int SDLCALL mouse_scaleMotionWatch(void *userdata, SDL_Event *event)
+{
+    if (event->type == SDL_EVENT_MOUSE_MOTION) {
+        ++*(int *)userdata;
+        event->motion.x *= 2.0f;
+        event->motion.y *= 2.0f;
+        event->motion.xrel *= 2.0f;
+        event->motion.yrel *= 2.0f;
+    }
+    return 1;
+}
+
+/**
+ * Check that consecutive motion is merged when SDL_HINT_MOUSE_COALESCE_MOTION is set
+ *
+ * \sa SDL_HINT_MOUSE_COALESCE_MOTION
+ * \sa SDL_GetMouseMotionSamples
+ */
+static int mouse_coalesceMotion(void *arg)
+{
+    SDL_MouseMotionEvent samples[8];
+    SDL_Event events[8];
+    SDL_Window *window;
+    int watched = 0;
+    int result;
+
+    /* Create test window */
+    window = createMouseSuiteTestWindow();
+    if (!window) {
+        return TEST_ABORTED;
+    }
+
+    /* Start from a known position with nothing queued */
+    SDL_WarpMouseInWindow(window, 1.0f, 1.0f);
+    SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+
+    SDL_SetHint(SDL_HINT_MOUSE_COALESCE_MOTION, "2");
+    SDLTest_AssertPass("SDL_SetHint(SDL_HINT_MOUSE_COALESCE_MOTION, \"2\")");
+
+    SDL_AddEventWatch(mouse_scaleMotionWatch, &watched);
+    SDLTest_AssertPass("Call to SDL_AddEventWatch()");
+
+    SDL_WarpMouseInWindow(window, 10.0f, 10.0f);
+    SDL_WarpMouseInWindow(window, 20.0f, 15.0f);
+    SDL_WarpMouseInWindow(window, 30.0f, 40.0f);
+    SDLTest_AssertPass("SDL_WarpMouseInWindow() three times");
+
+    SDL_DelEventWatch(mouse_scaleMotionWatch, &watched);
+    SDLTest_AssertCheck(watched == 3, "Check motion passed to the watcher, expected: 3, got: %d", watched);
+
+    /* The merged event must stay in the coordinates the watcher produced */
+    result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_EVENT_MOUSE_MOTION, SDL_EVENT_MOUSE_MOTION);
+    SDLTest_AssertCheck(result == 1, "Check number of motion events, expected: 1, got: %d", result);
+    if (result == 1) {
+        SDLTest_AssertCheck(events[0].motion.x == 60.0f && events[0].motion.y == 80.0f,
+                            "Check merged position, expected: 60,80, got: %.f,%.f", events[0].motion.x, events[0].motion.y);
+    }
+
+    result = SDL_GetMouseMotionSamples(samples, SDL_arraysize(samples));
+    SDLTest_AssertPass("Call to SDL_GetMouseMotionSamples()");
+    SDLTest_AssertCheck(result == 3, "Check number of motion samples, expected: 3, got: %d", result);
+    if (result == 3) {
+        SDLTest_AssertCheck(samples[1].x == 20.0f && samples[1].y == 15.0f,
+                            "Check second sample, expected: 20,15, got: %.f,%.f", samples[1].x, samples[1].y);
+    }
+    result = SDL_GetMouseMotionSamples(samples, SDL_arraysize(samples));
+    SDLTest_AssertCheck(result == 0, "Check samples were consumed, expected: 0, got: %d", result);
+
+    SDL_ResetHint(SDL_HINT_MOUSE_COALESCE_MOTION);
+
+    /* Clean up test window */
+    destroyMouseSuiteTestWindow(window);
+
+    return TEST_COMPLETED;
+}
+
 /**
  * Check call to SDL_GetMouseFocus
  *
@@ -646,10 +723,15 @@ static const SDLTest_TestCaseReference mouseTest12 = {
     (SDLTest_TestCaseFp)mouse_getGlobalMouseState, "mouse_getGlobalMouseState", "Check call to mouse_getGlobalMouseState", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference mouseTest13 = {
+    (SDLTest_TestCaseFp)mouse_coalesceMotion, "mouse_coalesceMotion", "Check merging of mouse motion events", TEST_ENABLED
+};
+
 /* Sequence of Mouse test cases */
 static const SDLTest_TestCaseReference *mouseTests[] = {
     &mouseTest1, &mouseTest2, &mouseTest3, &mouseTest4, &mouseTest5, &mouseTest6,
-    &mouseTest7, &mouseTest8, &mouseTest9, &mouseTest10, &mouseTest11, &mouseTest12, NULL
+    &mouseTest7, &mouseTest8, &mouseTest9, &mouseTest10, &mouseTest11, &mouseTest12,
+    &mouseTest13, NULL
 };
 
 /* Mouse test suite (global) */
@@ -0,0 +1,294 @@
+/*
+  Copyright (C) 1997-2023 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark of the event queue with several threads pushing events while
+   the main thread drains them, checking that each thread's events arrive
+   in order. Also measures how quickly SDL_WaitEventTimeout() wakes up when
+   another thread pushes an event. */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+#define DEFAULT_PRODUCERS 4
+#define DEFAULT_EVENTS    100000
+#define MAX_PRODUCERS     64
+#define BATCH_SIZE        64
+
+typedef enum
+{
+    DRAIN_POLL_EVENT,
+    DRAIN_POLL_EVENTS,
+    DRAIN_PEEK_FILTERED
+} DrainMode;
+
+static const char *drain_mode_names[] = {
+    "SDL_PollEvent",
+    "SDL_PollEvents",
+    "SDL_PeepEvents(SDL_EVENT_USER)"
+};
+
+typedef struct Producer_State
+{
+    SDL_Thread *thread;
+    int number;
+    int num_events;
+    int retries;
+} Producer_State;
+
+static SDL_AtomicInt start_flag;
+
+static int SDLCALL
+ProducerThread(void *data)
+{
+    Producer_State *state = (Producer_State *)data;
+    SDL_Event event;
+    int i;
+
+    while (!SDL_AtomicGet(&start_flag)) {
+        SDL_Delay(1);
+    }
+
+    for (i = 0; i < state->num_events; ++i) {
+        SDL_zero(event);
+        event.type = SDL_EVENT_USER;
+        event.user.code = i;
+        event.user.data1 = state;
+        while (SDL_PushEvent(&event) <= 0) {
+            /* The queue is full, give the consumer a chance to catch up */
+            ++state->retries;
+            SDL_DelayNS(0);
+        }
+    }
+    return 0;
+}
+
+static SDL_bool
+RunBenchmark(int num_producers, int num_events, DrainMode mode)
+{
+    Producer_State producers[MAX_PRODUCERS];
+    int next_code[MAX_PRODUCERS];
+    const Sint64 total = (Sint64)num_producers * num_events;
+    Sint64 received = 0;
+    Uint64 start, elapsed;
+    int retries = 0;
+    SDL_bool result = SDL_TRUE;
+    SDL_Event events[BATCH_SIZE];
+    int i, j;
+
+    SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+
+    SDL_AtomicSet(&start_flag, 0);
+    for (i = 0; i < num_producers; ++i) {
+        char name[64];
+        (void)SDL_snprintf(name, sizeof(name), "Producer%d", i);
+        producers[i].number = i;
+        producers[i].num_events = num_events;
+        producers[i].retries = 0;
+        producers[i].thread = SDL_CreateThread(ProducerThread, name, &producers[i]);
+        next_code[i] = 0;
+    }
+
+    start = SDL_GetTicksNS();
+    SDL_AtomicSet(&start_flag, 1);
+
+    while (received < total) {
+        int got;
+
+        switch (mode) {
+        case DRAIN_POLL_EVENTS:
+            got = SDL_PollEvents(events, BATCH_SIZE);
+            break;
+        case DRAIN_PEEK_FILTERED:
+            /* Take user events out of the middle of the queue */
+            SDL_PumpEvents();
+            got = SDL_PeepEvents(events, 1, SDL_GETEVENT, SDL_EVENT_USER, SDL_EVENT_USER);
+            break;
+        default:
+            got = SDL_PollEvent(&events[0]) ? 1 : 0;
+            break;
+        }
+
+        for (j = 0; j < got; ++j) {
+            const SDL_Event *event = &events[j];
+
+            if (event->type != SDL_EVENT_USER) {
+                continue;
+            }
+            for (i = 0; i < num_producers; ++i) {
+                if (event->user.data1 == &producers[i]) {
+                    break;
+                }
+            }
+            if (i == num_producers) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Got an event from an unknown producer\n");
+                result = SDL_FALSE;
+            } else if (event->user.code != next_code[i]) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Producer %d: expected event %d, got %d\n", i, next_code[i], (int)event->user.code);
+                result = SDL_FALSE;
+                next_code[i] = event->user.code + 1;
+            } else {
+                ++next_code[i];
+            }
+            ++received;
+        }
+    }
+    elapsed = SDL_GetTicksNS() - start;
+
+    for (i = 0; i < num_producers; ++i) {
+        SDL_WaitThread(producers[i].thread, NULL);
+        retries += producers[i].retries;
+    }
+
+    SDL_Log("%s: %d producers, %" SDL_PRIs64 " events in %.2f ms (%.0f events/sec, %d full-queue retries)\n",
+            drain_mode_names[mode],
+            num_producers, total, (double)elapsed / SDL_NS_PER_MS,
+            elapsed ? ((double)total * SDL_NS_PER_SECOND) / elapsed : 0.0, retries);
+
+    return result;
+}
+
+#define NUM_WAKEUPS 20
+#define WAKEUP_DELAY_MS 5
+
+static int SDLCALL
+WakeupThread(void *data)
+{
+    Uint64 *push_times = (Uint64 *)data;
+    SDL_Event event;
+    int i;
+
+    for (i = 0; i < NUM_WAKEUPS; ++i) {
+        SDL_Delay(WAKEUP_DELAY_MS);
+        SDL_zero(event);
+        event.type = SDL_EVENT_USER;
+        event.user.code = i;
+        push_times[i] = SDL_GetTicksNS();
+        SDL_PushEvent(&event);
+    }
+    return 0;
+}
+
+static SDL_bool
+RunWakeupBenchmark(void)
+{
+    Uint64 push_times[NUM_WAKEUPS];
+    Uint64 total_latency = 0, max_latency = 0;
+    Uint64 start, elapsed;
+    SDL_Thread *thread;
+    SDL_Event event;
+    SDL_bool result = SDL_TRUE;
+    int received = 0;
+
+    SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+
+    /* A wait with nothing to wake us should last the whole timeout */
+    start = SDL_GetTicksNS();
+    if (SDL_WaitEventTimeout(&event, 50)) {
+        SDL_Log("Woke up with an unexpected event 0x%x\n", (unsigned int)event.type);
+    }
+    elapsed = SDL_GetTicksNS() - start;
+    SDL_Log("SDL_WaitEventTimeout(50 ms) with no events took %.2f ms\n", (double)elapsed / SDL_NS_PER_MS);
+    if (elapsed < SDL_MS_TO_NS(50)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_WaitEventTimeout() returned before the timeout\n");
+        result = SDL_FALSE;
+    }
+
+    thread = SDL_CreateThread(WakeupThread, "WakeupThread", push_times);
+    while (received < NUM_WAKEUPS) {
+        if (!SDL_WaitEventTimeout(&event, 1000)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Timed out waiting for event %d\n", received);
+            result = SDL_FALSE;
+            break;
+        }
+        if (event.type == SDL_EVENT_USER) {
+            const Uint64 latency = SDL_GetTicksNS() - push_times[event.user.code];
+            total_latency += latency;
+            max_latency = SDL_max(max_latency, latency);
+            ++received;
+        }
+    }
+    SDL_WaitThread(thread, NULL);
+
+    if (received > 0) {
+        SDL_Log("SDL_WaitEventTimeout: %d wakeups from another thread, average latency %.3f ms, max %.3f ms\n",
+                received, ((double)total_latency / received) / SDL_NS_PER_MS, (double)max_latency / SDL_NS_PER_MS);
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int num_producers = DEFAULT_PRODUCERS;
+    int num_events = DEFAULT_EVENTS;
+    SDL_bool success = SDL_TRUE;
+    SDLTest_CommonState *state;
+    int i;
+
+    /* Initialize test framework */
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (!state) {
+        return 1;
+    }
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Parse commandline */
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (!consumed) {
+            if (SDL_strcmp(argv[i], "--producers") == 0 && argv[i + 1]) {
+                num_producers = SDL_clamp(SDL_atoi(argv[i + 1]), 1, MAX_PRODUCERS);
+                consumed = 2;
+            } else if (SDL_strcmp(argv[i], "--events") == 0 && argv[i + 1]) {
+                num_events = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            }
+        }
+        if (consumed <= 0) {
+            static const char *options[] = { "[--producers N]", "[--events N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+
+        i += consumed;
+    }
+
+    if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    if (!RunBenchmark(1, num_events, DRAIN_POLL_EVENT)) {
+        success = SDL_FALSE;
+    }
+    if (!RunBenchmark(num_producers, num_events, DRAIN_POLL_EVENT)) {
+        success = SDL_FALSE;
+    }
+    if (!RunBenchmark(num_producers, num_events, DRAIN_POLL_EVENTS)) {
+        success = SDL_FALSE;
+    }
+    if (!RunBenchmark(num_producers, SDL_max(num_events / 10, 1), DRAIN_PEEK_FILTERED)) {
+        success = SDL_FALSE;
+    }
+    if (!RunWakeupBenchmark()) {
+        success = SDL_FALSE;
+    }
+
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+
+    return success ? 0 : 1;
+}
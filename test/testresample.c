@@ -15,10 +15,147 @@
 #include <SDL3/SDL_test.h>
 
 static void log_usage(char *progname, SDLTest_CommonState *state) {
-    static const char *options[] = { "in.wav", "out.wav", "newfreq", "newchan", NULL };
+    static const char *options[] = { "[--benchmark [--seconds N]]", "in.wav", "out.wav", "newfreq", "newchan", NULL };
     SDLTest_CommonLogUsage(state, progname, options);
 }
 
+/* Push a generated sine wave through an SDL_AudioStream for `seconds` and return the output frames per second, or -1.0 on failure. */
+static double benchmark_stream(const SDL_AudioSpec *src_spec, const SDL_AudioSpec *dst_spec, SDL_AudioResamplerQuality quality,
+                               float *src_buf, float *dst_buf, int chunk_frames, double seconds)
+{
+    const int channels = src_spec->channels;
+    const int src_len = chunk_frames * channels * (int)sizeof(float);
+    const int dst_len = chunk_frames * 4 * dst_spec->channels * (int)sizeof(float);
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    SDL_AudioStream *stream;
+    Uint64 start, elapsed;
+    Sint64 total_bytes = 0;
+    int i;
+
+    for (i = 0; i < chunk_frames * channels; i++) {
+        src_buf[i] = SDL_sinf((float)(i / channels) * 440.0f * 2.0f * SDL_PI_F / (float)src_spec->freq) * 0.5f;
+    }
+
+    stream = SDL_CreateAudioStream(src_spec, dst_spec);
+    if (!stream) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_CreateAudioStream() failed: %s\n", SDL_GetError());
+        return -1.0;
+    }
+
+    SDL_SetNumberProperty(SDL_GetAudioStreamProperties(stream), "SDL.audiostream.resampler_quality", quality);
+
+    start = SDL_GetPerformanceCounter();
+    do {
+        int got;
+        if (SDL_PutAudioStreamData(stream, src_buf, src_len) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_PutAudioStreamData() failed: %s\n", SDL_GetError());
+            SDL_DestroyAudioStream(stream);
+            return -1.0;
+        }
+        while ((got = SDL_GetAudioStreamData(stream, dst_buf, dst_len)) > 0) {
+            total_bytes += got;
+        }
+        elapsed = SDL_GetPerformanceCounter() - start;
+    } while (elapsed < (Uint64)(frequency * seconds));
+
+    SDL_DestroyAudioStream(stream);
+
+    return (double)(total_bytes / (dst_spec->channels * (Sint64)sizeof(float))) * (double)frequency / (double)elapsed;
+}
+
+/* Resample a generated signal through SDL_AudioStreams and report the throughput.
+   44.1kHz to 48kHz is a 147:160 ratio and uses the precomputed polyphase filters; 47999Hz has
+   no small ratio and takes the interpolating path, so it's there for comparison.
+   After that, each resampler quality tier is run on a mono 22.05kHz "sound effect" voice
+   played at 48kHz, to show how many such voices one core could keep up with.
+   Last, every channel layout is converted to every other one, without resampling. */
+static int run_benchmark(int seconds)
+{
+    static const int channel_counts[] = { 1, 2, 6, 8 };
+    static const int dst_freqs[] = { 48000, 47999 };
+    static const char *quality_names[] = { "nearest", "linear", "cubic", "sinc" };
+    static const char *layout_names[] = { "mono", "stereo", "2.1", "quad", "4.1", "5.1", "6.1", "7.1" };
+    const int chunk_frames = 4096;
+    SDL_AudioSpec src_spec, dst_spec;
+    float *src_buf = NULL;
+    float *dst_buf = NULL;
+    double frames_per_second;
+    int ret = 0;
+    int i, j;
+
+    src_buf = (float *)SDL_malloc(chunk_frames * 8 * sizeof(float));
+    dst_buf = (float *)SDL_malloc(chunk_frames * 4 * 8 * sizeof(float));
+    if (!src_buf || !dst_buf) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        ret = 1;
+        goto end;
+    }
+
+    src_spec.format = SDL_AUDIO_F32;
+    src_spec.freq = 44100;
+    dst_spec.format = SDL_AUDIO_F32;
+
+    SDL_Log("Resampling from %d Hz for %d second(s) per test", src_spec.freq, seconds);
+
+    for (i = 0; i < (int)SDL_arraysize(channel_counts) * (int)SDL_arraysize(dst_freqs); i++) {
+        src_spec.channels = dst_spec.channels = channel_counts[i / SDL_arraysize(dst_freqs)];
+        dst_spec.freq = dst_freqs[i % SDL_arraysize(dst_freqs)];
+
+        frames_per_second = benchmark_stream(&src_spec, &dst_spec, SDL_AUDIO_RESAMPLER_SINC, src_buf, dst_buf, chunk_frames, seconds);
+        if (frames_per_second < 0.0) {
+            ret = 1;
+            goto end;
+        }
+
+        SDL_Log("%d channel(s) to %d Hz: %8.2f Mframes/s (%.0fx realtime)", src_spec.channels, dst_spec.freq, frames_per_second / 1000000.0, frames_per_second / dst_spec.freq);
+    }
+
+    src_spec.channels = dst_spec.channels = 1;
+    src_spec.freq = 22050;
+    dst_spec.freq = 48000;
+
+    SDL_Log("Resampling mono %d Hz voices to %d Hz", src_spec.freq, dst_spec.freq);
+
+    for (i = SDL_AUDIO_RESAMPLER_NEAREST; i <= SDL_AUDIO_RESAMPLER_SINC; i++) {
+        frames_per_second = benchmark_stream(&src_spec, &dst_spec, (SDL_AudioResamplerQuality)i, src_buf, dst_buf, chunk_frames, seconds);
+        if (frames_per_second < 0.0) {
+            ret = 1;
+            goto end;
+        }
+
+        SDL_Log("%-7s: %8.2f Mframes/s (%.0f voices per core)", quality_names[i], frames_per_second / 1000000.0, frames_per_second / dst_spec.freq);
+    }
+
+    src_spec.freq = dst_spec.freq = 48000;
+
+    SDL_Log("Converting channel layouts, in Mframes/s (rows are the source layout):");
+    SDL_Log("%-7s %7s %7s %7s %7s %7s %7s %7s %7s", "", layout_names[0], layout_names[1], layout_names[2], layout_names[3],
+            layout_names[4], layout_names[5], layout_names[6], layout_names[7]);
+
+    for (i = 0; i < (int)SDL_arraysize(layout_names); i++) {
+        double results[SDL_arraysize(layout_names)];
+
+        src_spec.channels = i + 1;
+        for (j = 0; j < (int)SDL_arraysize(layout_names); j++) {
+            dst_spec.channels = j + 1;
+            results[j] = benchmark_stream(&src_spec, &dst_spec, SDL_AUDIO_RESAMPLER_SINC, src_buf, dst_buf, chunk_frames, seconds / 8.0);
+            if (results[j] < 0.0) {
+                ret = 1;
+                goto end;
+            }
+        }
+
+        SDL_Log("%-7s %7.1f %7.1f %7.1f %7.1f %7.1f %7.1f %7.1f %7.1f", layout_names[i],
+                results[0] / 1000000.0, results[1] / 1000000.0, results[2] / 1000000.0, results[3] / 1000000.0,
+                results[4] / 1000000.0, results[5] / 1000000.0, results[6] / 1000000.0, results[7] / 1000000.0);
+    }
+
+end:
+    SDL_free(src_buf);
+    SDL_free(dst_buf);
+    return ret;
+}
+
 int main(int argc, char **argv)
 {
     SDL_AudioSpec spec;
@@ -38,6 +175,8 @@ int main(int argc, char **argv)
     SDLTest_CommonState *state;
     char *file_in = NULL;
     char *file_out = NULL;
+    SDL_bool benchmark = SDL_FALSE;
+    int seconds = 1;
 
     /* Initialize test framework */
     state = SDLTest_CommonCreateState(argv, 0);
@@ -56,7 +195,13 @@ int main(int argc, char **argv)
 
         consumed = SDLTest_CommonArg(state, i);
         if (!consumed) {
-            if (argpos == 0) {
+            if (SDL_strcmp(argv[i], "--benchmark") == 0) {
+                benchmark = SDL_TRUE;
+                consumed = 1;
+            } else if (SDL_strcmp(argv[i], "--seconds") == 0 && argv[i + 1]) {
+                seconds = SDL_atoi(argv[i + 1]);
+                consumed = (seconds > 0) ? 2 : -1;
+            } else if (argpos == 0) {
                 file_in = argv[i];
                 argpos++;
                 consumed = 1;
@@ -89,7 +234,7 @@ int main(int argc, char **argv)
         i += consumed;
     }
 
-    if (argpos != 4) {
+    if ((argpos != 4) && !(benchmark && argpos == 0)) {
         log_usage(argv[0], state);
         ret = 1;
         goto end;
@@ -101,6 +246,11 @@ int main(int argc, char **argv)
         goto end;
     }
 
+    if (benchmark) {
+        ret = run_benchmark(seconds);
+        goto end;
+    }
+
     if (SDL_LoadWAV(file_in, &spec, &data, &len) == -1) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "failed to load %s: %s\n", file_in, SDL_GetError());
         ret = 3;